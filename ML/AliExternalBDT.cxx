@@ -13,9 +13,20 @@
 #include "AliExternalBDT.h"
 
 #include <cassert>
+#include <cstdint>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <sstream>
 #include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
+
+#include <TSystem.h>
+
+#ifndef ALIEXTERNALBDT_TREELITE_VERSION
+#define ALIEXTERNALBDT_TREELITE_VERSION "unknown"
+#endif
 
 namespace {
   inline bool checkFile (const std::string name) {
@@ -27,18 +38,81 @@ namespace {
       return false;
     }
   }
+
+  const std::string kCompileFlags{"-O1 -fPIC"};
+
+  /// 64 bit FNV-1a, good enough to tell models apart
+  inline void hashBytes(uint64_t &hash, const char *data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+      hash ^= static_cast<unsigned char>(data[i]);
+      hash *= 1099511628211ull;
+    }
+  }
+
+  /// version of the treelite library generating the model code
+  std::string treeliteVersion() {
+#ifdef ALIEXTERNALBDT_TREELITE_VERSION_QUERY
+    return TreeliteQueryTreeliteVersion();
+#else
+    return ALIEXTERNALBDT_TREELITE_VERSION;
+#endif
+  }
+
+  /// version of the compiler used for the model libraries, evaluated once per process
+  std::string compilerVersion() {
+    static std::string version;
+    if (version.empty()) {
+      version = "unknown";
+      FILE *pipe = popen("gcc -dumpfullversion -dumpversion 2>/dev/null", "r");
+      if (pipe) {
+        char buffer[128];
+        if (fgets(buffer, sizeof(buffer), pipe)) {
+          version = buffer;
+          version.erase(version.find_last_not_of(" \n\r") + 1);
+        }
+        pclose(pipe);
+      }
+    }
+    return version;
+  }
 }
 
+std::string AliExternalBDT::fgCacheDirectory{""};
+
 AliExternalBDT::AliExternalBDT(std::string name) :
   fBDTname{name},
   fModel{},
   fModelPath{""},
   fModelName{""},
   fCompiler{},
-  fPredictor{}
+  fPredictor{},
+  fModelHash{""},
+  fCacheDirectory{""},
+  fMode{kCompiled},
+  fInterpreted{false},
+  fEntries{},
+  fFeatures{},
+  fResultSize{0u}
 {
 }
 
+std::string AliExternalBDT::GetDefaultCacheDirectory() {
+  if (!fgCacheDirectory.empty()) return fgCacheDirectory;
+  const char *env = getenv("ALIEXTERNALBDT_CACHE_DIR");
+  return env ? std::string(env) : std::string(".");
+}
+
+std::string AliExternalBDT::GetCacheDirectory() const {
+  return fCacheDirectory.empty() ? GetDefaultCacheDirectory() : fCacheDirectory;
+}
+
+bool AliExternalBDT::HasInterpreter() {
+#ifdef ALIEXTERNALBDT_GTIL
+  return true;
+#else
+  return false;
+#endif
+}
 
 bool AliExternalBDT::CompileAndLoadModelLibrary() {
   std::string path = GetUniquePath();
@@ -46,8 +120,17 @@ bool AliExternalBDT::CompileAndLoadModelLibrary() {
     std::cout << "Library found: " << path.data() << "/main.so . Loading it!" << std::endl;
   } else {
     std::cout << "Starting the model compilation, depending on the model size it can take a while..." << std::endl;
-    system((std::string("gcc -c -O1 -fPIC ") + path + "/main.c -o " + path + "/main.o && gcc -shared " + path + \
-          "/main.o -o " + path + "/main.so").data());
+    /// build under a process-unique name and rename, so that jobs sharing the cache never see a partial library
+    const std::string tmp = path + "/main." + std::to_string(getpid());
+    const int status = system((std::string("gcc -c ") + kCompileFlags + " " + path + "/main.c -o " + tmp + ".o && gcc -shared " + \
+          tmp + ".o -o " + tmp + ".so").data());
+    if (status != 0 || rename((tmp + ".so").data(), (path + "/main.so").data()) != 0) {
+      std::cerr << "Model compilation failed." << std::endl;
+      remove((tmp + ".so").data());
+      remove((tmp + ".o").data());
+      return false;
+    }
+    remove((tmp + ".o").data());
   }
   return LoadModelLibrary(path + "/main.so");
 }
@@ -55,29 +138,56 @@ bool AliExternalBDT::CompileAndLoadModelLibrary() {
 bool AliExternalBDT::CreateModelCode() {
   std::string path = GetUniquePath();
   if (checkFile(path + "/main.c")) {
-    std::cout << "Code found: " << path.data() << "/main.c . \
-      Remove it or unset/change the AliExternalBDT name to force its regeneration." << std::endl;
+    std::cout << "Code found: " << path.data() << "/main.c . Reusing it." << std::endl;
   } else {
     const int status_comp = TreeliteCompilerCreate("ast_native", &fCompiler);
     if (status_comp != 0) {
       std::cerr << "Compiler creation failed." << std::endl;
       return false;
     }
-    const int status_gen = TreeliteCompilerGenerateCode(fCompiler, fModel, 1, path.data());
+    /// generate in a private directory, then move it in place: the first job to finish wins
+    const std::string tmp = path + ".tmp" + std::to_string(getpid());
+    const int status_gen = TreeliteCompilerGenerateCode(fCompiler, fModel, 1, tmp.data());
+    TreeliteCompilerFree(fCompiler);
+    fCompiler = nullptr;
     if (status_gen != 0) {
       std::cerr << "Code generation failed." << std::endl;
       return false;
     }
+    if (rename(tmp.data(), path.data()) != 0) {
+      system((std::string("rm -rf ") + tmp).data());
+      if (!checkFile(path + "/main.c")) {
+        std::cerr << "Cannot move the generated code to " << path.data() << std::endl;
+        return false;
+      }
+    }
   }
   return true;
 }
 
-std::string AliExternalBDT::GetUniquePath() {
-  if (fBDTname.empty()) {
-    return fModelName + std::to_string((unsigned long)this);
-  } else {
-    return fBDTname + "_" + fModelName;
+bool AliExternalBDT::ComputeModelHash() {
+  std::ifstream model(fModelPath, std::ios::binary);
+  if (!model) {
+    std::cerr << "Cannot read the model file " << fModelPath.data() << std::endl;
+    return false;
+  }
+  uint64_t hash = 14695981039346656037ull;
+  char buffer[1 << 16];
+  while (model.read(buffer, sizeof(buffer)) || model.gcount() > 0) {
+    hashBytes(hash, buffer, static_cast<size_t>(model.gcount()));
   }
+  const std::string tools = "treelite " + treeliteVersion() + "|gcc " + compilerVersion() + "|" + kCompileFlags;
+  hashBytes(hash, tools.data(), tools.size());
+
+  std::ostringstream hex;
+  hex << std::hex << hash;
+  fModelHash = hex.str();
+  return true;
+}
+
+std::string AliExternalBDT::GetUniquePath() {
+  /// content addressed: identical models share the same code and library whatever the handler name
+  return GetCacheDirectory() + "/" + fModelName + "_" + fModelHash;
 }
 
 bool AliExternalBDT::LoadModel(const std::string &path, int type) {
@@ -103,7 +213,26 @@ bool AliExternalBDT::LoadModel(const std::string &path, int type) {
     std::cerr << "Model loading failed" << std::endl;
     return false;
   }
-  if (!CreateModelCode()) return false;
+  if (!ComputeModelHash()) return false;
+
+  const bool cached = checkFile(GetUniquePath() + "/main.so");
+  if (fMode == kInterpreted || (fMode == kCacheOrInterpreted && !cached)) {
+    if (!HasInterpreter()) {
+      std::cerr << "Interpreted prediction not available in this treelite build" << std::endl;
+      return false;
+    }
+    std::cout << "Using the interpreted prediction for " << fModelName.data() << std::endl;
+    fInterpreted = true;
+    return true;
+  }
+  if (!cached) {
+    const std::string dir = GetCacheDirectory();
+    if (gSystem->mkdir(dir.data(), kTRUE) != 0 && gSystem->AccessPathName(dir.data())) {
+      std::cerr << "Cannot create the cache directory " << dir.data() << std::endl;
+      return false;
+    }
+    if (!CreateModelCode()) return false;
+  }
   if (!CompileAndLoadModelLibrary()) return false;
   return true;
 }
@@ -124,20 +253,67 @@ bool AliExternalBDT::LoadModelLibrary(std::string path) {
     std::cerr << "Library loading failed" << std::endl;
     return false;
   }
+  TreelitePredictorQueryResultSizeSingleInst(fPredictor, &fResultSize);
+  assert(fResultSize == 1);
   return true;
 }
 
-double AliExternalBDT::Predict(double *features, int size, bool useRawScore) {
-  std::vector<TreelitePredictorEntry> entries(size);
-  for (size_t iEntry = 0; iEntry < entries.size(); ++iEntry) {
-    entries[iEntry].fvalue = static_cast<float>(features[iEntry]);
+double AliExternalBDT::Predict(const double *features, int size, bool useRawScore) {
+  double score = 0.;
+  if (!Predict(features, size, score, useRawScore)) return std::numeric_limits<double>::quiet_NaN();
+  return score;
+}
+
+bool AliExternalBDT::Predict(const double *features, int size, double &score, bool useRawScore) {
+  float output = 0.f;
+  if (fInterpreted) {
+    fFeatures.assign(features, features + size);
+    if (!PredictBatch(fFeatures.data(), 1, size, &output, useRawScore)) return false;
+    score = output;
+    return true;
+  }
+  if (fEntries.size() != static_cast<size_t>(size)) fEntries.resize(size);
+  for (size_t iEntry = 0; iEntry < fEntries.size(); ++iEntry) {
+    fEntries[iEntry].fvalue = static_cast<float>(features[iEntry]);
+  }
+  size_t out_size{fResultSize};
+  if (TreelitePredictorPredictInst(fPredictor, fEntries.data(),
+        static_cast<int>(useRawScore), &output, &out_size) != 0) {
+    std::cerr << "Prediction failed" << std::endl;
+    return false;
   }
+  score = output;
+  return true;
+}
+
+bool AliExternalBDT::PredictBatch(const float *features, size_t nRows, int nCols, float *out, bool useRawScore) {
+  if (nRows == 0) return true;
   size_t out_size{0u};
-  TreelitePredictorQueryResultSizeSingleInst(fPredictor, &out_size);
-  assert(out_size == 1);
-  float output = 0.f;
-  TreelitePredictorPredictInst(fPredictor, entries.data(),
-      static_cast<int>(useRawScore), &output,
-      &out_size);
-  return output;
+  if (fInterpreted) {
+#ifdef ALIEXTERNALBDT_GTIL
+    const int status = TreeliteGTILPredict(fModel, features, nRows, out, static_cast<int>(!useRawScore), &out_size);
+    if (status != 0 || out_size != nRows) {
+      std::cerr << "Interpreted prediction failed" << std::endl;
+      return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+  }
+  /// the dense batch only wraps the input matrix, no copy is done
+  DenseBatchHandle batch{};
+  if (TreeliteAssembleDenseBatch(features, std::numeric_limits<float>::quiet_NaN(), nRows,
+        static_cast<size_t>(nCols), &batch) != 0) {
+    std::cerr << "Batch assembly failed" << std::endl;
+    return false;
+  }
+  const int status = TreelitePredictorPredictBatch(fPredictor, batch, 0, 0,
+      static_cast<int>(useRawScore), out, &out_size);
+  TreeliteDeleteDenseBatch(batch);
+  if (status != 0 || out_size != nRows) {
+    std::cerr << "Batch prediction failed" << std::endl;
+    return false;
+  }
+  return true;
 }
@@ -22,18 +22,43 @@
 
 class AliExternalBDT {
 public:
+  /// kCompiled: use the cached library, compile it if missing (default)
+  /// kCacheOrInterpreted: use the cached library if present, never compile
+  /// kInterpreted: never compile, evaluate the model in process
+  enum EPredictionMode { kCompiled, kCacheOrInterpreted, kInterpreted };
+
   AliExternalBDT(std::string name = "");
   virtual ~AliExternalBDT(){};
 
+  /// default directory of the compiled models, used by the handlers without their own
+  /// ($ALIEXTERNALBDT_CACHE_DIR if set, current directory otherwise)
+  static void SetDefaultCacheDirectory(std::string dir) { fgCacheDirectory = dir; }
+  static std::string GetDefaultCacheDirectory();
+  /// true if the in-process (interpreted) treelite evaluation is available
+  static bool HasInterpreter();
+
+  /// directory of the compiled models of this handler, to be set before loading the model
+  void SetCacheDirectory(std::string dir) { fCacheDirectory = dir; }
+  std::string GetCacheDirectory() const;
+  void SetPredictionMode(EPredictionMode mode) { fMode = mode; }
+  EPredictionMode GetPredictionMode() const { return fMode; }
+  std::string const &GetModelHash() const { return fModelHash; }
+
   bool LoadLightGBMModel(std::string path);
   bool LoadModelLibrary(std::string path);
   bool LoadXGBoostModel(std::string path);
 
-  double Predict(double *features, int size, bool useRaw = false);
+  /// single instance prediction, NaN if the prediction fails
+  double Predict(const double *features, int size, bool useRaw = false);
+  /// single instance prediction, returns false if the prediction fails
+  bool Predict(const double *features, int size, double &score, bool useRaw = false);
+  /// batch prediction: features is a row-major nRows x nCols matrix, out has nRows entries
+  bool PredictBatch(const float *features, size_t nRows, int nCols, float *out, bool useRaw = false);
 
 private:
   bool CompileAndLoadModelLibrary();
   bool CreateModelCode();
+  bool ComputeModelHash();
   std::string GetUniquePath();
   bool LoadModel(const std::string &path, int type);
 
@@ -43,6 +68,17 @@ private:
   std::string fModelName;
   CompilerHandle fCompiler;
   PredictorHandle fPredictor;
+
+  std::string fModelHash;     /// hash of model content, treelite and compiler: key of the cache
+  std::string fCacheDirectory; /// directory of the compiled models, default one if empty
+  EPredictionMode fMode;      /// how the model is evaluated
+  bool fInterpreted;          /// true if the model is evaluated in process
+
+  std::vector<TreelitePredictorEntry> fEntries; //!<! scratch entries for the single-instance prediction
+  std::vector<float> fFeatures;                 //!<! scratch features for the interpreted prediction
+  size_t fResultSize;                           //!<! result size of a single instance, queried once
+
+  static std::string fgCacheDirectory;          /// shared directory of the compiled models
 };
 
 #endif
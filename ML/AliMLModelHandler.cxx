@@ -26,7 +26,8 @@ ClassImp(AliMLModelHandler);
 /// \endcond
 
 //_______________________________________________________________________________
-AliMLModelHandler::AliMLModelHandler() : TNamed(), fModel{nullptr}, fPath{}, fLibrary{}, fScoreCut{} {
+AliMLModelHandler::AliMLModelHandler()
+    : TNamed(), fModel{nullptr}, fPath{}, fLibrary{}, fScoreCut{}, fCacheDirectory{}, fPredictionMode{-1} {
   //
   // Default constructor
   //
@@ -35,7 +36,8 @@ AliMLModelHandler::AliMLModelHandler() : TNamed(), fModel{nullptr}, fPath{}, fLi
 //_______________________________________________________________________________
 AliMLModelHandler::AliMLModelHandler(const YAML::Node &node)
     : TNamed(), fModel{nullptr}, fPath{node["path"].as<std::string>()},
-      fLibrary{node["library"].as<std::string>()}, fScoreCut{node["cut"].as<double>()} {
+      fLibrary{node["library"].as<std::string>()}, fScoreCut{node["cut"].as<double>()}, fCacheDirectory{},
+      fPredictionMode{-1} {
   //
   // Standard constructor
   //
@@ -53,7 +55,8 @@ AliMLModelHandler::~AliMLModelHandler() {
 //_______________________________________________________________________________
 AliMLModelHandler::AliMLModelHandler(const AliMLModelHandler &source)
     : TNamed(source.GetName(), source.GetTitle()), fModel{nullptr}, fPath{source.fPath},
-      fLibrary{source.fLibrary}, fScoreCut{source.fScoreCut} {
+      fLibrary{source.fLibrary}, fScoreCut{source.fScoreCut}, fCacheDirectory{source.fCacheDirectory},
+      fPredictionMode{source.fPredictionMode} {
   //
   // Copy constructor
   //
@@ -75,6 +78,8 @@ AliMLModelHandler &AliMLModelHandler::operator=(const AliMLModelHandler &source)
   fPath      = source.fPath;
   fLibrary   = source.fLibrary;
   fScoreCut  = source.fScoreCut;
+  fCacheDirectory = source.fCacheDirectory;
+  fPredictionMode = source.fPredictionMode;
 
   return *this;
 }
@@ -88,6 +93,11 @@ bool AliMLModelHandler::CompileModel() {
 
   std::string localpath = ImportFile(fPath);
 
+  if (!fCacheDirectory.empty())
+    fModel->SetCacheDirectory(fCacheDirectory);
+  if (fPredictionMode >= 0)
+    fModel->SetPredictionMode(static_cast<AliExternalBDT::EPredictionMode>(fPredictionMode));
+
   switch (libraryMap[GetLibrary()]) {
     case kXGBoost: {
       return fModel->LoadXGBoostModel(localpath.data());
@@ -108,6 +118,19 @@ bool AliMLModelHandler::CompileModel() {
   }
 }
 
+//_______________________________________________________________________________
+int AliMLModelHandler::PredictionModeFromString(std::string mode) {
+  std::map<std::string, int> modeMap = {{"kCompiled", AliExternalBDT::kCompiled},
+                                        {"kCacheOrInterpreted", AliExternalBDT::kCacheOrInterpreted},
+                                        {"kInterpreted", AliExternalBDT::kInterpreted}};
+  auto found = modeMap.find(mode);
+  if (found == modeMap.end()) {
+    AliFatalClass(Form("Unknown prediction mode %s! Exit", mode.data()));
+    return -1;
+  }
+  return found->second;
+}
+
 //_______________________________________________________________________________
 std::string AliMLModelHandler::ImportFile(std::string path) {
   std::string modelname = path.substr(path.find_last_of("/") + 1);
@@ -39,6 +39,14 @@ public:
   std::string const &GetLibrary() const { return fLibrary; }
   double const &GetScoreCut() const { return fScoreCut; }
 
+  /// directory of the compiled model (AliExternalBDT default if empty)
+  void SetCacheDirectory(std::string dir) { fCacheDirectory = dir; }
+  std::string const &GetCacheDirectory() const { return fCacheDirectory; }
+  /// AliExternalBDT::EPredictionMode of the model (AliExternalBDT default if negative)
+  void SetPredictionMode(int mode) { fPredictionMode = mode; }
+  int GetPredictionMode() const { return fPredictionMode; }
+  static int PredictionModeFromString(std::string mode);
+
   bool CompileModel();
   static std::string ImportFile(std::string path);
 
@@ -50,8 +58,11 @@ private:
 
   double fScoreCut;        ///
 
+  std::string fCacheDirectory;    /// directory of the compiled model
+  int fPredictionMode;            /// how the model is evaluated
+
 /// \cond CLASSIMP
-ClassDef(AliMLModelHandler, 1);    ///
+ClassDef(AliMLModelHandler, 2);    ///
 /// \endcond
 };
 
@@ -12,6 +12,8 @@
 
 #include "AliMLResponse.h"
 
+#include <algorithm>
+
 #include "yaml-cpp/yaml.h"
 
 #include "AliExternalBDT.h"
@@ -28,8 +30,9 @@ ClassImp(AliMLResponse);
 
 //_______________________________________________________________________________
 AliMLResponse::AliMLResponse()
-    : TNamed(), fConfigFilePath{}, fModels{}, fCentClasses{}, fBins{}, fVariableNames{}, fNBins{}, fNVariables{},
-      fBinsBegin{}, fRaw{} {
+    : TNamed(), fConfigFilePath{}, fCacheDirectory{}, fPredictionMode{-1}, fModels{}, fCentClasses{}, fBins{},
+      fVariableNames{}, fNBins{}, fNVariables{}, fBinsBegin{}, fRaw{}, fFeatures{}, fBatchRows{}, fBatchFeatures{},
+      fBatchScores{} {
   //
   // Default constructor
   //
@@ -37,8 +40,9 @@ AliMLResponse::AliMLResponse()
 
 //_______________________________________________________________________________
 AliMLResponse::AliMLResponse(const Char_t *name, const Char_t *title)
-    : TNamed(name, title), fConfigFilePath{""}, fModels{}, fCentClasses{}, fBins{}, fVariableNames{}, fNBins{},
-      fNVariables{}, fBinsBegin{}, fRaw{} {
+    : TNamed(name, title), fConfigFilePath{""}, fCacheDirectory{""}, fPredictionMode{-1}, fModels{}, fCentClasses{},
+      fBins{}, fVariableNames{}, fNBins{}, fNVariables{}, fBinsBegin{}, fRaw{}, fFeatures{}, fBatchRows{},
+      fBatchFeatures{}, fBatchScores{} {
   //
   // Standard constructor
   //
@@ -53,9 +57,11 @@ AliMLResponse::~AliMLResponse() {
 
 //_______________________________________________________________________________
 AliMLResponse::AliMLResponse(const AliMLResponse &source)
-    : TNamed(source.GetName(), source.GetTitle()), fConfigFilePath{source.fConfigFilePath}, fModels{source.fModels},
+    : TNamed(source.GetName(), source.GetTitle()), fConfigFilePath{source.fConfigFilePath},
+      fCacheDirectory{source.fCacheDirectory}, fPredictionMode{source.fPredictionMode}, fModels{source.fModels},
       fCentClasses{source.fCentClasses}, fBins{source.fBins}, fVariableNames{source.fVariableNames},
-      fNBins{source.fNBins}, fNVariables{source.fNVariables}, fBinsBegin{source.fBinsBegin}, fRaw{source.fRaw} {
+      fNBins{source.fNBins}, fNVariables{source.fNVariables}, fBinsBegin{source.fBinsBegin}, fRaw{source.fRaw},
+      fFeatures{}, fBatchRows{}, fBatchFeatures{}, fBatchScores{} {
   //
   // Copy constructor
   //
@@ -70,6 +76,8 @@ AliMLResponse &AliMLResponse::operator=(const AliMLResponse &source) {
   TNamed::operator=(source);
 
   fConfigFilePath = source.fConfigFilePath;
+  fCacheDirectory = source.fCacheDirectory;
+  fPredictionMode = source.fPredictionMode;
   fModels         = source.fModels;
   fCentClasses    = source.fCentClasses;
   fBins           = source.fBins;
@@ -120,8 +128,16 @@ void AliMLResponse::CompileModels(std::string configLocalPath) {
 
   fBinsBegin = fBins.begin();
 
+  /// optional settings of the compiled-model cache, the values set in the code win
+  if (fCacheDirectory.empty() && nodeList["CACHE_DIR"])
+    fCacheDirectory = nodeList["CACHE_DIR"].as<string>();
+  if (fPredictionMode < 0 && nodeList["PREDICTION_MODE"])
+    fPredictionMode = AliMLModelHandler::PredictionModeFromString(nodeList["PREDICTION_MODE"].as<string>());
+
   for (const auto &model : nodeList["MODELS"]) {
     fModels.push_back(AliMLModelHandler{model});
+    fModels.back().SetCacheDirectory(fCacheDirectory);
+    fModels.back().SetPredictionMode(fPredictionMode);
   }
 
   for (auto &model : fModels) {
@@ -151,28 +167,33 @@ int AliMLResponse::FindBin(double binvar) {
 }
 
 //_______________________________________________________________________________
-double AliMLResponse::Predict(double binvar, map<string, double> varmap) {
+double AliMLResponse::Predict(double binvar, const map<string, double> &varmap) {
   if ((int)varmap.size() < fNVariables) {
     AliFatal("The variable map you provided to the predictor has a size smaller than the variable list size! Exit");
   }
 
-  vector<double> features;
+  fFeatures.clear();
   for (const auto &varname : fVariableNames) {
-    if (varmap.find(varname) == varmap.end()) {
+    auto var = varmap.find(varname);
+    if (var == varmap.end()) {
       AliFatal(Form("Variable |%s| not found in variable list provided in config! Exit", varname.data()));
     }
-    features.push_back(varmap[varname]);
+    fFeatures.push_back(var->second);
   }
 
   int bin = FindBin(binvar);
   if (bin < 0)
     return -999.;
 
-  return fModels.at(bin - 1).GetModel()->Predict(&features[0], fNVariables, fRaw);
+  double score{0.};
+  if (!fModels.at(bin - 1).GetModel()->Predict(fFeatures.data(), fNVariables, score, fRaw)) {
+    AliFatal("Error in prediction! Exit");
+  }
+  return score;
 }
 
 //_______________________________________________________________________________
-double AliMLResponse::Predict(double binvar, vector<double> variables) {
+double AliMLResponse::Predict(double binvar, const vector<double> &variables) {
   if ((int)variables.size() != fNVariables) {
     AliFatal(Form("Number of variables passed (%d) different from the one used in the model (%d)! Exit",
                   (int)variables.size(), fNVariables));
@@ -182,17 +203,78 @@ double AliMLResponse::Predict(double binvar, vector<double> variables) {
   if (bin < 0)
     return -999.;
 
-  return fModels.at(bin - 1).GetModel()->Predict(&variables[0], fNVariables, fRaw);
+  double score{0.};
+  if (!fModels.at(bin - 1).GetModel()->Predict(variables.data(), fNVariables, score, fRaw)) {
+    AliFatal("Error in prediction! Exit");
+  }
+  return score;
 }
 
 //_______________________________________________________________________________
-bool AliMLResponse::IsSelected(double binvar, std::map<std::string, double> varmap) {
+bool AliMLResponse::IsSelected(double binvar, const std::map<std::string, double> &varmap) {
   double score{0.};
   return IsSelected(binvar, varmap, score);
 }
 
 //_______________________________________________________________________________
-bool AliMLResponse::IsSelected(double binvar, std::vector<double> variables) {
+bool AliMLResponse::IsSelected(double binvar, const std::vector<double> &variables) {
   double score{0.};
   return IsSelected(binvar, variables, score);
-}
\ No newline at end of file
+}
+
+//_______________________________________________________________________________
+void AliMLResponse::PredictBatch(const float *features, const int *bins, size_t nCandidates, float *scores) {
+  /// group the rows per model, keeping their original order
+  const size_t nModels = fModels.size();
+  if (fBatchRows.size() != nModels)
+    fBatchRows.resize(nModels);
+  for (auto &rows : fBatchRows)
+    rows.clear();
+
+  for (size_t iCand = 0; iCand < nCandidates; ++iCand) {
+    if (bins[iCand] < 1 || bins[iCand] > (int)nModels) {
+      scores[iCand] = -999.f;
+      continue;
+    }
+    fBatchRows[bins[iCand] - 1].push_back(iCand);
+  }
+
+  for (size_t iModel = 0; iModel < nModels; ++iModel) {
+    const vector<size_t> &rows = fBatchRows[iModel];
+    if (rows.empty())
+      continue;
+    const size_t nRows = rows.size();
+
+    /// rows of a single bin are often already contiguous (e.g. candidates sorted in pT): no copy needed
+    if (rows.back() - rows.front() + 1 == nRows) {
+      if (!fModels[iModel].GetModel()->PredictBatch(features + rows.front() * fNVariables, nRows, fNVariables,
+                                                     scores + rows.front(), fRaw)) {
+        AliFatal("Error in batch prediction! Exit");
+      }
+      continue;
+    }
+
+    fBatchFeatures.resize(nRows * fNVariables);
+    fBatchScores.resize(nRows);
+    for (size_t iRow = 0; iRow < nRows; ++iRow) {
+      std::copy(features + rows[iRow] * fNVariables, features + (rows[iRow] + 1) * fNVariables,
+                fBatchFeatures.begin() + iRow * fNVariables);
+    }
+    if (!fModels[iModel].GetModel()->PredictBatch(fBatchFeatures.data(), nRows, fNVariables, fBatchScores.data(),
+                                                   fRaw)) {
+      AliFatal("Error in batch prediction! Exit");
+    }
+    for (size_t iRow = 0; iRow < nRows; ++iRow)
+      scores[rows[iRow]] = fBatchScores[iRow];
+  }
+}
+
+//_______________________________________________________________________________
+void AliMLResponse::IsSelectedBatch(const float *features, const int *bins, size_t nCandidates, float *scores,
+                                    bool *selected) {
+  PredictBatch(features, bins, nCandidates, scores);
+  for (size_t iCand = 0; iCand < nCandidates; ++iCand) {
+    selected[iCand] = bins[iCand] >= 1 && bins[iCand] <= (int)fModels.size() &&
+                      scores[iCand] >= fModels[bins[iCand] - 1].GetScoreCut();
+  }
+}
@@ -38,6 +38,10 @@ public:
 
   /// method to set yaml config file
   void SetConfigFilePath(const std::string configfilepath) { fConfigFilePath = configfilepath; }
+  /// directory of the compiled models, overrides CACHE_DIR of the config file
+  void SetCacheDirectory(const std::string dir) { fCacheDirectory = dir; }
+  /// AliExternalBDT::EPredictionMode of the models, overrides PREDICTION_MODE of the config file
+  void SetPredictionMode(int mode) { fPredictionMode = mode; }
   /// method to for importing the config file
   std::string ImportConfigFile() { return AliMLModelHandler::ImportFile(fConfigFilePath); }
   /// method to check whether the config file is formally correct
@@ -49,20 +53,28 @@ public:
   /// return the bin index
   int FindBin(double binvar);
   /// return the ML model predicted score (raw or proba, depending on useraw)
-  double Predict(double binvar, std::map<std::string, double> varmap);
+  double Predict(double binvar, const std::map<std::string, double> &varmap);
   /// overload to pass directly a vector of variables
-  double Predict(double binvar, std::vector<double> variables);
+  double Predict(double binvar, const std::vector<double> &variables);
   /// return true if predicted score for map is above the threshold given in the config
-  bool IsSelected(double binvar, std::map<std::string, double> varmap);
+  bool IsSelected(double binvar, const std::map<std::string, double> &varmap);
   /// overload for getting the model score too
-  template <typename F> bool IsSelected(double binvar, std::map<std::string, double> varmap, F &score);
+  template <typename F> bool IsSelected(double binvar, const std::map<std::string, double> &varmap, F &score);
   /// overload to pass directly a vector of variables
-  bool IsSelected(double binvar, std::vector<double> variables);
+  bool IsSelected(double binvar, const std::vector<double> &variables);
   /// overload for getting the model score too
-  template <typename F> bool IsSelected(double binvar, std::vector<double> variables, F &score);
+  template <typename F> bool IsSelected(double binvar, const std::vector<double> &variables, F &score);
+
+  /// batch interface: features is a row-major nCandidates x NUM_VAR matrix and bins holds the
+  /// FindBin() result of each row. Candidates are grouped per model and each model is called once.
+  void PredictBatch(const float *features, const int *bins, size_t nCandidates, float *scores);
+  /// batch selection, scores and selection flags are filled for each candidate
+  void IsSelectedBatch(const float *features, const int *bins, size_t nCandidates, float *scores, bool *selected);
 
 protected:
   std::string fConfigFilePath;    /// path of the config file
+  std::string fCacheDirectory;    /// directory of the compiled models (from config file if empty)
+  int fPredictionMode;            /// prediction mode of the models (from config file if negative)
 
   std::vector<AliMLModelHandler> fModels;     //!<! vector of models
   std::vector<int> fCentClasses;              /// centrality classes ([cent_min, cent_max])
@@ -76,12 +88,17 @@ protected:
 
   bool fRaw;    /// set to true to use raw score instead of probability
 
+  std::vector<double> fFeatures;                   //!<! scratch features for the map-based prediction
+  std::vector<std::vector<size_t>> fBatchRows;     //!<! scratch row indices per model for the batch prediction
+  std::vector<float> fBatchFeatures;               //!<! scratch gathered features for the batch prediction
+  std::vector<float> fBatchScores;                 //!<! scratch scores for the batch prediction
+
   /// \cond CLASSIMP
-  ClassDef(AliMLResponse, 2);    ///
+  ClassDef(AliMLResponse, 3);    ///
   /// \endcond
 };
 
-template <typename F> bool AliMLResponse::IsSelected(double binvar, std::map<std::string, double> varmap, F &score) {
+template <typename F> bool AliMLResponse::IsSelected(double binvar, const std::map<std::string, double> &varmap, F &score) {
   int bin = FindBin(binvar);
   if (bin < 0)
     return false;
@@ -89,7 +106,7 @@ template <typename F> bool AliMLResponse::IsSelected(double binvar, std::map<std
   return score >= fModels.at(bin - 1).GetScoreCut();
 }
 
-template <typename F> bool AliMLResponse::IsSelected(double binvar, std::vector<double> variables, F &score) {
+template <typename F> bool AliMLResponse::IsSelected(double binvar, const std::vector<double> &variables, F &score) {
   int bin = FindBin(binvar);
   if (bin < 0)
     return false;
@@ -20,18 +20,239 @@
 #include "TBrowser.h"
 #include "TFormula.h"
 #include "RVersion.h"
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+    //Recursive-descent compiler for estimator definitions, in which the
+    //variables have already been replaced by [i]. Operators follow C++
+    //precedence and types, as the definitions are evaluated as C++ by
+    //TFormula: anything that could behave differently (integer division,
+    //possible integer overflow, unknown functions...) makes it fail, and
+    //the estimator then keeps using the TFormula.
+    class AliMultEstimatorCompiler {
+    public:
+        AliMultEstimatorCompiler(const char* lExpr, Long_t lNVars,
+                                 std::vector<Int_t>& lCode, std::vector<Double_t>& lCodeArg) :
+        fPos(lExpr), fNVars(lNVars), fOK(kTRUE), fDepth(0), fCode(lCode), fCodeArg(lCodeArg) {}
+        
+        Bool_t Run() {
+            fCode.clear();
+            fCodeArg.clear();
+            ParseOr();
+            SkipSpaces();
+            if (*fPos != '\0') fOK = kFALSE;
+            if (!fOK) { fCode.clear(); fCodeArg.clear(); }
+            return fOK;
+        }
+        
+    private:
+        //Type of a sub-expression: double, or integral with a bound on its
+        //absolute value (bool results have bound 1)
+        struct Operand {
+            Bool_t   fIntegral;
+            Double_t fBound;
+        };
+        static Operand Dbl() { Operand o; o.fIntegral = kFALSE; o.fBound = 0; return o; }
+        static Operand Int(Double_t lBound) { Operand o; o.fIntegral = kTRUE; o.fBound = lBound; return o; }
+        
+        void SkipSpaces() { while (*fPos == ' ' || *fPos == '\t' || *fPos == '\n' || *fPos == '\r') fPos++; }
+        Bool_t Peek(const char* lTok) { SkipSpaces(); return strncmp(fPos, lTok, strlen(lTok)) == 0; }
+        Bool_t Accept(const char* lTok) {
+            if (!Peek(lTok)) return kFALSE;
+            fPos += strlen(lTok);
+            return kTRUE;
+        }
+        void Emit(Int_t lOp, Double_t lArg = 0) {
+            fCode.push_back(lOp);
+            fCodeArg.push_back(lArg);
+            if (lOp == AliMultEstimator::kOpConst || lOp == AliMultEstimator::kOpVar) fDepth++;
+            else if (lOp >= AliMultEstimator::kOpAdd && lOp <= AliMultEstimator::kOpPow) fDepth--;
+            if (fDepth > AliMultEstimator::kMaxStack) fOK = kFALSE;
+        }
+        //Integer arithmetic is exact in double precision unless it overflows
+        Operand Arithmetic(Int_t lOp, const Operand& a, const Operand& b) {
+            Emit(lOp);
+            if (!a.fIntegral || !b.fIntegral) return Dbl();
+            if (lOp == AliMultEstimator::kOpDiv) { fOK = kFALSE; return Dbl(); }
+            Double_t lBound = (lOp == AliMultEstimator::kOpMul) ? a.fBound*b.fBound : a.fBound+b.fBound;
+            if (lBound > 2147483647.) fOK = kFALSE;
+            return Int(lBound);
+        }
+        
+        Operand ParseOr() {
+            Operand a = ParseAnd();
+            while (fOK && Accept("||")) { ParseAnd(); Emit(AliMultEstimator::kOpOr); a = Int(1); }
+            return a;
+        }
+        Operand ParseAnd() {
+            Operand a = ParseEquality();
+            while (fOK && Accept("&&")) { ParseEquality(); Emit(AliMultEstimator::kOpAnd); a = Int(1); }
+            return a;
+        }
+        Operand ParseEquality() {
+            Operand a = ParseRelational();
+            while (fOK) {
+                Int_t lOp = -1;
+                if (Accept("==")) lOp = AliMultEstimator::kOpEq;
+                else if (Accept("!=")) lOp = AliMultEstimator::kOpNe;
+                else break;
+                ParseRelational();
+                Emit(lOp);
+                a = Int(1);
+            }
+            return a;
+        }
+        Operand ParseRelational() {
+            Operand a = ParseAdditive();
+            while (fOK) {
+                Int_t lOp = -1;
+                if (Accept("<=")) lOp = AliMultEstimator::kOpLe;
+                else if (Accept(">=")) lOp = AliMultEstimator::kOpGe;
+                else if (Peek("<<") || Peek(">>")) { fOK = kFALSE; break; }
+                else if (Accept("<")) lOp = AliMultEstimator::kOpLt;
+                else if (Accept(">")) lOp = AliMultEstimator::kOpGt;
+                else break;
+                ParseAdditive();
+                Emit(lOp);
+                a = Int(1);
+            }
+            return a;
+        }
+        Operand ParseAdditive() {
+            Operand a = ParseMultiplicative();
+            while (fOK) {
+                Int_t lOp = -1;
+                if (Peek("++") || Peek("--")) { fOK = kFALSE; break; }
+                if (Accept("+")) lOp = AliMultEstimator::kOpAdd;
+                else if (Accept("-")) lOp = AliMultEstimator::kOpSub;
+                else break;
+                Operand b = ParseMultiplicative();
+                a = Arithmetic(lOp, a, b);
+            }
+            return a;
+        }
+        Operand ParseMultiplicative() {
+            Operand a = ParseUnary();
+            while (fOK) {
+                Int_t lOp = -1;
+                if (Accept("*")) lOp = AliMultEstimator::kOpMul;
+                else if (Accept("/")) lOp = AliMultEstimator::kOpDiv;
+                else break;
+                Operand b = ParseUnary();
+                a = Arithmetic(lOp, a, b);
+            }
+            return a;
+        }
+        Operand ParseUnary() {
+            if (Peek("++") || Peek("--")) { fOK = kFALSE; return Dbl(); }
+            if (Accept("-")) {
+                Operand a = ParseUnary();
+                Emit(AliMultEstimator::kOpNeg);
+                return a;
+            }
+            if (Accept("+")) return ParseUnary();
+            if (Peek("!=")) { fOK = kFALSE; return Dbl(); }
+            if (Accept("!")) {
+                ParseUnary();
+                Emit(AliMultEstimator::kOpNot);
+                return Int(1);
+            }
+            return ParsePrimary();
+        }
+        Operand ParsePrimary() {
+            SkipSpaces();
+            if (!fOK) return Dbl();
+            //Parenthesis
+            if (Accept("(")) {
+                Operand a = ParseOr();
+                if (!Accept(")")) fOK = kFALSE;
+                return a;
+            }
+            //Variable
+            if (Accept("[")) {
+                char* lEnd = 0;
+                Long_t lIdx = strtol(fPos, &lEnd, 10);
+                if (lEnd == fPos || lIdx < 0 || lIdx >= fNVars) { fOK = kFALSE; return Dbl(); }
+                fPos = lEnd;
+                if (!Accept("]")) { fOK = kFALSE; return Dbl(); }
+                Emit(AliMultEstimator::kOpVar, lIdx);
+                return Dbl();
+            }
+            //Number
+            if ((*fPos >= '0' && *fPos <= '9') || *fPos == '.') {
+                const char* lStart = fPos;
+                Bool_t lIntegral = kTRUE;
+                while ((*fPos >= '0' && *fPos <= '9')) fPos++;
+                if (*fPos == 'x' || *fPos == 'X') { fOK = kFALSE; return Dbl(); } //hexadecimal
+                if (*fPos == '.') { lIntegral = kFALSE; fPos++; while (*fPos >= '0' && *fPos <= '9') fPos++; }
+                if (*fPos == 'e' || *fPos == 'E') {
+                    lIntegral = kFALSE;
+                    fPos++;
+                    if (*fPos == '+' || *fPos == '-') fPos++;
+                    if (!(*fPos >= '0' && *fPos <= '9')) { fOK = kFALSE; return Dbl(); }
+                    while (*fPos >= '0' && *fPos <= '9') fPos++;
+                }
+                //No suffixes (f, L, u...) or octal literals
+                if (isalnum(*fPos) || *fPos == '_' || *fPos == '.') { fOK = kFALSE; return Dbl(); }
+                if (lIntegral && fPos - lStart > 1 && *lStart == '0') { fOK = kFALSE; return Dbl(); }
+                Double_t lVal = strtod(TString(lStart, fPos - lStart).Data(), 0);
+                if (lIntegral && lVal > 2147483647.) { fOK = kFALSE; return Dbl(); }
+                Emit(AliMultEstimator::kOpConst, lVal);
+                return lIntegral ? Int(lVal) : Dbl();
+            }
+            //Function call
+            static const struct { const char* fName; Int_t fOp; Int_t fNArgs; } lFunctions[] = {
+                {"TMath::Power", AliMultEstimator::kOpPow,   2}, {"pow",   AliMultEstimator::kOpPow,   2},
+                {"TMath::Abs",   AliMultEstimator::kOpAbs,   1}, {"fabs",  AliMultEstimator::kOpAbs,   1},
+                {"TMath::Sqrt",  AliMultEstimator::kOpSqrt,  1}, {"sqrt",  AliMultEstimator::kOpSqrt,  1},
+                {"TMath::Exp",   AliMultEstimator::kOpExp,   1}, {"exp",   AliMultEstimator::kOpExp,   1},
+                {"TMath::Log10", AliMultEstimator::kOpLog10, 1}, {"log10", AliMultEstimator::kOpLog10, 1},
+                {"TMath::Log",   AliMultEstimator::kOpLog,   1}, {"log",   AliMultEstimator::kOpLog,   1}
+            };
+            const char* lStart = fPos;
+            while (isalnum(*fPos) || *fPos == '_' || *fPos == ':') fPos++;
+            const TString lName(lStart, fPos - lStart);
+            for (UInt_t iF = 0; iF < sizeof(lFunctions)/sizeof(lFunctions[0]); iF++) {
+                if (lName != lFunctions[iF].fName) continue;
+                if (!Accept("(")) break;
+                Bool_t lAllIntegral = kTRUE;
+                for (Int_t iArg = 0; iArg < lFunctions[iF].fNArgs; iArg++) {
+                    if (iArg > 0 && !Accept(",")) { fOK = kFALSE; return Dbl(); }
+                    if (!ParseOr().fIntegral) lAllIntegral = kFALSE;
+                }
+                if (!Accept(")")) { fOK = kFALSE; return Dbl(); }
+                //integer overloads may be chosen, stay with TFormula
+                if (lAllIntegral) fOK = kFALSE;
+                Emit(lFunctions[iF].fOp);
+                return Dbl();
+            }
+            fOK = kFALSE;
+            return Dbl();
+        }
+        
+        const char* fPos;
+        Long_t fNVars;
+        Bool_t fOK;
+        Int_t  fDepth;
+        std::vector<Int_t>&    fCode;
+        std::vector<Double_t>& fCodeArg;
+    };
+}
 
 ClassImp(AliMultEstimator);
 //________________________________________________________________
 AliMultEstimator::AliMultEstimator() :
-  TNamed(), fDefinition(""), fIsInteger(kFALSE), fValue(0), fMean(0), fPercentile(0), fFormula(0),
+  TNamed(), fDefinition(""), fIsInteger(kFALSE), fValue(0), fMean(0), fPercentile(0), fFormula(0), fCode(), fCodeArg(),
 fkUseAnchor(kFALSE), fAnchorPoint(0), fAnchorPercentile(100.0)
 {
   // Constructor
   
 }
 AliMultEstimator::AliMultEstimator(const char * name, const char * title, TString lInitDef):
-TNamed(name,title), fDefinition(""), fIsInteger(kFALSE), fValue(0), fMean(0), fPercentile(0), fFormula(0),
+TNamed(name,title), fDefinition(""), fIsInteger(kFALSE), fValue(0), fMean(0), fPercentile(0), fFormula(0), fCode(), fCodeArg(),
 fkUseAnchor(kFALSE), fAnchorPoint(0), fAnchorPercentile(100.0)
 {
     //Named, titled, definition constructor
@@ -46,6 +267,8 @@ fValue(e.fValue),
 fMean(e.fMean),
 fPercentile(e.fPercentile),
 fFormula(0),
+fCode(e.fCode),
+fCodeArg(e.fCodeArg),
 fkUseAnchor(e.fkUseAnchor),
 fAnchorPoint(e.fAnchorPoint),
 fAnchorPercentile(e.fAnchorPercentile)
@@ -67,6 +290,8 @@ AliMultEstimator& AliMultEstimator::operator=(const AliMultEstimator& e)
     if (fFormula) delete fFormula;
     fFormula = 0;
     if (e.fFormula) fFormula = new TFormula(*e.fFormula);
+    fCode        = e.fCode;
+    fCodeArg     = e.fCodeArg;
     
     //Anchor point configs
     fkUseAnchor         = e.fkUseAnchor;
@@ -121,13 +346,70 @@ void AliMultEstimator::SetupFormula(const AliMultInput* lInput)
         lVarName.Prepend("(");
         expr.ReplaceAll(lVarName, repl);
     }
+    if (fFormula) delete fFormula;
     fFormula = new TFormula(Form("e%s", GetName()), expr);
 #if ROOT_VERSION_CODE < ROOT_VERSION(5,99,4)
     fFormula->Optimize();
 #endif
+    if (!Compile(expr, nVar))
+        Printf("Estimator %s: definition \"%s\" not compiled, will be evaluated with TFormula", GetName(), fDefinition.Data());
+}
+//________________________________________________________________
+Bool_t AliMultEstimator::Compile(const TString& lExpression, Long_t lNVars)
+{
+    //Compile definition (with variables as [i]) into fCode/fCodeArg
+    AliMultEstimatorCompiler lCompiler(lExpression.Data(), lNVars, fCode, fCodeArg);
+    return lCompiler.Run();
 }
 //________________________________________________________________
 Float_t AliMultEstimator::Evaluate(const AliMultInput* lInput)
+{
+    if (IsCompiled()) return EvaluateCompiled(lInput->GetValues());
+    return EvaluateFormula(lInput);
+}
+//________________________________________________________________
+Float_t AliMultEstimator::EvaluateCompiled(const Double_t* lValues)
+{
+    //Stack machine for the compiled definition
+    Double_t lStack[kMaxStack];
+    Int_t lTop = -1;
+    const Int_t lN = fCode.size();
+    for (Int_t i = 0; i < lN; i++) {
+        switch (fCode[i]) {
+            case kOpConst: lStack[++lTop] = fCodeArg[i]; break;
+            case kOpVar:   lStack[++lTop] = lValues[(Int_t) fCodeArg[i]]; break;
+            case kOpNeg:   lStack[lTop] = -lStack[lTop]; break;
+            case kOpNot:   lStack[lTop] = !lStack[lTop]; break;
+            case kOpAbs:   lStack[lTop] = std::fabs (lStack[lTop]); break;
+            case kOpSqrt:  lStack[lTop] = std::sqrt (lStack[lTop]); break;
+            case kOpExp:   lStack[lTop] = std::exp  (lStack[lTop]); break;
+            case kOpLog:   lStack[lTop] = std::log  (lStack[lTop]); break;
+            case kOpLog10: lStack[lTop] = std::log10(lStack[lTop]); break;
+            default: {
+                const Double_t b = lStack[lTop--];
+                Double_t& a = lStack[lTop];
+                switch (fCode[i]) {
+                    case kOpAdd: a = a + b; break;
+                    case kOpSub: a = a - b; break;
+                    case kOpMul: a = a * b; break;
+                    case kOpDiv: a = a / b; break;
+                    case kOpLt:  a = a <  b; break;
+                    case kOpGt:  a = a >  b; break;
+                    case kOpLe:  a = a <= b; break;
+                    case kOpGe:  a = a >= b; break;
+                    case kOpEq:  a = a == b; break;
+                    case kOpNe:  a = a != b; break;
+                    case kOpAnd: a = a && b; break;
+                    case kOpOr:  a = a || b; break;
+                    case kOpPow: a = std::pow(a, b); break;
+                }
+            }
+        }
+    }
+    return fValue = lStack[0];
+}
+//________________________________________________________________
+Float_t AliMultEstimator::EvaluateFormula(const AliMultInput* lInput)
 {
     if (!fFormula) return fValue = 0;
     for (Int_t i = 0; i < lInput->GetNVariables(); i++) {
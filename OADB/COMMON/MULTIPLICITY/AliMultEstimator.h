@@ -1,6 +1,7 @@
 #ifndef AliMultEstimator_H
 #define AliMultEstimator_H
 #include <TNamed.h>
+#include <vector>
 class AliMultInput;
 class TFormula;
 
@@ -44,7 +45,28 @@ public:
     void SetupFormula(const AliMultInput* lInput);
     Float_t Evaluate(const AliMultInput* lInput);
     
+    //The definition is also compiled into a short postfix program by
+    //SetupFormula. Definitions using anything beyond arithmetic, comparison
+    //and logical operators, Power, Abs, Sqrt, Exp, Log and Log10 are not
+    //compiled and are always evaluated through the TFormula
+    Bool_t  IsCompiled() const { return !fCode.empty(); }
+    //Evaluate compiled program, lValues as given by AliMultInput::GetValues
+    Float_t EvaluateCompiled(const Double_t* lValues);
+    //Evaluate through the TFormula (reference)
+    Float_t EvaluateFormula(const AliMultInput* lInput);
+    
+    //Instruction set of the compiled definitions
+    enum EOpCode {
+        kOpConst = 0, kOpVar, kOpNeg, kOpNot,
+        kOpAdd, kOpSub, kOpMul, kOpDiv,
+        kOpLt, kOpGt, kOpLe, kOpGe, kOpEq, kOpNe, kOpAnd, kOpOr,
+        kOpPow, kOpAbs, kOpSqrt, kOpExp, kOpLog, kOpLog10
+    };
+    static const Int_t kMaxStack = 64; //max. depth of the evaluation stack
+    
 private:
+    Bool_t Compile(const TString& lExpression, Long_t lNVars);
+    
     TString fDefinition; //How to evaluate based on AliMultVariables
     Bool_t fIsInteger; //Requires special treatment when calibrating
     
@@ -52,12 +74,15 @@ private:
     Float_t fMean;   // estimator mean value
     Float_t fPercentile;   //Percentile
     TFormula* fFormula; //!
+    std::vector<Int_t>    fCode;    //! compiled definition: opcodes
+    std::vector<Double_t> fCodeArg; //! compiled definition: constant or variable index
     
     //Anchor point definition
     Bool_t  fkUseAnchor;        //Use Anchor Logic (default: No)
     Float_t fAnchorPoint;       //Raw value below which
     Float_t fAnchorPercentile;  //Percentile of X-section at anchor point
     
-    ClassDef(AliMultEstimator, 1)
+    ClassDef(AliMultEstimator, 2)
+    // 2 - transient compiled definition
 };
 #endif
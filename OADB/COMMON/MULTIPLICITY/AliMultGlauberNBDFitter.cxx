@@ -20,13 +20,39 @@
 #include "TF1.h"
 #include "TStopwatch.h"
 #include "TVirtualFitter.h"
+#include "Math/Factory.h"
+#include "Math/IFunction.h"
+#include "Math/Minimizer.h"
+#include "Math/MinimizerOptions.h"
+#include "Math/PdfFuncMathCore.h"
 
 ClassImp(AliMultGlauberNBDFitter);
 
+namespace {
+  //Objective with gradient as seen by the minimizer
+  class AliMultGlauberNBDObjective : public ROOT::Math::IMultiGradFunction {
+  public:
+    AliMultGlauberNBDObjective(AliMultGlauberNBDFitter *lFitter) : fFitter(lFitter) {}
+    ROOT::Math::IMultiGenFunction* Clone() const { return new AliMultGlauberNBDObjective(fFitter); }
+    unsigned int NDim() const { return 4; }
+    void Gradient(const double *x, double *grad) const { fFitter->EvaluateObjective(x, grad); }
+    void FdF(const double *x, double &f, double *grad) const { f = fFitter->EvaluateObjective(x, grad); }
+  private:
+    double DoEval(const double *x) const { return fFitter->EvaluateObjective(x); }
+    double DoDerivative(const double *x, unsigned int icoord) const {
+      double grad[4];
+      fFitter->EvaluateObjective(x, grad);
+      return grad[icoord];
+    }
+    AliMultGlauberNBDFitter *fFitter;
+  };
+}
+
 AliMultGlauberNBDFitter::AliMultGlauberNBDFitter() : TNamed(), 
 fNBD(0x0),
 fhNanc(0x0),
 fhNpNc(0x0),
+fhV0M(0x0),
 ffChanged(kTRUE),
 fCurrentf(-1),
 fNpart(0x0),
@@ -38,7 +64,18 @@ fMu(45),
 fk(1.5),
 ff(0.8),
 fnorm(100),
-fFitOptions("R0")
+fFitOptions("R0"),
+fUseFastFit(kTRUE),
+fAncestors(kNAncestorBins, 0.),
+fAncestorsFilled(kFALSE),
+fFitLikelihood(kFALSE),
+fFitX(),
+fFitY(),
+fFitErr(),
+fFitLnGammaX1(),
+fModel(),
+fModelDMu(),
+fModelDk()
 {
   // Constructor
   fNpart = new Double_t[fMaxNpNcPairs];
@@ -64,6 +101,7 @@ AliMultGlauberNBDFitter::AliMultGlauberNBDFitter(const char * name, const char *
 fNBD(0x0),
 fhNanc(0x0),
 fhNpNc(0x0),
+fhV0M(0x0),
 ffChanged(kTRUE),
 fCurrentf(-1),
 fNpart(0x0),
@@ -75,7 +113,18 @@ fMu(45),
 fk(1.5),
 ff(0.8),
 fnorm(100),
-fFitOptions("R0")
+fFitOptions("R0"),
+fUseFastFit(kTRUE),
+fAncestors(kNAncestorBins, 0.),
+fAncestorsFilled(kFALSE),
+fFitLikelihood(kFALSE),
+fFitX(),
+fFitY(),
+fFitErr(),
+fFitLnGammaX1(),
+fModel(),
+fModelDMu(),
+fModelDk()
 {
   //Named constructor
   fNpart = new Double_t[fMaxNpNcPairs];
@@ -122,38 +171,202 @@ Double_t AliMultGlauberNBDFitter::ProbDistrib(Double_t *x, Double_t *par)
 {
   Double_t lMultValue = TMath::Floor(x[0]+0.5);
   Double_t lProbability = 0.0;
-  ffChanged = kTRUE;
-
-  //Comment this line in order to make the code evaluate Nancestor all the time
-  if ( TMath::Abs( fCurrentf - par[2] ) < kAlmost0 ) ffChanged = kFALSE ;
+  if ( lMultValue < 0 ) return 0.0;
   
-  //______________________________________________________
   //Recalculate the ancestor distribution in case f changed
-  if( ffChanged ){
-    fCurrentf = par[2];
-    fhNanc->Reset();
-    
-    for(int ibin=0;ibin<fNNpNcPairs;ibin++){
-      //Atentar-se à normalização de Nanc
-      fhNanc->Fill(TMath::Floor(fNpart[ibin]*par[2] + fNcoll[ibin]*(1-par[2]) + 0.5),fContent[ibin]);
-    }
-    fhNanc->Scale(1./fhNanc->Integral());
-  }
+  UpdateAncestors(par[2]);
+  
   //______________________________________________________
   //Actually ealuate function
-  for(Long_t iNanc = 1; iNanc<900; iNanc++){
+  for(Long_t iNanc = 1; iNanc<kMaxAncestors; iNanc++){
+    if( fAncestors[iNanc] == 0 ) continue;
     Double_t lThisMu = ((Double_t)iNanc)*par[0];
     Double_t lThisk = ((Double_t)iNanc)*par[1];
     Double_t lpval = TMath::Power(1+lThisMu/lThisk,-1);
-    fNBD->SetParameter(1,lThisk);
-    fNBD->SetParameter(0,lpval);
-    Double_t lMult = fNBD->Eval(lMultValue);
-    lProbability += fhNanc->GetBinContent(fhNanc->FindBin(iNanc))*lMult;
+    Double_t lMult = ROOT::Math::negative_binomial_pdf((UInt_t)lMultValue,lpval,lThisk);
+    lProbability += fAncestors[iNanc]*lMult;
   }
   //______________________________________________________
   return par[3]*lProbability;
 }
 
+//______________________________________________________
+void AliMultGlauberNBDFitter::UpdateAncestors(Double_t lf)
+{
+  //fCurrentf and fhNanc are streamed, fAncestors is not: after reading the
+  //fitter back, start from the stored distribution of fCurrentf
+  if( !fAncestorsFilled ){
+    for(Int_t iBin=0; iBin<kNAncestorBins; iBin++) fAncestors[iBin] = fhNanc ? fhNanc->GetBinContent(iBin+1) : 0;
+    fAncestorsFilled = kTRUE;
+  }
+  //Comment this line in order to make the code evaluate Nancestor all the time
+  ffChanged = kTRUE;
+  if ( TMath::Abs( fCurrentf - lf ) < kAlmost0 ) ffChanged = kFALSE ;
+  if( !ffChanged ) return;
+  
+  fCurrentf = lf;
+  ComputeAncestors(lf, fAncestors.data());
+  //keep histogram for inspection
+  for(Int_t iBin=0; iBin<kNAncestorBins; iBin++) fhNanc->SetBinContent(iBin+1, fAncestors[iBin]);
+}
+
+//______________________________________________________
+void AliMultGlauberNBDFitter::ComputeAncestors(Double_t lf, Double_t *lAnc) const
+{
+  //Normalized number of ancestors, same binning as fhNanc (values outside
+  //its range are not counted, as for under/overflow)
+  Double_t lIntegral = 0;
+  for(Int_t iBin=0; iBin<kNAncestorBins; iBin++) lAnc[iBin] = 0;
+  for(Long_t ibin=0;ibin<fNNpNcPairs;ibin++){
+    //Atentar-se à normalização de Nanc
+    Double_t lNanc = TMath::Floor(fNpart[ibin]*lf + fNcoll[ibin]*(1-lf) + 0.5);
+    if( lNanc < 0 || lNanc >= kNAncestorBins ) continue;
+    lAnc[(Int_t)lNanc] += fContent[ibin];
+    lIntegral += fContent[ibin];
+  }
+  if( lIntegral <= 0 ) return;
+  for(Int_t iBin=0; iBin<kNAncestorBins; iBin++) lAnc[iBin] *= 1./lIntegral;
+}
+
+//______________________________________________________
+void AliMultGlauberNBDFitter::EvaluateModel(const Double_t *par, const Double_t *lAnc, Bool_t lGrad)
+{
+  //Glauber+NBD model for all fit bins at once. For a given number of
+  //ancestors n, the NBD is followed from one multiplicity value to the next
+  //with the recurrence log P(x+1) = log P(x) + log(x+nk) - log(x+1) + log(1-p)
+  //(the lgamma(x+1) terms are cached per bin), re-anchored with lgamma
+  //after jumps and periodically to avoid accumulation of rounding errors.
+  //p = 1/(1+mu/k) does not depend on n.
+  const Int_t lNBins = fFitX.size();
+  const Double_t lMu = par[0];
+  const Double_t lk  = par[1];
+  const Double_t lp  = 1./(1.+lMu/lk);
+  const Double_t lLogP   = TMath::Log(lp);
+  const Double_t lLog1mP = TMath::Log(1.-lp);
+  const Int_t kMaxSteps  = 8;   //longer jumps: re-anchor
+  const Int_t kReanchor  = 256; //steps between re-anchoring
+  
+  fModel.assign(lNBins, 0.);
+  if( lGrad ){
+    fModelDMu.assign(lNBins, 0.);
+    fModelDk.assign(lNBins, 0.);
+  }
+  for(Int_t iNanc = 1; iNanc<kMaxAncestors; iNanc++){
+    const Double_t lA = lAnc[iNanc];
+    if( lA == 0 ) continue;
+    const Double_t ln       = iNanc*lk;
+    const Double_t lLnGamN  = TMath::LnGamma(ln);
+    const Double_t lDiGamN  = lGrad ? TMath::DiGamma(ln) : 0;
+    const Double_t lConst   = ln*lLogP - lLnGamN;
+    Double_t lLnGam = 0, lDiGam = 0, lLastX = -1;
+    Int_t lNSteps = 0;
+    for(Int_t iBin = 0; iBin<lNBins; iBin++){
+      const Double_t lx = fFitX[iBin];
+      if( lLastX < 0 || lx-lLastX > kMaxSteps || lNSteps > kReanchor ){
+        lLnGam = TMath::LnGamma(lx+ln);
+        if( lGrad ) lDiGam = TMath::DiGamma(lx+ln);
+        lNSteps = 0;
+      }else{
+        for(Double_t lt = lLastX; lt < lx; lt += 1.){
+          lLnGam += TMath::Log(lt+ln);
+          if( lGrad ) lDiGam += 1./(lt+ln);
+          lNSteps++;
+        }
+      }
+      lLastX = lx;
+      const Double_t lProb = lA*TMath::Exp(lLnGam - fFitLnGammaX1[iBin] + lConst + lx*lLog1mP);
+      fModel[iBin] += lProb;
+      if( lGrad && lProb > 0 ){
+        //d log P/d mu and d log P/d k
+        fModelDMu[iBin] += lProb*( lx/lMu - (ln+lx)/(lk+lMu) );
+        fModelDk [iBin] += lProb*( iNanc*(lDiGam - lDiGamN + lLogP + 1.) - (ln+lx)/(lk+lMu) );
+      }
+    }
+  }
+}
+
+//______________________________________________________
+Bool_t AliMultGlauberNBDFitter::PrepareFitData()
+{
+  //Bins of the input histogram to be used by EvaluateObjective
+  if( !fhV0M ) return kFALSE;
+  TString lOpt = fFitOptions;
+  lOpt.ToUpper();
+  fFitLikelihood = lOpt.Contains("L");
+  Double_t lMin = -1e+30, lMax = 1e+30;
+  if( lOpt.Contains("R") ) fGlauberNBD->GetRange(lMin, lMax);
+  
+  fFitX.clear(); fFitY.clear(); fFitErr.clear(); fFitLnGammaX1.clear();
+  for(Int_t iBin=1; iBin<=fhV0M->GetNbinsX(); iBin++){
+    const Double_t lCenter = fhV0M->GetBinCenter(iBin);
+    if( lCenter < lMin || lCenter > lMax ) continue;
+    const Double_t lx = TMath::Floor(lCenter+0.5);
+    if( lx < 0 ) continue;
+    //as TH1::Fit: empty bins (zero error) do not enter the chi2
+    if( !fFitLikelihood && fhV0M->GetBinError(iBin) <= 0 ) continue;
+    fFitX.push_back( lx );
+    fFitY.push_back( fhV0M->GetBinContent(iBin) );
+    fFitErr.push_back( fhV0M->GetBinError(iBin) );
+    fFitLnGammaX1.push_back( TMath::LnGamma(lx+1.) );
+  }
+  return !fFitX.empty();
+}
+
+//______________________________________________________
+Double_t AliMultGlauberNBDFitter::EvaluateObjective(const Double_t *par, Double_t *lGrad)
+{
+  const Int_t lNBins = fFitX.size();
+  UpdateAncestors(par[2]);
+  EvaluateModel(par, fAncestors.data(), lGrad != 0);
+  
+  //Derivative in f: the ancestor distribution only changes in steps, use
+  //a finite difference over a step that moves a fair number of pairs
+  std::vector<Double_t> lModelDf;
+  if( lGrad ){
+    const Double_t lStep = 1e-3;
+    std::vector<Double_t> lModel(fModel), lModelDMu(fModelDMu), lModelDk(fModelDk);
+    std::vector<Double_t> lAnc(kNAncestorBins);
+    Double_t lParShift[4] = {par[0], par[1], par[2], par[3]};
+    lParShift[2] = par[2]+lStep;
+    ComputeAncestors(lParShift[2], lAnc.data());
+    EvaluateModel(lParShift, lAnc.data(), kFALSE);
+    std::vector<Double_t> lModelUp(fModel);
+    lParShift[2] = par[2]-lStep;
+    ComputeAncestors(lParShift[2], lAnc.data());
+    EvaluateModel(lParShift, lAnc.data(), kFALSE);
+    lModelDf.resize(lNBins);
+    for(Int_t iBin=0; iBin<lNBins; iBin++) lModelDf[iBin] = (lModelUp[iBin]-fModel[iBin])/(2*lStep);
+    fModel.swap(lModel);
+    fModelDMu.swap(lModelDMu);
+    fModelDk.swap(lModelDk);
+    for(Int_t iPar=0; iPar<4; iPar++) lGrad[iPar] = 0;
+  }
+  
+  Double_t lValue = 0;
+  for(Int_t iBin=0; iBin<lNBins; iBin++){
+    const Double_t lPred = par[3]*fModel[iBin];
+    Double_t lDeriv = 0; //d(objective)/d(prediction)
+    if( !fFitLikelihood ){
+      const Double_t lRes = (fFitY[iBin]-lPred)/fFitErr[iBin];
+      lValue += lRes*lRes;
+      lDeriv  = -2.*lRes/fFitErr[iBin];
+    }else{
+      //Baker-Cousins likelihood ratio
+      const Double_t lSafePred = TMath::Max(lPred, 1e-300);
+      lValue += 2.*(lSafePred - fFitY[iBin]);
+      if( fFitY[iBin] > 0 ) lValue += 2.*fFitY[iBin]*TMath::Log(fFitY[iBin]/lSafePred);
+      lDeriv  = 2.*(1. - fFitY[iBin]/lSafePred);
+    }
+    if( lGrad ){
+      lGrad[0] += lDeriv*par[3]*fModelDMu[iBin];
+      lGrad[1] += lDeriv*par[3]*fModelDk[iBin];
+      lGrad[2] += lDeriv*par[3]*lModelDf[iBin];
+      lGrad[3] += lDeriv*fModel[iBin];
+    }
+  }
+  return lValue;
+}
+
 //________________________________________________________________
 Bool_t AliMultGlauberNBDFitter::SetNpartNcollCorrelation(TH2 *hNpNc){
   Bool_t lReturnValue = kTRUE;
@@ -206,8 +419,12 @@ Bool_t AliMultGlauberNBDFitter::DoFit(){
   timer->Start ( kTRUE );
   cout<<"---> Now fitting, please wait..."<<endl;
   
-  fGlauberNBD->SetNpx(100);
-  fhV0M->Fit("fGlauberNBD",fFitOptions.Data());
+  Bool_t lFitted = kFALSE;
+  if( fUseFastFit ) lFitted = DoFastFit();
+  if( !lFitted ){
+    fGlauberNBD->SetNpx(100);
+    fhV0M->Fit("fGlauberNBD",fFitOptions.Data());
+  }
   
   timer->Stop();
   Double_t lTotalTime = timer->RealTime();
@@ -221,6 +438,86 @@ Bool_t AliMultGlauberNBDFitter::DoFit(){
   return kTRUE;
 }
 
+//________________________________________________________________
+Bool_t AliMultGlauberNBDFitter::DoFastFit(){
+  //Minimize EvaluateObjective with analytical gradient. Starting values,
+  //errors and limits are taken from fGlauberNBD, as TH1::Fit would do
+  TString lOpt = fFitOptions;
+  lOpt.ToUpper();
+  Bool_t lSupported = !lOpt.Contains("LL");
+  for(Int_t iChar=0; iChar<lOpt.Length(); iChar++)
+    if( TString("R0QNL+").First(lOpt[iChar]) == kNPOS ) lSupported = kFALSE;
+  if( !lSupported ){
+    cout<<"---> Fit options "<<fFitOptions.Data()<<" not supported by fast fit, using TH1::Fit"<<endl;
+    return kFALSE;
+  }
+  if( !PrepareFitData() ){
+    cout<<"---> No bins to fit!"<<endl;
+    return kFALSE;
+  }
+  
+  ROOT::Math::Minimizer *lMinimizer = ROOT::Math::Factory::CreateMinimizer(ROOT::Math::MinimizerOptions::DefaultMinimizerType(),
+                                                                           ROOT::Math::MinimizerOptions::DefaultMinimizerAlgo());
+  if( !lMinimizer ) return kFALSE;
+  lMinimizer->SetMaxFunctionCalls(5000000);
+  lMinimizer->SetMaxIterations(5000000);
+  lMinimizer->SetPrintLevel( lOpt.Contains("Q") ? -1 : 0 );
+  
+  AliMultGlauberNBDObjective lObjective(this);
+  lMinimizer->SetFunction(lObjective);
+  
+  Int_t lNFree = 0;
+  for(Int_t iPar=0; iPar<4; iPar++){
+    const Double_t lVal = fGlauberNBD->GetParameter(iPar);
+    Double_t lStep = fGlauberNBD->GetParError(iPar);
+    if( lStep <= 0 ) lStep = ( lVal != 0 ) ? 0.1*TMath::Abs(lVal) : 0.1;
+    Double_t lLow = 0, lHigh = 0;
+    fGlauberNBD->GetParLimits(iPar, lLow, lHigh);
+    const char* lName = fGlauberNBD->GetParName(iPar);
+    if( lLow*lHigh != 0 && lLow >= lHigh ){
+      lMinimizer->SetFixedVariable(iPar, lName, lVal);
+      continue;
+    }
+    lNFree++;
+    if( lLow < lHigh ) lMinimizer->SetLimitedVariable(iPar, lName, lVal, lStep, lLow, lHigh);
+    else lMinimizer->SetVariable(iPar, lName, lVal, lStep);
+  }
+  
+  lMinimizer->Minimize();
+  if( !lOpt.Contains("Q") ) lMinimizer->PrintResults();
+  
+  fGlauberNBD->SetParameters(lMinimizer->X());
+  if( lMinimizer->Errors() ) fGlauberNBD->SetParErrors(lMinimizer->Errors());
+  fGlauberNBD->SetChisquare(lMinimizer->MinValue());
+  fGlauberNBD->SetNDF( (Int_t) fFitX.size() - lNFree );
+  delete lMinimizer;
+  
+  //As TH1::Fit: unless N is given, a copy of the fitted function is
+  //attached to the histogram, replacing the previous ones unless + is given
+  if( !lOpt.Contains("N") ){
+    TList *lFunctions = fhV0M->GetListOfFunctions();
+    if( !lOpt.Contains("+") ){
+      TIter lNext(lFunctions, kIterBackward);
+      TObject *lObj = 0x0;
+      while( (lObj = lNext()) ){
+        if( !lObj->InheritsFrom(TF1::Class()) ) continue;
+        lFunctions->Remove(lObj);
+        delete lObj;
+      }
+    }
+    Double_t lMin = fhV0M->GetXaxis()->GetXmin(), lMax = fhV0M->GetXaxis()->GetXmax();
+    if( lOpt.Contains("R") ) fGlauberNBD->GetRange(lMin, lMax);
+    TF1 *lStored = new TF1();
+    fGlauberNBD->Copy(*lStored);
+    lStored->SetParent(fhV0M);
+    //the function is bound to this object: keep its values for drawing after streaming
+    lStored->Save(lMin, lMax, 0, 0, 0, 0);
+    if( lOpt.Contains("0") ) lStored->SetBit(TF1::kNotDraw);
+    lFunctions->Add(lStored);
+  }
+  return kTRUE;
+}
+
 //________________________________________________________________
 Bool_t AliMultGlauberNBDFitter::InitializeNpNc(){
   //This function initializes fhNpNc
@@ -228,6 +525,7 @@ Bool_t AliMultGlauberNBDFitter::InitializeNpNc(){
   Bool_t lReturnValue = kFALSE;
   if(fhNpNc){
     fNNpNcPairs = 0;
+    fCurrentf = -1; //ancestor distribution to be recomputed
     //Sweep all allowed values of Npart, Ncoll; find counters
     for(int xbin=1;xbin<500;xbin++){
       for(int ybin=1;ybin<3000;ybin++){
@@ -6,6 +6,7 @@
 #include "AliVEvent.h"
 //For Run Ranges functionality
 #include <map>
+#include <vector>
 
 using namespace std;
 class AliMultGlauberNBDFitter : public TNamed {
@@ -18,6 +19,16 @@ public:
   
   //Master fitter function
   Double_t ProbDistrib(Double_t *x, Double_t *par);
+  
+  //Whole-histogram objective: chi2 of the model over the fit range (or
+  //Poisson likelihood ratio if the fit options contain "L"), with its
+  //gradient in lGrad if requested. Used by the fast fit, can be handed to
+  //any minimizer. Requires InitializeNpNc() and PrepareFitData()
+  Double_t EvaluateObjective(const Double_t *par, Double_t *lGrad = 0);
+  Bool_t PrepareFitData();
+  
+  //Fit through EvaluateObjective (default) or through TH1::Fit of ProbDistrib
+  void SetUseFastFit ( Bool_t lVal = kTRUE ) { fUseFastFit = lVal; }
 
   //Do Fit: where everything happens 
   Bool_t DoFit();
@@ -53,6 +64,15 @@ public:
   //void    Print(Option_t *option="") const;
   
 private:
+  //Ancestor distribution: binning of fhNanc, ancestors summed in the model
+  static const Int_t kNAncestorBins = 1000;
+  static const Int_t kMaxAncestors  = 900;
+  
+  void UpdateAncestors(Double_t lf);
+  void ComputeAncestors(Double_t lf, Double_t *lAnc) const;
+  void EvaluateModel(const Double_t *par, const Double_t *lAnc, Bool_t lGrad);
+  Bool_t DoFastFit();
+  
   //This function serves as the (analytical) NBD
   TF1 *fNBD;
   
@@ -82,7 +102,23 @@ private:
   Double_t fnorm;
   
   TString fFitOptions; 
-  
-  ClassDef(AliMultGlauberNBDFitter, 1);
+  Bool_t fUseFastFit; //minimize EvaluateObjective instead of TH1::Fit
+  
+  //Normalized ancestor distribution for fCurrentf, index = number of ancestors
+  std::vector<Double_t> fAncestors; //!
+  Bool_t fAncestorsFilled; //! fAncestors set in this process, otherwise taken from fhNanc
+  
+  //Fit data (bins in fit range) and model with derivatives in mu, k
+  Bool_t fFitLikelihood; //!
+  std::vector<Double_t> fFitX;          //! multiplicity value
+  std::vector<Double_t> fFitY;          //! bin content
+  std::vector<Double_t> fFitErr;        //! bin error
+  std::vector<Double_t> fFitLnGammaX1;  //! lgamma(x+1)
+  std::vector<Double_t> fModel;         //!
+  std::vector<Double_t> fModelDMu;      //!
+  std::vector<Double_t> fModelDk;       //!
+  
+  ClassDef(AliMultGlauberNBDFitter, 2);
+  //2 - Whole-histogram objective and fast fit
 };
 #endif
@@ -17,21 +17,21 @@
 ClassImp(AliMultInput);
 
 AliMultInput::AliMultInput() :
-  TNamed(), fNVars(0), fVariableList(0x0)
+  TNamed(), fNVars(0), fVariableList(0x0), fValues()
 {
   // Constructor
     fVariableList = new TList();
 }
 
 AliMultInput::AliMultInput(const char * name, const char * title):
-TNamed(name,title), fNVars(0), fVariableList(0x0)
+TNamed(name,title), fNVars(0), fVariableList(0x0), fValues()
 {
   // Constructor
     fVariableList = new TList();
 }
 
 AliMultInput::AliMultInput(const AliMultInput& o)
-: TNamed(o), fNVars(0), fVariableList(0x0)
+: TNamed(o), fNVars(0), fVariableList(0x0), fValues()
 {
     // Constructor
     fVariableList = new TList();
@@ -92,6 +92,19 @@ AliMultVariable* AliMultInput::GetVariable (Long_t iIdx) const
     return static_cast<AliMultVariable*>(fVariableList->At(iIdx));
 }
 
+const Double_t* AliMultInput::GetValues() const
+{
+    //Single pass over the list (GetVariable(i) walks the list every time)
+    fValues.resize(fNVars);
+    if (!fVariableList) return fValues.data();
+    TIter next(fVariableList);
+    AliMultVariable* v = 0;
+    Long_t i = 0;
+    while ((v = static_cast<AliMultVariable*>(next())))
+        fValues[i++] = v->IsInteger() ? v->GetValueInteger() : v->GetValue();
+    return fValues.data();
+}
+
 void AliMultInput::Clear(Option_t* option)
 {
     TIter next(fVariableList);
@@ -2,6 +2,7 @@
 #define AliMultInput_H
 #include <TNamed.h>
 #include "AliMultVariable.h"
+#include <vector>
 
 class AliMultInput : public TNamed {
     
@@ -16,6 +17,9 @@ public:
     AliMultVariable* GetVariable (const TString& lName) const;
     AliMultVariable* GetVariable (Long_t iIdx) const;
     Long_t GetNVariables         () const { return fNVars; }
+    //Flat array with the current values of all variables, in the order of
+    //GetVariable(i) (integer variables converted). Refreshed at each call
+    const Double_t* GetValues    () const;
     void Clear(Option_t* option="");
     void Set(const AliMultInput* other);
     void Print(Option_t* option="") const;
@@ -23,7 +27,9 @@ public:
 private:
     Long_t fNVars;
     TList *fVariableList; //List containing all AliMultVariables
+    mutable std::vector<Double_t> fValues; //! buffer for GetValues()
     
-    ClassDef(AliMultInput, 1)
+    ClassDef(AliMultInput, 2)
+    // 2 - added transient value buffer for compiled estimators
 };
 #endif
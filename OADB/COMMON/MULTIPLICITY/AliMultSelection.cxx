@@ -239,11 +239,16 @@ void AliMultSelection::Evaluate( AliMultInput *lInput )
 //Master function to evaluate all existing estimators based on
 //a set of input variables. Error handling to be done with care...
 {
+    //Input values are collected once and shared by all compiled estimators
+    const Double_t* lValues = lInput->GetValues();
+    
     //Loop over estimators defined in the acquired list
     AliMultEstimator* estimator = 0;
     TIter             next(fEstimatorList);
-    while ((estimator = static_cast<AliMultEstimator*>(next())))
-        estimator->Evaluate(lInput);
+    while ((estimator = static_cast<AliMultEstimator*>(next()))) {
+        if (estimator->IsCompiled()) estimator->EvaluateCompiled(lValues);
+        else                         estimator->EvaluateFormula(lInput);
+    }
 
 //deprecated evaluation
 #if 0
@@ -28,13 +28,136 @@
 #include "TFile.h"
 #include "TStopwatch.h"
 #include "TArrayL64.h"
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <vector>
 
 ClassImp(AliMultSelectionCalibrator);
 
+namespace {
+    //Calibration information of one estimator in one run, determined from
+    //the values of that estimator for all selected events of the run
+    struct AliMultCalibEstimatorJob {
+        //Input
+        std::vector<Float_t> *fValues; //values, reordered while processing
+        Bool_t   fIsInteger;
+        Bool_t   fUseAnchor;
+        Double_t fAnchorPoint;
+        Double_t fAnchorPercentile;
+        //Output
+        Double_t fAverage;
+        Double_t fMin;
+        Double_t fMax;
+        Long64_t fAccepted;                //events above anchor point
+        std::vector<Double_t> fBoundaries; //raw boundaries (floating point engine)
+        std::vector<Float_t>  fCumulative; //normalized cumulative (integer engine)
+    };
+
+    //Pure array work, no ROOT I/O involved: safe to run concurrently for
+    //different estimators
+    void ProcessEstimator( AliMultCalibEstimatorJob &lJob, const Double_t *lDesiredBoundaries, Long_t lNDesiredBoundaries ){
+        std::vector<Float_t> &lValues = *lJob.fValues;
+        const Long64_t ntot = (Long64_t) lValues.size();
+
+        //Averages and extreme values (useful for integer calibration mode)
+        lJob.fAverage = 0;
+        lJob.fMax = -1e+3;
+        lJob.fMin = 1e+6; //not more than a million, I hope?
+        for( Long64_t iEntry=0; iEntry<ntot; iEntry++) {
+            Float_t lThisVal = lValues[iEntry];
+            lJob.fAverage += lThisVal;
+            if( lThisVal < lJob.fMin ) lJob.fMin = lThisVal;
+            if( lThisVal > lJob.fMax ) lJob.fMax = lThisVal;
+        }
+        if( ntot < 1 ) {
+            lJob.fAverage = -1;
+        } else {
+            lJob.fAverage /= ( (Double_t) ntot );
+        }
+
+        if( lJob.fIsInteger ){
+            //Normalized distribution with unit-width bins centered on the
+            //integer values, same binning as the calibration histogram
+            if( ntot < 1 ) return;
+            const Long_t lNBins = lJob.fMax-lJob.fMin+1;
+            const Double_t lLowEdge  = lJob.fMin-0.5;
+            const Double_t lHighEdge = lJob.fMax+0.5;
+            std::vector<Double_t> lCounts( lNBins+2, 0. );
+            for( Long64_t iEntry=0; iEntry<ntot; iEntry++) {
+                const Double_t lThisVal = lValues[iEntry];
+                Long_t lBin = 0;
+                if( lThisVal >= lHighEdge ) lBin = lNBins+1;
+                else if( lThisVal >= lLowEdge ) lBin = 1 + (Long_t) ( lNBins*(lThisVal-lLowEdge)/(lHighEdge-lLowEdge) );
+                lCounts[lBin] += 1.;
+            }
+            lJob.fCumulative.assign( lNBins+1, 0. );
+            for(Long_t iB=1; iB<lNBins+1; iB++) {
+                const Float_t lContent = lCounts[iB] * ( 1./((Double_t)ntot) );
+                lJob.fCumulative[iB] = lJob.fCumulative[iB-1]+lContent;
+            }
+            return;
+        }
+
+        //==== Floating Point Calibration Engine ====
+        lJob.fAccepted = ntot;
+        if( lJob.fUseAnchor ){
+            //Count fraction of accepted
+            lJob.fAccepted = 0;
+            for( Long64_t iEntry=0; iEntry<ntot; iEntry++) if( lValues[iEntry] > lJob.fAnchorPoint ) lJob.fAccepted++;
+        }
+        lJob.fBoundaries.assign( lNDesiredBoundaries, 0. );
+        lJob.fBoundaries[0] = 0.0; //Defined OK even if anchored
+        //Overwrite lower boundary in case this has a negative minimum...
+        if ( lJob.fMin < 0 ) lJob.fBoundaries[0] = lJob.fMin;
+        if( ntot < 1 ) return;
+
+        //Position of each boundary in the list of values in descending order
+        std::vector<Long64_t> lPositions( lNDesiredBoundaries, 0 );
+        for( Long_t lB=1; lB<lNDesiredBoundaries; lB++) {
+            Long64_t position = (Long64_t) ( 0.01 * ((Double_t)(ntot)* lDesiredBoundaries[lB] ) );
+            if( lJob.fUseAnchor ){
+                //Make sure index position corresponds to lAnchorPercentile
+                Double_t lFractionAccepted = (((Double_t) lJob.fAccepted )/((Double_t) ntot));
+                Double_t lScalingFactor    = lFractionAccepted/((0.01)*lJob.fAnchorPercentile);
+                //Make sure: if AnchorPercentile requested, cut at AnchorPoint
+                position = (Long64_t) ( ( 0.01 * ((Double_t)(ntot)* lDesiredBoundaries[lB] ) ) * lScalingFactor );
+            }
+            if( position > ntot-1 ) position = ntot-1; //protection !
+            lPositions[lB] = position;
+        }
+
+        //Only the requested order statistics are needed: select them one by
+        //one on successively narrower ranges instead of sorting everything
+        std::vector<Long64_t> lSorted( lPositions.begin()+1, lPositions.end() );
+        std::sort( lSorted.begin(), lSorted.end() );
+        lSorted.erase( std::unique( lSorted.begin(), lSorted.end() ), lSorted.end() );
+        Long64_t lFirst = 0;
+        for( size_t iPos=0; iPos<lSorted.size(); iPos++) {
+            std::nth_element( lValues.begin()+lFirst, lValues.begin()+lSorted[iPos], lValues.end(), std::greater<Float_t>() );
+            lFirst = lSorted[iPos]+1;
+        }
+        for( Long_t lB=1; lB<lNDesiredBoundaries; lB++) lJob.fBoundaries[lB] = lValues[ lPositions[lB] ];
+
+        //Cross-check correct rejection of anything beyond anchor point
+        if( lJob.fUseAnchor ){
+            for( Long_t lB=0; lB<lNDesiredBoundaries-1; lB++) {
+                if (lJob.fBoundaries[lB+1]>lJob.fAnchorPoint){
+                    if(lJob.fBoundaries[lB]<lJob.fAnchorPoint){
+                        //This is the threshold, should actually be identical to anchor point please
+                        lJob.fBoundaries[lB] = lJob.fAnchorPoint;
+                    }
+                }
+            }
+        }
+    }
+}
+
 AliMultSelectionCalibrator::AliMultSelectionCalibrator() : TNamed(),
 fInput(0), fSelection(0), lDesiredBoundaries(0), lNDesiredBoundaries(0),
 fRunToUseAsDefault(-1), fMaxEventsPerRun(1e+9), fCheckTriggerType(kFALSE),
-fTrigType(AliVEvent::kAny), fPrefilterOnly(kFALSE), fFiredTrigString(""),
+fTrigType(AliVEvent::kAny), fPrefilterOnly(kFALSE), fNThreads(1), fStreamingMode(kFALSE),
+fFiredTrigString(""),
 fNRunRanges(0), fRunRangesMap(), fMultSelectionList(0),
 fInputFileName(""), fBufferFileName("buffer.root"),
 fOutputFileName(""), fMultSelectionCuts(0), fCalibHists(0)
@@ -64,7 +187,8 @@ AliMultSelectionCalibrator::AliMultSelectionCalibrator(const char * name, const
     TNamed(name,title),
 fInput(0), fSelection(0), lDesiredBoundaries(0), lNDesiredBoundaries(0),
 fRunToUseAsDefault(-1), fMaxEventsPerRun(1e+9), fCheckTriggerType(kFALSE),
-fTrigType(AliVEvent::kAny), fPrefilterOnly(kFALSE), fFiredTrigString(""),
+fTrigType(AliVEvent::kAny), fPrefilterOnly(kFALSE), fNThreads(1), fStreamingMode(kFALSE),
+fFiredTrigString(""),
 fNRunRanges(0), fRunRangesMap(), fMultSelectionList(0),
 fInputFileName(""), fBufferFileName("buffer.root"),
 fOutputFileName(""), fMultSelectionCuts(0), fCalibHists(0)
@@ -263,11 +387,20 @@ Bool_t AliMultSelectionCalibrator::Calibrate() {
     Int_t lNRuns = 0;
     Bool_t lNewRun = kTRUE;
     Int_t lThisRunIndex = -1;
-    //Buffer file with run-by-run TTree objects needed for later processing
 
-    TFile *fOutput = new TFile (fBufferFileName.Data(), "RECREATE");
+    if( fStreamingMode && fPrefilterOnly ){
+        AliWarning("Filter-only mode requires buffer trees, streaming mode disabled");
+        fStreamingMode = kFALSE;
+    }
+
+    //Selected events per run (range)
+    std::vector<Long64_t> lNEventsRun( lMaxQuantiles, 0 );
+    //Streaming mode: estimator values per run (range), [run][estimator][event]
+    std::vector< std::vector< std::vector<Float_t> > > lStreamValues;
+
+    //Buffer file with run-by-run TTree objects needed for later processing
+    TFile *fOutput = 0x0;
     TTree *sTree[lMaxQuantiles];
-    cout<<"Creating Trees..."<<endl;
     //N.B. No need to Exceed Run Ranges in Calibration Code here!
     Int_t lNTrees = 0;
     if( !lAutoDiscover ){
@@ -275,6 +408,20 @@ Bool_t AliMultSelectionCalibrator::Calibrate() {
     }else{
         lNTrees = lMax;
     }
+    if( fStreamingMode ){
+        cout<<"Streaming mode: estimators evaluated while reading, no buffer trees"<<endl;
+        lStreamValues.resize( lNTrees );
+        //Set up each AliMultSelection once, before the event loop
+        if( !lAutoDiscover ){
+            for(Int_t iRun=0; iRun<fNRunRanges; iRun++) ((AliMultSelection*) fMultSelectionList->At(iRun))->Setup ( fInput );
+        }else{
+            fSelection->Setup ( fInput );
+        }
+        lNTrees = 0;
+    }else{
+        fOutput = new TFile (fBufferFileName.Data(), "RECREATE");
+        cout<<"Creating Trees..."<<endl;
+    }
     for(Int_t iRun=0; iRun<lNTrees; iRun++) {
         sTree[iRun] = new TTree(Form("sTree%i",iRun),Form("sTree%i",iRun));
 
@@ -398,26 +545,36 @@ Bool_t AliMultSelectionCalibrator::Calibrate() {
             }
         }
         if ( lSaveThisEvent ) {
-            if( sTree[lIndex]->GetEntries()<fMaxEventsPerRun ){
-                sTree [ lIndex ] -> Fill();
+            if( lNEventsRun[lIndex]<fMaxEventsPerRun ){
+                lNEventsRun[lIndex]++;
+                if( !fStreamingMode ){
+                    sTree [ lIndex ] -> Fill();
+                }else{
+                    AliMultSelection *lSel = lAutoDiscover ? fSelection : (AliMultSelection*) fMultSelectionList->At(lIndex);
+                    lSel->Evaluate ( fInput );
+                    std::vector< std::vector<Float_t> > &lRunValues = lStreamValues[lIndex];
+                    if( lRunValues.empty() ) lRunValues.resize( lSel->GetNEstimators() );
+                    for(Int_t iEst=0; iEst<lSel->GetNEstimators(); iEst++)
+                        lRunValues[iEst].push_back( lSel->GetEstimator(iEst)->GetValue() );
+                }
             }
         }
 
     }
 
     //Write buffer to file
-    for(Int_t iRun=0; iRun<lNRuns; iRun++) sTree[iRun]->Write();
+    if( !fStreamingMode ) for(Int_t iRun=0; iRun<lNRuns; iRun++) sTree[iRun]->Write();
 
     if(!lAutoDiscover){
     cout<<"(3) Inspect Run Ranges and corresponding statistics: "<<endl;
     for(Int_t iRun = 0; iRun<fNRunRanges; iRun++) {
-        cout<<" --- Range #"<<iRun<<", ("<<fFirstRun[iRun]<<" - "<<fLastRun[iRun]<<"), N(events) = "<<sTree[iRun]->GetEntries()<<endl;
+        cout<<" --- Range #"<<iRun<<", ("<<fFirstRun[iRun]<<" - "<<fLastRun[iRun]<<"), N(events) = "<<lNEventsRun[iRun]<<endl;
     }
     cout<<endl;
     }else{
         cout<<"(3) Inspect Runs and corresponding statistics: "<<endl;
         for(Int_t iRun = 0; iRun<fNRunRanges; iRun++) {
-            cout<<" --- Run #"<<iRun<<", (#"<<lRunNumbers[iRun]<<"), N(events) = "<<sTree[iRun]->GetEntries()<<endl;
+            cout<<" --- Run #"<<iRun<<", (#"<<lRunNumbers[iRun]<<"), N(events) = "<<lNEventsRun[iRun]<<endl;
         }
         cout<<endl;
     }
@@ -438,62 +595,9 @@ Bool_t AliMultSelectionCalibrator::Calibrate() {
         lMiddleOfBins[lB-1] = 0.5*(lDesiredBoundaries[lB]+lDesiredBoundaries[lB-1]);
     }
 
-    // STEP 4: Actual determination of boundaries...
-    Long64_t *index;
-    Double_t *lValues;
-
     //Histograms to store calibration information
     TH1F *hCalib[1000][lNEstimators];
 
-    cout<<"(4) Look at average values"<<endl;
-    for(Int_t iRun=0; iRun<fNRunRanges; iRun++) {
-
-        //Contextualize AliMultSelection for this run
-        if ( !lAutoDiscover ) fSelection = (AliMultSelection*) fMultSelectionList->At(iRun);
-
-        // Calibration pre-optimization and setup
-        fSelection->Setup ( fInput );
-
-        const Int_t lNEstimatorsThis = fSelection->GetNEstimators();
-
-        const Long64_t ntot = (Long64_t) sTree[iRun]->GetEntries();
-        if ( !lAutoDiscover ){
-            cout<<"--- Processing run range "<<fFirstRun[iRun]<<"-"<<fLastRun[iRun]<<" ("<<iRun<<"/"<<fNRunRanges<<"), with "<<ntot<<" events..."<<endl;
-        }else{
-            cout<<"--- Processing run "<<lRunNumbers[iRun]<<" ("<<iRun<<"/"<<fNRunRanges<<"), with "<<ntot<<" events..."<<endl;
-        }
-        sTree[iRun]->SetEstimate(ntot+1);
-        //Cast Run Number into drawing conditions
-        for(Int_t iEst=0; iEst<lNEstimatorsThis; iEst++) {
-            lRunStats[iRun] = sTree[iRun]->Draw(fSelection->GetEstimator(iEst)->GetDefinition(),"","goff");
-            lValues = sTree[iRun]->GetV1();
-            cout<<"--- Calculating averages: "<<flush;
-            for( Long64_t iEntry=0; iEntry<ntot; iEntry++) {
-                Float_t lThisVal = lValues[iEntry]; //Test
-                lAvEst[iEst][iRun] += lThisVal;
-                if( lThisVal < lMinEst[iEst][iRun] ) {
-                    lMinEst[iEst][iRun] = lThisVal;
-                }
-                if( lThisVal > lMaxEst[iEst][iRun] ) {
-                    lMaxEst[iEst][iRun] = lThisVal;
-                }
-            }
-            if( sTree[iRun]->GetEntries() < 1 ) {
-                lAvEst[iEst][iRun] = -1;
-            } else {
-                lAvEst[iEst][iRun] /= ( (Double_t) (sTree[iRun]->GetEntries()) );
-            }
-            cout<<" Min = "<<lMinEst[iEst][iRun]<<", Max = "<<lMaxEst[iEst][iRun]<<", Av = "<<lAvEst[iEst][iRun]<<endl;
-
-            if ( TMath::Abs( lMinEst[iEst][iRun] - lMaxEst[iEst][iRun] ) < 1e-6 ){
-                lInsane[iEst][iRun] = kTRUE; //No valid information to do calibration, please be careful !
-            }
-
-        }
-    }
-    //might be needed
-    Long64_t lAcceptedEvents;
-
     //=========================================
     // Determine Calibration Information
     //=========================================
@@ -509,7 +613,7 @@ Bool_t AliMultSelectionCalibrator::Calibrate() {
     //Actual Calibration Histograms
     TH1F * hCalibData[lNEstimators];
 
-    cout<<"(5) Generate Boundaries through a loop in all desired estimators"<<endl;
+    cout<<"(4) Look at average values and generate boundaries, run by run"<<endl;
     for(Int_t iRun=0; iRun<fNRunRanges; iRun++) {
 
         //Contextualize AliMultSelection for this run
@@ -520,74 +624,81 @@ Bool_t AliMultSelectionCalibrator::Calibrate() {
 
         const Int_t lNEstimatorsThis = fSelection->GetNEstimators();
 
-        const Long64_t ntot = (Long64_t) sTree[iRun]->GetEntries();
+        const Long64_t ntot = lNEventsRun[iRun];
         if ( !lAutoDiscover ){
             cout<<"--- Processing run range "<<fFirstRun[iRun]<<"-"<<fLastRun[iRun]<<" ("<<iRun<<"/"<<fNRunRanges<<"), with "<<ntot<<" events..."<<endl;
         }else{
             cout<<"--- Processing run "<<lRunNumbers[iRun]<<" ("<<iRun<<"/"<<fNRunRanges<<"), with "<<ntot<<" events..."<<endl;
         }
-        sTree[iRun]->SetEstimate(ntot+1);
-        // Memory allocation: don't repeat it per estimator! only per run
-        TArrayL64 index(ntot);
-        //Cast Run Number into drawing conditions
+
+        //(4a) Values of all estimators for all events of this run,
+        //     evaluated once per event
+        std::vector< std::vector<Float_t> > lValues;
+        if( fStreamingMode ){
+            lValues.swap( lStreamValues[iRun] );
+            lValues.resize( lNEstimatorsThis );
+        }else{
+            cout<<"--- Evaluating estimators..."<<flush;
+            lValues.resize( lNEstimatorsThis );
+            for(Int_t iEst=0; iEst<lNEstimatorsThis; iEst++) lValues[iEst].reserve(ntot);
+            for( Long64_t iEntry=0; iEntry<ntot; iEntry++) {
+                sTree[iRun]->GetEntry( iEntry );
+                fSelection->Evaluate ( fInput );
+                for(Int_t iEst=0; iEst<lNEstimatorsThis; iEst++)
+                    lValues[iEst].push_back( fSelection->GetEstimator(iEst)->GetValue() );
+            }
+            cout<<" Done!"<<endl;
+        }
+
+        //(4b) Averages, extreme values and boundaries: independent per estimator
+        std::vector<AliMultCalibEstimatorJob> lJobs( lNEstimatorsThis );
         for(Int_t iEst=0; iEst<lNEstimatorsThis; iEst++) {
-            if( ! ( fSelection->GetEstimator(iEst)->IsInteger() ) ) {
-                //==== Floating Point Calibration Engine ====
-                lRunStats[iRun] = sTree[iRun]->Draw(fSelection->GetEstimator(iEst)->GetDefinition(),"","goff");
-                cout<<"--- Sorting estimator "<<fSelection->GetEstimator(iEst)->GetName()<<"..."<<flush;
-
-                TMath::Sort(ntot,sTree[iRun]->GetV1(), index.GetArray() );
-                cout<<" Done! Getting Boundaries... "<<flush;
-
-                //Special override in case anchored estimator
-                if( fSelection->GetEstimator(iEst)->GetUseAnchor() ){
-                    cout<<"Anchoring... "<<flush;
-                    //Require determination of index after which values are to be discarded
-                    //Count fraction of accepted
-                    TString lCondition = fSelection->GetEstimator(iEst)->GetDefinition();
-                    lCondition.Append(Form("> %.10f",fSelection->GetEstimator(iEst)->GetAnchorPoint() ) );
-                    lAcceptedEvents = sTree[iRun]->Draw(fSelection->GetEstimator(iEst)->GetDefinition(),lCondition.Data(),"goff");
-                    lRunStats[iRun] = lAcceptedEvents;
-                }
-                lNrawBoundaries[0] = 0.0; //Defined OK even if anchored
-                //Overwrite lower boundary in case this has a negative minimum...
-                if ( lMinEst[iEst][iRun] < 0 ) {
-                    lNrawBoundaries[0] = lMinEst[iEst][iRun];
-                    cout<<"Min Value Override, Negative..."<<flush;
-                }
+            lJobs[iEst].fValues          = &lValues[iEst];
+            lJobs[iEst].fIsInteger       = fSelection->GetEstimator(iEst)->IsInteger();
+            lJobs[iEst].fUseAnchor       = fSelection->GetEstimator(iEst)->GetUseAnchor();
+            lJobs[iEst].fAnchorPoint     = fSelection->GetEstimator(iEst)->GetAnchorPoint();
+            lJobs[iEst].fAnchorPercentile= fSelection->GetEstimator(iEst)->GetAnchorPercentile();
+        }
+        const Int_t lNWorkers = TMath::Min( fNThreads, lNEstimatorsThis );
+        cout<<"--- Calculating averages and boundaries ("<<TMath::Max(lNWorkers,1)<<" thread(s))..."<<flush;
+        if( lNWorkers <= 1 ){
+            for(Int_t iEst=0; iEst<lNEstimatorsThis; iEst++)
+                ProcessEstimator( lJobs[iEst], lDesiredBoundaries, lNDesiredBoundaries );
+        }else{
+            std::vector<std::thread> lWorkers;
+            for(Int_t iWorker=0; iWorker<lNWorkers; iWorker++) {
+                lWorkers.push_back( std::thread( [&lJobs, lNWorkers, iWorker, this]() {
+                    for(size_t iEst=iWorker; iEst<lJobs.size(); iEst+=lNWorkers)
+                        ProcessEstimator( lJobs[iEst], lDesiredBoundaries, lNDesiredBoundaries );
+                } ) );
+            }
+            for(size_t iWorker=0; iWorker<lWorkers.size(); iWorker++) lWorkers[iWorker].join();
+        }
+        cout<<" Done!"<<endl;
+        //Values no longer needed: free memory before the next run
+        std::vector< std::vector<Float_t> >().swap( lValues );
 
-                for( Long_t lB=1; lB<lNDesiredBoundaries; lB++) {
-                    Long64_t position = (Long64_t) ( 0.01 * ((Double_t)(ntot)* lDesiredBoundaries[lB] ) );
-
-                    if( fSelection->GetEstimator(iEst)->GetUseAnchor() && ntot != 0 ){
-                        //Make sure index position lAnchorEst corresponds to lAnchorPercentile
-                        Double_t lAnchorPercentile = (Double_t) fSelection->GetEstimator(iEst)->GetAnchorPercentile();
-                        Double_t lFractionAccepted = (((Double_t) lAcceptedEvents )/((Double_t) ntot));
-                        Double_t lScalingFactor    = lFractionAccepted/((0.01)*lAnchorPercentile);
-                        //Make sure: if AnchorPercentile requested, cut at AnchorPoint
-                        position = (Long64_t) ( ( 0.01 * ((Double_t)(ntot)* lDesiredBoundaries[lB] ) ) * lScalingFactor );
-                        if(position > ntot-1 ) position = ntot-1; //protection !
-                    }
-                    //cout<<"Position requested: "<<position<<flush;
-                    sTree[iRun]->GetEntry( index[position] );
-                    //Calculate the estimator with this input, please
-                    fSelection->Evaluate ( fInput );
-                    //fSelection->PrintInfo();
-                    lNrawBoundaries[lB] = fSelection->GetEstimator(iEst)->GetValue();
-                }
-                //Cross-check correct rejection of anything beyond anchor point
-                if( fSelection->GetEstimator(iEst)->GetUseAnchor() && ntot != 0 ){
-                    for( Long_t lB=0; lB<lNDesiredBoundaries-1; lB++) {
-                        if (lNrawBoundaries[lB+1]>fSelection->GetEstimator(iEst)->GetAnchorPoint()){
-                            if(lNrawBoundaries[lB]<fSelection->GetEstimator(iEst)->GetAnchorPoint()){
-                                //This is the threshold, should actually be identical to anchor point please
-                                lNrawBoundaries[lB] = fSelection->GetEstimator(iEst)->GetAnchorPoint();
-                            }
-                        }
-                    }
-                }
+        for(Int_t iEst=0; iEst<lNEstimatorsThis; iEst++) {
+            lAvEst[iEst][iRun]  = lJobs[iEst].fAverage;
+            lMinEst[iEst][iRun] = lJobs[iEst].fMin;
+            lMaxEst[iEst][iRun] = lJobs[iEst].fMax;
+            cout<<"--- "<<fSelection->GetEstimator(iEst)->GetName()<<": Min = "<<lMinEst[iEst][iRun]<<", Max = "<<lMaxEst[iEst][iRun]<<", Av = "<<lAvEst[iEst][iRun]<<endl;
 
-                cout<<" Done! Saving... "<<endl;
+            if ( TMath::Abs( lMinEst[iEst][iRun] - lMaxEst[iEst][iRun] ) < 1e-6 ){
+                lInsane[iEst][iRun] = kTRUE; //No valid information to do calibration, please be careful !
+            }
+            //Statistics used for the saving decision: accepted events of the
+            //last estimator (below the anchor point, if anchored)
+            lRunStats[iRun] = ( !lJobs[iEst].fIsInteger && lJobs[iEst].fUseAnchor ) ? lJobs[iEst].fAccepted : ntot;
+        }
+
+        //(5) Generate calibration histograms from the boundaries
+        for(Int_t iEst=0; iEst<lNEstimatorsThis; iEst++) {
+            const AliMultCalibEstimatorJob &lJob = lJobs[iEst];
+            if( ! ( fSelection->GetEstimator(iEst)->IsInteger() ) ) {
+                //==== Floating Point Calibration Engine ====
+                if( lJob.fUseAnchor ) cout<<"--- Estimator "<<fSelection->GetEstimator(iEst)->GetName()<<" anchored, "<<lJob.fAccepted<<" events accepted"<<endl;
+                for( Long_t lB=0; lB<lNDesiredBoundaries; lB++) lNrawBoundaries[lB] = lJob.fBoundaries[lB];
 
                 if( lInsane[iEst][iRun] == kFALSE) {
                     //Create a sane calibration histogram
@@ -619,36 +730,21 @@ Bool_t AliMultSelectionCalibrator::Calibrate() {
                 //==== End Floating Point Calibration Engine ====
             } else {
                 //==== Integer Value Calibration Engine ====
-                //Procedure: Create histogram to be filled
-                cout<<"Integer calibration engine started!"<<endl;
                 const Long_t lNBins    = lMaxEst[iEst][iRun]-lMinEst[iEst][iRun]+1;
                 Float_t lLowEdge = lMinEst[iEst][iRun]-0.5;
                 Float_t lHighEdge= lMaxEst[iEst][iRun]+0.5;
-                cout<<"Inspect: "<<lNBins<<", low "<<lLowEdge<<", high "<<lHighEdge<<endl;
-                if( sTree[iRun]->GetEntries() < 1 ) {
+                cout<<"Integer calibration engine: "<<lNBins<<" bins, low "<<lLowEdge<<", high "<<lHighEdge<<endl;
+                if( ntot < 1 ) {
                     //Case of an empty run!
                     hCalib[iRun][iEst] = new TH1F(Form("hCalib_%i_%s",lRunNumbers[iRun],fSelection->GetEstimator(iEst)->GetName()),"",1,0,1);
                     hCalib[iRun][iEst]->SetDirectory(0);
                 } else {
-                    TH1F *hTemporary = new TH1F("hTemporary", "", lNBins, lMinEst[iEst][iRun]-0.5, lMaxEst[iEst][iRun]+0.5 );
-                    //hTemporary->SetDirectory(0);
-                    lRunStats[iRun] = sTree[iRun]->Draw(Form("%s>>hTemporary",fSelection->GetEstimator(iEst)->GetDefinition().Data()),"","goff");
-                    cout<<"entries = "<<lRunStats[iRun]<<endl;
-                    //In memory now: histogram with content, please normalize to unity
-                    hTemporary->Scale(1./((double)(lRunStats[iRun])));
-
-                    Float_t lBoundaries[lNBins+1]; //to store cumulative function
-                    lBoundaries[0] = 0;
-                    for(Long_t iB=1; iB<hTemporary->GetNbinsX()+1; iB++) {
-                        lBoundaries[iB] = lBoundaries[iB-1]+hTemporary->GetBinContent(iB);
-                    }
+                    //Cumulative function of the normalized distribution
+                    const std::vector<Float_t> &lBoundaries = lJob.fCumulative;
                     //This won't follow what was requested (it cannot, mathematically)
                     hCalib[iRun][iEst] = new TH1F(Form("hCalib_%i_%s",lRunNumbers[iRun],fSelection->GetEstimator(iEst)->GetName()),"",lNBins,lLowEdge,lHighEdge);
                     hCalib[iRun][iEst]->SetDirectory(0);
                     for(Long_t ibin=1; ibin<hCalib[iRun][iEst]->GetNbinsX()+1; ibin++) hCalib[iRun][iEst] -> SetBinContent(ibin, 100.0-50.0*(lBoundaries[ibin-1]+lBoundaries[ibin]));
-                    //Enough info for calibration determined...
-                    delete hTemporary;
-                    hTemporary = 0x0;
                 }
             }
         }
@@ -74,6 +74,15 @@ public:
     //Filter only flag
     void SetFilterOnly(Bool_t lOpt = kTRUE){ fPrefilterOnly = lOpt; }
     
+    //Number of threads used to compute averages and boundaries of the
+    //estimators of one run (1: sequential)
+    void SetNThreads(Int_t lN){ fNThreads = lN > 0 ? lN : 1; }
+    
+    //Streaming mode: estimators are evaluated while reading the input tree
+    //and no buffer trees are written. Values of all runs are kept in memory
+    //(4 bytes per estimator per selected event) until calibration is done
+    void SetStreamingMode(Bool_t lOpt = kTRUE){ fStreamingMode = lOpt; }
+    
     //Master Function in this Class: To be called once filenames are set
     Bool_t Calibrate();
     
@@ -95,6 +104,8 @@ private:
     Bool_t fCheckTriggerType; 
     AliVEvent::EOfflineTriggerTypes fTrigType; // trigger type to calibrate
     Bool_t fPrefilterOnly; //stop before calibrating stuff
+    Int_t  fNThreads;      //threads for boundary determination
+    Bool_t fStreamingMode; //evaluate estimators without buffer trees
     TString fFiredTrigString; //select on fired trigger string if desired
     
     //Run Ranges map - master storage
@@ -115,10 +126,11 @@ private:
     // TList object for storing histograms
     TList *fCalibHists; 
 
-    ClassDef(AliMultSelectionCalibrator, 2);
+    ClassDef(AliMultSelectionCalibrator, 3);
     //(this classdef is only for bookkeeping, class will not usually
     // be streamed according to current workflow except in very specific
     // tests!) 
     //2 - Adjustments of extra event selections
+    //3 - Threaded boundary determination, streaming mode
 };
 #endif
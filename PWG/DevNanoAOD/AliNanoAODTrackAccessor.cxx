@@ -0,0 +1,116 @@
+#include "AliNanoAODTrackAccessor.h"
+#include "AliNanoAODTrackMapping.h"
+#include "AliVEvent.h"
+#include "AliLog.h"
+
+AliNanoAODTrackAccessor::AliNanoAODTrackAccessor() :
+  fNames(),
+  fRequired(),
+  fIndex(),
+  fNamesInt(),
+  fRequiredInt(),
+  fIndexInt(),
+  fMapping(0),
+  fColumns()
+{
+  /// default ctor
+}
+
+AliNanoAODTrackAccessor::Var AliNanoAODTrackAccessor::Declare(const char * varName, Bool_t required)
+{
+  /// Declare a float variable. If required, Resolve() fails with AliFatal
+  /// when it is not in the mapping, otherwise check it with Has()
+
+  fNames.push_back(varName);
+  fRequired.push_back(required);
+  fIndex.push_back(-1);
+  if (fMapping)
+    ResolveVar(fNames.size() - 1);
+  return Var(fNames.size() - 1);
+}
+
+AliNanoAODTrackAccessor::VarInt AliNanoAODTrackAccessor::DeclareInt(const char * varName, Bool_t required)
+{
+  /// Declare an int variable, see Declare
+
+  fNamesInt.push_back(varName);
+  fRequiredInt.push_back(required);
+  fIndexInt.push_back(-1);
+  if (fMapping)
+    ResolveVarInt(fNamesInt.size() - 1);
+  return VarInt(fNamesInt.size() - 1);
+}
+
+Bool_t AliNanoAODTrackAccessor::Resolve()
+{
+  /// Look up the indexes of the declared variables in the mapping of the
+  /// current input. Call from UserNotify
+
+  fMapping = AliNanoAODTrackMapping::GetInstance();
+  Bool_t all = kTRUE;
+  for (UInt_t slot = 0; slot < fNames.size(); slot++)
+    all &= ResolveVar(slot);
+  for (UInt_t slot = 0; slot < fNamesInt.size(); slot++)
+    all &= ResolveVarInt(slot);
+  return all;
+}
+
+Bool_t AliNanoAODTrackAccessor::ResolveVar(Int_t slot)
+{
+  if (fMapping->GetVarIndexInt(fNames[slot]) != -1)
+    AliFatalGeneral("AliNanoAODTrackAccessor", Form("Variable [%s] is an int variable, use DeclareInt", fNames[slot].Data()));
+
+  fIndex[slot] = fMapping->GetVarIndex(fNames[slot]);
+  if (fIndex[slot] != -1)
+    return kTRUE;
+  if (fRequired[slot])
+    AliFatalGeneral("AliNanoAODTrackAccessor", Form("Variable [%s] not available in the nano AOD", fNames[slot].Data()));
+  return kFALSE;
+}
+
+Bool_t AliNanoAODTrackAccessor::ResolveVarInt(Int_t slot)
+{
+  fIndexInt[slot] = fMapping->GetVarIndexInt(fNamesInt[slot]);
+  if (fIndexInt[slot] != -1)
+    return kTRUE;
+  if (fMapping->GetVarIndex(fNamesInt[slot]) != -1)
+    AliFatalGeneral("AliNanoAODTrackAccessor", Form("Variable [%s] is a float variable, use Declare", fNamesInt[slot].Data()));
+  if (fRequiredInt[slot])
+    AliFatalGeneral("AliNanoAODTrackAccessor", Form("Variable [%s] not available in the nano AOD", fNamesInt[slot].Data()));
+  return kFALSE;
+}
+
+const AliNanoAODTrackAccessor::Columns & AliNanoAODTrackAccessor::GetColumns(AliVEvent * event)
+{
+  /// Copy the declared variables of all tracks of event into the columns.
+  /// Variables which are not available are filled with 0
+
+  if (!fMapping)
+    AliFatalGeneral("AliNanoAODTrackAccessor", "GetColumns called before Resolve");
+
+  const Int_t nTracks = event->GetNumberOfTracks();
+  const Int_t nVars = fIndex.size();
+  const Int_t nVarsInt = fIndexInt.size();
+  fColumns.fNTracks = nTracks;
+  fColumns.fNVars = nVars;
+  fColumns.fNVarsInt = nVarsInt;
+  fColumns.fValues.assign((size_t) nVars * nTracks, 0.);
+  fColumns.fValuesInt.assign((size_t) nVarsInt * nTracks, 0);
+  if (nTracks == 0)
+    return fColumns;
+
+  if (!dynamic_cast<AliNanoAODTrack*>(event->GetTrack(0)))
+    AliFatalGeneral("AliNanoAODTrackAccessor", "The input event does not contain nano AOD tracks");
+
+  // Gather track by track, each track holds its own storage
+  for (Int_t itrack = 0; itrack < nTracks; itrack++) {
+    const AliNanoAODTrack * track = static_cast<const AliNanoAODTrack*>(event->GetTrack(itrack));
+    for (Int_t ivar = 0; ivar < nVars; ivar++)
+      if (fIndex[ivar] != -1)
+        fColumns.fValues[(size_t) ivar * nTracks + itrack] = track->GetVar(fIndex[ivar]);
+    for (Int_t ivar = 0; ivar < nVarsInt; ivar++)
+      if (fIndexInt[ivar] != -1)
+        fColumns.fValuesInt[(size_t) ivar * nTracks + itrack] = track->GetVarInt(fIndexInt[ivar]);
+  }
+  return fColumns;
+}
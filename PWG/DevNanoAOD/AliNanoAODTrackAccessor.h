@@ -0,0 +1,104 @@
+/// \class AliNanoAODTrackAccessor
+/// Resolved access to the variables of AliNanoAODTrack.
+///
+/// The task declares the variables it needs once (e.g. in
+/// UserCreateOutputObjects) and keeps the returned handles. Resolve() looks
+/// up their index in AliNanoAODTrackMapping, it has to be called from
+/// UserNotify(). Afterwards Get() reads a variable of a track without any
+/// name lookup or mapping access:
+///
+///   fPt = fAccessor.Declare("pt");
+///   fNSigmaTPCPr = fAccessor.Declare("cstNSigmaTPCPr", kFALSE);
+///   fNCls = fAccessor.DeclareInt("TPCncls");
+///   ...
+///   Bool_t UserNotify() { fAccessor.Resolve(); return kTRUE; }
+///   ...
+///   Double_t pt = fAccessor.Get(track, fPt);
+///
+/// GetColumns() copies the declared variables of all tracks of an event into
+/// one array per variable, for loops which run over all tracks several times.
+
+#ifndef _ALINANOAODTRACKACCESSOR_H_
+#define _ALINANOAODTRACKACCESSOR_H_
+
+#include "TString.h"
+#include "AliNanoAODTrack.h"
+
+#include <vector>
+
+class AliVEvent;
+class AliNanoAODTrackMapping;
+
+class AliNanoAODTrackAccessor
+{
+public:
+  /// Handle of a float variable
+  class Var {
+  public:
+    Var() : fSlot(-1) {}
+  private:
+    explicit Var(Int_t slot) : fSlot(slot) {}
+    Int_t fSlot;
+    friend class AliNanoAODTrackAccessor;
+  };
+
+  /// Handle of an int variable
+  class VarInt {
+  public:
+    VarInt() : fSlot(-1) {}
+  private:
+    explicit VarInt(Int_t slot) : fSlot(slot) {}
+    Int_t fSlot;
+    friend class AliNanoAODTrackAccessor;
+  };
+
+  /// Declared variables of all tracks of one event, one array per variable
+  class Columns {
+  public:
+    Columns() : fNTracks(0), fNVars(0), fNVarsInt(0), fValues(), fValuesInt() {}
+    Int_t GetNTracks() const { return fNTracks; }
+    const Double_t * operator[](Var var) const { return fValues.data() + (size_t) var.fSlot * fNTracks; }
+    const Int_t * operator[](VarInt var) const { return fValuesInt.data() + (size_t) var.fSlot * fNTracks; }
+  private:
+    Int_t fNTracks;
+    Int_t fNVars;
+    Int_t fNVarsInt;
+    std::vector<Double_t> fValues;
+    std::vector<Int_t> fValuesInt;
+    friend class AliNanoAODTrackAccessor;
+  };
+
+  AliNanoAODTrackAccessor();
+  virtual ~AliNanoAODTrackAccessor() {}
+
+  Var Declare(const char * varName, Bool_t required = kTRUE);
+  VarInt DeclareInt(const char * varName, Bool_t required = kTRUE);
+
+  Bool_t Resolve(); // returns kFALSE if an optional variable is not in the mapping
+  Bool_t IsResolved() const { return fMapping != 0; }
+
+  Bool_t Has(Var var) const { return fIndex[var.fSlot] != -1; }
+  Bool_t Has(VarInt var) const { return fIndexInt[var.fSlot] != -1; }
+  Int_t GetIndex(Var var) const { return fIndex[var.fSlot]; }
+  Int_t GetIndexInt(VarInt var) const { return fIndexInt[var.fSlot]; }
+
+  Double_t Get(const AliNanoAODTrack * track, Var var) const { return track->GetVar(fIndex[var.fSlot]); }
+  Int_t Get(const AliNanoAODTrack * track, VarInt var) const { return track->GetVarInt(fIndexInt[var.fSlot]); }
+
+  const Columns & GetColumns(AliVEvent * event);
+
+private:
+  Bool_t ResolveVar(Int_t slot);
+  Bool_t ResolveVarInt(Int_t slot);
+
+  std::vector<TString> fNames;    ///< Declared float variables
+  std::vector<Bool_t> fRequired;  ///< Declared float variables, AliFatal if missing
+  std::vector<Int_t> fIndex;      ///< Index of the declared float variables in the track
+  std::vector<TString> fNamesInt; ///< Declared int variables
+  std::vector<Bool_t> fRequiredInt; ///< Declared int variables, AliFatal if missing
+  std::vector<Int_t> fIndexInt;   ///< Index of the declared int variables in the track
+  AliNanoAODTrackMapping * fMapping; ///< Mapping the indexes were resolved with
+  Columns fColumns;               ///< Buffer returned by GetColumns
+};
+
+#endif /* _ALINANOAODTRACKACCESSOR_H_ */
@@ -62,7 +62,11 @@ AliNanoAODTrackMapping::AliNanoAODTrackMapping() :
   fTOFchi2{-1},
   fTOFsignalDz{-1},
   fTOFsignalDx{-1},
-  fStatus{-1}
+  fStatus{-1},
+  fMapCstVar(),
+  fVarIndex(),
+  fVarIndexInt(),
+  fVarIndexBuilt(kFALSE)
 { 
   /// default ctor
 
@@ -120,7 +124,11 @@ AliNanoAODTrackMapping::AliNanoAODTrackMapping(const char * mappingString) :
   fTOFchi2{-1},
   fTOFsignalDz{-1},
   fTOFsignalDx{-1},
-  fStatus{-1}
+  fStatus{-1},
+  fMapCstVar(),
+  fVarIndex(),
+  fVarIndexInt(),
+  fVarIndexBuilt(kFALSE)
 {
   /// ctor
 
@@ -213,62 +221,96 @@ AliNanoAODTrackMapping::AliNanoAODTrackMapping(const char * mappingString) :
 }
 
 Int_t AliNanoAODTrackMapping::GetVarIndex(TString varName){
+  /// Get index from variable name, float variables and int variables
 
-    if     (varName == "pt"               ) return fPt               ;
-    else if(varName == "phi"              ) return fPhi              ;
-    else if(varName == "theta"            ) return fTheta            ; 
-    else if(varName == "chi2perNDF"       ) return fChi2PerNDF       ;
-    else if(varName == "posx"             ) return fPosX             ;
-    else if(varName == "posy"             ) return fPosY             ;
-    else if(varName == "posz"             ) return fPosZ             ;
-    else if(varName == "pDCAx"            ) return fPDCAX            ;
-    else if(varName == "pDCAy"            ) return fPDCAY            ;
-    else if(varName == "pDCAz"            ) return fPDCAZ            ;
-    else if(varName == "posDCAx"          ) return fPosDCAx          ;
-    else if(varName == "posDCAy"          ) return fPosDCAy          ;
-    else if(varName == "posDCAz"          ) return fPosDCAz          ;
-    else if(varName == "DCA"              ) return fDCA              ;
-    else if(varName == "RAtAbsorberEnd"   ) return fRAtAbsorberEnd   ;
-    else if(varName == "TPCncls"          ) return fTPCncls          ;
-    else if(varName == "ID"               ) return fID               ;
-    else if(varName == "TPCnclsF"         ) return fTPCnclsF         ;
-    else if(varName == "TPCNCrossedRows"  ) return fTPCNCrossedRows  ;
-    else if(varName == "TrackPhiOnEMCal"  ) return fTrackPhiOnEMCal  ;
-    else if(varName == "TrackEtaOnEMCal"  ) return fTrackEtaOnEMCal  ;
-    else if(varName == "TrackPtOnEMCal"   ) return fTrackPtOnEMCal   ;
-    else if(varName == "ITSsignal"        ) return fITSsignal        ;
-    else if(varName == "TPCsignal"        ) return fTPCsignal        ;
-    else if(varName == "TPCsignalTuned"   ) return fTPCsignalTuned   ;
-    else if(varName == "TPCsignalN"       ) return fTPCsignalN       ;
-    else if(varName == "TPCmomentum"      ) return fTPCmomentum      ;
-    else if(varName == "TPCTgl"           ) return fTPCTgl           ;
-    else if(varName == "TOFsignal"        ) return fTOFsignal        ;
-    else if(varName == "integratedLength" ) return fintegratedLength ;
-    else if(varName == "TOFsignalTuned"   ) return fTOFsignalTuned   ;
-    else if(varName == "HMPIDsignal"      ) return fHMPIDsignal      ;
-    else if(varName == "HMPIDoccupancy"   ) return fHMPIDoccupancy   ;
-    else if(varName == "TRDsignal"        ) return fTRDsignal        ;
-    else if(varName == "TRDChi2"          ) return fTRDChi2          ;
-    else if(varName == "TRDnSlices"       ) return fTRDnSlices       ;
-    else if(varName == "TRDntrackletsPID" ) return fTRDntrackletsPID ;
-    else if(varName == "TRDnClusters"     ) return fTRDnClusters     ;
-    else if(varName == "TPCnclsS"         ) return fTPCnclsS         ;
-    else if(varName == "FilterMap"        ) return fFilterMap        ;
-    else if(varName == "TOFBunchCrossing" ) return fTOFBunchCrossing ;
-    else if(varName == "covmat0"          ) return fcovmat[0]        ;
-    else if(varName == "TOFchi2"          ) return fTOFchi2          ;
-    else if(varName == "TOFsignalDz"      ) return fTOFsignalDz      ;
-    else if(varName == "TOFsignalDx"      ) return fTOFsignalDx      ;
-    else if(varName == "Status"           ) return fStatus           ;
+  if (!fVarIndexBuilt)
+    BuildVarIndex();
 
-    std::map<TString,Int_t>::iterator it = fMapCstVar.find(varName); // FIXME: do I need to delete "it"?
-    if(it != fMapCstVar.end()) {
-      //element found;
-	return it->second;
-    }
+  std::map<TString,Int_t>::const_iterator it = fVarIndex.find(varName);
+  if (it != fVarIndex.end())
+    return it->second;
 
-    return -1;
-  
+  return GetVarIndexInt(varName);
+}
+
+Int_t AliNanoAODTrackMapping::GetVarIndexInt(TString varName){
+  /// Get index from variable name, int variables only
+
+  if (!fVarIndexBuilt)
+    BuildVarIndex();
+
+  std::map<TString,Int_t>::const_iterator it = fVarIndexInt.find(varName);
+  if (it != fVarIndexInt.end())
+    return it->second;
+
+  return -1;
+}
+
+void AliNanoAODTrackMapping::BuildVarIndex() {
+  /// Fill the name to index maps used by GetVarIndex and GetVarIndexInt.
+  /// Not done in the ctor as the maps are not streamed with the mapping
+
+  struct { const char * name; Int_t index; } vars[] = {
+    { "pt"               , fPt               },
+    { "phi"              , fPhi              },
+    { "theta"            , fTheta            },
+    { "chi2perNDF"       , fChi2PerNDF       },
+    { "posx"             , fPosX             },
+    { "posy"             , fPosY             },
+    { "posz"             , fPosZ             },
+    { "pDCAx"            , fPDCAX            },
+    { "pDCAy"            , fPDCAY            },
+    { "pDCAz"            , fPDCAZ            },
+    { "posDCAx"          , fPosDCAx          },
+    { "posDCAy"          , fPosDCAy          },
+    { "posDCAz"          , fPosDCAz          },
+    { "DCA"              , fDCA              },
+    { "RAtAbsorberEnd"   , fRAtAbsorberEnd   },
+    { "ID"               , fID               },
+    { "TrackPhiOnEMCal"  , fTrackPhiOnEMCal  },
+    { "TrackEtaOnEMCal"  , fTrackEtaOnEMCal  },
+    { "TrackPtOnEMCal"   , fTrackPtOnEMCal   },
+    { "ITSsignal"        , fITSsignal        },
+    { "TPCsignal"        , fTPCsignal        },
+    { "TPCsignalTuned"   , fTPCsignalTuned   },
+    { "TPCmomentum"      , fTPCmomentum      },
+    { "TPCTgl"           , fTPCTgl           },
+    { "TOFsignal"        , fTOFsignal        },
+    { "integratedLength" , fintegratedLength },
+    { "TOFsignalTuned"   , fTOFsignalTuned   },
+    { "HMPIDsignal"      , fHMPIDsignal      },
+    { "HMPIDoccupancy"   , fHMPIDoccupancy   },
+    { "TRDsignal"        , fTRDsignal        },
+    { "TRDChi2"          , fTRDChi2          },
+    { "TRDnSlices"       , fTRDnSlices       },
+    { "TOFBunchCrossing" , fTOFBunchCrossing },
+    { "TOFchi2"          , fTOFchi2          },
+    { "TOFsignalDz"      , fTOFsignalDz      },
+    { "TOFsignalDx"      , fTOFsignalDx      }
+  };
+  struct { const char * name; Int_t index; } varsInt[] = {
+    { "TPCncls"          , fTPCncls          },
+    { "TPCnclsF"         , fTPCnclsF         },
+    { "TPCNCrossedRows"  , fTPCNCrossedRows  },
+    { "TPCsignalN"       , fTPCsignalN       },
+    { "TRDntrackletsPID" , fTRDntrackletsPID },
+    { "TRDnClusters"     , fTRDnClusters     },
+    { "TPCnclsS"         , fTPCnclsS         },
+    { "FilterMap"        , fFilterMap        },
+    { "Status"           , fStatus           }
+  };
+
+  fVarIndex.clear();
+  fVarIndexInt.clear();
+  for (UInt_t ivar = 0; ivar < sizeof(vars)/sizeof(vars[0]); ivar++)
+    if (vars[ivar].index != -1) fVarIndex[vars[ivar].name] = vars[ivar].index;
+  for (UInt_t ivar = 0; ivar < sizeof(varsInt)/sizeof(varsInt[0]); ivar++)
+    if (varsInt[ivar].index != -1) fVarIndexInt[varsInt[ivar].name] = varsInt[ivar].index;
+  for (Int_t i = 0; i < 21; i++)
+    if (fcovmat[i] != -1) fVarIndex[TString::Format("covmat%d", i)] = fcovmat[i];
+  fVarIndex.insert(fMapCstVar.begin(), fMapCstVar.end());
+
+  fVarIndexBuilt = kTRUE;
 }
 
 const char * AliNanoAODTrackMapping::GetVarName(Int_t index) const {
@@ -32,6 +32,7 @@ public:
   const char * GetVarName(Int_t index) const;
   const char * GetVarNameInt(Int_t index) const;
   Int_t GetVarIndex(TString varName); // cannot be const (uses stl map)
+  Int_t GetVarIndexInt(TString varName); // index of an int variable, -1 if varName is not an int variable
 
   //TODO: implement custom variables
 
@@ -92,6 +93,7 @@ public:
 private:
 
   static void  LoadInstance() ;
+  void BuildVarIndex();
   
   Int_t fSize; ///< Number of variables actually allocated
   Int_t fSizeInt; ///< Number of int variables actually allocated
@@ -145,7 +147,10 @@ private:
 
   static AliNanoAODTrackMapping * fInstance; ///< instance, needed for the singleton implementation
   static TString fMappingString; ///< the string which this class was initialized with
-  std::map<TString,int> fMapCstVar;// Map of indexes of custom variables: CACHE THIS TO CONST INTs IN YOUR TASK TO AVOID CONTINUOUS STRING COMPARISONS
+  std::map<TString,int> fMapCstVar;// Map of indexes of custom variables: use AliNanoAODTrackAccessor in your task to avoid lookups per track
+  std::map<TString,int> fVarIndex;    //! Indexes of all allocated variables, filled on the first call to GetVarIndex
+  std::map<TString,int> fVarIndexInt; //! Indexes of all allocated int variables
+  Bool_t fVarIndexBuilt;              //! fVarIndex and fVarIndexInt are filled
   ClassDef(AliNanoAODTrackMapping, 3)
   
 };
@@ -22,7 +22,11 @@ ClassImp(AliAnalysisTaskNanoSimple)
 AliAnalysisTaskNanoSimple:: AliAnalysisTaskNanoSimple(const char* name):
 AliAnalysisTaskSE(name),
 // general configuration
-fListOfHistos(0x0)
+fListOfHistos(0x0),
+fAccessor(),
+fDCA(),
+fNSigmaTPCPr(),
+fNSigmaTOFPr()
 {
   // Default constructor
 
@@ -56,9 +60,23 @@ void  AliAnalysisTaskNanoSimple::UserCreateOutputObjects()
   // TODO add output histograms to this list. E.g.
   //fListOfHistos->Add(new TH2F("multVsMPI", ";n_{MPI};nch_alice;events", 20, -0.5, 19.5, 301, -0.5, 300.5));
   
+  // Declare the track variables used in UserExec, the indexes are resolved in UserNotify
+  fDCA = fAccessor.Declare("DCA", kFALSE);
+  fNSigmaTPCPr = fAccessor.Declare(AliNanoAODTrack::GetPIDVarName(AliNanoAODTrack::kSigmaTPC, AliPID::kProton), kFALSE);
+  fNSigmaTOFPr = fAccessor.Declare(AliNanoAODTrack::GetPIDVarName(AliNanoAODTrack::kSigmaTOF, AliPID::kProton), kFALSE);
+
   PostData(1, fListOfHistos);
 }
 
+//____________________________________________________________________
+Bool_t AliAnalysisTaskNanoSimple::UserNotify()
+{
+  // new input file
+
+  fAccessor.Resolve();
+  return kTRUE;
+}
+
 //____________________________________________________________________
 void  AliAnalysisTaskNanoSimple::UserExec(Option_t */*option*/)
 {
@@ -94,14 +112,12 @@ void  AliAnalysisTaskNanoSimple::UserExec(Option_t */*option*/)
     
     // for custom variables, cast to nano AOD track
     AliNanoAODTrack* nanoTrack = dynamic_cast<AliNanoAODTrack*>(track);
-    //Printf("  DCA = %f", nanoTrack->DCA());
+    //if (nanoTrack && fAccessor.Has(fDCA))
+    //  Printf("  DCA = %f", fAccessor.Get(nanoTrack, fDCA));
 
-    // NOTE Access to custom variables. Use static here for caching of index
-    static Bool_t bPIDAvailable = AliNanoAODTrack::InitPIDIndex();
-    static const Int_t kcstNSigmaTPCPr  = AliNanoAODTrack::GetPIDIndex(AliNanoAODTrack::kSigmaTPC, AliPID::kProton);
-    static const Int_t kcstNSigmaTOFPr  = AliNanoAODTrack::GetPIDIndex(AliNanoAODTrack::kSigmaTOF, AliPID::kProton);
-    if (nanoTrack && bPIDAvailable)
-      Printf("  TPC_sigma_proton = %f  hasTOF = %d  TOF_sigma_proton = %f", nanoTrack->GetVar(kcstNSigmaTPCPr), nanoTrack->HasTOFpid(), nanoTrack->GetVar(kcstNSigmaTOFPr));
+    // NOTE Access to custom variables through the accessor, the indexes were resolved in UserNotify
+    if (nanoTrack && fAccessor.Has(fNSigmaTPCPr) && fAccessor.Has(fNSigmaTOFPr))
+      Printf("  TPC_sigma_proton = %f  hasTOF = %d  TOF_sigma_proton = %f", fAccessor.Get(nanoTrack, fNSigmaTPCPr), nanoTrack->HasTOFpid(), fAccessor.Get(nanoTrack, fNSigmaTOFPr));
 
     // Applying PID response on nano track
     static AliPIDResponse* pidResponse = 0;
@@ -115,6 +131,16 @@ void  AliAnalysisTaskNanoSimple::UserExec(Option_t */*option*/)
       //Printf("  TPC_sigma_proton = %f               TOF_sigma_proton = %f", pidResponse->NumberOfSigmasTPC(track, AliPID::kProton), pidResponse->NumberOfSigmasTOF(track, AliPID::kProton));
   }
   
+  // All tracks at once: one array per declared variable
+  if (fAccessor.Has(fNSigmaTPCPr)) {
+    const AliNanoAODTrackAccessor::Columns& columns = fAccessor.GetColumns(fInputEvent);
+    const Double_t* nSigmaTPCPr = columns[fNSigmaTPCPr];
+    Int_t nProtonCandidates = 0;
+    for (Int_t i = 0; i < columns.GetNTracks(); i++)
+      nProtonCandidates += (TMath::Abs(nSigmaTPCPr[i]) < 3);
+    Printf("Proton candidates (TPC) = %d", nProtonCandidates);
+  }
+
   // V0 access - as usual
   AliAODEvent* aod = dynamic_cast<AliAODEvent*> (fInputEvent);
   if (aod->GetV0s()) {
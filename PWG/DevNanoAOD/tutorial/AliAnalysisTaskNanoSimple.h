@@ -2,6 +2,7 @@
 #define AliAnalysisTaskNanoSimple_H
 
 #include "AliAnalysisTaskSE.h"
+#include "AliNanoAODTrackAccessor.h"
 
 class  AliAnalysisTaskNanoSimple : public AliAnalysisTaskSE
 {
@@ -12,6 +13,7 @@ public:
   // Implementation of interace methods
   virtual     void   UserCreateOutputObjects();
   virtual     void   UserExec(Option_t *option);
+  virtual     Bool_t UserNotify();
 
 private:
   AliAnalysisTaskNanoSimple(const  AliAnalysisTaskNanoSimple &det);
@@ -20,7 +22,13 @@ private:
   // Histogram settings
   TList*              fListOfHistos;    //  Output list of containers
 
-  ClassDef(AliAnalysisTaskNanoSimple, 1); // Analysis task for correlation development
+  // Track variables, resolved in UserNotify
+  AliNanoAODTrackAccessor           fAccessor;       //!
+  AliNanoAODTrackAccessor::Var      fDCA;            //!
+  AliNanoAODTrackAccessor::Var      fNSigmaTPCPr;    //!
+  AliNanoAODTrackAccessor::Var      fNSigmaTOFPr;    //!
+
+  ClassDef(AliAnalysisTaskNanoSimple, 2); // Analysis task for correlation development
 };
 
 #endif
@@ -476,6 +476,7 @@ void AliClusterContainer::SetClusUserDefEnergyCut(Int_t t, Double_t cut)
   else {
     fMinE = cut;
   }
+  InvalidateAcceptCache();
 }
 
 /**
@@ -60,6 +60,12 @@ AliEmcalContainer::AliEmcalContainer():
   fCurrentID(0),
   fLabelMap(0),
   fLoadedClass(0),
+  fCacheAccepted(kTRUE),
+  fAcceptCacheValid(kFALSE),
+  fAcceptCacheArray(0),
+  fAcceptCacheNEntries(0),
+  fAcceptIndices(),
+  fRejectionReasons(),
   fClassName()
 {
   fVertex[0] = 0;
@@ -90,6 +96,12 @@ AliEmcalContainer::AliEmcalContainer(const char *name):
   fCurrentID(0),
   fLabelMap(0),
   fLoadedClass(0),
+  fCacheAccepted(kTRUE),
+  fAcceptCacheValid(kFALSE),
+  fAcceptCacheArray(0),
+  fAcceptCacheNEntries(0),
+  fAcceptIndices(),
+  fRejectionReasons(),
   fClassName()
 {
   fVertex[0] = 0;
@@ -132,6 +144,7 @@ void AliEmcalContainer::SetArray(const AliVEvent *event)
   if (!event) return;
 
   GetVertexFromEvent(event);
+  InvalidateAcceptCache();
 
   if (!fClArrayName.IsNull() && !fClArray) {
     fClArray = dynamic_cast<TClonesArray*>(event->FindListObject(fClArrayName));
@@ -162,18 +175,43 @@ void AliEmcalContainer::NextEvent(const AliVEvent * event)
   // Get the right event (either the current event of the embedded event)
   event = AliEmcalContainerUtils::GetEvent(event, fIsEmbedding);
 
+  InvalidateAcceptCache();
+
   if (!event) return;
 
   GetVertexFromEvent(event);
 }
 
 Int_t AliEmcalContainer::GetNAcceptEntries() const{
-  Int_t result = 0;
-  for(int index = 0; index < GetNEntries(); index++){
+  return GetAcceptIndices().size();
+}
+
+const std::vector<Int_t> &AliEmcalContainer::GetAcceptIndices() const {
+  if(!fCacheAccepted || !fAcceptCacheValid || fAcceptCacheArray != fClArray || fAcceptCacheNEntries != GetNEntries())
+    BuildAcceptCache();
+  return fAcceptIndices;
+}
+
+UInt_t AliEmcalContainer::GetCachedRejectionReason(Int_t i) const {
+  if(!fCacheAccepted || !fAcceptCacheValid || fAcceptCacheArray != fClArray || fAcceptCacheNEntries != GetNEntries())
+    BuildAcceptCache();
+  if(i < 0 || i >= static_cast<Int_t>(fRejectionReasons.size())) return 0;
+  return fRejectionReasons[i];
+}
+
+void AliEmcalContainer::BuildAcceptCache() const {
+  const Int_t nentries = GetNEntries();
+  fAcceptIndices.clear();
+  fAcceptIndices.reserve(nentries);
+  fRejectionReasons.resize(nentries);
+  for(int index = 0; index < nentries; index++){
     UInt_t rejectionReason = 0;
-    if(AcceptObject(index, rejectionReason)) result++;
+    if(AcceptObject(index, rejectionReason)) fAcceptIndices.push_back(index);
+    fRejectionReasons[index] = rejectionReason;
   }
-  return result;
+  fAcceptCacheArray = fClArray;
+  fAcceptCacheNEntries = nentries;
+  fAcceptCacheValid = kTRUE;
 }
 
 Int_t AliEmcalContainer::GetIndexFromLabel(Int_t lab) const
@@ -37,6 +37,7 @@ class AliVEvent;
 class AliNamedArrayI;
 class AliVParticle;
 
+#include <vector>
 #include <TNamed.h>
 #include <TClonesArray.h>
 
@@ -229,6 +230,40 @@ class AliEmcalContainer : public TObject {
    */
   Int_t                       GetNAcceptEntries() const;
 
+  /**
+   * @brief Get the indices of the accepted objects in the current event
+   *
+   * The selection is evaluated once per event and shared by all accepted()
+   * iterables and by GetNAcceptEntries(). It is invalidated when a new event
+   * is loaded, the array changes or a cut is modified via the setters. Code
+   * modifying the objects in the array within the event (i.e. correction
+   * components) needs to call InvalidateAcceptCache().
+   * @return Indices of the accepted objects, in increasing order
+   */
+  const std::vector<Int_t>&   GetAcceptIndices() const;
+
+  /**
+   * @brief Get the rejection reason of an object from the per-event selection cache
+   * @param i Index of the object in the container
+   * @return Rejection reason bitmap (0 if accepted)
+   */
+  UInt_t                      GetCachedRejectionReason(Int_t i) const;
+
+  /**
+   * @brief Mark the per-event selection cache as outdated
+   */
+  void                        InvalidateAcceptCache() const         { fAcceptCacheValid = kFALSE        ; }
+
+  /**
+   * @brief Enable / disable caching of the selection over calls within the same event
+   *
+   * When disabled the selection is evaluated each time the accepted objects
+   * are requested (behaviour of previous versions).
+   * @param b If true the selection is cached
+   */
+  void                        SetCacheAcceptedObjects(Bool_t b)     { fCacheAccepted = b ; InvalidateAcceptCache(); }
+  Bool_t                      IsCachingAcceptedObjects() const      { return fCacheAccepted             ; }
+
   /**
    * @brief Reset the iterator to a given index
    * 
@@ -247,10 +282,10 @@ class AliEmcalContainer : public TObject {
    */
   virtual void                SetArray(const AliVEvent *event);
   void                        SetArrayName(const char *n)           { fClArrayName = n                  ; }
-  void                        SetVertex(Double_t *vtx)              { memcpy(fVertex, vtx, sizeof(Double_t) * 3); }
-  void                        SetBitMap(UInt_t m)                   { fBitMap = m                       ; }
-  void                        SetIsParticleLevel(Bool_t b)          { fIsParticleLevel = b              ; }
-  void                        SortArray()                           { fClArray->Sort()                  ; }
+  void                        SetVertex(Double_t *vtx)              { memcpy(fVertex, vtx, sizeof(Double_t) * 3); InvalidateAcceptCache(); }
+  void                        SetBitMap(UInt_t m)                   { fBitMap = m                       ; InvalidateAcceptCache(); }
+  void                        SetIsParticleLevel(Bool_t b)          { fIsParticleLevel = b              ; InvalidateAcceptCache(); }
+  void                        SortArray()                           { fClArray->Sort()                  ; InvalidateAcceptCache(); }
 
   TClass*                     GetLoadedClass()                      { return fLoadedClass               ; }
 
@@ -259,18 +294,18 @@ class AliEmcalContainer : public TObject {
    * @param[in] event The event to be processed.
    */
   virtual void                NextEvent(const AliVEvent *event);
-  void                        SetMinMCLabel(Int_t s)                            { fMinMCLabel      = s   ; }
-  void                        SetMaxMCLabel(Int_t s)                            { fMaxMCLabel      = s   ; }
+  void                        SetMinMCLabel(Int_t s)                            { fMinMCLabel      = s   ; InvalidateAcceptCache(); }
+  void                        SetMaxMCLabel(Int_t s)                            { fMaxMCLabel      = s   ; InvalidateAcceptCache(); }
   void                        SetMCLabelRange(Int_t min, Int_t max)             { SetMinMCLabel(min)     ; SetMaxMCLabel(max)    ; }
-  void                        SetELimits(Double_t min, Double_t max)    { fMinE   = min ; fMaxE   = max ; }
-  void                        SetMinE(Double_t min)                     { fMinE   = min ; }
-  void                        SetMaxE(Double_t max)                     { fMaxE   = max ; }
-  void                        SetPtLimits(Double_t min, Double_t max)   { fMinPt  = min ; fMaxPt  = max ; }
-  void                        SetMinPt(Double_t min)                    { fMinPt  = min ; }
-  void                        SetMaxPt(Double_t max)                    { fMaxPt  = max ; }
-  void                        SetEtaLimits(Double_t min, Double_t max)  { fMaxEta = max ; fMinEta = min ; }
-  void                        SetPhiLimits(Double_t min, Double_t max)  { fMaxPhi = max ; fMinPhi = min ; }
-  void                        SetMassHypothesis(Double_t m)             { fMassHypothesis         = m   ; }
+  void                        SetELimits(Double_t min, Double_t max)    { fMinE   = min ; fMaxE   = max ; InvalidateAcceptCache(); }
+  void                        SetMinE(Double_t min)                     { fMinE   = min ; InvalidateAcceptCache(); }
+  void                        SetMaxE(Double_t max)                     { fMaxE   = max ; InvalidateAcceptCache(); }
+  void                        SetPtLimits(Double_t min, Double_t max)   { fMinPt  = min ; fMaxPt  = max ; InvalidateAcceptCache(); }
+  void                        SetMinPt(Double_t min)                    { fMinPt  = min ; InvalidateAcceptCache(); }
+  void                        SetMaxPt(Double_t max)                    { fMaxPt  = max ; InvalidateAcceptCache(); }
+  void                        SetEtaLimits(Double_t min, Double_t max)  { fMaxEta = max ; fMinEta = min ; InvalidateAcceptCache(); }
+  void                        SetPhiLimits(Double_t min, Double_t max)  { fMaxPhi = max ; fMinPhi = min ; InvalidateAcceptCache(); }
+  void                        SetMassHypothesis(Double_t m)             { fMassHypothesis         = m   ; InvalidateAcceptCache(); }
   void                        SetClassName(const char *clname);
 
   /**
@@ -279,7 +314,7 @@ class AliEmcalContainer : public TObject {
    * Embedding means that the container consists only of tracks from the embedded event.
    * @param[in] b If true the container handles the embedded event
    */
-  void                        SetIsEmbedding(Bool_t b)                  { fIsEmbedding = b ; }
+  void                        SetIsEmbedding(Bool_t b)                  { fIsEmbedding = b ; InvalidateAcceptCache(); }
 
   /**
    * @brief Get embedding status
@@ -372,6 +407,11 @@ class AliEmcalContainer : public TObject {
    */
   void                        GetVertexFromEvent(const AliVEvent * event);
 
+  /**
+   * @brief Evaluate the selection for all objects and fill the per-event selection cache
+   */
+  void                        BuildAcceptCache() const;
+
   TString                     fName;                    ///< object name
   TString                     fClArrayName;             ///< name of branch
   TString                     fBaseClassName;           ///< name of the base class that this container can handle
@@ -394,6 +434,12 @@ class AliEmcalContainer : public TObject {
   AliNamedArrayI             *fLabelMap;                //!<! Label-Index map
   Double_t                    fVertex[3];               //!<! event vertex array
   TClass                     *fLoadedClass;             //!<! Class of the objects contained in the TClonesArray
+  Bool_t                      fCacheAccepted;           ///< cache the selection of the objects within the event
+  mutable Bool_t              fAcceptCacheValid;        //!<! the selection cache corresponds to the current event and cuts
+  mutable const TClonesArray *fAcceptCacheArray;        //!<! array the selection cache was built for
+  mutable Int_t               fAcceptCacheNEntries;     //!<! number of entries the selection cache was built for
+  mutable std::vector<Int_t>  fAcceptIndices;           //!<! indices of the accepted objects
+  mutable std::vector<UInt_t> fRejectionReasons;        //!<! rejection reason of each object
 
  private:
   TString                     fClassName;               ///< name of the class in the TClonesArray
@@ -401,6 +447,6 @@ class AliEmcalContainer : public TObject {
   AliEmcalContainer(const AliEmcalContainer& obj); // copy constructor
   AliEmcalContainer& operator=(const AliEmcalContainer& other); // assignment
 
-  ClassDef(AliEmcalContainer,9);
+  ClassDef(AliEmcalContainer,10);
 };
 #endif
@@ -5,6 +5,7 @@
 /* Copyright(c) 1998-2016, ALICE Experiment at CERN, All rights reserved. *
  * See cxx source for full Copyright notice                               */
 
+#include <algorithm>
 #include <iterator>
 #include <vector>
 #include <type_traits>
@@ -328,17 +329,15 @@ T *AliEmcalIterableContainerT<T, STAR>::operator[](int index) const {
 
 /**
  * Build list of accepted indices inside the container.
- * For this all objects inside the container are checked
- * for being accepted or not.
+ * The selection is evaluated once per event by the container
+ * (see AliEmcalContainer::GetAcceptIndices) and shared between
+ * all iterables, here the indices are only copied.
  */
 template <typename T, typename STAR>
 void AliEmcalIterableContainerT<T, STAR>::BuildAcceptIndices(){
-  fAcceptIndices.Set(fkContainer->GetNAcceptEntries());
-  int acceptCounter = 0;
-  for(int index = 0; index < fkContainer->GetNEntries(); index++){
-    UInt_t rejectionReason = 0;
-    if(fkContainer->AcceptObject(index, rejectionReason)) fAcceptIndices[acceptCounter++] = index;
-  }
+  const std::vector<Int_t> &acceptIndices = fkContainer->GetAcceptIndices();
+  fAcceptIndices.Set(acceptIndices.size());
+  if(acceptIndices.size()) std::copy(acceptIndices.begin(), acceptIndices.end(), fAcceptIndices.GetArray());
 }
 
 ///////////////////////////////////////////////////////////////////////
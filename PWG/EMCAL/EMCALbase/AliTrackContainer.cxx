@@ -593,6 +593,7 @@ void AliTrackContainer::AddTrackCuts(AliVCuts *cuts)
     fListOfCuts->SetOwner(true);
   }
   fListOfCuts->Add(cuts);
+  InvalidateAcceptCache();
 }
 
 /**
@@ -144,21 +144,21 @@ class AliTrackContainer : public AliParticleContainer {
 
   void                        SetArray(const AliVEvent *event);
 
-  void                        SetTrackFilterType(ETrackFilterType_t f)          { fTrackFilterType = f; }
-  void                        SetFilterHybridTracks(Bool_t f)                   { if (f) fTrackFilterType = AliEmcalTrackSelection::kHybridTracks; else fTrackFilterType = AliEmcalTrackSelection::kNoTrackFilter; }   // legacy method
-  void                        SetITSHybridTrackDistinction(Bool_t doUse)        { fITSHybridTrackDistinction = doUse; }
+  void                        SetTrackFilterType(ETrackFilterType_t f)          { fTrackFilterType = f; InvalidateAcceptCache(); }
+  void                        SetFilterHybridTracks(Bool_t f)                   { if (f) fTrackFilterType = AliEmcalTrackSelection::kHybridTracks; else fTrackFilterType = AliEmcalTrackSelection::kNoTrackFilter; InvalidateAcceptCache(); }   // legacy method
+  void                        SetITSHybridTrackDistinction(Bool_t doUse)        { fITSHybridTrackDistinction = doUse; InvalidateAcceptCache(); }
 
-  void                        SetTrackCutsPeriod(const char* period)            { fTrackCutsPeriod = period; }
+  void                        SetTrackCutsPeriod(const char* period)            { fTrackCutsPeriod = period; InvalidateAcceptCache(); }
   void                        AddTrackCuts(AliVCuts *cuts);
   Int_t                       GetNumberOfCutObjects() const;
   AliVCuts                   *GetTrackCuts(Int_t icut);
-  void                        SetAODFilterBits(UInt_t bits)                     { fAODFilterBits   = bits  ; }
-  void                        AddAODFilterBit(UInt_t bit)                       { fAODFilterBits  |= bit   ; }
+  void                        SetAODFilterBits(UInt_t bits)                     { fAODFilterBits   = bits  ; InvalidateAcceptCache(); }
+  void                        AddAODFilterBit(UInt_t bit)                       { fAODFilterBits  |= bit   ; InvalidateAcceptCache(); }
   UInt_t                      GetAODFilterBits()                          const { return fAODFilterBits    ; }
   Bool_t                      IsHybridTrackSelection() const;
 
-  void SetSelectionModeAny() { fSelectionModeAny = kTRUE ; }
-  void SetSelectionModeAll() { fSelectionModeAny = kFALSE; }
+  void SetSelectionModeAny() { fSelectionModeAny = kTRUE ; InvalidateAcceptCache(); }
+  void SetSelectionModeAll() { fSelectionModeAny = kFALSE; InvalidateAcceptCache(); }
 
   void                        NextEvent(const AliVEvent* event);
 
@@ -0,0 +1,153 @@
+/**************************************************************************
+ * Copyright(c) 1998-2016, ALICE Experiment at CERN, All rights reserved. *
+ *                                                                        *
+ * Author: The ALICE Off-line Project.                                    *
+ * Contributors are mentioned in the code where appropriate.              *
+ *                                                                        *
+ * Permission to use, copy, modify and distribute this software and its   *
+ * documentation strictly for non-commercial purposes is hereby granted   *
+ * without fee, provided that the above copyright notice appears in all   *
+ * copies and that both the copyright notice and this permission notice   *
+ * appear in the supporting documentation. The authors make no claims     *
+ * about the suitability of this software for any purpose. It is          *
+ * provided "as is" without express or implied warranty.                  *
+ **************************************************************************/
+#include <vector>
+#include <TStopwatch.h>
+#include <THistManager.h>
+
+#include "AliClusterContainer.h"
+#include "AliParticleContainer.h"
+
+#include "AliAnalysisTaskEmcalAcceptCacheBenchmark.h"
+
+/// \cond CLASSIMP
+ClassImp(AliAnalysisTaskEmcalAcceptCacheBenchmark)
+/// \endcond
+
+/**
+ * Default (I/O) constructor
+ */
+AliAnalysisTaskEmcalAcceptCacheBenchmark::AliAnalysisTaskEmcalAcceptCacheBenchmark():
+  AliAnalysisTaskEmcal(),
+  fHistos(NULL),
+  fNIterations(5)
+{
+
+}
+
+/**
+ * Named constructor, initializing the histograms from the AliAnalysisTaskEmcal.
+ */
+AliAnalysisTaskEmcalAcceptCacheBenchmark::AliAnalysisTaskEmcalAcceptCacheBenchmark(const char *name):
+  AliAnalysisTaskEmcal(name, true),
+  fHistos(NULL),
+  fNIterations(5)
+{
+
+}
+
+/**
+ * Destructor
+ */
+AliAnalysisTaskEmcalAcceptCacheBenchmark::~AliAnalysisTaskEmcalAcceptCacheBenchmark(){
+}
+
+/**
+ * Creating histograms for the timing and the consistency check
+ * of each container attached to the task.
+ */
+void AliAnalysisTaskEmcalAcceptCacheBenchmark::UserCreateOutputObjects() {
+  AliAnalysisTaskEmcal::UserCreateOutputObjects();
+  fHistos = new THistManager("benchmarkhistos");
+  fHistos->ReleaseOwner();
+
+  for(auto cont : fParticleCollArray) CreateContainerHistos(static_cast<AliEmcalContainer *>(cont)->GetName());
+  for(auto cont : fClusterCollArray) CreateContainerHistos(static_cast<AliEmcalContainer *>(cont)->GetName());
+
+  for(TIter histiter = TIter(fHistos->GetListOfHistograms()).Begin(); histiter != TIter::End(); ++histiter){
+    fOutput->Add(*histiter);
+  }
+  PostData(1, fOutput);
+}
+
+/**
+ * Create the histograms for a given container
+ * @param contname Name of the container
+ */
+void AliAnalysisTaskEmcalAcceptCacheBenchmark::CreateContainerHistos(const char *contname) {
+  fHistos->CreateTH1(Form("hTimeUncached%s", contname), Form("Time per event without selection cache, container %s; t (#mus)", contname), 1000, 0., 10000.);
+  fHistos->CreateTH1(Form("hTimeCached%s", contname), Form("Time per event with selection cache, container %s; t (#mus)", contname), 1000, 0., 10000.);
+  fHistos->CreateTH1(Form("hSpeedup%s", contname), Form("Time uncached / time cached, container %s; t_{uncached} / t_{cached}", contname), 500, 0., 50.);
+  fHistos->CreateTH1(Form("hConsistency%s", contname), Form("Consistency of the accepted indices, container %s", contname), 3, -0.5, 2.5);
+}
+
+/**
+ * Run the benchmark for all particle and cluster containers
+ * attached to the task.
+ *
+ * @return Always true
+ */
+bool AliAnalysisTaskEmcalAcceptCacheBenchmark::Run() {
+  for(auto cont : fParticleCollArray) BenchmarkContainer(static_cast<AliEmcalContainer *>(cont));
+  for(auto cont : fClusterCollArray) BenchmarkContainer(static_cast<AliEmcalContainer *>(cont));
+  return kTRUE;
+}
+
+/**
+ * Loop fNIterations times over the accepted objects of the container,
+ * once as done before the selection cache and once with the selection
+ * cache, and compare the accepted indices found in both modes. The
+ * baseline builds each iterable like the former AliEmcalIterableContainer:
+ * the selection is evaluated a first time to count the accepted objects
+ * and a second time to fill their indices. The caching mode configured
+ * for the container is restored at the end.
+ * @param cont Container to benchmark
+ */
+void AliAnalysisTaskEmcalAcceptCacheBenchmark::BenchmarkContainer(AliEmcalContainer *cont) {
+  const char *contname = cont->GetName();
+  Bool_t cachingBefore = cont->IsCachingAcceptedObjects();
+  std::vector<int> indicesUncached, indicesCached;
+  TStopwatch timer;
+
+  timer.Start();
+  for(int iiter = 0; iiter < fNIterations; iiter++){
+    UInt_t rejectionReason = 0;
+    int nAccepted = 0;
+    for(int index = 0; index < cont->GetNEntries(); index++){
+      if(cont->AcceptObject(index, rejectionReason)) nAccepted++;
+    }
+    std::vector<int> acceptIndices(nAccepted);
+    int acceptCounter = 0;
+    for(int index = 0; index < cont->GetNEntries(); index++){
+      if(cont->AcceptObject(index, rejectionReason)) acceptIndices[acceptCounter++] = index;
+    }
+    if(iiter == 0) indicesUncached = acceptIndices;
+  }
+  timer.Stop();
+  double timeUncached = timer.RealTime() * 1e6;
+
+  // The selection is evaluated again for this event, as for the first accepted() call
+  cont->SetCacheAcceptedObjects(kTRUE);
+  timer.Start();
+  for(int iiter = 0; iiter < fNIterations; iiter++){
+    auto iterable = cont->accepted();
+    if(iiter == 0) indicesCached.reserve(iterable.GetEntries());
+    for(auto it = iterable.begin(); it != iterable.end(); ++it){
+      if(iiter == 0) indicesCached.push_back(it.current_index());
+    }
+  }
+  timer.Stop();
+  double timeCached = timer.RealTime() * 1e6;
+
+  cont->SetCacheAcceptedObjects(cachingBefore);
+
+  int consistency = 0;
+  if(indicesCached.size() != indicesUncached.size()) consistency = 1;
+  else if(indicesCached != indicesUncached) consistency = 2;
+
+  fHistos->FillTH1(Form("hTimeUncached%s", contname), timeUncached);
+  fHistos->FillTH1(Form("hTimeCached%s", contname), timeCached);
+  if(timeCached > 0) fHistos->FillTH1(Form("hSpeedup%s", contname), timeUncached / timeCached);
+  fHistos->FillTH1(Form("hConsistency%s", contname), consistency);
+}
@@ -0,0 +1,62 @@
+#ifndef ALIANALYSISTASKEMCALACCEPTCACHEBENCHMARK_H
+#define ALIANALYSISTASKEMCALACCEPTCACHEBENCHMARK_H
+/* Copyright(c) 1998-2016, ALICE Experiment at CERN, All rights reserved. *
+ * See cxx source for full Copyright notice                               */
+
+#include "AliAnalysisTaskEmcal.h"
+
+class THistManager;
+class AliEmcalContainer;
+
+/**
+ * \class AliAnalysisTaskEmcalAcceptCacheBenchmark
+ * \brief Benchmark of the per-event selection cache of the EMCAL containers
+ * \ingroup EMCALFWTASKS
+ *
+ * Based on AliAnalysisTaskEmcalIteratorTest. For each particle and cluster
+ * container attached to the task the accepted objects are looped over a
+ * configurable number of times per event (mimicking several tasks or
+ * correction components working on the same container), once building the
+ * accepted indices as the iterables did before the selection cache (two
+ * evaluations of the selection per loop) and once with the accepted()
+ * iterable and the selection cache enabled.
+ * The time per event for both modes and the ratio are monitored in histograms,
+ * together with a consistency check of the accepted indices in both modes
+ * (0 - same indices, 1 - different number of entries, 2 - different indices).
+ *
+ * ~~~{.cxx}
+ * AliAnalysisTaskEmcalAcceptCacheBenchmark *bench = new AliAnalysisTaskEmcalAcceptCacheBenchmark("acceptCacheBenchmark");
+ * bench->AddClusterContainer("caloClusters");
+ * bench->AddTrackContainer("tracks");
+ * bench->SetNumberOfIterations(5);
+ * ~~~
+ */
+class AliAnalysisTaskEmcalAcceptCacheBenchmark : public AliAnalysisTaskEmcal {
+public:
+  AliAnalysisTaskEmcalAcceptCacheBenchmark();
+  AliAnalysisTaskEmcalAcceptCacheBenchmark(const char *name);
+  virtual ~AliAnalysisTaskEmcalAcceptCacheBenchmark();
+
+  void SetNumberOfIterations(Int_t niter)          { fNIterations = niter; }
+
+protected:
+
+  virtual void UserCreateOutputObjects();
+  virtual bool Run();
+
+  void CreateContainerHistos(const char *contname);
+  void BenchmarkContainer(AliEmcalContainer *cont);
+
+  THistManager                *fHistos;                     //!<!  Histogram manager
+  Int_t                       fNIterations;                 ///< Number of accepted() loops per container and event
+
+private:
+  AliAnalysisTaskEmcalAcceptCacheBenchmark(const AliAnalysisTaskEmcalAcceptCacheBenchmark &);
+  AliAnalysisTaskEmcalAcceptCacheBenchmark &operator=(const AliAnalysisTaskEmcalAcceptCacheBenchmark &);
+
+  /// \cond CLASSIMP
+  ClassDef(AliAnalysisTaskEmcalAcceptCacheBenchmark, 1);
+  /// \endcond
+};
+
+#endif /* ALIANALYSISTASKEMCALACCEPTCACHEBENCHMARK_H */
@@ -1305,6 +1305,14 @@ Bool_t AliEmcalCorrectionTask::Run()
     component->SetCentrality(fCent);
     component->SetVertex(fVertex);
 
+    // Components modify the objects in the shared containers (energy, matching)
+    // or replace them, so the cached selections of the previous component are outdated
+    AliEmcalContainer* cont = 0;
+    TIter nextPartColl(&fParticleCollArray);
+    while ((cont = static_cast<AliEmcalContainer*>(nextPartColl()))) cont->InvalidateAcceptCache();
+    TIter nextClusColl(&fClusterCollArray);
+    while ((cont = static_cast<AliEmcalContainer*>(nextClusColl()))) cont->InvalidateAcceptCache();
+
     component->Run();
   }
 
@@ -30,6 +30,7 @@
 #pragma link C++ class  AliEMCALConfigHandler+;
 #pragma link C++ class  AliEMCALConfigurationMatcher+;
 #pragma link C++ class  AliAnalysisTaskEmcalIteratorTest+;
+#pragma link C++ class  AliAnalysisTaskEmcalAcceptCacheBenchmark+;
 #pragma link C++ class  AliEmcalCopyCollection+;
 #pragma link C++ class  AliEmcalCorrectionEventManager+;
 #pragma link C++ class  AliEmcalCorrectionTask+;
@@ -39,6 +39,8 @@ AliEmcalTriggerMakerPart::AliEmcalTriggerMakerPart() :
 	fGammaTrigger(),
 	fTriggerChannelsEMCAL(48, 64),
 	fTriggerChannelsDCALPHOS(48, 40),
+	fPatchSumsEMCAL(),
+	fPatchSumsDCALPHOS(),
 	fTriggerMapping(),
 	fBadChannelsEMCAL(),
 	fBadChannelsDCALPHOS(),
@@ -89,12 +91,16 @@ void AliEmcalTriggerMakerPart::Reset() {
 
 void AliEmcalTriggerMakerPart::FindPatches() {
 
-	fGammaEMCAL     = fGammaTrigger.FindPatches 	(	&fTriggerChannelsEMCAL		);
-	fGammaDCALPHOS  = fGammaTrigger.FindPatches 	(	&fTriggerChannelsDCALPHOS	);
-	fJetEMCAL       = fJetTrigger.  FindPatches 	(	&fTriggerChannelsEMCAL		);
-	fJetDCALPHOS    = fJetTrigger.  FindPatches 	(	&fTriggerChannelsDCALPHOS	);
-	fJetEMCAL8x8    = fJetTrigger.  FindPatches8x8	(	&fTriggerChannelsEMCAL		);
-	fJetDCALPHOS8x8 = fJetTrigger.  FindPatches8x8	(	&fTriggerChannelsDCALPHOS	);
+	// summed-area tables shared by the gamma and jet algorithms
+	fPatchSumsEMCAL.Fill(fTriggerChannelsEMCAL);
+	fPatchSumsDCALPHOS.Fill(fTriggerChannelsDCALPHOS);
+
+	fGammaEMCAL     = fGammaTrigger.FindPatches 	(	&fTriggerChannelsEMCAL,		&fPatchSumsEMCAL		);
+	fGammaDCALPHOS  = fGammaTrigger.FindPatches 	(	&fTriggerChannelsDCALPHOS,	&fPatchSumsDCALPHOS	);
+	fJetEMCAL       = fJetTrigger.  FindPatches 	(	&fTriggerChannelsEMCAL,		&fPatchSumsEMCAL		);
+	fJetDCALPHOS    = fJetTrigger.  FindPatches 	(	&fTriggerChannelsDCALPHOS,	&fPatchSumsDCALPHOS	);
+	fJetEMCAL8x8    = fJetTrigger.  FindPatches8x8	(	&fTriggerChannelsEMCAL,		&fPatchSumsEMCAL		);
+	fJetDCALPHOS8x8 = fJetTrigger.  FindPatches8x8	(	&fTriggerChannelsDCALPHOS,	&fPatchSumsDCALPHOS	);
 
 	fHasRun = true;
 }
@@ -34,6 +34,7 @@
 #include "AliEmcalTriggerPartChannelMap.h"
 #include "AliEmcalTriggerPartBadChannelContainer.h"
 #include "AliEmcalTriggerPartMapping.h"
+#include "AliEmcalTriggerPartPatchSumTable.h"
 #include "AliEmcalTriggerPartSetup.h"
 
 namespace PWG {
@@ -150,6 +151,8 @@ private:
 	AliEmcalTriggerPartGammaAlgorithm							fGammaTrigger;							///< Algorithm finding gamma patches on a trigger channel map
 	AliEmcalTriggerPartChannelMap									fTriggerChannelsEMCAL;			///< Trigger channels for the EMCAL
 	AliEmcalTriggerPartChannelMap									fTriggerChannelsDCALPHOS;		///< Trigger channels for the combination DCAL-PHOS
+	AliEmcalTriggerPartPatchSumTable							fPatchSumsEMCAL;						//!<! Summed-area table of the EMCAL trigger channels
+	AliEmcalTriggerPartPatchSumTable							fPatchSumsDCALPHOS;					//!<! Summed-area table of the DCAL-PHOS trigger channels
 	AliEmcalTriggerPartMapping										fTriggerMapping;						///< Mapping between trigger channels and eta and phi
 	AliEmcalTriggerPartSetup											fTriggerSetup;							///< Setup of the EMCAL / DCAL-PHOS trigger algorithms
 	AliEmcalTriggerPartBadChannelContainer				fBadChannelsEMCAL;					///< Map with bad EMCAL channels
@@ -163,7 +166,7 @@ private:
 	std::vector<AliEmcalTriggerPartRawPatch>			fJetEMCAL8x8;
 	std::vector<AliEmcalTriggerPartRawPatch>			fJetDCALPHOS8x8;
 
-	ClassDef(AliEmcalTriggerMakerPart, 1);
+	ClassDef(AliEmcalTriggerMakerPart, 2);
 };
 
 }
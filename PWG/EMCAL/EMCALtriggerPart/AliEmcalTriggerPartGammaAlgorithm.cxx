@@ -27,6 +27,7 @@
 #include <algorithm>
 #include "AliEmcalTriggerPartGammaAlgorithm.h"
 #include "AliEmcalTriggerPartChannelMap.h"
+#include "AliEmcalTriggerPartPatchSumTable.h"
 #include "AliEmcalTriggerPartSetup.h"
 
 ClassImp(PWG::EMCAL::TriggerPart::AliEmcalTriggerPartGammaAlgorithm);
@@ -47,26 +48,39 @@ AliEmcalTriggerPartAlgorithm()
 AliEmcalTriggerPartGammaAlgorithm::~AliEmcalTriggerPartGammaAlgorithm() {
 }
 
+/**
+ * Build the summed-area table of the channel map and find the patches
+ * @param channels Input channel map
+ * @return vector with trigger patches
+ */
+std::vector<AliEmcalTriggerPartRawPatch> AliEmcalTriggerPartGammaAlgorithm::FindPatches(const AliEmcalTriggerPartChannelMap *channels) const {
+	AliEmcalTriggerPartPatchSumTable sums;
+	sums.Fill(*channels);
+	return FindPatches(channels, &sums);
+}
+
 /**
  * Gamma trigger algorithm
  * 1. Loop over all rows (- patchsize) to get the starting position of the patch
- * 2. Loop over ADC values in the 2x2 window
+ * 2. Reject positions below threshold using the summed-area table, loop over ADC values in the 2x2 window of the other positions
  * 3. Sorting of the trigger patches so that the highest energetic patch (main patch is the first)
  * 4. Fill the output trigger object
  * @param channes Input channel map
+ * @param sums Summed-area table of the channel map
  * @return vector with trigger patches
  */
-std::vector<AliEmcalTriggerPartRawPatch> AliEmcalTriggerPartGammaAlgorithm::FindPatches(const AliEmcalTriggerPartChannelMap *channels) const {
+std::vector<AliEmcalTriggerPartRawPatch> AliEmcalTriggerPartGammaAlgorithm::FindPatches(const AliEmcalTriggerPartChannelMap *channels, const AliEmcalTriggerPartPatchSumTable *sums) const {
 	std::vector<AliEmcalTriggerPartRawPatch> rawpatches;
 
+	const double minthreshold = std::min(fTriggerSetup->GetThresholdGammaHigh(), fTriggerSetup->GetThresholdGammaLow());
 	double adcsum(0);
 	for(unsigned char irow = 0; irow < channels->GetNumberOfRows() - 1; ++irow){
 		for(unsigned char icol = 0; icol < channels->GetNumberOfCols() - 1; ++icol){
+			// reject positions which cannot pass the lower threshold using the summed-area table
+			if(sums->IsBelow(icol, irow, 2, minthreshold)) continue;
+
 			// 2x2 window
-			adcsum = 0;
-			for(unsigned char jrow = 0; jrow < 2; jrow++)
-				for(unsigned char jcol = 0; jcol < 2; jcol++)
-					adcsum += channels->GetADC(icol + jcol, irow + jrow);
+			adcsum = AliEmcalTriggerPartPatchSumTable::SumPatch(*channels, icol, irow, 2);
 
 			// make decision, low and high threshold
 			int triggerBits(0);
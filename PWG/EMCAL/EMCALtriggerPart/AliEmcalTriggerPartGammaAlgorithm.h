@@ -37,6 +37,7 @@ namespace TriggerPart {
 
 class AliEmcalTriggerPartPatchContainer;
 class AliEmcalTriggerPartChannelMap;
+class AliEmcalTriggerPartPatchSumTable;
 
 /**
  * @class AliEmcalTriggerPartGammaAlgorithm
@@ -51,6 +52,7 @@ public:
 	virtual ~AliEmcalTriggerPartGammaAlgorithm();
 
 	std::vector<PWG::EMCAL::TriggerPart::AliEmcalTriggerPartRawPatch> FindPatches(const AliEmcalTriggerPartChannelMap * channels) const;
+	std::vector<PWG::EMCAL::TriggerPart::AliEmcalTriggerPartRawPatch> FindPatches(const AliEmcalTriggerPartChannelMap * channels, const AliEmcalTriggerPartPatchSumTable *sums) const;
 
 	ClassDef(AliEmcalTriggerPartGammaAlgorithm, 1);
 };
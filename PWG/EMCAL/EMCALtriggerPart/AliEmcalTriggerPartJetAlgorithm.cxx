@@ -26,6 +26,7 @@
  ************************************************************************************/
 #include <algorithm>
 #include "AliEmcalTriggerPartChannelMap.h"
+#include "AliEmcalTriggerPartPatchSumTable.h"
 #include "AliEmcalTriggerPartJetAlgorithm.h"
 #include "AliEmcalTriggerPartSetup.h"
 
@@ -47,26 +48,39 @@ AliEmcalTriggerPartJetAlgorithm::AliEmcalTriggerPartJetAlgorithm():
 AliEmcalTriggerPartJetAlgorithm::~AliEmcalTriggerPartJetAlgorithm() {
 }
 
+/**
+ * Build the summed-area table of the channel map and find the patches
+ * @param channels Input channel map
+ * @return vector with trigger patches
+ */
+std::vector<AliEmcalTriggerPartRawPatch> AliEmcalTriggerPartJetAlgorithm::FindPatches(const AliEmcalTriggerPartChannelMap *channels) const {
+	AliEmcalTriggerPartPatchSumTable sums;
+	sums.Fill(*channels);
+	return FindPatches(channels, &sums);
+}
+
 /**
  * Gamma trigger algorithm
  * 1. Loop over all rows (- patchsize) to get the starting position of the patch
- * 2. Loop over ADC values in the 16x16 window
+ * 2. Reject positions below threshold using the summed-area table, loop over ADC values in the 16x16 window of the other positions
  * 3. Sorting of the trigger patches so that the highest energetic patch (main patch is the first)
  * 4. Fill the output trigger object
  * @param channes Input channel map
+ * @param sums Summed-area table of the channel map
  * @return vector with trigger patches
  */
-std::vector<AliEmcalTriggerPartRawPatch> AliEmcalTriggerPartJetAlgorithm::FindPatches(const AliEmcalTriggerPartChannelMap *channels) const {
+std::vector<AliEmcalTriggerPartRawPatch> AliEmcalTriggerPartJetAlgorithm::FindPatches(const AliEmcalTriggerPartChannelMap *channels, const AliEmcalTriggerPartPatchSumTable *sums) const {
 	std::vector<AliEmcalTriggerPartRawPatch> rawpatches;
 
+	const double minthreshold = std::min(fTriggerSetup->GetThresholdJetHigh(), fTriggerSetup->GetThresholdJetLow());
 	double adcsum(0);
 	for(unsigned char irow = 0; irow < channels->GetNumberOfRows() - 15; irow+=4){
 		for(unsigned char icol = 0; icol < channels->GetNumberOfCols() - 15; icol+=4){
+			// reject positions which cannot pass the lower threshold using the summed-area table
+			if(sums->IsBelow(icol, irow, 16, minthreshold)) continue;
+
 			// 16x16 window
-			adcsum = 0;
-			for(unsigned char jrow = 0; jrow < 16; jrow++)
-				for(unsigned char jcol = 0; jcol < 16; jcol++)
-					adcsum += channels->GetADC(icol + jcol, irow + jrow);
+			adcsum = AliEmcalTriggerPartPatchSumTable::SumPatch(*channels, icol, irow, 16);
 
 			// make decision, low and high threshold
 			int triggerBits(0);
@@ -87,17 +101,35 @@ std::vector<AliEmcalTriggerPartRawPatch> AliEmcalTriggerPartJetAlgorithm::FindPa
 	return rawpatches;
 }
 
+/**
+ * Build the summed-area table of the channel map and find the 8x8 patches
+ * @param channels Input channel map
+ * @return vector with trigger patches
+ */
 std::vector<AliEmcalTriggerPartRawPatch> AliEmcalTriggerPartJetAlgorithm::FindPatches8x8(const AliEmcalTriggerPartChannelMap *channels) const {
+	AliEmcalTriggerPartPatchSumTable sums;
+	sums.Fill(*channels);
+	return FindPatches8x8(channels, &sums);
+}
+
+/**
+ * Jet trigger algorithm for 8x8 patches, see FindPatches
+ * @param channels Input channel map
+ * @param sums Summed-area table of the channel map
+ * @return vector with trigger patches
+ */
+std::vector<AliEmcalTriggerPartRawPatch> AliEmcalTriggerPartJetAlgorithm::FindPatches8x8(const AliEmcalTriggerPartChannelMap *channels, const AliEmcalTriggerPartPatchSumTable *sums) const {
 	std::vector<AliEmcalTriggerPartRawPatch> rawpatches;
 
+	const double minthreshold = std::min(fTriggerSetup->GetThresholdJetHigh(), fTriggerSetup->GetThresholdJetLow());
 	double adcsum(0);
 	for(unsigned char irow = 0; irow < channels->GetNumberOfRows() - 8-1; irow+=4){
 		for(unsigned char icol = 0; icol < channels->GetNumberOfCols() - 8-1; icol+=4){
+			// reject positions which cannot pass the lower threshold using the summed-area table
+			if(sums->IsBelow(icol, irow, 8, minthreshold)) continue;
+
 			// 8x8 window
-			adcsum = 0;
-			for(unsigned char jrow = 0; jrow < 8; jrow++)
-				for(unsigned char jcol = 0; jcol < 8; jcol++)
-					adcsum += channels->GetADC(icol + jcol, irow + jrow);
+			adcsum = AliEmcalTriggerPartPatchSumTable::SumPatch(*channels, icol, irow, 8);
 
 			// make decision, low and high threshold
 			int triggerBits(0);
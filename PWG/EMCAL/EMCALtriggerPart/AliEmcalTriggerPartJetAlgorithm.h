@@ -36,6 +36,7 @@ namespace EMCAL {
 namespace TriggerPart {
 
 class AliEmcalTriggerPartPatchContainer;
+class AliEmcalTriggerPartPatchSumTable;
 
 class AliEmcalTriggerPartJetAlgorithm: public AliEmcalTriggerPartAlgorithm {
 public:
@@ -43,7 +44,9 @@ public:
 	virtual ~AliEmcalTriggerPartJetAlgorithm();
 
 	std::vector<PWG::EMCAL::TriggerPart::AliEmcalTriggerPartRawPatch> FindPatches(const AliEmcalTriggerPartChannelMap * channels) const;
+	std::vector<PWG::EMCAL::TriggerPart::AliEmcalTriggerPartRawPatch> FindPatches(const AliEmcalTriggerPartChannelMap * channels, const AliEmcalTriggerPartPatchSumTable *sums) const;
 	std::vector<PWG::EMCAL::TriggerPart::AliEmcalTriggerPartRawPatch> FindPatches8x8(const AliEmcalTriggerPartChannelMap *channels) const;
+	std::vector<PWG::EMCAL::TriggerPart::AliEmcalTriggerPartRawPatch> FindPatches8x8(const AliEmcalTriggerPartChannelMap *channels, const AliEmcalTriggerPartPatchSumTable *sums) const;
 
 	ClassDef(AliEmcalTriggerPartJetAlgorithm, 1);
 };
@@ -0,0 +1,92 @@
+/************************************************************************************
+ * Copyright (C) 2017, Copyright Holders of the ALICE Collaboration                 *
+ * All rights reserved.                                                             *
+ *                                                                                  *
+ * Redistribution and use in source and binary forms, with or without               *
+ * modification, are permitted provided that the following conditions are met:      *
+ *     * Redistributions of source code must retain the above copyright             *
+ *       notice, this list of conditions and the following disclaimer.              *
+ *     * Redistributions in binary form must reproduce the above copyright          *
+ *       notice, this list of conditions and the following disclaimer in the        *
+ *       documentation and/or other materials provided with the distribution.       *
+ *     * Neither the name of the <organization> nor the                             *
+ *       names of its contributors may be used to endorse or promote products       *
+ *       derived from this software without specific prior written permission.      *
+ *                                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND  *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED    *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE           *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY              *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES       *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;     *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND      *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS    *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                     *
+ ************************************************************************************/
+#include <cmath>
+#include "AliEmcalTriggerPartChannelMap.h"
+#include "AliEmcalTriggerPartPatchSumTable.h"
+
+ClassImp(PWG::EMCAL::TriggerPart::AliEmcalTriggerPartPatchSumTable);
+
+using namespace PWG::EMCAL::TriggerPart;
+
+/**
+ * Constructor
+ */
+AliEmcalTriggerPartPatchSumTable::AliEmcalTriggerPartPatchSumTable():
+	TObject(),
+	fNCols(0),
+	fNRows(0),
+	fTolerance(0.),
+	fSums()
+{
+}
+
+/**
+ * Build the summed-area table of the channel map. Each row is accumulated along
+ * the columns and added to the entries of the row before.
+ *
+ * The tolerance bounds the rounding error of a patch sum from the table, and of the
+ * same sum calculated channel by channel, with respect to the exact sum. Both are
+ * below (number of additions) x epsilon x (sum of absolute ADC values), about 1e-13
+ * of the absolute sum for the EMCAL map. The tolerance is set one order of magnitude
+ * above. For non-finite ADC values the tolerance is not finite and no patch is rejected.
+ * @param channels Input channel map
+ */
+void AliEmcalTriggerPartPatchSumTable::Fill(const AliEmcalTriggerPartChannelMap &channels) {
+	fNCols = channels.GetNumberOfCols();
+	fNRows = channels.GetNumberOfRows();
+	fSums.assign((fNCols + 1) * (fNRows + 1), 0.);
+
+	double abssum(0);
+	for(int irow = 0; irow < fNRows; irow++){
+		const double *previous = &fSums[(fNCols + 1) * irow];
+		double *current = &fSums[(fNCols + 1) * (irow + 1)];
+		double rowsum(0);
+		for(int icol = 0; icol < fNCols; icol++){
+			double adc = channels.GetADC(icol, irow);
+			rowsum += adc;
+			abssum += std::abs(adc);
+			current[icol + 1] = previous[icol + 1] + rowsum;
+		}
+	}
+	fTolerance = 1e-12 * abssum;
+}
+
+/**
+ * Sum the ADC values of a patch from the channel map, row by row
+ * @param channels Input channel map
+ * @param col Starting column of the patch
+ * @param row Starting row of the patch
+ * @param size Patch size
+ * @return Patch sum
+ */
+double AliEmcalTriggerPartPatchSumTable::SumPatch(const AliEmcalTriggerPartChannelMap &channels, int col, int row, int size) {
+	double adcsum(0);
+	for(int jrow = 0; jrow < size; jrow++)
+		for(int jcol = 0; jcol < size; jcol++)
+			adcsum += channels.GetADC(col + jcol, row + jrow);
+	return adcsum;
+}
@@ -0,0 +1,106 @@
+/************************************************************************************
+ * Copyright (C) 2017, Copyright Holders of the ALICE Collaboration                 *
+ * All rights reserved.                                                             *
+ *                                                                                  *
+ * Redistribution and use in source and binary forms, with or without               *
+ * modification, are permitted provided that the following conditions are met:      *
+ *     * Redistributions of source code must retain the above copyright             *
+ *       notice, this list of conditions and the following disclaimer.              *
+ *     * Redistributions in binary form must reproduce the above copyright          *
+ *       notice, this list of conditions and the following disclaimer in the        *
+ *       documentation and/or other materials provided with the distribution.       *
+ *     * Neither the name of the <organization> nor the                             *
+ *       names of its contributors may be used to endorse or promote products       *
+ *       derived from this software without specific prior written permission.      *
+ *                                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND  *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED    *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE           *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY              *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES       *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;     *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND      *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS    *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                     *
+ ************************************************************************************/
+#ifndef ALIEMCALTRIGGERPARTPATCHSUMTABLE_H
+#define ALIEMCALTRIGGERPARTPATCHSUMTABLE_H
+
+#include <vector>
+#include <TObject.h>
+
+namespace PWG {
+
+namespace EMCAL {
+
+namespace TriggerPart {
+
+class AliEmcalTriggerPartChannelMap;
+
+/**
+ * @class AliEmcalTriggerPartPatchSumTable
+ * @brief Summed-area table of a trigger channel map
+ *
+ * Stores for each position (col, row) the sum of all ADC values in the rectangle
+ * spanned by (0, 0) and (col - 1, row - 1). Once filled, the sum of a patch of any
+ * size is obtained from four entries of the table, independent of the patch size.
+ * The table is built once per event and channel map and shared by all patch finding
+ * algorithms running on the same map.
+ *
+ * Sums from the table differ from the sums over the channels at the level of the
+ * rounding precision. The table is therefore used to reject patch positions
+ * below threshold (IsBelow), the ADC of the accepted patches is summed from the
+ * channel map in the same order as in the original algorithms.
+ */
+class AliEmcalTriggerPartPatchSumTable : public TObject {
+public:
+	AliEmcalTriggerPartPatchSumTable();
+	virtual ~AliEmcalTriggerPartPatchSumTable() {}
+
+	void Fill(const AliEmcalTriggerPartChannelMap &channels);
+
+	/**
+	 * Get the sum of the ADC values in the patch of size x size channels starting at (col, row)
+	 * @param col Starting column of the patch
+	 * @param row Starting row of the patch
+	 * @param size Patch size
+	 * @return Patch sum, with rounding error up to GetTolerance()
+	 */
+	double GetPatchSum(int col, int row, int size) const {
+		return GetEntry(col + size, row + size) - GetEntry(col, row + size) - GetEntry(col + size, row) + GetEntry(col, row);
+	}
+	/**
+	 * Check whether the exact patch sum is guaranteed to be not above the threshold
+	 * @param col Starting column of the patch
+	 * @param row Starting row of the patch
+	 * @param size Patch size
+	 * @param threshold Threshold to compare to
+	 * @return True if the patch cannot pass the threshold, false if the patch has to be summed
+	 */
+	bool IsBelow(int col, int row, int size, double threshold) const {
+		return GetPatchSum(col, row, size) + fTolerance <= threshold;
+	}
+	/**
+	 * Get the absolute tolerance of sums obtained from the table
+	 * @return Tolerance
+	 */
+	double GetTolerance() const { return fTolerance; }
+
+	static double SumPatch(const AliEmcalTriggerPartChannelMap &channels, int col, int row, int size);
+
+protected:
+	double GetEntry(int col, int row) const { return fSums[(fNCols + 1) * row + col]; }
+
+	int                     fNCols;           ///< Number of columns of the channel map
+	int                     fNRows;           ///< Number of rows of the channel map
+	double                  fTolerance;       ///< Maximum rounding difference between table sums and channel sums
+	std::vector<double>     fSums;            //!<! Summed-area table, (fNCols + 1) x (fNRows + 1) entries
+
+	ClassDef(AliEmcalTriggerPartPatchSumTable, 1);
+};
+
+}
+}
+}
+#endif /* ALIEMCALTRIGGERPARTPATCHSUMTABLE_H */
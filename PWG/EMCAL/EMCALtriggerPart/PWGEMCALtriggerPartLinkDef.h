@@ -20,5 +20,6 @@
 #pragma link C++ class PWG::EMCAL::TriggerPart::AliEmcalTriggerPartChannelMap+;
 #pragma link C++ class PWG::EMCAL::TriggerPart::AliEmcalTriggerPartChannel+;
 #pragma link C++ class PWG::EMCAL::TriggerPart::AliEmcalTriggerPartMapping+;
+#pragma link C++ class PWG::EMCAL::TriggerPart::AliEmcalTriggerPartPatchSumTable+;
 #pragma link C++ class PWG::EMCAL::TriggerPart::AliEmcalTriggerPartSetup+;
 #endif
@@ -32,6 +32,10 @@
 #include <TFile.h>
 #include <TTree.h>
 #include <TF1.h>
+#include <TRandom3.h>
+#include <TROOT.h>
+#include <thread>
+#include <vector>
 
 #include "AliGlauberNucleon.h"
 #include "AliGlauberNucleus.h"
@@ -172,7 +176,27 @@ AliGlauberMC::AliGlauberMC(Option_t* NA, Option_t* NB, Double_t xsect) :
   fOmega(0),
   fSig0(0),
   fLambda(0),
-  fSigFluc(0)
+  fSigFluc(0),
+  fSeed(4357),
+  fEventsPerBlock(10000),
+  fRandom(0),
+  fPosXA(),
+  fPosYA(),
+  fSigNNA(),
+  fNCollA(),
+  fPosXB(),
+  fPosYB(),
+  fSigNNB(),
+  fNCollB(),
+  fGridStart(),
+  fGridIndex(),
+  fGridCell(),
+  fGridNX(0),
+  fGridNY(0),
+  fGridX0(0),
+  fGridY0(0),
+  fGridWX(0),
+  fGridWY(0)
 {
   //ctor
   for (UInt_t i=0; i<(sizeof(fdNdEtaParam)/sizeof(fdNdEtaParam[0])); i++)
@@ -322,7 +346,27 @@ AliGlauberMC::AliGlauberMC(const AliGlauberMC& in):
   fOmega(in.fOmega),
   fSig0(in.fSig0),
   fLambda(in.fLambda),
-  fSigFluc(in.fSigFluc)
+  fSigFluc(in.fSigFluc),
+  fSeed(in.fSeed),
+  fEventsPerBlock(in.fEventsPerBlock),
+  fRandom(0),
+  fPosXA(in.fPosXA),
+  fPosYA(in.fPosYA),
+  fSigNNA(in.fSigNNA),
+  fNCollA(in.fNCollA),
+  fPosXB(in.fPosXB),
+  fPosYB(in.fPosYB),
+  fSigNNB(in.fSigNNB),
+  fNCollB(in.fNCollB),
+  fGridStart(),
+  fGridIndex(),
+  fGridCell(),
+  fGridNX(0),
+  fGridNY(0),
+  fGridX0(0),
+  fGridY0(0),
+  fGridWX(0),
+  fGridWY(0)
 {
   //copy ctor
   memcpy(fdNdEtaParam,in.fdNdEtaParam,sizeof(fdNdEtaParam));
@@ -453,6 +497,16 @@ AliGlauberMC& AliGlauberMC::operator=(const AliGlauberMC& in)
   fSxyCom=in.fSxyCom;
   fX=in.fX;
   fNpp=in.fNpp;
+  fSeed=in.fSeed;
+  fEventsPerBlock=in.fEventsPerBlock;
+  fPosXA=in.fPosXA;
+  fPosYA=in.fPosYA;
+  fSigNNA=in.fSigNNA;
+  fNCollA=in.fNCollA;
+  fPosXB=in.fPosXB;
+  fPosYB=in.fPosYB;
+  fSigNNB=in.fSigNNB;
+  fNCollB=in.fNCollB;
   return *this;
 }
 
@@ -469,11 +523,15 @@ Bool_t AliGlauberMC::CalcEvent(Double_t bgen)
     }
   }
 
-  fANucleus.ThrowNucleons(-bgen/2.);
+  fANucleus.ThrowNucleons(-bgen/2.,fRandom);
   fNucleonsA = fANucleus.GetNucleons();
   fAN = fANucleus.GetN();
   fQAN = fAN * 3;
   //fAN = 3 * fANucleus.GetN(); // for Pb, Number of quark = 3*208;
+  fPosXA.resize(fAN);
+  fPosYA.resize(fAN);
+  fSigNNA.resize(fAN);
+  fNCollA.assign(fAN,0);
   for (Int_t i = 0; i<fAN; i++)
   {
     AliGlauberNucleon *nucleonA=(AliGlauberNucleon*)(fNucleonsA->UncheckedAt(i));
@@ -481,12 +539,19 @@ Bool_t AliGlauberMC::CalcEvent(Double_t bgen)
     nucleonA->SetSigNN(fXSect);
     if (fDoFluc)
       nucleonA->SetSigNN(fSigFluc->GetRandom());
+    fPosXA[i] = nucleonA->GetX();
+    fPosYA[i] = nucleonA->GetY();
+    fSigNNA[i] = nucleonA->GetSigNN();
   }
-  fBNucleus.ThrowNucleons(bgen/2.);
+  fBNucleus.ThrowNucleons(bgen/2.,fRandom);
   fNucleonsB = fBNucleus.GetNucleons();
   //fBN = 3 * fBNucleus.GetN(); // Number of quark = number of nucleus*3;
   fBN = fBNucleus.GetN();
   fQBN = fBN * 3;
+  fPosXB.resize(fBN);
+  fPosYB.resize(fBN);
+  fSigNNB.resize(fBN);
+  fNCollB.assign(fBN,0);
   for (Int_t i = 0; i<fBN; i++)
   {
     AliGlauberNucleon *nucleonB=(AliGlauberNucleon*)(fNucleonsB->UncheckedAt(i));
@@ -494,6 +559,9 @@ Bool_t AliGlauberMC::CalcEvent(Double_t bgen)
     nucleonB->SetSigNN(fXSect);
     if (fDoFluc)
       nucleonB->SetSigNN(fSigFluc->GetRandom());
+    fPosXB[i] = nucleonB->GetX();
+    fPosYB[i] = nucleonB->GetY();
+    fSigNNB[i] = nucleonB->GetSigNN();
   }
 
   if (fDoFluc) {
@@ -507,37 +575,67 @@ Bool_t AliGlauberMC::CalcEvent(Double_t bgen)
   // "ball" diameter = distance at which two balls interact
   Double_t d2 = (Double_t)fXSect/(TMath::Pi()*10); // in fm^2
 
+  // with fluctuations the largest sigNN of the event sets the reach of a nucleon
+  Double_t d2max = d2;
+  if (fDoFluc) {
+    Double_t sigmax = 0;
+    for (Int_t j = 0; j<fAN; j++) sigmax = TMath::Max(sigmax,fSigNNA[j]);
+    for (Int_t i = 0; i<fBN; i++) sigmax = TMath::Max(sigmax,fSigNNB[i]);
+    d2max = sigmax/(TMath::Pi()*10);
+  }
+  BuildGrid(d2max>0 ? TMath::Sqrt(d2max) : 0);
+
   Double_t bNN   = 0;
   Double_t Nco   = 0;
   Double_t Ncohc = 0; // hard core
 
-  // for each of the A nucleons in nucleus B
+  // for each of the nucleons in nucleus B, test the nucleons of nucleus A
+  // in the neighbouring transverse cells
   for (Int_t i = 0; i<fBN; i++)
   {
-    AliGlauberNucleon *nucleonB=(AliGlauberNucleon*)(fNucleonsB->UncheckedAt(i));
-    for (Int_t j = 0 ; j < fAN ; j++)
+    const Double_t xB = fPosXB[i];
+    const Double_t yB = fPosYB[i];
+    const Double_t cx = TMath::Floor((xB-fGridX0)/fGridWX);
+    const Double_t cy = TMath::Floor((yB-fGridY0)/fGridWY);
+    if (cx < -1 || cx > fGridNX || cy < -1 || cy > fGridNY) continue;
+    const Int_t ixmin = TMath::Max(0,(Int_t)cx-1), ixmax = TMath::Min(fGridNX-1,(Int_t)cx+1);
+    const Int_t iymin = TMath::Max(0,(Int_t)cy-1), iymax = TMath::Min(fGridNY-1,(Int_t)cy+1);
+    for (Int_t iy = iymin; iy <= iymax; iy++)
     {
-      AliGlauberNucleon *nucleonA=(AliGlauberNucleon*)(fNucleonsA->UncheckedAt(j));
-      Double_t dx = nucleonB->GetX()-nucleonA->GetX();
-      Double_t dy = nucleonB->GetY()-nucleonA->GetY();
-      Double_t dij = dx*dx+dy*dy;
-      if (fDoFluc) {
-	//fXSect = nucleonA->GetSigNN();
-	//fXSect = (nucleonA->GetSigNN()+nucleonB->GetSigNN())/2.;
-	fXSect = TMath::Max(nucleonA->GetSigNN(),nucleonB->GetSigNN());
-	d2 = (Double_t)fXSect/(TMath::Pi()*10); // in fm^2
-      }
-      if (dij < d2)
+      for (Int_t ix = ixmin; ix <= ixmax; ix++)
       {
-	bNN += dij;
-	++Nco;
-        nucleonB->Collide();
-        nucleonA->Collide();
-	if (dij<d2/4)
-	  ++Ncohc;
+        const Int_t cell = iy*fGridNX+ix;
+        for (Int_t k = fGridStart[cell]; k < fGridStart[cell+1]; k++)
+        {
+          const Int_t j = fGridIndex[k];
+          Double_t dx = xB-fPosXA[j];
+          Double_t dy = yB-fPosYA[j];
+          Double_t dij = dx*dx+dy*dy;
+          if (fDoFluc) {
+            d2 = TMath::Max(fSigNNA[j],fSigNNB[i])/(TMath::Pi()*10); // in fm^2
+          }
+          if (dij < d2)
+          {
+            bNN += dij;
+            ++Nco;
+            fNCollB[i]++;
+            fNCollA[j]++;
+            if (dij<d2/4)
+              ++Ncohc;
+          }
+        }
       }
     }
   }
+  // the pair loop used to leave the cross section of the last pair in fXSect
+  if (fDoFluc && fAN>0 && fBN>0)
+    fXSect = TMath::Max(fSigNNA[fAN-1],fSigNNB[fBN-1]);
+
+  // keep the nucleon objects in sync (GetNucleons, Draw)
+  for (Int_t j = 0; j<fAN; j++)
+    ((AliGlauberNucleon*)(fNucleonsA->UncheckedAt(j)))->SetNColl(fNCollA[j]);
+  for (Int_t i = 0; i<fBN; i++)
+    ((AliGlauberNucleon*)(fNucleonsB->UncheckedAt(i)))->SetNColl(fNCollB[i]);
 
   if (Nco>0) {
     fNcollw = Ncohc;
@@ -554,6 +652,52 @@ Bool_t AliGlauberMC::CalcEvent(Double_t bgen)
   return CalcResults(bgen);
 }
 
+//______________________________________________________________________________
+void AliGlauberMC::BuildGrid(Double_t cell)
+{
+  // sort the nucleons of nucleus A into transverse cells no smaller than the
+  // interaction distance, so that only the neighbouring cells of a nucleon of
+  // nucleus B have to be tested
+  Double_t xmin = 0, xmax = 0, ymin = 0, ymax = 0;
+  for (Int_t j = 0; j<fAN; j++)
+  {
+    if (j==0 || fPosXA[j]<xmin) xmin = fPosXA[j];
+    if (j==0 || fPosXA[j]>xmax) xmax = fPosXA[j];
+    if (j==0 || fPosYA[j]<ymin) ymin = fPosYA[j];
+    if (j==0 || fPosYA[j]>ymax) ymax = fPosYA[j];
+  }
+  fGridNX = 1;
+  fGridNY = 1;
+  if (cell>0)
+  {
+    fGridNX = TMath::Max(1,TMath::Min(kMaxGridCells,(Int_t)((xmax-xmin)/cell)));
+    fGridNY = TMath::Max(1,TMath::Min(kMaxGridCells,(Int_t)((ymax-ymin)/cell)));
+  }
+  fGridX0 = xmin;
+  fGridY0 = ymin;
+  fGridWX = TMath::Max((xmax-xmin)/fGridNX,cell);
+  fGridWY = TMath::Max((ymax-ymin)/fGridNY,cell);
+  if (fGridWX<=0) fGridWX = 1;
+  if (fGridWY<=0) fGridWY = 1;
+
+  const Int_t ncells = fGridNX*fGridNY;
+  fGridStart.assign(ncells+1,0);
+  fGridIndex.resize(fAN);
+  fGridCell.resize(fAN);
+  for (Int_t j = 0; j<fAN; j++)
+  {
+    Int_t ix = TMath::Min(fGridNX-1,(Int_t)((fPosXA[j]-fGridX0)/fGridWX));
+    Int_t iy = TMath::Min(fGridNY-1,(Int_t)((fPosYA[j]-fGridY0)/fGridWY));
+    fGridCell[j] = iy*fGridNX+ix;
+    fGridStart[fGridCell[j]+1]++;
+  }
+  for (Int_t c = 0; c<ncells; c++) fGridStart[c+1] += fGridStart[c];
+  // fill: fGridStart[c] advances to the end of cell c, shift it back afterwards
+  for (Int_t j = 0; j<fAN; j++) fGridIndex[fGridStart[fGridCell[j]]++] = j;
+  for (Int_t c = ncells; c>0; c--) fGridStart[c] = fGridStart[c-1];
+  fGridStart[0] = 0;
+}
+
 //______________________________________________________________________________
 Bool_t AliGlauberMC::CalcResults(Double_t bgen)
 {
@@ -654,15 +798,14 @@ Bool_t AliGlauberMC::CalcResults(Double_t bgen)
 
   for (Int_t i = 0; i<fAN; i++)
   {
-    AliGlauberNucleon *nucleonA=(AliGlauberNucleon*)(fNucleonsA->UncheckedAt(i));
-    Double_t oXA = nucleonA->GetX();
-    Double_t oYA = nucleonA->GetY();
+    Double_t oXA = fPosXA[i];
+    Double_t oYA = fPosYA[i];
     //fMeanOXSystem  += oXA;
     //fMeanOYSystem  += oYA;
     fMeanOXA  += oXA;
     fMeanOYA  += oYA;
 
-    if(nucleonA->IsWounded())
+    if(fNCollA[i]>0)
     {
       fONpart++;
       fMeanOXParts  += oXA;
@@ -676,13 +819,12 @@ Bool_t AliGlauberMC::CalcResults(Double_t bgen)
 
   for (Int_t i = 0; i<fBN; i++)
   {
-    AliGlauberNucleon *nucleonB=(AliGlauberNucleon*)(fNucleonsB->UncheckedAt(i));
-    Double_t oXB=nucleonB->GetX();
-    Double_t oYB=nucleonB->GetY();
+    Double_t oXB=fPosXB[i];
+    Double_t oYB=fPosYB[i];
     
-    if(nucleonB->IsWounded())
+    if(fNCollB[i]>0)
     {
-      Int_t oNcoll = nucleonB->GetNColl();
+      Int_t oNcoll = fNCollB[i];
       fONpart++;
       fMeanOXParts  += oXB;
       fMeanOXColl  += oXB*oNcoll;
@@ -731,9 +873,8 @@ Bool_t AliGlauberMC::CalcResults(Double_t bgen)
   //////////////////////////////////////////////////////////////////
   for (Int_t i = 0; i<fAN; i++)
   {
-    AliGlauberNucleon *nucleonA=(AliGlauberNucleon*)(fNucleonsA->UncheckedAt(i));
-    Double_t xAA = nucleonA->GetX(); // X
-    Double_t yAA = nucleonA->GetY(); // Y
+    Double_t xAA = fPosXA[i]; // X
+    Double_t yAA = fPosYA[i]; // Y
     Double_t xAPart = xAA - fMeanOXParts; // X'
     Double_t yAPart = yAA - fMeanOYParts; // Y'
     Double_t r2APart = xAPart *xAPart+yAPart*yAPart;     // r'^2
@@ -777,7 +918,7 @@ Bool_t AliGlauberMC::CalcResults(Double_t bgen)
     fMeanY2 += yAA * yAA;
     fMeanXY += xAA * yAA;
     
-    if(nucleonA->IsWounded())
+    if(fNCollA[i]>0)
      {
        //Wounded
       fNpart++;
@@ -836,9 +977,8 @@ Bool_t AliGlauberMC::CalcResults(Double_t bgen)
   
   for (Int_t i = 0; i<fBN; i++)
     {
-      AliGlauberNucleon *nucleonB=(AliGlauberNucleon*)(fNucleonsB->UncheckedAt(i));
-      Double_t xBB = nucleonB->GetX();
-      Double_t yBB = nucleonB->GetY();
+      Double_t xBB = fPosXB[i];
+      Double_t yBB = fPosYB[i];
       // for Wounded
       Double_t xBPart = xBB - fMeanOXParts; // X'
       Double_t yBPart = yBB - fMeanOYParts; // Y'
@@ -899,9 +1039,9 @@ Bool_t AliGlauberMC::CalcResults(Double_t bgen)
       fMeanY2 += yBB*yBB;
       fMeanXY += xBB*yBB;
       
-      if(nucleonB->IsWounded())
+      if(fNCollB[i]>0)
 	{
-	  Int_t ncoll = nucleonB->GetNColl();
+	  Int_t ncoll = fNCollB[i];
 	  fNpart++;
 	  fMeanXParts  += xBPart;
 	  fMeanXColl  += xBColl*ncoll;
@@ -1267,7 +1407,7 @@ Int_t AliGlauberMC::NegativeBinomialRandom(Int_t k, Double_t nmean) const
   {
     array[i] = NegativeBinomialDistribution(i,k,nmean) + array[i-1];
   }
-  Double_t r = gRandom->Uniform(0,1);
+  Double_t r = Rnd()->Uniform(0,1);
   return TMath::BinarySearch(fMaxPlot,array,r)+2;
 
 }
@@ -1278,7 +1418,7 @@ Int_t AliGlauberMC::NegativeBinomialRandomSV(Double_t k, Double_t nbar) const
   // negative binomial distribution generator, S. Voloshin, 09-May-2007
   Double_t sum=0.;
   Int_t i=0;
-  Double_t ran=gRandom->Rndm();
+  Double_t ran=Rnd()->Rndm();
   Double_t trm=1./pow(1.+nbar/k,k);
   if (trm==0.)
   {
@@ -1308,7 +1448,7 @@ Int_t AliGlauberMC::DoubleNegativeBinomialRandom( Int_t k,
   {
     array[i] = alpha*NegativeBinomialDistribution(i,k,nmean)+(1-alpha)*NegativeBinomialDistribution(i,k2,nmean2) + array[i-1];
   }
-  Double_t r = gRandom->Uniform(0,1);
+  Double_t r = Rnd()->Uniform(0,1);
   return TMath::BinarySearch(fMaxPlot,array,r)+2;
 }
 
@@ -1506,7 +1646,7 @@ Bool_t AliGlauberMC::NextEvent(Double_t bgen)
   {
     if(bgen<0||!succes) //get impactparameter
     {
-      bgen = TMath::Sqrt((fBMax*fBMax-fBMin*fBMin)*gRandom->Rndm()+fBMin*fBMin);
+      bgen = TMath::Sqrt((fBMax*fBMax-fBMin*fBMin)*Rnd()->Rndm()+fBMin*fBMin);
     }
     if ( (succes=CalcEvent(bgen)) ) break; //ends if we have particparts
   }
@@ -1682,18 +1822,100 @@ Double_t AliGlauberMC::GetPsi4m2() const
 }
 */
 //______________________________________________________________________________
-void AliGlauberMC::Run(Int_t nevents)
+TRandom *AliGlauberMC::Rnd() const
 {
-  //example run
-  cout << "Generating " << nevents << " events..." << endl;
-  TString name(Form("nt_%s_%s",fANucleus.GetName(),fBNucleus.GetName()));
-  TString title(Form("%s + %s (x-sect = %d mb)",fANucleus.GetName(),fBNucleus.GetName(),(Int_t) fXSect));
+  //generator of the current event block, gRandom outside of Run(nevents,nthreads)
+  return fRandom ? fRandom : gRandom;
+}
+
+//______________________________________________________________________________
+TNtuple *AliGlauberMC::CreateNtuple()
+{
+  //create the result ntuple if not there yet
   if (fnt == 0)
   {
+    TString name(Form("nt_%s_%s",fANucleus.GetName(),fBNucleus.GetName()));
+    TString title(Form("%s + %s (x-sect = %d mb)",fANucleus.GetName(),fBNucleus.GetName(),(Int_t) fXSect));
     fnt = new TNtuple(name,title,
                       "Npart:Ncoll:B:MeanX:MeanY:MeanX2:MeanY2:MeanXY:VarX:VarY:VarXY:MeanXSystem:MeanYSystem:MeanXA:MeanYA:MeanXB:MeanYB:VarE:Stoa:VarEColl:VarECom:VarEPart:VarEPartColl:VarEPartCom:dNdEta:dNdEtaGBW:dNdEtaTwoNBD:xsect:tAA:Epsl2:Epsl3:Epsl4:Epsl5:E2Coll:E3Coll:E4Coll:E5Coll:E2Com:E3Com:E4Com:E5Com:Psi2:Psi3:Psi4:Psi5:BNN:signn:Ncollw");
     fnt->SetDirectory(0);
   }
+  return fnt;
+}
+
+//______________________________________________________________________________
+void AliGlauberMC::FillNtupleValues(Float_t *v) const
+{
+  //ntuple variables of the current event, v has kNNtupleVars entries
+  v[0]  = GetNpart();
+  v[1]  = GetNcoll();
+  v[2]  = fBMC;
+  v[3]  = fMeanXParts;
+  v[4]  = fMeanYParts;
+  v[5]  = fMeanX2Parts;
+  v[6]  = fMeanY2Parts;
+  v[7]  = fMeanXYParts;
+  v[8]  = fSx2Parts;
+  v[9]  = fSy2Parts;
+  v[10] = fSxyParts;
+  v[11] = fMeanXSystem;
+  v[12] = fMeanYSystem;
+  v[13] = fMeanXA;
+  v[14] = fMeanYA;
+  v[15] = fMeanXB;
+  v[16] = fMeanYB;
+  v[17] = GetEccentricity();
+  v[18] = GetStoa();
+  v[19] = GetEccentricityColl();
+  v[20] = GetEccentricityCom();
+  v[21] = GetEccentricityPart();
+  v[22] = GetEccentricityPartColl();
+  v[23] = GetEccentricityPartCom();
+  if (fDoPartProd)
+  {
+    v[24] = GetdNdEta();
+    v[25] = GetdNdEta();
+    v[26] = v[24]+v[25];
+  }
+  else
+  {
+    v[24] = 0;
+    v[25] = 0;
+    v[26] = 0;
+  }
+  v[27]=fXSect;
+
+  Float_t mytAA=-999;
+  if (GetNcoll()>0) mytAA=GetNcoll()/fXSect;
+  v[28]=mytAA;
+  //_____________epsilon2,3,4,4_______
+  v[29] = GetEpsilon2Part();
+  v[30] = GetEpsilon3Part();
+  v[31] = GetEpsilon4Part();
+  v[32] = GetEpsilon5Part();
+  v[33] = GetEpsilon2Coll();
+  v[34] = GetEpsilon3Coll();
+  v[35] = GetEpsilon4Coll();
+  v[36] = GetEpsilon5Coll();
+  v[37] = GetEpsilon2Com();
+  v[38] = GetEpsilon3Com();
+  v[39] = GetEpsilon4Com();
+  v[40] = GetEpsilon5Com();
+  v[41] = GetPsi2();
+  v[42] = GetPsi3();
+  v[43] = GetPsi4();
+  v[44] = GetPsi5();
+  v[45] = fBNN;
+  v[46] = fXSect;
+  v[47] = fNcollw;
+}
+
+//______________________________________________________________________________
+void AliGlauberMC::Run(Int_t nevents)
+{
+  //example run
+  cout << "Generating " << nevents << " events..." << endl;
+  CreateNtuple();
   Int_t q = 0;
   Int_t u = 0;
   for (Int_t i = 0; i<nevents; i++)
@@ -1706,73 +1928,108 @@ void AliGlauberMC::Run(Int_t nevents)
     }
 
     q++;
-    Float_t v[48];
-    v[0]  = GetNpart();
-    v[1]  = GetNcoll();
-    v[2]  = fBMC;
-    v[3]  = fMeanXParts;
-    v[4]  = fMeanYParts;
-    v[5]  = fMeanX2Parts;
-    v[6]  = fMeanY2Parts;
-    v[7]  = fMeanXYParts;
-    v[8]  = fSx2Parts;
-    v[9]  = fSy2Parts;
-    v[10] = fSxyParts;
-    v[11] = fMeanXSystem;
-    v[12] = fMeanYSystem;
-    v[13] = fMeanXA;
-    v[14] = fMeanYA;
-    v[15] = fMeanXB;
-    v[16] = fMeanYB;
-    v[17] = GetEccentricity();
-    v[18] = GetStoa();
-    v[19] = GetEccentricityColl();
-    v[20] = GetEccentricityCom();
-    v[21] = GetEccentricityPart();
-    v[22] = GetEccentricityPartColl();
-    v[23] = GetEccentricityPartCom();
-    if (fDoPartProd)
+    Float_t v[kNNtupleVars];
+    FillNtupleValues(v);
+
+    //always at the end
+    fnt->Fill(v);
+
+    if ((i%100)==0) std::cout << "Generating Event # " << i << "... \r" << flush;
+  }
+  std::cout << "Generating Event # " << nevents << "... \r" << endl << "Done! Succesfull events:  " << q << "  discarded events:  " << u <<"."<< endl;
+}
+
+//______________________________________________________________________________
+void AliGlauberMC::Run(Int_t nevents, Int_t nthreads)
+{
+  //run on nthreads worker threads
+  //The events are generated in blocks of fEventsPerBlock events, block k
+  //with its own TRandom3 seeded from fSeed and k. Blocks are written to the
+  //ntuple in block order, so the output does not depend on nthreads.
+  if (fDoFluc)
+  {
+    cout << "Fluctuating cross section needs gRandom, running single-threaded" << endl;
+    Run(nevents);
+    return;
+  }
+  if (nthreads<1) nthreads = 1;
+  if (nthreads>1) ROOT::EnableThreadSafety();
+  if (fEventsPerBlock<1) fEventsPerBlock = 10000;
+  cout << "Generating " << nevents << " events on " << nthreads << " threads..." << endl;
+  CreateNtuple();
+
+  //one generator per thread, set up here since TF1 creation is not thread safe
+  std::vector<AliGlauberMC*> workers(nthreads);
+  for (Int_t t = 0; t<nthreads; t++)
+  {
+    AliGlauberMC *w = new AliGlauberMC(fANucleus.GetName(),fBNucleus.GetName(),fXSect);
+    AliGlauberNucleus *nuc[2] = {&w->fANucleus,&w->fBNucleus};
+    const AliGlauberNucleus *src[2] = {&fANucleus,&fBNucleus};
+    for (Int_t n = 0; n<2; n++)
     {
-      v[24] = GetdNdEta();
-      v[25] = GetdNdEta();
-      v[26] = v[24]+v[25];
+      nuc[n]->SetR(src[n]->GetR());
+      nuc[n]->SetA(src[n]->GetA());
+      nuc[n]->SetW(src[n]->GetW());
+      nuc[n]->SetMinDist(src[n]->GetMinDist());
+      nuc[n]->PrepareRandomRadius();
     }
-    else
+    w->fBMin = fBMin;
+    w->fBMax = fBMax;
+    w->fMultType = fMultType;
+    memcpy(w->fdNdEtaParam,fdNdEtaParam,sizeof(fdNdEtaParam));
+    w->fX = fX;
+    w->fNpp = fNpp;
+    w->fDoPartProd = fDoPartProd;
+    workers[t] = w;
+  }
+
+  const Int_t nblocks = (nevents+fEventsPerBlock-1)/fEventsPerBlock;
+  std::vector<std::vector<Float_t> > rows(nthreads);
+  Int_t q = 0;
+  Int_t u = 0;
+  for (Int_t first = 0; first<nblocks; first += nthreads)
+  {
+    const Int_t nround = TMath::Min(nthreads,nblocks-first);
+    std::vector<std::thread> threads;
+    for (Int_t t = 0; t<nround; t++)
     {
-      v[24] = 0;
-      v[25] = 0;
-      v[26] = 0;
+      threads.push_back(std::thread([this,&workers,&rows,first,t,nevents]() {
+        const Int_t block = first+t;
+        const Int_t nev = TMath::Min(fEventsPerBlock,nevents-block*fEventsPerBlock);
+        UInt_t seed = fSeed + 7919u*(UInt_t)(block+1);
+        TRandom3 rnd(seed ? seed : 1);
+        AliGlauberMC *w = workers[t];
+        w->fRandom = &rnd;
+        rows[t].clear();
+        Float_t v[kNNtupleVars];
+        for (Int_t i = 0; i<nev; i++)
+        {
+          if (!w->NextEvent()) continue;
+          w->FillNtupleValues(v);
+          rows[t].insert(rows[t].end(),v,v+kNNtupleVars);
+        }
+        w->fRandom = 0;
+      }));
     }
-    v[27]=fXSect;
-
-    Float_t mytAA=-999;
-    if (GetNcoll()>0) mytAA=GetNcoll()/fXSect;
-    v[28]=mytAA;
-    //_____________epsilon2,3,4,4_______
-    v[29] = GetEpsilon2Part();
-    v[30] = GetEpsilon3Part();
-    v[31] = GetEpsilon4Part();
-    v[32] = GetEpsilon5Part();
-    v[33] = GetEpsilon2Coll();
-    v[34] = GetEpsilon3Coll();
-    v[35] = GetEpsilon4Coll();
-    v[36] = GetEpsilon5Coll();
-    v[37] = GetEpsilon2Com();
-    v[38] = GetEpsilon3Com();
-    v[39] = GetEpsilon4Com();
-    v[40] = GetEpsilon5Com();
-    v[41] = GetPsi2();
-    v[42] = GetPsi3();
-    v[43] = GetPsi4();
-    v[44] = GetPsi5();
-    v[45] = fBNN;
-    v[46] = fXSect;
-    v[47] = fNcollw;
+    for (Int_t t = 0; t<nround; t++) threads[t].join();
 
-    //always at the end
-    fnt->Fill(v);
+    for (Int_t t = 0; t<nround; t++)
+    {
+      const Int_t nev = TMath::Min(fEventsPerBlock,nevents-(first+t)*fEventsPerBlock);
+      const Int_t nrows = rows[t].size()/kNNtupleVars;
+      for (Int_t r = 0; r<nrows; r++) fnt->Fill(&rows[t][r*kNNtupleVars]);
+      q += nrows;
+      u += nev-nrows;
+    }
+    std::cout << "Generating Event # " << TMath::Min(nevents,(first+nround)*fEventsPerBlock) << "... \r" << flush;
+  }
 
-    if ((i%100)==0) std::cout << "Generating Event # " << i << "... \r" << flush;
+  for (Int_t t = 0; t<nthreads; t++)
+  {
+    fEvents += workers[t]->fEvents;
+    fTotalEvents += workers[t]->fTotalEvents;
+    if (workers[t]->fMaxNpartFound > fMaxNpartFound) fMaxNpartFound = workers[t]->fMaxNpartFound;
+    delete workers[t];
   }
   std::cout << "Generating Event # " << nevents << "... \r" << endl << "Done! Succesfull events:  " << q << "  discarded events:  " << u <<"."<< endl;
 }
@@ -16,9 +16,11 @@
 #include "AliGlauberNucleus.h"
 #include <Riostream.h>
 #include <TNamed.h>
+#include <vector>
 
 class TObjArray;
 class TNtuple;
+class TRandom;
 
 using std::cout;
 using std::endl;
@@ -39,6 +41,7 @@ public:
    void         Draw(Option_t* option);
 
    void         Run(Int_t nevents);
+   void         Run(Int_t nevents, Int_t nthreads);
    Bool_t       NextEvent(Double_t bgen=-1);
    Bool_t       CalcEvent(Double_t bgen);
 
@@ -96,6 +99,8 @@ public:
    void   SetBmax(Double_t bmax)      {fBMax = bmax;}
    void   SetMinDistance(Double_t d)  {fANucleus.SetMinDist(d); fBNucleus.SetMinDist(d);}
    void   SetDoPartProduction(Bool_t b) { fDoPartProd = b; }
+   void   SetSeed(UInt_t seed)        {fSeed = seed;}
+   void   SetEventsPerBlock(Int_t n)  {fEventsPerBlock = n;}
    void   Setr(Double_t r)  {fANucleus.SetR(r); fBNucleus.SetR(r);}
    void   Seta(Double_t a)  {fANucleus.SetA(a); fBNucleus.SetA(a);}
    void   SetDoFluc(Double_t omega, Double_t sig0, Double_t lam, Bool_t on=kTRUE) 
@@ -251,9 +256,36 @@ private:
    Double_t     fSig0;           //regularization parameter 
    Double_t     fLambda;         //lambda parameter
    TF1         *fSigFluc;        //!parameterization for fluctuating sigNN
+   UInt_t       fSeed;           //Base seed of the event blocks in Run(nevents,nthreads)
+   Int_t        fEventsPerBlock; //Events generated with one seed in Run(nevents,nthreads)
+   TRandom     *fRandom;         //!Generator of the current event block, gRandom if not set
+   std::vector<Double_t> fPosXA; //!x of nucleons in nucleus A
+   std::vector<Double_t> fPosYA; //!y of nucleons in nucleus A
+   std::vector<Double_t> fSigNNA;//!sigNN of nucleons in nucleus A
+   std::vector<Int_t>    fNCollA;//!Number of collisions of nucleons in nucleus A
+   std::vector<Double_t> fPosXB; //!x of nucleons in nucleus B
+   std::vector<Double_t> fPosYB; //!y of nucleons in nucleus B
+   std::vector<Double_t> fSigNNB;//!sigNN of nucleons in nucleus B
+   std::vector<Int_t>    fNCollB;//!Number of collisions of nucleons in nucleus B
+   std::vector<Int_t> fGridStart;//!Offset of each transverse cell in fGridIndex
+   std::vector<Int_t> fGridIndex;//!Nucleons of nucleus A ordered by transverse cell
+   std::vector<Int_t> fGridCell; //!Transverse cell of each nucleon of nucleus A
+   Int_t        fGridNX;         //!Number of grid cells in x
+   Int_t        fGridNY;         //!Number of grid cells in y
+   Double_t     fGridX0;         //!Lower x edge of the grid
+   Double_t     fGridY0;         //!Lower y edge of the grid
+   Double_t     fGridWX;         //!Cell width in x
+   Double_t     fGridWY;         //!Cell width in y
    Bool_t       CalcResults(Double_t bgen);
+   void         BuildGrid(Double_t cell);
+   TNtuple     *CreateNtuple();
+   void         FillNtupleValues(Float_t *v) const;
+   TRandom     *Rnd() const;
 
-   ClassDef(AliGlauberMC,4)
+   static const Int_t kNNtupleVars = 48; //Number of ntuple variables
+   static const Int_t kMaxGridCells = 32; //Maximum number of grid cells per direction
+
+   ClassDef(AliGlauberMC,5)
 };
 
 #endif
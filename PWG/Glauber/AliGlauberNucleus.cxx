@@ -30,6 +30,7 @@
 #include <TObjArray.h>
 #include <TF1.h>
 #include <TRandom.h>
+#include <algorithm>
 #include "AliGlauberNucleon.h"
 #include "AliGlauberNucleus.h"
 
@@ -49,7 +50,10 @@ AliGlauberNucleus::AliGlauberNucleus(Option_t* iname, Int_t iN, Double_t iR, Dou
   fF(0),
   fTrials(0),
   fFunction(ifunc),
-  fNucleons(NULL)
+  fNucleons(NULL),
+  fRadiusCDF(),
+  fRadiusMin(0),
+  fRadiusStep(0)
 {
    if (fN==0) {
       cout << "Setting up nucleus " << iname << endl;
@@ -77,7 +81,10 @@ AliGlauberNucleus::AliGlauberNucleus(const AliGlauberNucleus& in):
   fF(in.fF),
   fTrials(in.fTrials),
   fFunction(in.fFunction),
-  fNucleons(NULL)
+  fNucleons(NULL),
+  fRadiusCDF(in.fRadiusCDF),
+  fRadiusMin(in.fRadiusMin),
+  fRadiusStep(in.fRadiusStep)
 {
   //copy ctor
   if (in.fNucleons)
@@ -97,6 +104,9 @@ AliGlauberNucleus& AliGlauberNucleus::operator=(const AliGlauberNucleus& in)
   fF=in.fF;
   fTrials=in.fTrials;
   fFunction=in.fFunction;
+  fRadiusCDF=in.fRadiusCDF;
+  fRadiusMin=in.fRadiusMin;
+  fRadiusStep=in.fRadiusStep;
   delete fNucleons;
   fNucleons=static_cast<TObjArray*>((in.fNucleons)->Clone());
   fNucleons->SetOwner();
@@ -177,6 +187,7 @@ void AliGlauberNucleus::Lookup(Option_t* name)
 void AliGlauberNucleus::SetR(Double_t ir)
 {
    fR = ir;
+   fRadiusCDF.clear();
    switch (fF)
    {
       case 0: // Proton
@@ -195,6 +206,7 @@ void AliGlauberNucleus::SetR(Double_t ir)
 void AliGlauberNucleus::SetA(Double_t ia)
 {
    fA = ia;
+   fRadiusCDF.clear();
    switch (fF)
    {
       case 0: // Proton
@@ -212,6 +224,7 @@ void AliGlauberNucleus::SetA(Double_t ia)
 void AliGlauberNucleus::SetW(Double_t iw)
 {
    fW = iw;
+   fRadiusCDF.clear();
    switch (fF)
    {
       case 0: // Proton
@@ -226,8 +239,46 @@ void AliGlauberNucleus::SetW(Double_t iw)
 }
 
 //______________________________________________________________________________
-void AliGlauberNucleus::ThrowNucleons(Double_t xshift)
+void AliGlauberNucleus::PrepareRandomRadius(Int_t nsteps)
 {
+   // tabulate the cumulative of rho(r), used instead of TF1::GetRandom when
+   // nucleons are thrown with a given generator (which must not touch gRandom)
+   fRadiusCDF.clear();
+   if (!fFunction || nsteps<1) return;
+   fRadiusMin  = fFunction->GetXmin();
+   fRadiusStep = (fFunction->GetXmax()-fRadiusMin)/nsteps;
+   fRadiusCDF.resize(nsteps+1);
+   fRadiusCDF[0] = 0;
+   Double_t prev = TMath::Max(0.,fFunction->Eval(fRadiusMin));
+   for (Int_t i=1; i<=nsteps; i++) {
+      Double_t cur = TMath::Max(0.,fFunction->Eval(fRadiusMin+i*fRadiusStep));
+      fRadiusCDF[i] = fRadiusCDF[i-1] + 0.5*(prev+cur);
+      prev = cur;
+   }
+}
+
+//______________________________________________________________________________
+Double_t AliGlauberNucleus::GetRandomRadius(TRandom *rnd) const
+{
+   // radius distributed according to rho(r), from the tabulated cumulative
+   const Int_t nsteps = fRadiusCDF.size()-1;
+   Double_t u = rnd->Rndm()*fRadiusCDF[nsteps];
+   Int_t bin = std::upper_bound(fRadiusCDF.begin(),fRadiusCDF.end(),u)-fRadiusCDF.begin()-1;
+   if (bin<0) bin=0;
+   if (bin>=nsteps) bin=nsteps-1;
+   Double_t width = fRadiusCDF[bin+1]-fRadiusCDF[bin];
+   Double_t frac = (width>0) ? (u-fRadiusCDF[bin])/width : 0.5;
+   return fRadiusMin + (bin+frac)*fRadiusStep;
+}
+
+//______________________________________________________________________________
+void AliGlauberNucleus::ThrowNucleons(Double_t xshift, TRandom *rnd)
+{
+   // throw the nucleons of the nucleus; if rnd is given it is used for all
+   // random numbers, otherwise gRandom and TF1::GetRandom
+   if (rnd && fRadiusCDF.empty()) PrepareRandomRadius();
+   TRandom *gen = rnd ? rnd : gRandom;
+
    if (fNucleons==0) {
       fNucleons=new TObjArray(fN);
       fNucleons->SetOwner();
@@ -246,9 +297,9 @@ void AliGlauberNucleus::ThrowNucleons(Double_t xshift)
    Bool_t hulthen = (TString(GetName())=="dh");
    if (fN==2 && hulthen) { //special treatmeant for Hulten
 
-      Double_t r = fFunction->GetRandom()/2;
-      Double_t phi = gRandom->Rndm() * 2 * TMath::Pi() ;
-      Double_t ctheta = 2*gRandom->Rndm() - 1 ;
+      Double_t r = (rnd ? GetRandomRadius(rnd) : fFunction->GetRandom())/2;
+      Double_t phi = gen->Rndm() * 2 * TMath::Pi() ;
+      Double_t ctheta = 2*gen->Rndm() - 1 ;
       Double_t stheta = sqrt(1-ctheta*ctheta);
      
       AliGlauberNucleon *nucleon1=(AliGlauberNucleon*)(fNucleons->UncheckedAt(0));
@@ -270,9 +321,9 @@ void AliGlauberNucleus::ThrowNucleons(Double_t xshift)
       nucleon->Reset();
       while(1) {
          fTrials++;
-         Double_t r = fFunction->GetRandom();
-         Double_t phi = gRandom->Rndm() * 2 * TMath::Pi() ;
-         Double_t ctheta = 2*gRandom->Rndm() - 1 ;
+         Double_t r = rnd ? GetRandomRadius(rnd) : fFunction->GetRandom();
+         Double_t phi = gen->Rndm() * 2 * TMath::Pi() ;
+         Double_t ctheta = 2*gen->Rndm() - 1 ;
          Double_t stheta = TMath::Sqrt(1-ctheta*ctheta);
          Double_t x = r * stheta * cos(phi) + xshift;
          Double_t y = r * stheta * sin(phi);      
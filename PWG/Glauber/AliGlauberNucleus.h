@@ -16,8 +16,10 @@
 
 //class TNamed;
 #include <TNamed.h>
+#include <vector>
 class TObjArray;
 class TF1;
+class TRandom;
 
 class AliGlauberNucleus : public TNamed {
 private:
@@ -30,8 +32,12 @@ private:
    Int_t      fTrials;     //Store trials needed to complete nucleus
    TF1*       fFunction;   //Probability density function rho(r)
    TObjArray* fNucleons;   //Array of nucleons
+   std::vector<Double_t> fRadiusCDF; //!Tabulated cumulative of rho(r), for sampling with a given generator
+   Double_t   fRadiusMin;  //!Lower edge of the tabulated cumulative
+   Double_t   fRadiusStep; //!Step of the tabulated cumulative
 
    void       Lookup(Option_t* name);
+   Double_t   GetRandomRadius(TRandom *rnd) const;
 
 public:
    AliGlauberNucleus(Option_t* iname="Au", Int_t iN=0, Double_t iR=0, Double_t ia=0, Double_t iw=0, TF1* ifunc=0);
@@ -47,14 +53,16 @@ public:
    Double_t   GetW()             const {return fW;}
    TObjArray *GetNucleons()      const {return fNucleons;}
    Int_t      GetTrials()        const {return fTrials;}
+   Double_t   GetMinDist()       const {return fMinDist;}
    void       SetN(Int_t in)           {fN=in;}
    void       SetR(Double_t ir);
    void       SetA(Double_t ia);
    void       SetW(Double_t iw);
    void       SetMinDist(Double_t min) {fMinDist=min;}
-   void       ThrowNucleons(Double_t xshift=0.);
+   void       ThrowNucleons(Double_t xshift=0., TRandom *rnd=0);
+   void       PrepareRandomRadius(Int_t nsteps=10000);
 
-   ClassDef(AliGlauberNucleus,1)
+   ClassDef(AliGlauberNucleus,2)
 };
 
 #endif
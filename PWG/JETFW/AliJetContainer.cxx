@@ -798,6 +798,7 @@ void AliJetContainer::ResetCuts()
   fLeadingHadronType = 0;
   fZLeadingEmcCut = 10.;
   fZLeadingChCut  = 10.;
+  InvalidateAcceptCache();
 }
 
 /**
@@ -95,41 +95,41 @@ class AliJetContainer : public AliParticleContainer {
   void LoadLocalRho(const AliVEvent *event);
   void LoadRhoMass(const AliVEvent *event);
 
-  void                        SetJetAcceptanceType(UInt_t type)         { fJetAcceptanceType          = type ; }
+  void                        SetJetAcceptanceType(UInt_t type)         { fJetAcceptanceType          = type ; InvalidateAcceptCache(); }
   void                        PrintCuts();
   void                        ResetCuts();
   void                        SetJetEtaLimits(Float_t min, Float_t max)            { SetEtaLimits(min, max)             ; }
   void                        SetJetPhiLimits(Float_t min, Float_t max)            { SetPhiLimits(min, max)             ; }
   void                        SetJetPtCut(Float_t cut)                             { SetMinPt(cut)                      ; }
   void                        SetJetPtCutMax(Float_t cut)                          { SetMaxPt(cut)                      ; }
-  void                        SetRunNumber(Int_t r)                                { fRunNumber = r;                      }
-  void                        SetJetRadius(Float_t r)                              { fJetRadius      = r                ; } 
-  void                        SetJetType(EJetType_t type)                          { fJetType        = type             ; }
-  void                        SetJetAreaCut(Float_t cut)                           { fJetAreaCut     = cut              ; }
+  void                        SetRunNumber(Int_t r)                                { fRunNumber = r; InvalidateAcceptCache(); }
+  void                        SetJetRadius(Float_t r)                              { fJetRadius      = r                ; InvalidateAcceptCache(); }
+  void                        SetJetType(EJetType_t type)                          { fJetType        = type             ; InvalidateAcceptCache(); }
+  void                        SetJetAreaCut(Float_t cut)                           { fJetAreaCut     = cut              ; InvalidateAcceptCache(); }
   void                        SetPercAreaCut(Float_t p)                            { if(fJetRadius==0.) AliWarning("JetRadius not set. Area cut will be 0"); 
-                                                                                     fJetAreaCut = p*TMath::Pi()*fJetRadius*fJetRadius; }
-  void                        SetAreaEmcCut(Double_t a = 0.99)                     { fAreaEmcCut     = a                ; }
-  void                        SetZLeadingCut(Float_t zemc, Float_t zch)            { fZLeadingEmcCut = zemc; fZLeadingChCut = zch ; }
-  void                        SetNEFCut(Float_t min = 0., Float_t max = 1.)        { fNEFMinCut = min; fNEFMaxCut = max;  }
-  void                        SetFlavourCut(Int_t myflavour)                       { fFlavourSelection = myflavour;}
-  void                        SetMinClusterPt(Float_t b)                           { fMinClusterPt   = b                ; }
-  void                        SetMaxClusterPt(Float_t b)                           { fMaxClusterPt   = b                ; }
-  void                        SetMinTrackPt(Float_t b)                             { fMinTrackPt     = b                ; }
-  void                        SetMaxTrackPt(Float_t b)                             { fMaxTrackPt     = b                ; }
+                                                                                     fJetAreaCut = p*TMath::Pi()*fJetRadius*fJetRadius; InvalidateAcceptCache(); }
+  void                        SetAreaEmcCut(Double_t a = 0.99)                     { fAreaEmcCut     = a                ; InvalidateAcceptCache(); }
+  void                        SetZLeadingCut(Float_t zemc, Float_t zch)            { fZLeadingEmcCut = zemc; fZLeadingChCut = zch ; InvalidateAcceptCache(); }
+  void                        SetNEFCut(Float_t min = 0., Float_t max = 1.)        { fNEFMinCut = min; fNEFMaxCut = max; InvalidateAcceptCache(); }
+  void                        SetFlavourCut(Int_t myflavour)                       { fFlavourSelection = myflavour; InvalidateAcceptCache(); }
+  void                        SetMinClusterPt(Float_t b)                           { fMinClusterPt   = b                ; InvalidateAcceptCache(); }
+  void                        SetMaxClusterPt(Float_t b)                           { fMaxClusterPt   = b                ; InvalidateAcceptCache(); }
+  void                        SetMinTrackPt(Float_t b)                             { fMinTrackPt     = b                ; InvalidateAcceptCache(); }
+  void                        SetMaxTrackPt(Float_t b)                             { fMaxTrackPt     = b                ; InvalidateAcceptCache(); }
   void                        SetPtBiasJetClus(Float_t b)                          { SetMinClusterPt(b)                 ; }
-  void                        SetNLeadingJets(Int_t t)                             { fNLeadingJets   = t                ; }
-  void                        SetMinNConstituents(Int_t n)                         { fMinNConstituents = n              ; }
+  void                        SetNLeadingJets(Int_t t)                             { fNLeadingJets   = t                ; InvalidateAcceptCache(); }
+  void                        SetMinNConstituents(Int_t n)                         { fMinNConstituents = n              ; InvalidateAcceptCache(); }
   void                        SetPtBiasJetTrack(Float_t b)                         { SetMinTrackPt(b)                   ; }
-  void                        SetLeadingHadronType(Int_t t)                        { fLeadingHadronType = t             ; }
-  void                        SetJetTrigger(UInt_t t=AliVEvent::kEMCEJE)           { fJetTrigger     = t                ; }
-  void                        SetTagStatus(Int_t i)                                { fTagStatus      = i                ; }
+  void                        SetLeadingHadronType(Int_t t)                        { fLeadingHadronType = t             ; InvalidateAcceptCache(); }
+  void                        SetJetTrigger(UInt_t t=AliVEvent::kEMCEJE)           { fJetTrigger     = t                ; InvalidateAcceptCache(); }
+  void                        SetTagStatus(Int_t i)                                { fTagStatus      = i                ; InvalidateAcceptCache(); }
 
-  void                        SetRhoName(const char *n)                            { fRhoName        = n                ; }
-  void                        SetLocalRhoName(const char *n)                       { fLocalRhoName   = n                ; }
-  void                        SetRhoMassName(const char *n)                        { fRhoMassName    = n                ; }
+  void                        SetRhoName(const char *n)                            { fRhoName        = n                ; InvalidateAcceptCache(); }
+  void                        SetLocalRhoName(const char *n)                       { fLocalRhoName   = n                ; InvalidateAcceptCache(); }
+  void                        SetRhoMassName(const char *n)                        { fRhoMassName    = n                ; InvalidateAcceptCache(); }
     
-  void                        SetTpcHolePos(Double_t b)                                {fTpcHolePos       =   b     ;}
-  void                        SetTpcHoleWidth(Double_t b)                             {fTpcHoleWidth    =   b     ;} 
+  void                        SetTpcHolePos(Double_t b)                                {fTpcHolePos       =   b     ; InvalidateAcceptCache(); }
+  void                        SetTpcHoleWidth(Double_t b)                             {fTpcHoleWidth    =   b     ; InvalidateAcceptCache(); }
 
 
   void                        ConnectParticleContainer(AliParticleContainer *c)    { fParticleContainer = c             ; }
@@ -354,7 +354,7 @@ THnSparse* THistManager::CreateTHnSparse(const char *name, const char *title, in
   return hsparse;
 }
 
-void THistManager::CreateTProfile(const char* name, const char* title, int nbinsX, double xmin, double xmax, Option_t *opt) {
+TProfile* THistManager::CreateTProfile(const char* name, const char* title, int nbinsX, double xmin, double xmax, Option_t *opt) {
   TString dirname(basename(name)), hname(histname(name));
   THashList *parent(FindGroup(dirname));
   if(!parent) parent = CreateHistoGroup(dirname);
@@ -362,9 +362,10 @@ void THistManager::CreateTProfile(const char* name, const char* title, int nbins
 		Fatal("THistManager::CreateTProfile", "Object %s already exists in group %s", hname.Data(), dirname.Data());
   TProfile *hist = new TProfile(hname, title, nbinsX, xmin, xmax, opt);
   parent->Add(hist);
+  return hist;
 }
 
-void THistManager::CreateTProfile(const char* name, const char* title, int nbinsX, const double* xbins, Option_t *opt) {
+TProfile* THistManager::CreateTProfile(const char* name, const char* title, int nbinsX, const double* xbins, Option_t *opt) {
   TString dirname(basename(name)), hname(histname(name));
   THashList *parent(FindGroup(dirname));
   if(!parent) parent = CreateHistoGroup(dirname);
@@ -372,9 +373,10 @@ void THistManager::CreateTProfile(const char* name, const char* title, int nbins
 		Fatal("THistManager::CreateTHnSparse", "Object %s already exists in group %s", hname.Data(), dirname.Data());
   TProfile *hist = new TProfile(hname, title, nbinsX, xbins, opt);
   parent->Add(hist);
+  return hist;
 }
 
-void THistManager::CreateTProfile(const char* name, const char* title, const TArrayD& xbins, Option_t *opt){
+TProfile* THistManager::CreateTProfile(const char* name, const char* title, const TArrayD& xbins, Option_t *opt){
   TString dirname(basename(name)), hname(histname(name));
   THashList *parent(FindGroup(dirname));
   if(!parent) parent = CreateHistoGroup(dirname);
@@ -382,16 +384,17 @@ void THistManager::CreateTProfile(const char* name, const char* title, const TAr
 		Fatal("THistManager::CreateTHnSparse", "Object %s already exists in group %s", hname.Data(), dirname.Data());
   TProfile *hist = new TProfile(hname.Data(), title, xbins.GetSize()-1, xbins.GetArray(), opt);
   parent->Add(hist);
+  return hist;
 }
 
-void THistManager::CreateTProfile(const char *name, const char *title, const TBinning &xbins, Option_t *opt){
+TProfile* THistManager::CreateTProfile(const char *name, const char *title, const TBinning &xbins, Option_t *opt){
   TArrayD myxbins;
   try{
     xbins.CreateBinEdges(myxbins);
   } catch (std::exception &e){
     Fatal("THistManager::CreateProfile", "Exception raised: %s", e.what());
   }
-  CreateTProfile(name, title, myxbins, opt);
+  return CreateTProfile(name, title, myxbins, opt);
 }
 
 void THistManager::SetObject(TObject * const o, const char *group) {
@@ -421,13 +424,7 @@ void THistManager::FillTH1(const char *name, double x, double weight, Option_t *
 		return;
 	}
 	TString optionstring(opt);
-	if(optionstring.Contains("w")){
-	  // use bin width as weight
-	  Int_t bin = hist->GetXaxis()->FindBin(x);
-	  // check if not overflow or underflow bin
-	  if(bin != 0 && bin != hist->GetXaxis()->GetNbins())
-	    weight = 1./hist->GetXaxis()->GetBinWidth(bin);
-	}
+	if(optionstring.Contains("w")) weight *= BinWidthWeight(hist->GetXaxis(), x);
 	hist->Fill(x, weight);
 }
 
@@ -444,14 +441,7 @@ void THistManager::FillTH1(const char *name, const char *label, double weight, O
     return;
   }
 	TString optionstring(opt);
-	if(optionstring.Contains("w")){
-	  // use bin width as weight
-	  // get bin for label
-	  Int_t bin = hist->GetXaxis()->FindBin(label);
-	  // check if not overflow or underflow bin
-	  if(bin != 0 && bin != hist->GetXaxis()->GetNbins())
-	    weight = 1./hist->GetXaxis()->GetBinWidth(bin);
-	}
+	if(optionstring.Contains("w")) weight *= BinWidthWeight(hist->GetXaxis(), label);
   hist->Fill(label, weight);
 }
 
@@ -468,15 +458,9 @@ void THistManager::FillTH2(const char *name, double x, double y, double weight,
 		return;
 	}
 	TString optstring(opt);
-	Double_t myweight = optstring.Contains("w") ? 1. : weight;
-	if(optstring.Contains("wx")){
-	  Int_t binx = hist->GetXaxis()->FindBin(x);
-	  if(binx != 0 && binx != hist->GetXaxis()->GetNbins()) myweight *= 1./hist->GetXaxis()->GetBinWidth(binx);
-	}
-	if(optstring.Contains("wy")){
-	  Int_t biny = hist->GetYaxis()->FindBin(y);
-	  if(biny != 0 && biny != hist->GetYaxis()->GetNbins()) myweight *= 1./hist->GetYaxis()->GetBinWidth(biny);
-	}
+	Double_t myweight = weight;
+	if(optstring.Contains("wx")) myweight *= BinWidthWeight(hist->GetXaxis(), x);
+	if(optstring.Contains("wy")) myweight *= BinWidthWeight(hist->GetYaxis(), y);
 	hist->Fill(x, y, myweight);
 }
 
@@ -493,16 +477,10 @@ void THistManager::FillTH2(const char *name, double *point, double weight, Optio
 		return;
 	}
 	TString optstring(opt);
-	Double_t myweight = optstring.Contains("w") ? 1. : weight;
-	if(optstring.Contains("wx")){
-	  Int_t binx = hist->GetXaxis()->FindBin(point[0]);
-	  if(binx != 0 && binx != hist->GetXaxis()->GetNbins()) myweight *= 1./hist->GetXaxis()->GetBinWidth(binx);
-	}
-	if(optstring.Contains("wy")){
-	  Int_t biny = hist->GetYaxis()->FindBin(point[1]);
-	  if(biny != 0 && biny != hist->GetYaxis()->GetNbins()) myweight *= 1./hist->GetYaxis()->GetBinWidth(biny);
-	}
-	hist->Fill(point[0], point[1], weight);
+	Double_t myweight = weight;
+	if(optstring.Contains("wx")) myweight *= BinWidthWeight(hist->GetXaxis(), point[0]);
+	if(optstring.Contains("wy")) myweight *= BinWidthWeight(hist->GetYaxis(), point[1]);
+	hist->Fill(point[0], point[1], myweight);
 }
 
 void THistManager::FillTH2(const char *name, const char *labelX, const char *labelY, double weight, Option_t *opt) {
@@ -518,16 +496,10 @@ void THistManager::FillTH2(const char *name, const char *labelX, const char *lab
     return;
   }
   TString optstring(opt);
-  Double_t myweight = optstring.Contains("w") ? 1. : weight;
-  if(optstring.Contains("wx")){
-    Int_t binx = hist->GetXaxis()->FindBin(labelY);
-    if(binx != 0 && binx != hist->GetXaxis()->GetNbins()) myweight *= 1./hist->GetXaxis()->GetBinWidth(binx);
-  }
-  if(optstring.Contains("wy")){
-    Int_t biny = hist->GetYaxis()->FindBin(labelX);
-    if(biny != 0 && biny != hist->GetYaxis()->GetNbins()) myweight *= 1./hist->GetYaxis()->GetBinWidth(biny);
-  }
-  hist->Fill(labelX, labelY, weight);
+  Double_t myweight = weight;
+  if(optstring.Contains("wx")) myweight *= BinWidthWeight(hist->GetXaxis(), labelX);
+  if(optstring.Contains("wy")) myweight *= BinWidthWeight(hist->GetYaxis(), labelY);
+  hist->Fill(labelX, labelY, myweight);
 }
 
 void THistManager::FillTH3(const char* name, double x, double y, double z, double weight, Option_t *opt) {
@@ -543,20 +515,11 @@ void THistManager::FillTH3(const char* name, double x, double y, double z, doubl
 		return;
 	}
 	TString optstring(opt);
-	Double_t myweight = optstring.Contains("w") ? 1. : weight;
-	if(optstring.Contains("wx")){
-	  Int_t binx = hist->GetXaxis()->FindBin(x);
-	  if(binx != 0 && binx != hist->GetXaxis()->GetNbins()) myweight *= 1./hist->GetXaxis()->GetBinWidth(binx);
-	}
-	if(optstring.Contains("wy")){
-	  Int_t biny = hist->GetYaxis()->FindBin(y);
-	  if(biny != 0 && biny != hist->GetYaxis()->GetNbins()) myweight *= 1./hist->GetYaxis()->GetBinWidth(biny);
-	}
-	if(optstring.Contains("wz")){
-	  Int_t binz = hist->GetZaxis()->FindBin(z);
-	  if(binz != 0 && binz != hist->GetZaxis()->GetNbins()) myweight *= 1./hist->GetZaxis()->GetBinWidth(binz);
-	}
-	hist->Fill(x, y, z, weight);
+	Double_t myweight = weight;
+	if(optstring.Contains("wx")) myweight *= BinWidthWeight(hist->GetXaxis(), x);
+	if(optstring.Contains("wy")) myweight *= BinWidthWeight(hist->GetYaxis(), y);
+	if(optstring.Contains("wz")) myweight *= BinWidthWeight(hist->GetZaxis(), z);
+	hist->Fill(x, y, z, myweight);
 }
 
 void THistManager::FillTH3(const char* name, const double* point, double weight, Option_t *opt) {
@@ -572,20 +535,11 @@ void THistManager::FillTH3(const char* name, const double* point, double weight,
 		return;
 	}
 	TString optstring(opt);
-	Double_t myweight = optstring.Contains("w") ? 1. : weight;
-	if(optstring.Contains("wx")){
-	  Int_t binx = hist->GetXaxis()->FindBin(point[0]);
-	  if(binx != 0 && binx != hist->GetXaxis()->GetNbins()) myweight *= 1./hist->GetXaxis()->GetBinWidth(binx);
-	}
-	if(optstring.Contains("wy")){
-	  Int_t biny = hist->GetYaxis()->FindBin(point[1]);
-	  if(biny != 0 && biny != hist->GetYaxis()->GetNbins()) myweight *= 1./hist->GetYaxis()->GetBinWidth(biny);
-	}
-	if(optstring.Contains("wz")){
-	  Int_t binz = hist->GetZaxis()->FindBin(point[2]);
-	  if(binz != 0 && binz != hist->GetZaxis()->GetNbins()) myweight *= 1./hist->GetZaxis()->GetBinWidth(binz);
-	}
-	hist->Fill(point[0], point[1], point[2], weight);
+	Double_t myweight = weight;
+	if(optstring.Contains("wx")) myweight *= BinWidthWeight(hist->GetXaxis(), point[0]);
+	if(optstring.Contains("wy")) myweight *= BinWidthWeight(hist->GetYaxis(), point[1]);
+	if(optstring.Contains("wz")) myweight *= BinWidthWeight(hist->GetZaxis(), point[2]);
+	hist->Fill(point[0], point[1], point[2], myweight);
 }
 
 void THistManager::FillTHnSparse(const char *name, const double *x, double weight, Option_t *opt) {
@@ -601,17 +555,14 @@ void THistManager::FillTHnSparse(const char *name, const double *x, double weigh
 		return;
 	}
 	TString optstring(opt);
-	Double_t myweight = optstring.Contains("w") ? 1. : weight;
+	Double_t myweight = weight;
 	for(Int_t iaxis = 0; iaxis < hist->GetNdimensions(); iaxis++){
 	  std::stringstream weighthandler;
 	  weighthandler << "w" << iaxis;
-	  if(optstring.Contains(weighthandler.str().c_str())){
-	    Int_t bin = hist->GetAxis(iaxis)->FindBin(x[iaxis]);
-	    if(bin != 0 && bin != hist->GetAxis(iaxis)->GetNbins()) myweight *= hist->GetAxis(iaxis)->GetBinWidth(bin);
-	  }
+	  if(optstring.Contains(weighthandler.str().c_str())) myweight *= BinWidthWeight(hist->GetAxis(iaxis), x[iaxis]);
 	}
 
-	hist->Fill(x, weight);
+	hist->Fill(x, myweight);
 }
 
 void THistManager::FillProfile(const char* name, double x, double y, double weight){
@@ -625,6 +576,60 @@ void THistManager::FillProfile(const char* name, double x, double y, double weig
   hist->Fill(x, y, weight);
 }
 
+void THistManager::Fill(const TH1Handle &hist, double x, double weight, Option_t *opt) {
+  TH1 *h = hist.Get();
+  if(opt && opt[0] && strchr(opt, 'w')) weight *= BinWidthWeight(h->GetXaxis(), x);
+  h->Fill(x, weight);
+}
+
+void THistManager::Fill(const TH2Handle &hist, double x, double y, double weight, Option_t *opt) {
+  TH2 *h = hist.Get();
+  if(opt && opt[0]){
+    TString optstring(opt);
+    if(optstring.Contains("wx")) weight *= BinWidthWeight(h->GetXaxis(), x);
+    if(optstring.Contains("wy")) weight *= BinWidthWeight(h->GetYaxis(), y);
+  }
+  h->Fill(x, y, weight);
+}
+
+void THistManager::Fill(const TH3Handle &hist, double x, double y, double z, double weight, Option_t *opt) {
+  TH3 *h = hist.Get();
+  if(opt && opt[0]){
+    TString optstring(opt);
+    if(optstring.Contains("wx")) weight *= BinWidthWeight(h->GetXaxis(), x);
+    if(optstring.Contains("wy")) weight *= BinWidthWeight(h->GetYaxis(), y);
+    if(optstring.Contains("wz")) weight *= BinWidthWeight(h->GetZaxis(), z);
+  }
+  h->Fill(x, y, z, weight);
+}
+
+void THistManager::Fill(const THnSparseHandle &hist, const double *x, double weight, Option_t *opt) {
+  THnSparse *h = hist.Get();
+  if(opt && opt[0]){
+    TString optstring(opt);
+    for(Int_t iaxis = 0; iaxis < h->GetNdimensions(); iaxis++){
+      if(optstring.Contains(Form("w%d", iaxis))) weight *= BinWidthWeight(h->GetAxis(iaxis), x[iaxis]);
+    }
+  }
+  h->Fill(x, weight);
+}
+
+void THistManager::Fill(const TProfileHandle &hist, double x, double y, double weight) {
+  hist.Get()->Fill(x, y, weight);
+}
+
+double THistManager::BinWidthWeight(const TAxis *axis, double x) {
+  Int_t bin = axis->FindFixBin(x);
+  if(bin >= 1 && bin <= axis->GetNbins()) return 1./axis->GetBinWidth(bin);
+  return 1.;
+}
+
+double THistManager::BinWidthWeight(const TAxis *axis, const char *label) {
+  Int_t bin = axis->FindFixBin(label);
+  if(bin >= 1 && bin <= axis->GetNbins()) return 1./axis->GetBinWidth(bin);
+  return 1.;
+}
+
 TObject *THistManager::FindObject(const char *name) const {
 	TString dirname(basename(name)), hname(histname(name));
 	THashList *parent(FindGroup(dirname));
@@ -1030,6 +1035,62 @@ namespace TestTHistManager {
     return success ? 0 : 1;
   }
 
+  int THistManagerTestSuite::TestFillHandleHistograms(){
+    THistManager testmgr("testmgr");
+
+    THistManager::TH1Handle h1(testmgr.CreateTH1("Group1/Test1", "Test handle 1D", 1, 0., 1.));
+    testmgr.CreateTH2("Group1/Test2", "Test handle 2D", 1, 0., 1., 1, 0., 1.);
+    testmgr.CreateTH3("Group2/Test3", "Test handle 3D", 1, 0., 1., 1, 0., 1., 1, 0., 1.);
+    int nbins[4] = {1,1,1,1}; double min[4] = {0.,0.,0.,0.}, max[4] = {1.,1.,1.,1.};
+    testmgr.CreateTHnSparse("Group2/TestN", "Test handle THnSparse", 4, nbins, min, max);
+    THistManager::TProfileHandle hprof(testmgr.CreateTProfile("Group3/Subgroup1/TestProfile", "Test handle profile", 1, 0., 1.));
+
+    THistManager::TH2Handle h2 = testmgr.Lookup<TH2>("Group1/Test2");
+    THistManager::TH3Handle h3 = testmgr.Lookup<TH3>("Group2/Test3");
+    THistManager::THnSparseHandle hn = testmgr.Lookup<THnSparse>("Group2/TestN");
+
+    double point[4] = {0.5, 0.5, 0.5, 0.5};
+    for(int i = 0; i < 100; i++){
+      testmgr.Fill(h1, 0.5);
+      testmgr.Fill(h2, 0.5, 0.5);
+      testmgr.Fill(h3, 0.5, 0.5, 0.5);
+      testmgr.Fill(hn, point);
+      testmgr.Fill(hprof, 0.5, 1.);
+    }
+
+    // Evaluate test, using the histograms in the manager, not the handles
+    bool success(true);
+
+    TH1 *test1 = dynamic_cast<TH1 *>(testmgr.FindObject("Group1/Test1"));
+    if(!test1 || TMath::Abs(test1->GetBinContent(1) - 100) > DBL_EPSILON){
+      std::cout << "Group1/Test1: not found or value mismatch, expected 100" << std::endl;
+      success = false;
+    }
+    TH2 *test2 = dynamic_cast<TH2 *>(testmgr.FindObject("Group1/Test2"));
+    if(!test2 || TMath::Abs(test2->GetBinContent(1, 1) - 100) > DBL_EPSILON){
+      std::cout << "Group1/Test2: not found or value mismatch, expected 100" << std::endl;
+      success = false;
+    }
+    TH3 *test3 = dynamic_cast<TH3 *>(testmgr.FindObject("Group2/Test3"));
+    if(!test3 || TMath::Abs(test3->GetBinContent(1, 1, 1) - 100) > DBL_EPSILON){
+      std::cout << "Group2/Test3: not found or value mismatch, expected 100" << std::endl;
+      success = false;
+    }
+    THnSparse *testN = dynamic_cast<THnSparse *>(testmgr.FindObject("Group2/TestN"));
+    int index[4] = {1,1,1,1};
+    if(!testN || TMath::Abs(testN->GetBinContent(index) - 100) > DBL_EPSILON){
+      std::cout << "Group2/TestN: not found or value mismatch, expected 100" << std::endl;
+      success = false;
+    }
+    TProfile *testProfile = dynamic_cast<TProfile *>(testmgr.FindObject("Group3/Subgroup1/TestProfile"));
+    if(!testProfile || TMath::Abs(testProfile->GetBinContent(1) - 1) > DBL_EPSILON){
+      std::cout << "Group3/Subgroup1/TestProfile: not found or value mismatch, expected 1" << std::endl;
+      success = false;
+    }
+
+    return success ? 0 : 1;
+  }
+
   int TestRunAll(){
     int testresult(0);
     THistManagerTestSuite testsuite;
@@ -1050,6 +1111,10 @@ namespace TestTHistManager {
     testresult += testsuite.TestFillGroupedHistograms();
     std::cout << "Result after test: " << testresult << std::endl;
 
+    std::cout << "Running test: Fill Handle" << std::endl;
+    testresult += testsuite.TestFillHandleHistograms();
+    std::cout << "Result after test: " << testresult << std::endl;
+
     return testresult;
   }
 
@@ -1072,4 +1137,9 @@ namespace TestTHistManager {
     THistManagerTestSuite testsuite;
     return testsuite.TestFillGroupedHistograms();
   }
+
+  int TestRunFillHandle(){
+    THistManagerTestSuite testsuite;
+    return testsuite.TestFillHandleHistograms();
+  }
 }
@@ -94,7 +94,9 @@ class TProfile;
  * manager when filling the histogram. For this purpose the Fill methods provide
  * an argument for options. Automatic correction for the bin width is done when
  * specifying the argument *W*, followed by the direction. Adding multiple directions
- * the weight is calculated for all directions at the same time.
+ * the weight is calculated for all directions at the same time. The weight given
+ * by the caller is divided by the width of the bin the entry falls in, no correction
+ * is applied in underflow / overflow. The fills by name and by handle behave the same.
  */
 class THistManager : public TNamed {
 public:
@@ -229,6 +231,59 @@ public:
     iterator();
   };
 
+  /**
+   * @class Handle
+   * @brief Typed reference to a histogram inside the histogram manager
+   * @ingroup Histmanager
+   *
+   * Lightweight handle to a histogram owned by the histogram manager. The
+   * handle is resolved once, either from the pointer returned by the Create
+   * methods or via Lookup, and can then be used in the Fill overloads without
+   * parsing the histogram path and searching the groups at each fill. The
+   * histogram itself stays in the group structure of the manager, so storage
+   * and merging are not affected. The handle is only valid as long as the
+   * manager owning the histogram exists.
+   *
+   * ~~~{.cxx}
+   * THistManager::TH1Handle hPt(mgr.CreateTH1("tracks/hPt", "pt-distribution", TLinearBinning(100, 0., 100.)));
+   * auto hEtaPhi = mgr.Lookup<TH2>("tracks/hEtaPhi");
+   * for(auto t : tracks) {
+   *   mgr.Fill(hPt, t->Pt());
+   *   mgr.Fill(hEtaPhi, t->Eta(), t->Phi());
+   * }
+   * ~~~
+   */
+  template<class HistType>
+  class Handle {
+  public:
+    /**
+     * @brief Constructor
+     * @param[in] hist Histogram handled (owned by the histogram manager)
+     */
+    explicit Handle(HistType *hist = nullptr): fHist(hist) {}
+
+    /**
+     * @brief Access to the underlying histogram
+     * @return Histogram handled (nullptr if not resolved)
+     */
+    HistType *Get() const { return fHist; }
+
+    /**
+     * @brief Check whether the handle points to a histogram
+     * @return True if the handle is resolved
+     */
+    bool IsValid() const { return fHist != nullptr; }
+
+  private:
+    HistType                    *fHist;               ///< Histogram handled (not owned)
+  };
+
+  typedef Handle<TH1> TH1Handle;
+  typedef Handle<TH2> TH2Handle;
+  typedef Handle<TH3> TH3Handle;
+  typedef Handle<THnSparse> THnSparseHandle;
+  typedef Handle<TProfile> TProfileHandle;
+
   /**
    * @brief Default constructor.
    *
@@ -481,7 +536,7 @@ public:
 	 * @param[in] xmax max. value in x-direction
 	 * @param[in] opt Further options
 	 */
-  void CreateTProfile(const char *name, const char *title, int nbinsX, double xmin, double xmax, Option_t *opt = "");
+  TProfile* CreateTProfile(const char *name, const char *title, int nbinsX, double xmin, double xmax, Option_t *opt = "");
 
   /**
    * @brief Create a new TProfile within the container.
@@ -494,7 +549,7 @@ public:
    * @param[in] xbins binning in x-direction
    * @param[in] opt Further options
    */
-  void CreateTProfile(const char *name, const char *title, int nbinsX, const double *xbins, Option_t *opt = "");
+  TProfile* CreateTProfile(const char *name, const char *title, int nbinsX, const double *xbins, Option_t *opt = "");
 
   /**
    * @brief Create a new TProfile within the container.
@@ -506,7 +561,7 @@ public:
    * @param[in] xbins binning in x-direction
    * @param[in] opt Further options
    */
-  void CreateTProfile(const char *name, const char *title, const TArrayD &xbins, Option_t *opt = "");
+  TProfile* CreateTProfile(const char *name, const char *title, const TArrayD &xbins, Option_t *opt = "");
 
   /**
    * @brief Create a new TProfile within the container.
@@ -518,7 +573,7 @@ public:
    * @param[in] xbins User binning
    * @param[in] opt Further options
    */
-  void CreateTProfile(const char *name, const char *title, const TBinning &xbins, Option_t *opt = "");
+  TProfile* CreateTProfile(const char *name, const char *title, const TBinning &xbins, Option_t *opt = "");
 
   /**
    * @brief Set a new group into the container into the parent group
@@ -634,6 +689,66 @@ public:
 	 */
   void FillProfile(const char *name, double x, double y, double weight = 1.);
 
+  /**
+   * @brief Resolve a histogram handle from the histogram path.
+   *
+   * To be done once (i.e. in UserCreateOutputObjects), the handle can then be
+   * used in the Fill overloads below. Fatal if the histogram does not exist
+   * or is not of the requested type.
+   * @param[in] name Name of the histogram including the parent group(s)
+   * @return Handle to the histogram
+   */
+  template<class HistType>
+  Handle<HistType> Lookup(const char *name) const;
+
+  /**
+   * @brief Fill a 1D histogram via its handle.
+   * @param[in] hist Handle to the histogram
+   * @param[in] x x-coordinate
+   * @param[in] weight optional weight of the entry (default 1)
+   * @param[in] opt Optional filling arguments (w for bin width correction, as in FillTH1)
+   */
+  void Fill(const TH1Handle &hist, double x, double weight = 1., Option_t *opt = "");
+
+  /**
+   * @brief Fill a 2D histogram via its handle.
+   * @param[in] hist Handle to the histogram
+   * @param[in] x x-coordinate
+   * @param[in] y y-coordinate
+   * @param[in] weight optional weight of the entry (default 1)
+   * @param[in] opt Optional filling arguments (wx, wy for bin width correction, as in FillTH2)
+   */
+  void Fill(const TH2Handle &hist, double x, double y, double weight = 1., Option_t *opt = "");
+
+  /**
+   * @brief Fill a 3D histogram via its handle.
+   * @param[in] hist Handle to the histogram
+   * @param[in] x x-coordinate
+   * @param[in] y y-coordinate
+   * @param[in] z z-coordinate
+   * @param[in] weight optional weight of the entry (default 1)
+   * @param[in] opt Optional filling arguments (wx, wy, wz for bin width correction, as in FillTH3)
+   */
+  void Fill(const TH3Handle &hist, double x, double y, double z, double weight = 1., Option_t *opt = "");
+
+  /**
+   * @brief Fill a n-dimensional histogram via its handle.
+   * @param[in] hist Handle to the histogram
+   * @param[in] x coordinates of the point
+   * @param[in] weight optional weight of the entry (default 1)
+   * @param[in] opt Optional filling arguments (w0, w1, ... for bin width correction)
+   */
+  void Fill(const THnSparseHandle &hist, const double *x, double weight = 1., Option_t *opt = "");
+
+  /**
+   * @brief Fill a profile histogram via its handle.
+   * @param[in] hist Handle to the profile histogram
+   * @param[in] x x-coordinate
+   * @param[in] y y-coordinate
+   * @param[in] weight optional weight of the entry (default 1)
+   */
+  void Fill(const TProfileHandle &hist, double x, double y, double weight = 1.);
+
   /**
    * @brief Create forward iterator starting at the beginning of the
    * container
@@ -719,6 +834,22 @@ private:
 	 */
 	TString histname(const TString &path) const;
 
+	/**
+	 * @brief Weight correcting for the bin width at a given position
+	 * @param[in] axis Axis on which the position is evaluated
+	 * @param[in] x Position on the axis
+	 * @return Inverse of the bin width (1 for underflow / overflow)
+	 */
+	static double BinWidthWeight(const TAxis *axis, double x);
+
+	/**
+	 * @brief Weight correcting for the bin width of a labelled bin
+	 * @param[in] axis Axis on which the label is searched
+	 * @param[in] label Bin label
+	 * @return Inverse of the bin width (1 if the label is not found)
+	 */
+	static double BinWidthWeight(const TAxis *axis, const char *label);
+
 	THashList *fHistos;                   ///< List of histograms
 	bool fIsOwner;                        ///< Set the ownership
 
@@ -743,6 +874,13 @@ THistManager::iterator THistManager::rend() const {
   return iterator(this, -1, iterator::kTHMIbackward);
 }
 
+template<class HistType>
+THistManager::Handle<HistType> THistManager::Lookup(const char *name) const {
+  HistType *hist = dynamic_cast<HistType *>(FindObject(name));
+  if(!hist) Fatal("THistManager::Lookup", "Histogram %s not found or of wrong type", name);
+  return Handle<HistType>(hist);
+}
+
 /**
  * @namespace TestTHistManager
  * @brief Collection of simple test for the THistManager
@@ -845,6 +983,20 @@ public:
    * @return 0 if test is passed, 1 if it failed
    */
   int TestFillGroupedHistograms();
+
+  /**
+   * Purpose of the test: Test filling of histograms via handles
+   * Relies on: TestBuildSimpleHistograms, TestBuildGroupedHistograms, TestFillSimpleHistograms
+   *
+   * Create TH1, TH2, TH3, THnSparse and TProfile in groups, obtain handles
+   * from the create functions (TH1, TProfile) and via Lookup (others), and
+   * fill each of them 100 times for bin 1 (TProfile with weight 1).
+   *
+   * Test passed:
+   * - All histograms have the expected value (100 for histograms, 1 for profile)
+   * @return 0 if test is passed, 1 if it failed
+   */
+  int TestFillHandleHistograms();
 };
 
 /**
@@ -882,5 +1034,12 @@ int TestRunFillSimple();
  */
 int TestRunFillGrouped();
 
+/**
+ * Run the test for filling histograms via handles. See @ref THistManagerTestSuite
+ * for details.
+ * @return 0 if test is passed, 1 if failed
+ */
+int TestRunFillHandle();
+
 }
 #endif
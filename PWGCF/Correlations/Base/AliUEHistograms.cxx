@@ -86,7 +86,18 @@ AliUEHistograms::AliUEHistograms(const char* name, const char* histograms, const
   fTwoTrackCutMinRadius(0.8),
   fCheckEventNumberInCorrelation(kFALSE),
   fRunNumber(0),
-  fMergeCount(1)
+  fMergeCount(1),
+  fTriggerBlock(),
+  fAssociatedBlock(),
+  fTriggerEff(),
+  fAssociatedEff(),
+  fTriggerWeight(),
+  fTriggerAccepted(),
+  fTriggerResonance(),
+  fAssociatedResonance(),
+  fPairAccepted(),
+  fPairDEta(),
+  fPairDPhi()
 {
   // Constructor
   //
@@ -267,7 +278,18 @@ AliUEHistograms::AliUEHistograms(const AliUEHistograms &c) :
   fTwoTrackCutMinRadius(0.8),
   fCheckEventNumberInCorrelation(kFALSE),
   fRunNumber(0),
-  fMergeCount(1)
+  fMergeCount(1),
+  fTriggerBlock(),
+  fAssociatedBlock(),
+  fTriggerEff(),
+  fAssociatedEff(),
+  fTriggerWeight(),
+  fTriggerAccepted(),
+  fTriggerResonance(),
+  fAssociatedResonance(),
+  fPairAccepted(),
+  fPairDEta(),
+  fPairDPhi()
 {
   //
   // AliUEHistograms copy constructor
@@ -571,14 +593,34 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
   // fills the fNumberDensityPhi histogram
   //
   // this function need a list of AliVParticles which contain the particles/tracks to be filled
+  // they are copied into AliUEParticleBlocks, see the function below for the details
+  //
+  // tasks which fill several steps with the same particles should build the blocks once per event
+  // and call the AliUEParticleBlock version directly
+
+  fTriggerBlock.Fill(particles);
+  if (mixed)
+    fAssociatedBlock.Fill(mixed);
+
+  FillCorrelations(centrality, zVtx, step, fTriggerBlock, (mixed) ? &fAssociatedBlock : 0, weight, firstTime, twoTrackEfficiencyCut, bSign, twoTrackEfficiencyCutValue, applyEfficiency);
+}
+
+//____________________________________________________________________
+void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEHist::CFStep step, const AliUEParticleBlock& particles, const AliUEParticleBlock* mixed, Float_t weight, Bool_t firstTime, Bool_t twoTrackEfficiencyCut, Float_t bSign, Float_t twoTrackEfficiencyCutValue, Bool_t applyEfficiency)
+{
+  // fills the fNumberDensityPhi histogram
   //
   // if mixed is non-0, mixed events are filled, the trigger particle is from particles, the associated from mixed
   // if weight < 0, then the pt of the associated particle is filled as weight
-  
+  //
+  // the pair loop is done in two passes per trigger particle: first all cuts which depend only on the
+  // kinematics (and delta eta, delta phi) are evaluated for all associated particles in simple loops
+  // over the columns, then the invariant-mass and two-track cuts are applied to the remaining pairs
+
   Bool_t fillpT = kFALSE;
   if (weight < 0)
     fillpT = kTRUE;
-  
+
   if (twoTrackEfficiencyCut && !fTwoTrackDistancePt[0])
   {
     // do not add this hists to the directory
@@ -591,495 +633,486 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
     TH1::AddDirectory(oldStatus);
   }
 
-  // Eta() is extremely time consuming, therefore cache it for the inner loop here:
-  TObjArray* input = (mixed) ? mixed : particles;
-  TArrayF eta(input->GetEntriesFast());
-  for (Int_t i=0; i<input->GetEntriesFast(); i++)
-    eta[i] = ((AliVParticle*) input->UncheckedAt(i))->Eta();
-  
-  // if particles is not set, just fill event statistics
-  if (particles)
+  const AliUEParticleBlock& assoc = (mixed) ? *mixed : particles;
+
+  const Int_t iMax = particles.GetEntries();
+  const Int_t jMax = assoc.GetEntries();
+
+  const Double_t* pt = particles.GetPt();
+  const Double_t* phi = particles.GetPhi();
+  const Float_t* eta = particles.GetEta();
+  const Short_t* charge = particles.GetCharge();
+
+  const Double_t* assocPt = assoc.GetPt();
+  const Double_t* assocPhi = assoc.GetPhi();
+  const Float_t* assocEta = assoc.GetEta();
+  const Short_t* assocCharge = assoc.GetCharge();
+
+  if (fCheckEventNumberInCorrelation && iMax > 0 && jMax > 0 && (!particles.HasEventIndex() || !assoc.HasEventIndex()))
+    AliFatal("If fCheckEventNumberInCorrelation is set, particle must be derived from AliBasicParticle");
+
+  const Int_t nMax = TMath::Max(iMax, jMax);
+  if ((Int_t) fPairAccepted.size() < nMax)
+  {
+    fTriggerEff.resize(nMax);
+    fAssociatedEff.resize(nMax);
+    fTriggerWeight.resize(nMax);
+    fTriggerAccepted.resize(nMax);
+    fTriggerResonance.resize(nMax);
+    fAssociatedResonance.resize(nMax);
+    fPairAccepted.resize(nMax);
+    fPairDEta.resize(nMax);
+    fPairDPhi.resize(nMax);
+  }
+
+  // single-particle selection of the trigger particles
+  for (Int_t i=0; i<iMax; i++)
+  {
+    Bool_t accepted = kTRUE;
+
+    if (fTriggerRestrictEta > 0 && TMath::Abs(eta[i]) > fTriggerRestrictEta)
+      accepted = kFALSE;
+
+    if (fOnlyOneEtaSide != 0 && fOnlyOneEtaSide * eta[i] < 0)
+      accepted = kFALSE;
+
+    if (fTriggerSelectCharge != 0 && charge[i] * fTriggerSelectCharge < 0)
+      accepted = kFALSE;
+
+    fTriggerAccepted[i] = accepted;
+  }
+
+  if (fWeightPerEvent)
+  {
+    TAxis* axis = fNumberDensityPhi->GetTrackHist(AliUEHist::kToward)->GetGrid(0)->GetGrid()->GetAxis(2);
+    TH1F triggerWeighting("triggerWeighting", "", axis->GetNbins(), axis->GetXbins()->GetArray());
+    triggerWeighting.SetDirectory(0);
+
+    for (Int_t i=0; i<iMax; i++)
+      if (fTriggerAccepted[i])
+        triggerWeighting.Fill(pt[i]);
+
+    for (Int_t i=0; i<iMax; i++)
+      fTriggerWeight[i] = triggerWeighting.GetBinContent(triggerWeighting.GetXaxis()->FindBin(pt[i]));
+  }
+
+  // the efficiency corrections only depend on single-particle quantities, they are looked up once per particle
+  const Bool_t useAssociatedEff = (applyEfficiency && fEfficiencyCorrectionAssociated);
+  const Bool_t useTriggerEff = (applyEfficiency && fEfficiencyCorrectionTriggers);
+  if (useAssociatedEff)
+  {
+    Int_t effVars[4];
+    effVars[2] = fEfficiencyCorrectionAssociated->GetAxis(2)->FindBin(centrality);
+    effVars[3] = fEfficiencyCorrectionAssociated->GetAxis(3)->FindBin((Double_t) zVtx);
+    for (Int_t j=0; j<jMax; j++)
+    {
+      effVars[0] = fEfficiencyCorrectionAssociated->GetAxis(0)->FindBin(assocEta[j]);
+      effVars[1] = fEfficiencyCorrectionAssociated->GetAxis(1)->FindBin(assocPt[j]);
+      fAssociatedEff[j] = fEfficiencyCorrectionAssociated->GetBinContent(effVars);
+    }
+  }
+  if (useTriggerEff)
   {
-    Int_t jMax = particles->GetEntriesFast();
+    Int_t effVars[4];
+    effVars[2] = fEfficiencyCorrectionTriggers->GetAxis(2)->FindBin(centrality);
+    effVars[3] = fEfficiencyCorrectionTriggers->GetAxis(3)->FindBin((Double_t) zVtx);
+    for (Int_t i=0; i<iMax; i++)
+    {
+      effVars[0] = fEfficiencyCorrectionTriggers->GetAxis(0)->FindBin(eta[i]);
+      effVars[1] = fEfficiencyCorrectionTriggers->GetAxis(1)->FindBin(pt[i]);
+      fTriggerEff[i] = fEfficiencyCorrectionTriggers->GetBinContent(effVars);
+    }
+  }
+
+  // identify K, Lambda candidates and flag those particles
+  // a TObject bit is used for this, so that particles which are shared between particles and mixed are flagged in both
+  const UInt_t kResonanceDaughterFlag = 1 << 14;
+  if (fRejectResonanceDaughters > 0)
+  {
+    Double_t resonanceMass = -1;
+    Double_t massDaughter1 = -1;
+    Double_t massDaughter2 = -1;
+    const Double_t interval = 0.02;
+
+    switch (fRejectResonanceDaughters)
+    {
+      case 1: resonanceMass = 1.2; massDaughter1 = 0.1396; massDaughter2 = 0.9383; break; // method test
+      case 2: resonanceMass = 0.4976; massDaughter1 = 0.1396; massDaughter2 = massDaughter1; break; // k0
+      case 3: resonanceMass = 1.115; massDaughter1 = 0.1396; massDaughter2 = 0.9383; break; // lambda
+      default: AliFatal(Form("Invalid setting %d", fRejectResonanceDaughters));
+    }
+
+    for (Int_t i=0; i<iMax; i++)
+      particles.GetObject(i)->ResetBit(kResonanceDaughterFlag);
     if (mixed)
-      jMax = mixed->GetEntriesFast();
-    
-    TH1* triggerWeighting = 0;
-    if (fWeightPerEvent)
+      for (Int_t j=0; j<jMax; j++)
+        mixed->GetObject(j)->ResetBit(kResonanceDaughterFlag);
+
+    for (Int_t i=0; i<iMax; i++)
     {
-      TAxis* axis = fNumberDensityPhi->GetTrackHist(AliUEHist::kToward)->GetGrid(0)->GetGrid()->GetAxis(2);
-      triggerWeighting = new TH1F("triggerWeighting", "", axis->GetNbins(), axis->GetXbins()->GetArray());
-    
-      for (Int_t i=0; i<particles->GetEntriesFast(); i++)
+      for (Int_t j=0; j<jMax; j++)
       {
-	AliVParticle* triggerParticle = (AliVParticle*) particles->UncheckedAt(i);
-	
-	// some optimization
-	Float_t triggerEta = triggerParticle->Eta();
-
-	if (fTriggerRestrictEta > 0 && TMath::Abs(triggerEta) > fTriggerRestrictEta)
-	  continue;
-
-	if (fOnlyOneEtaSide != 0)
-	{
-	  if (fOnlyOneEtaSide * triggerEta < 0)
-	    continue;
-	}
-	
-	if (fTriggerSelectCharge != 0)
-	  if (triggerParticle->Charge() * fTriggerSelectCharge < 0)
-	    continue;
-	
-	triggerWeighting->Fill(triggerParticle->Pt());
+        if (!mixed && i == j)
+          continue;
+
+        // check if both particles point to the same element (does not occur for mixed events, but if subsets are mixed within the same event)
+        if (fCheckEventNumberInCorrelation)
+        {
+          if (particles.GetEventIndex()[i] == assoc.GetEventIndex()[j])
+            continue;
+        }
+        else if (mixed && IsEqualParticle(particles, i, assoc, j))
+          continue;
+
+        if (charge[i] * assocCharge[j] > 0)
+          continue;
+
+        Float_t mass = GetInvMassSquaredCheap(pt[i], eta[i], phi[i], assocPt[j], assocEta[j], assocPhi[j], massDaughter1, massDaughter2);
+
+        if (TMath::Abs(mass - resonanceMass*resonanceMass) < interval*5)
+        {
+          mass = GetInvMassSquared(pt[i], eta[i], phi[i], assocPt[j], assocEta[j], assocPhi[j], massDaughter1, massDaughter2);
+
+          if (mass > (resonanceMass-interval)*(resonanceMass-interval) && mass < (resonanceMass+interval)*(resonanceMass+interval))
+          {
+            particles.GetObject(i)->SetBit(kResonanceDaughterFlag);
+            assoc.GetObject(j)->SetBit(kResonanceDaughterFlag);
+          }
+        }
       }
     }
-    
-    // identify K, Lambda candidates and flag those particles
-    // a TObject bit is used for this
-    const UInt_t kResonanceDaughterFlag = 1 << 14;
-    if (fRejectResonanceDaughters > 0)
+
+    for (Int_t i=0; i<iMax; i++)
+      fTriggerResonance[i] = particles.GetObject(i)->TestBit(kResonanceDaughterFlag);
+    for (Int_t j=0; j<jMax; j++)
+      fAssociatedResonance[j] = assoc.GetObject(j)->TestBit(kResonanceDaughterFlag);
+  }
+
+  Char_t* pairAccepted = fPairAccepted.data();
+  Float_t* pairDEta = fPairDEta.data();
+  Double_t* pairDPhi = fPairDPhi.data();
+
+  for (Int_t i=0; i<iMax; i++)
+  {
+    if (!fTriggerAccepted[i])
+      continue;
+
+    if (fRejectResonanceDaughters > 0 && fTriggerResonance[i])
+      continue;
+
+    const Double_t triggerPt = pt[i];
+    const Double_t triggerPhi = phi[i];
+    const Float_t triggerEta = eta[i];
+    const Short_t triggerCharge = charge[i];
+
+    // pass 1: cuts which only need the columns, evaluated for all associated particles
+    for (Int_t j=0; j<jMax; j++)
     {
-      Double_t resonanceMass = -1;
-      Double_t massDaughter1 = -1;
-      Double_t massDaughter2 = -1;
-      const Double_t interval = 0.02;
-      
-      switch (fRejectResonanceDaughters)
+      pairDEta[j] = triggerEta - assocEta[j];
+
+      Double_t dphi = triggerPhi - assocPhi[j];
+      if (dphi > 1.5 * TMath::Pi())
+        dphi -= TMath::TwoPi();
+      if (dphi < -0.5 * TMath::Pi())
+        dphi += TMath::TwoPi();
+      pairDPhi[j] = dphi;
+
+      pairAccepted[j] = 1;
+    }
+
+    if (!mixed)
+      pairAccepted[i] = 0;
+
+    // check if both particles point to the same element (does not occur for mixed events, but if subsets are mixed within the same event)
+    if (fCheckEventNumberInCorrelation)
+    {
+      const Long64_t triggerEvent = particles.GetEventIndex()[i];
+      const Long64_t* assocEvent = assoc.GetEventIndex();
+      for (Int_t j=0; j<jMax; j++)
+        pairAccepted[j] &= (assocEvent[j] != triggerEvent);
+    }
+    else if (mixed)
+    {
+      if (particles.GetEqualByID()[i])
       {
-	case 1: resonanceMass = 1.2; massDaughter1 = 0.1396; massDaughter2 = 0.9383; break; // method test
-	case 2: resonanceMass = 0.4976; massDaughter1 = 0.1396; massDaughter2 = massDaughter1; break; // k0
-	case 3: resonanceMass = 1.115; massDaughter1 = 0.1396; massDaughter2 = 0.9383; break; // lambda
-	default: AliFatal(Form("Invalid setting %d", fRejectResonanceDaughters));
+        const UInt_t triggerID = particles.GetID()[i];
+        const UInt_t* assocID = assoc.GetID();
+        for (Int_t j=0; j<jMax; j++)
+          pairAccepted[j] &= (assocID[j] != triggerID);
       }
-
-      for (Int_t i=0; i<particles->GetEntriesFast(); i++)
-	particles->UncheckedAt(i)->ResetBit(kResonanceDaughterFlag);
-      if (mixed)
-	for (Int_t i=0; i<jMax; i++)
-	  mixed->UncheckedAt(i)->ResetBit(kResonanceDaughterFlag);
-      
-      for (Int_t i=0; i<particles->GetEntriesFast(); i++)
+      else
       {
-	AliVParticle* triggerParticle = (AliVParticle*) particles->UncheckedAt(i);
-	
-	for (Int_t j=0; j<jMax; j++)
-	{
-	  if (!mixed && i == j)
-	    continue;
-	
-	  AliVParticle* particle = 0;
-	  if (!mixed)
-	    particle = (AliVParticle*) particles->UncheckedAt(j);
-	  else
-	    particle = (AliVParticle*) mixed->UncheckedAt(j);
-	  
-	  // check if both particles point to the same element (does not occur for mixed events, but if subsets are mixed within the same event)
-	  if (fCheckEventNumberInCorrelation)
-	  {
-	    AliBasicParticle* triggerParticleBasic = dynamic_cast<AliBasicParticle*>(triggerParticle);
-	    AliBasicParticle* particleBasic        = dynamic_cast<AliBasicParticle*>(particle);
-	    if(!triggerParticleBasic || !particleBasic)
-	    {
-	      AliFatal("If fCheckEventNumberInCorrelation is set, particle must be derived from AliBasicParticle");
-	      continue;
-	    }
-	
-	    if(triggerParticleBasic->IsInSameEvent(particleBasic))
-	      continue;
-	  }
-	  else if (mixed && triggerParticle->IsEqual(particle))
-	    continue;
-	  
-	  if (triggerParticle->Charge() * particle->Charge() > 0)
-	    continue;
-      
-	  Float_t mass = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerParticle->Eta(), triggerParticle->Phi(), particle->Pt(), particle->Eta(), particle->Phi(), massDaughter1, massDaughter2);
-	      
-	  if (TMath::Abs(mass - resonanceMass*resonanceMass) < interval*5)
-	  {
-	    mass = GetInvMassSquared(triggerParticle->Pt(), triggerParticle->Eta(), triggerParticle->Phi(), particle->Pt(), particle->Eta(), particle->Phi(), massDaughter1, massDaughter2);
-
-	    if (mass > (resonanceMass-interval)*(resonanceMass-interval) && mass < (resonanceMass+interval)*(resonanceMass+interval))
-	    {
-	      triggerParticle->SetBit(kResonanceDaughterFlag);
-	      particle->SetBit(kResonanceDaughterFlag);
-	      
-// 	      Printf("Flagged %d %d %f", i, j, TMath::Sqrt(mass));
-	    }
-	  }
-	}
+        for (Int_t j=0; j<jMax; j++)
+          if (pairAccepted[j] && particles.GetObject(i)->IsEqual(assoc.GetObject(j)))
+            pairAccepted[j] = 0;
       }
     }
-    
-    for (Int_t i=0; i<particles->GetEntriesFast(); i++)
+
+    if (fPtOrder)
+      for (Int_t j=0; j<jMax; j++)
+        pairAccepted[j] &= (assocPt[j] < triggerPt);
+
+    if (fAssociatedSelectCharge != 0)
+      for (Int_t j=0; j<jMax; j++)
+        pairAccepted[j] &= (assocCharge[j] * fAssociatedSelectCharge >= 0);
+
+    // skip like sign
+    if (fSelectCharge == 1)
+      for (Int_t j=0; j<jMax; j++)
+        pairAccepted[j] &= (assocCharge[j] * triggerCharge <= 0);
+
+    // skip unlike sign
+    if (fSelectCharge == 2)
+      for (Int_t j=0; j<jMax; j++)
+        pairAccepted[j] &= (assocCharge[j] * triggerCharge >= 0);
+
+    if (fOnlyOneAssocEtaSide != 0)
+      for (Int_t j=0; j<jMax; j++)
+        pairAccepted[j] &= (fOnlyOneAssocEtaSide * assocEta[j] >= 0);
+
+    if (fEtaOrdering)
     {
-      AliVParticle* triggerParticle = (AliVParticle*) particles->UncheckedAt(i);
-      
-      // some optimization
-      Float_t triggerEta = triggerParticle->Eta();
-      
-      if (fTriggerRestrictEta > 0 && TMath::Abs(triggerEta) > fTriggerRestrictEta)
-	continue;
+      if (triggerEta < 0)
+        for (Int_t j=0; j<jMax; j++)
+          pairAccepted[j] &= !(assocEta[j] < triggerEta);
+      if (triggerEta > 0)
+        for (Int_t j=0; j<jMax; j++)
+          pairAccepted[j] &= !(assocEta[j] > triggerEta);
+    }
+
+    if (fRejectResonanceDaughters > 0)
+      for (Int_t j=0; j<jMax; j++)
+        pairAccepted[j] &= !fAssociatedResonance[j];
 
-      if (fOnlyOneEtaSide != 0)
+    // pass 2: invariant-mass and two-track cuts on the remaining pairs, then fill
+    for (Int_t j=0; j<jMax; j++)
+    {
+      if (!pairAccepted[j])
+        continue;
+
+      const Bool_t unlikeSign = (assocCharge[j] * triggerCharge < 0);
+
+      // conversions
+      if (fCutConversionsV > 0 && unlikeSign)
       {
-	if (fOnlyOneEtaSide * triggerEta < 0)
-	  continue;
+        Float_t mass = GetInvMassSquaredCheap(triggerPt, triggerEta, triggerPhi, assocPt[j], assocEta[j], assocPhi[j], 0.510e-3, 0.510e-3);
+
+        if (mass < fCutConversionsV * 5)
+        {
+          mass = GetInvMassSquared(triggerPt, triggerEta, triggerPhi, assocPt[j], assocEta[j], assocPhi[j], 0.510e-3, 0.510e-3);
+
+          fControlConvResoncances->Fill(0.0, mass);
+
+          if (mass < fCutConversionsV*fCutConversionsV)
+            continue;
+        }
       }
-      
-      if (fTriggerSelectCharge != 0)
-	if (triggerParticle->Charge() * fTriggerSelectCharge < 0)
-	  continue;
-	
-      if (fRejectResonanceDaughters > 0)
-	if (triggerParticle->TestBit(kResonanceDaughterFlag))
-	{
-// 	  Printf("Skipped i=%d", i);
-	  continue;
-	}
-	
-      for (Int_t j=0; j<jMax; j++)
+
+      // K0s
+      if (fCutK0sV > 0 && unlikeSign)
       {
-        if (!mixed && i == j)
-          continue;
-      
-        AliVParticle* particle = 0;
-        if (!mixed)
-          particle = (AliVParticle*) particles->UncheckedAt(j);
-        else
-          particle = (AliVParticle*) mixed->UncheckedAt(j);
-        
-        // check if both particles point to the same element (does not occur for mixed events, but if subsets are mixed within the same event)
-        if (fCheckEventNumberInCorrelation)
+        Float_t mass = GetInvMassSquaredCheap(triggerPt, triggerEta, triggerPhi, assocPt[j], assocEta[j], assocPhi[j], 0.1396, 0.1396);
+
+        const Float_t kK0smass = 0.4976;
+
+        if (TMath::Abs(mass - kK0smass*kK0smass) < fCutK0sV * 5)
         {
-          AliBasicParticle* triggerParticleBasic = dynamic_cast<AliBasicParticle*>(triggerParticle);
-          AliBasicParticle* particleBasic        = dynamic_cast<AliBasicParticle*>(particle);
-          if(!triggerParticleBasic || !particleBasic)
-            AliFatal("If fCheckEventNumberInCorrelation is set, particle must be derived from AliBasicParticle");
-      
-          if(triggerParticleBasic->IsInSameEvent(particleBasic))
+          mass = GetInvMassSquared(triggerPt, triggerEta, triggerPhi, assocPt[j], assocEta[j], assocPhi[j], 0.1396, 0.1396);
+
+          fControlConvResoncances->Fill(1, mass - kK0smass*kK0smass);
+
+          if (mass > (kK0smass-fCutK0sV)*(kK0smass-fCutK0sV) && mass < (kK0smass+fCutK0sV)*(kK0smass+fCutK0sV))
             continue;
         }
-        else if (mixed && triggerParticle->IsEqual(particle))
-          continue;
-        
-        if (fPtOrder)
-	  if (particle->Pt() >= triggerParticle->Pt())
-	    continue;
-	
-	if (fAssociatedSelectCharge != 0)
-	  if (particle->Charge() * fAssociatedSelectCharge < 0)
-	    continue;
-
-        if (fSelectCharge > 0)
+      }
+
+      // Lambda
+      if (fCutLambdaV > 0 && unlikeSign)
+      {
+        Float_t mass1 = GetInvMassSquaredCheap(triggerPt, triggerEta, triggerPhi, assocPt[j], assocEta[j], assocPhi[j], 0.1396, 0.9383);
+        Float_t mass2 = GetInvMassSquaredCheap(triggerPt, triggerEta, triggerPhi, assocPt[j], assocEta[j], assocPhi[j], 0.9383, 0.1396);
+
+        const Float_t kLambdaMass = 1.115;
+
+        if (TMath::Abs(mass1 - kLambdaMass*kLambdaMass) < fCutLambdaV * 5)
         {
-          // skip like sign
-          if (fSelectCharge == 1 && particle->Charge() * triggerParticle->Charge() > 0)
+          mass1 = GetInvMassSquared(triggerPt, triggerEta, triggerPhi, assocPt[j], assocEta[j], assocPhi[j], 0.1396, 0.9383);
+
+          fControlConvResoncances->Fill(2, mass1 - kLambdaMass*kLambdaMass);
+
+          if (mass1 > (kLambdaMass-fCutLambdaV)*(kLambdaMass-fCutLambdaV) && mass1 < (kLambdaMass+fCutLambdaV)*(kLambdaMass+fCutLambdaV))
             continue;
-            
-          // skip unlike sign
-          if (fSelectCharge == 2 && particle->Charge() * triggerParticle->Charge() < 0)
+        }
+        if (TMath::Abs(mass2 - kLambdaMass*kLambdaMass) < fCutLambdaV * 5)
+        {
+          mass2 = GetInvMassSquared(triggerPt, triggerEta, triggerPhi, assocPt[j], assocEta[j], assocPhi[j], 0.9383, 0.1396);
+
+          fControlConvResoncances->Fill(2, mass2 - kLambdaMass*kLambdaMass);
+
+          if (mass2 > (kLambdaMass-fCutLambdaV)*(kLambdaMass-fCutLambdaV) && mass2 < (kLambdaMass+fCutLambdaV)*(kLambdaMass+fCutLambdaV))
             continue;
         }
-        
-        if (fOnlyOneAssocEtaSide != 0)
-          if (fOnlyOneAssocEtaSide * eta[j] < 0)
+      }
+
+      // Phi
+      if (fCutPhiV > 0 && unlikeSign)
+      {
+        Float_t mass = GetInvMassSquaredCheap(triggerPt, triggerEta, triggerPhi, assocPt[j], assocEta[j], assocPhi[j], 0.4937, 0.4937);
+
+        const Float_t kPhimass = 1.019;
+
+        if (TMath::Abs(mass - kPhimass*kPhimass) < fCutPhiV * 5)
+        {
+          mass = GetInvMassSquared(triggerPt, triggerEta, triggerPhi, assocPt[j], assocEta[j], assocPhi[j], 0.4937, 0.4937);
+
+          fControlConvResoncances->Fill(3, mass - kPhimass*kPhimass);
+
+          if (mass > (kPhimass-fCutPhiV)*(kPhimass-fCutPhiV) && mass < (kPhimass+fCutPhiV)*(kPhimass+fCutPhiV))
             continue;
+        }
+      }
 
-	if (fEtaOrdering)
-	{
-	  if (triggerEta < 0 && eta[j] < triggerEta)
-	    continue;
-	  if (triggerEta > 0 && eta[j] > triggerEta)
-	    continue;
-	}
-
-	if (fRejectResonanceDaughters > 0)
-	  if (particle->TestBit(kResonanceDaughterFlag))
-	  {
-// 	    Printf("Skipped j=%d", j);
-	    continue;
-	  }
-
-	// conversions
-	if (fCutConversionsV > 0 && particle->Charge() * triggerParticle->Charge() < 0)
-	{
-	  Float_t mass = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.510e-3, 0.510e-3);
-	  
-	  if (mass < fCutConversionsV * 5)
-	  {
-	    mass = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.510e-3, 0.510e-3);
-	    
-	    fControlConvResoncances->Fill(0.0, mass);
-
-	    if (mass < fCutConversionsV*fCutConversionsV) 
-	      continue;
-	  }
-	}
-	
-	// K0s
-	if (fCutK0sV > 0 && particle->Charge() * triggerParticle->Charge() < 0)
-	{
-	  Float_t mass = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.1396, 0.1396);
-	  
-	  const Float_t kK0smass = 0.4976;
-	  
-	  if (TMath::Abs(mass - kK0smass*kK0smass) < fCutK0sV * 5)
-	  {
-	    mass = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.1396, 0.1396);
-	    
-	    fControlConvResoncances->Fill(1, mass - kK0smass*kK0smass);
-
-	    if (mass > (kK0smass-fCutK0sV)*(kK0smass-fCutK0sV) && mass < (kK0smass+fCutK0sV)*(kK0smass+fCutK0sV))
-	      continue;
-	  }
-	}
-
-	// Lambda
-	if (fCutLambdaV > 0 && particle->Charge() * triggerParticle->Charge() < 0)
-	{
-	  Float_t mass1 = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.1396, 0.9383);
-	  Float_t mass2 = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.9383, 0.1396);
-	  
-	  const Float_t kLambdaMass = 1.115;
-
-	  if (TMath::Abs(mass1 - kLambdaMass*kLambdaMass) < fCutLambdaV * 5)
-	  {
-	    mass1 = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.1396, 0.9383);
-
-	    fControlConvResoncances->Fill(2, mass1 - kLambdaMass*kLambdaMass);
-	    
-	    if (mass1 > (kLambdaMass-fCutLambdaV)*(kLambdaMass-fCutLambdaV) && mass1 < (kLambdaMass+fCutLambdaV)*(kLambdaMass+fCutLambdaV))
-	      continue;
-	  }
-	  if (TMath::Abs(mass2 - kLambdaMass*kLambdaMass) < fCutLambdaV * 5)
-	  {
-	    mass2 = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.9383, 0.1396);
-
-	    fControlConvResoncances->Fill(2, mass2 - kLambdaMass*kLambdaMass);
-
-	    if (mass2 > (kLambdaMass-fCutLambdaV)*(kLambdaMass-fCutLambdaV) && mass2 < (kLambdaMass+fCutLambdaV)*(kLambdaMass+fCutLambdaV))
-	      continue;
-	  }
-	}
-
-        // Phi
-	if (fCutPhiV > 0 && particle->Charge() * triggerParticle->Charge() < 0)
-	{
-	  Float_t mass = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.4937, 0.4937);
-	  
-	  const Float_t kPhimass = 1.019;
-	  
-	  if (TMath::Abs(mass - kPhimass*kPhimass) < fCutPhiV * 5)
-	  {
-	    mass = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.4937, 0.4937);
-	    
-	    fControlConvResoncances->Fill(3, mass - kPhimass*kPhimass);
-	    
-	    if (mass > (kPhimass-fCutPhiV)*(kPhimass-fCutPhiV) && mass < (kPhimass+fCutPhiV)*(kPhimass+fCutPhiV))
-	      continue;
-	  }
-	}	
-
-        // Rho
-	if (fCutRhoV > 0 && particle->Charge() * triggerParticle->Charge() < 0)
+      // Rho
+      if (fCutRhoV > 0 && unlikeSign)
+      {
+        Float_t mass = GetInvMassSquaredCheap(triggerPt, triggerEta, triggerPhi, assocPt[j], assocEta[j], assocPhi[j], 0.1396, 0.1396);
+
+        const Float_t kRhomass = 0.770;
+
+        if (TMath::Abs(mass - kRhomass*kRhomass) < fCutRhoV * 5)
         {
-	  Float_t mass = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.1396, 0.1396);
-	  
-	  const Float_t kRhomass = 0.770;
-	  
-	  if (TMath::Abs(mass - kRhomass*kRhomass) < fCutRhoV * 5)
-          {
-	    mass = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), 0.1396, 0.1396);
-	    
-	    fControlConvResoncances->Fill(4, mass - kRhomass*kRhomass);
-	    
-	    if (mass > (kRhomass-fCutRhoV)*(kRhomass-fCutRhoV) && mass < (kRhomass+fCutRhoV)*(kRhomass+fCutRhoV))
-	      continue;
-	  }
-	}
-
-        // User-defined cut
-	if (fCutCustomMass > 0 && fCutCustomFirst > 0 && fCutCustomSecond > 0 && fCutCustomV > 0 && particle->Charge() * triggerParticle->Charge() < 0)
+          mass = GetInvMassSquared(triggerPt, triggerEta, triggerPhi, assocPt[j], assocEta[j], assocPhi[j], 0.1396, 0.1396);
+
+          fControlConvResoncances->Fill(4, mass - kRhomass*kRhomass);
+
+          if (mass > (kRhomass-fCutRhoV)*(kRhomass-fCutRhoV) && mass < (kRhomass+fCutRhoV)*(kRhomass+fCutRhoV))
+            continue;
+        }
+      }
+
+      // User-defined cut
+      if (fCutCustomMass > 0 && fCutCustomFirst > 0 && fCutCustomSecond > 0 && fCutCustomV > 0 && unlikeSign)
+      {
+        Float_t mass = GetInvMassSquaredCheap(triggerPt, triggerEta, triggerPhi, assocPt[j], assocEta[j], assocPhi[j], fCutCustomFirst, fCutCustomSecond);
+
+        if (TMath::Abs(mass - fCutCustomMass*fCutCustomMass) < fCutCustomV * 5)
         {
-	  Float_t mass = GetInvMassSquaredCheap(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), fCutCustomFirst, fCutCustomSecond);
-	  
-	  if (TMath::Abs(mass - fCutCustomMass*fCutCustomMass) < fCutCustomV * 5)
-          {
-	    mass = GetInvMassSquared(triggerParticle->Pt(), triggerEta, triggerParticle->Phi(), particle->Pt(), eta[j], particle->Phi(), fCutCustomFirst, fCutCustomSecond);
-	    
-	    fControlConvResoncances->Fill(5, mass - fCutCustomMass*fCutCustomMass);
-	    
-	    if (mass > (fCutCustomMass-fCutCustomV)*(fCutCustomMass-fCutCustomV) && mass < (fCutCustomMass+fCutCustomV)*(fCutCustomMass+fCutCustomV))
-	      continue;
-	  }
-	}
-
-	if (twoTrackEfficiencyCut)
-	{
-	  // the variables & cuthave been developed by the HBT group 
-	  // see e.g. https://indico.cern.ch/materialDisplay.py?contribId=36&sessionId=6&materialId=slides&confId=142700
-
-	  Float_t phi1 = triggerParticle->Phi();
-	  Float_t pt1 = triggerParticle->Pt();
-	  Float_t charge1 = triggerParticle->Charge();
-	    
-	  Float_t phi2 = particle->Phi();
-	  Float_t pt2 = particle->Pt();
-	  Float_t charge2 = particle->Charge();
-	      
-	  Float_t deta = triggerEta - eta[j];
-	      
-	  // optimization
-	  if (TMath::Abs(deta) < twoTrackEfficiencyCutValue * 2.5 * 3)
-	  {
-	    // check first boundaries to see if is worth to loop and find the minimum
-	    Float_t dphistar1 = GetDPhiStar(phi1, pt1, charge1, phi2, pt2, charge2, fTwoTrackCutMinRadius, bSign);
-	    Float_t dphistar2 = GetDPhiStar(phi1, pt1, charge1, phi2, pt2, charge2, 2.5, bSign);
-	    
-	    const Float_t kLimit = twoTrackEfficiencyCutValue * 3;
-
-	    Float_t dphistarminabs = 1e5;
-	    Float_t dphistarmin = 1e5;
-	    if (TMath::Abs(dphistar1) < kLimit || TMath::Abs(dphistar2) < kLimit || dphistar1 * dphistar2 < 0)
-	    {
-	      for (Double_t rad=fTwoTrackCutMinRadius; rad<2.51; rad+=0.01) 
-	      {
-		Float_t dphistar = GetDPhiStar(phi1, pt1, charge1, phi2, pt2, charge2, rad, bSign);
-
-		Float_t dphistarabs = TMath::Abs(dphistar);
-		
-		if (dphistarabs < dphistarminabs)
-		{
-		  dphistarmin = dphistar;
-		  dphistarminabs = dphistarabs;
-		}
-	      }
-	      
-	      fTwoTrackDistancePt[0]->Fill(deta, dphistarmin, TMath::Abs(pt1 - pt2));
-	      
-	      if (dphistarminabs < twoTrackEfficiencyCutValue && TMath::Abs(deta) < twoTrackEfficiencyCutValue)
-	      {
-// 		Printf("Removed track pair %d %d with %f %f %f %f %f %f %f %f %f", i, j, deta, dphistarminabs, phi1, pt1, charge1, phi2, pt2, charge2, bSign);
-		continue;
-	      }
-
-    	      fTwoTrackDistancePt[1]->Fill(deta, dphistarmin, TMath::Abs(pt1 - pt2));
-	    }
-	  }
-	}
-        
-        Double_t vars[6];
-        vars[0] = triggerEta - eta[j];
-        vars[1] = particle->Pt();
-        vars[2] = triggerParticle->Pt();
-        vars[3] = centrality;
-        vars[4] = triggerParticle->Phi() - particle->Phi();
-        if (vars[4] > 1.5 * TMath::Pi()) 
-          vars[4] -= TMath::TwoPi();
-        if (vars[4] < -0.5 * TMath::Pi())
-          vars[4] += TMath::TwoPi();
-	vars[5] = zVtx;
-	
-	if (fillpT)
-	  weight = particle->Pt();
-	
-	Double_t useWeight = weight;
-	if (applyEfficiency)
-	{
-	  if (fEfficiencyCorrectionAssociated)
-	  {
-	    Int_t effVars[4];
-	    // associated particle
-	    effVars[0] = fEfficiencyCorrectionAssociated->GetAxis(0)->FindBin(eta[j]);
-	    effVars[1] = fEfficiencyCorrectionAssociated->GetAxis(1)->FindBin(vars[1]); //pt
-	    effVars[2] = fEfficiencyCorrectionAssociated->GetAxis(2)->FindBin(vars[3]); //centrality
-	    effVars[3] = fEfficiencyCorrectionAssociated->GetAxis(3)->FindBin(vars[5]); //zVtx
-	    
-	    // 	  Printf("%d %d %d %d %f", effVars[0], effVars[1], effVars[2], effVars[3], fEfficiencyCorrectionAssociated->GetBinContent(effVars));
-	  
-	    useWeight *= fEfficiencyCorrectionAssociated->GetBinContent(effVars);
-	  }
-	  if (fEfficiencyCorrectionTriggers)
-	  {
-	    Int_t effVars[4];
-
-	    effVars[0] = fEfficiencyCorrectionTriggers->GetAxis(0)->FindBin(triggerEta);
-	    effVars[1] = fEfficiencyCorrectionTriggers->GetAxis(1)->FindBin(vars[2]); //pt
-	    effVars[2] = fEfficiencyCorrectionTriggers->GetAxis(2)->FindBin(vars[3]); //centrality
-	    effVars[3] = fEfficiencyCorrectionTriggers->GetAxis(3)->FindBin(vars[5]); //zVtx
-	    useWeight *= fEfficiencyCorrectionTriggers->GetBinContent(effVars);
-	  }
-	}
-
-	if (fWeightPerEvent)
-	{
-	  Int_t weightBin = triggerWeighting->GetXaxis()->FindBin(vars[2]);
-// 	  Printf("Using weight %f", triggerWeighting->GetBinContent(weightBin));
-	  useWeight /= triggerWeighting->GetBinContent(weightBin);
-	}
-    
-        // fill all in toward region and do not use the other regions
-	fNumberDensityPhi->GetTrackHist(AliUEHist::kToward)->Fill(vars, step, useWeight);
+          mass = GetInvMassSquared(triggerPt, triggerEta, triggerPhi, assocPt[j], assocEta[j], assocPhi[j], fCutCustomFirst, fCutCustomSecond);
+
+          fControlConvResoncances->Fill(5, mass - fCutCustomMass*fCutCustomMass);
 
-// 	Printf("%.2f %.2f --> %.2f", triggerEta, eta[j], vars[0]);
+          if (mass > (fCutCustomMass-fCutCustomV)*(fCutCustomMass-fCutCustomV) && mass < (fCutCustomMass+fCutCustomV)*(fCutCustomMass+fCutCustomV))
+            continue;
+        }
       }
- 
-      if (firstTime)
+
+      if (twoTrackEfficiencyCut)
       {
-        // once per trigger particle
-        Double_t vars[3];
-        vars[0] = triggerParticle->Pt();
-        vars[1] = centrality;
-	vars[2] = zVtx;
-
-	Double_t useWeight = 1;
-	if (fEfficiencyCorrectionTriggers && applyEfficiency)
-	{
-	  Int_t effVars[4];
-	  
-	  // trigger particle
-	  effVars[0] = fEfficiencyCorrectionTriggers->GetAxis(0)->FindBin(triggerEta);
-	  effVars[1] = fEfficiencyCorrectionTriggers->GetAxis(1)->FindBin(vars[0]); //pt
-	  effVars[2] = fEfficiencyCorrectionTriggers->GetAxis(2)->FindBin(vars[1]); //centrality
-	  effVars[3] = fEfficiencyCorrectionTriggers->GetAxis(3)->FindBin(vars[2]); //zVtx
-	  useWeight *= fEfficiencyCorrectionTriggers->GetBinContent(effVars);
-	}
-
-	if (TMath::Abs(triggerEta) < 0.8 && triggerParticle->Pt() > 0)
-	  fInvYield2->Fill(centrality, triggerParticle->Pt(), useWeight / triggerParticle->Pt());
-
-	if (fWeightPerEvent)
-	{
-	  // leads effectively to a filling of one entry per filled trigger particle pT bin
-	  Int_t weightBin = triggerWeighting->GetXaxis()->FindBin(vars[0]);
-// 	  Printf("Using weight %f", triggerWeighting->GetBinContent(weightBin));
-	  useWeight /= triggerWeighting->GetBinContent(weightBin);
-	}
-	
-        fNumberDensityPhi->GetEventHist()->Fill(vars, step, useWeight);
-
-	// QA
-        fCorrelationpT->Fill(centrality, triggerParticle->Pt());
-        fCorrelationEta->Fill(centrality, triggerEta);
-        fCorrelationPhi->Fill(centrality, triggerParticle->Phi());
-	fYields->Fill(centrality, triggerParticle->Pt(), triggerEta);
-	fYieldsEtaPhiPT->Fill(triggerParticle->Pt(), triggerEta, triggerParticle->Phi());
-	
-/*        if (dynamic_cast<AliAODTrack*>(triggerParticle))
-          fITSClusterMap->Fill(((AliAODTrack*) triggerParticle)->GetITSClusterMap(), centrality, triggerParticle->Pt());*/
+        // the variables & cuthave been developed by the HBT group
+        // see e.g. https://indico.cern.ch/materialDisplay.py?contribId=36&sessionId=6&materialId=slides&confId=142700
+
+        Float_t phi1 = triggerPhi;
+        Float_t pt1 = triggerPt;
+        Float_t charge1 = triggerCharge;
+
+        Float_t phi2 = assocPhi[j];
+        Float_t pt2 = assocPt[j];
+        Float_t charge2 = assocCharge[j];
+
+        Float_t deta = pairDEta[j];
+
+        // optimization
+        if (TMath::Abs(deta) < twoTrackEfficiencyCutValue * 2.5 * 3)
+        {
+          // check first boundaries to see if is worth to loop and find the minimum
+          Float_t dphistar1 = GetDPhiStar(phi1, pt1, charge1, phi2, pt2, charge2, fTwoTrackCutMinRadius, bSign);
+          Float_t dphistar2 = GetDPhiStar(phi1, pt1, charge1, phi2, pt2, charge2, 2.5, bSign);
+
+          const Float_t kLimit = twoTrackEfficiencyCutValue * 3;
+
+          Float_t dphistarminabs = 1e5;
+          Float_t dphistarmin = 1e5;
+          if (TMath::Abs(dphistar1) < kLimit || TMath::Abs(dphistar2) < kLimit || dphistar1 * dphistar2 < 0)
+          {
+            for (Double_t rad=fTwoTrackCutMinRadius; rad<2.51; rad+=0.01)
+            {
+              Float_t dphistar = GetDPhiStar(phi1, pt1, charge1, phi2, pt2, charge2, rad, bSign);
+
+              Float_t dphistarabs = TMath::Abs(dphistar);
+
+              if (dphistarabs < dphistarminabs)
+              {
+                dphistarmin = dphistar;
+                dphistarminabs = dphistarabs;
+              }
+            }
+
+            fTwoTrackDistancePt[0]->Fill(deta, dphistarmin, TMath::Abs(pt1 - pt2));
+
+            if (dphistarminabs < twoTrackEfficiencyCutValue && TMath::Abs(deta) < twoTrackEfficiencyCutValue)
+              continue;
+
+            fTwoTrackDistancePt[1]->Fill(deta, dphistarmin, TMath::Abs(pt1 - pt2));
+          }
+        }
       }
+
+      Double_t vars[6];
+      vars[0] = pairDEta[j];
+      vars[1] = assocPt[j];
+      vars[2] = triggerPt;
+      vars[3] = centrality;
+      vars[4] = pairDPhi[j];
+      vars[5] = zVtx;
+
+      if (fillpT)
+        weight = assocPt[j];
+
+      Double_t useWeight = weight;
+      if (useAssociatedEff)
+        useWeight *= fAssociatedEff[j];
+      if (useTriggerEff)
+        useWeight *= fTriggerEff[i];
+
+      if (fWeightPerEvent)
+        useWeight /= fTriggerWeight[i];
+
+      // fill all in toward region and do not use the other regions
+      fNumberDensityPhi->GetTrackHist(AliUEHist::kToward)->Fill(vars, step, useWeight);
     }
-    
-    if (triggerWeighting)
+
+    if (firstTime)
     {
-      delete triggerWeighting;
-      triggerWeighting = 0;
+      // once per trigger particle
+      Double_t vars[3];
+      vars[0] = triggerPt;
+      vars[1] = centrality;
+      vars[2] = zVtx;
+
+      Double_t useWeight = 1;
+      if (useTriggerEff)
+        useWeight *= fTriggerEff[i];
+
+      if (TMath::Abs(triggerEta) < 0.8 && triggerPt > 0)
+        fInvYield2->Fill(centrality, triggerPt, useWeight / triggerPt);
+
+      // leads effectively to a filling of one entry per filled trigger particle pT bin
+      if (fWeightPerEvent)
+        useWeight /= fTriggerWeight[i];
+
+      fNumberDensityPhi->GetEventHist()->Fill(vars, step, useWeight);
+
+      // QA
+      fCorrelationpT->Fill(centrality, triggerPt);
+      fCorrelationEta->Fill(centrality, triggerEta);
+      fCorrelationPhi->Fill(centrality, triggerPhi);
+      fYields->Fill(centrality, triggerPt, triggerEta);
+      fYieldsEtaPhiPT->Fill(triggerPt, triggerEta, triggerPhi);
     }
   }
-  
+
   fCentralityDistribution->Fill(centrality);
-  fCentralityCorrelation->Fill(centrality, particles->GetEntriesFast());
+  fCentralityCorrelation->Fill(centrality, iMax);
   FillEvent(centrality, step);
 }
   
@@ -12,6 +12,8 @@
 #include "AliUEHist.h"
 #include "TMath.h"
 #include "THn.h" // in cxx file causes .../THn.h:257: error: conflicting declaration ‘typedef class THnT<float> THnF’
+#include "AliUEParticleBlock.h"
+#include <vector>
 
 class AliVParticle;
 
@@ -30,6 +32,7 @@ class AliUEHistograms : public TNamed
   
   void Fill(Int_t eventType, Float_t zVtx, AliUEHist::CFStep step, AliVParticle* leading, TList* toward, TList* away, TList* min, TList* max);
   void FillCorrelations(Double_t centrality, Float_t zVtx, AliUEHist::CFStep step, TObjArray* particles, TObjArray* mixed = 0, Float_t weight = 1, Bool_t firstTime = kTRUE, Bool_t twoTrackEfficiencyCut = kFALSE, Float_t bSign = 0, Float_t twoTrackEfficiencyCutValue = 0.02, Bool_t applyEfficiency = kFALSE);
+  void FillCorrelations(Double_t centrality, Float_t zVtx, AliUEHist::CFStep step, const AliUEParticleBlock& particles, const AliUEParticleBlock* mixed = 0, Float_t weight = 1, Bool_t firstTime = kTRUE, Bool_t twoTrackEfficiencyCut = kFALSE, Float_t bSign = 0, Float_t twoTrackEfficiencyCutValue = 0.02, Bool_t applyEfficiency = kFALSE);
   void Fill(AliVParticle* leadingMC, AliVParticle* leadingReco);
   void FillEvent(Int_t eventType, Int_t step);
   void FillEvent(Double_t centrality, Int_t step);
@@ -123,6 +126,7 @@ protected:
   inline Float_t GetInvMassSquared(Float_t pt1, Float_t eta1, Float_t phi1, Float_t pt2, Float_t eta2, Float_t phi2, Float_t m0_1, Float_t m0_2);
   inline Float_t GetInvMassSquaredCheap(Float_t pt1, Float_t eta1, Float_t phi1, Float_t pt2, Float_t eta2, Float_t phi2, Float_t m0_1, Float_t m0_2);
   inline Float_t GetDPhiStar(Float_t phi1, Float_t pt1, Float_t charge1, Float_t phi2, Float_t pt2, Float_t charge2, Float_t radius, Float_t bSign);
+  inline Bool_t IsEqualParticle(const AliUEParticleBlock& block1, Int_t i, const AliUEParticleBlock& block2, Int_t j) const;
   
   static const Int_t fgkUEHists; // number of histograms
 
@@ -182,7 +186,20 @@ protected:
   
   Int_t fMergeCount;		// counts how many objects have been merged together
   
-  ClassDef(AliUEHistograms, 33)  // underlying event histogram container
+  // work space of FillCorrelations, the capacity is kept between calls
+  AliUEParticleBlock fTriggerBlock;        //! block filled from the TObjArray interface (trigger particles)
+  AliUEParticleBlock fAssociatedBlock;     //! block filled from the TObjArray interface (associated particles from mixed)
+  std::vector<Double_t> fTriggerEff;       //! efficiency correction per trigger particle
+  std::vector<Double_t> fAssociatedEff;    //! efficiency correction per associated particle
+  std::vector<Double_t> fTriggerWeight;    //! content of the trigger weighting histogram per trigger particle (fWeightPerEvent)
+  std::vector<Char_t> fTriggerAccepted;    //! trigger particle passes the single-particle selection
+  std::vector<Char_t> fTriggerResonance;   //! trigger particle is flagged as resonance daughter
+  std::vector<Char_t> fAssociatedResonance; //! associated particle is flagged as resonance daughter
+  std::vector<Char_t> fPairAccepted;       //! pair passes the cheap pair cuts (for the current trigger particle)
+  std::vector<Float_t> fPairDEta;          //! delta eta (for the current trigger particle)
+  std::vector<Double_t> fPairDPhi;         //! delta phi (for the current trigger particle)
+  
+  ClassDef(AliUEHistograms, 34)  // underlying event histogram container
 };
 
 Float_t AliUEHistograms::GetDPhiStar(Float_t phi1, Float_t pt1, Float_t charge1, Float_t phi2, Float_t pt2, Float_t charge2, Float_t radius, Float_t bSign)
@@ -290,4 +307,14 @@ Float_t AliUEHistograms::GetInvMassSquaredCheap(Float_t pt1, Float_t eta1, Float
   return mass2;
 }
 
+Bool_t AliUEHistograms::IsEqualParticle(const AliUEParticleBlock& block1, Int_t i, const AliUEParticleBlock& block2, Int_t j) const
+{
+  // same as block1.GetObject(i)->IsEqual(block2.GetObject(j)) without the virtual call for AliBasicParticle and AliCFParticle
+  
+  if (block1.GetEqualByID()[i])
+    return (block1.GetID()[i] == block2.GetID()[j]);
+  
+  return block1.GetObject(i)->IsEqual(block2.GetObject(j));
+}
+
 #endif
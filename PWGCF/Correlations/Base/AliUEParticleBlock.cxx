@@ -0,0 +1,107 @@
+/**************************************************************************
+ * Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. *
+ *                                                                        *
+ * Author: The ALICE Off-line Project.                                    *
+ * Contributors are mentioned in the code where appropriate.              *
+ *                                                                        *
+ * Permission to use, copy, modify and distribute this software and its   *
+ * documentation strictly for non-commercial purposes is hereby granted   *
+ * without fee, provided that the above copyright notice appears in all   *
+ * copies and that both the copyright notice and this permission notice   *
+ * appear in the supporting documentation. The authors make no claims     *
+ * about the suitability of this software for any purpose. It is          *
+ * provided "as is" without express or implied warranty.                  *
+ **************************************************************************/
+
+//
+//
+// structure-of-arrays copy of a list of AliVParticles
+//
+// The block is filled once per event (or once per event taken from the mixing pool) and can be passed
+// to AliUEHistograms::FillCorrelations for all steps, so that the kinematics are read only once
+// through the virtual AliVParticle interface. The capacity of the columns is kept between events.
+//
+
+#include "AliUEParticleBlock.h"
+
+#include "AliVParticle.h"
+#include "AliBasicParticle.h"
+#include "AliCFParticle.h"
+
+#include "TObjArray.h"
+
+ClassImp(AliUEParticleBlock)
+
+//____________________________________________________________________
+AliUEParticleBlock::AliUEParticleBlock() :
+  TObject(),
+  fNParticles(0),
+  fHasEventIndex(kTRUE),
+  fPt(),
+  fPhi(),
+  fEta(),
+  fCharge(),
+  fID(),
+  fEventIndex(),
+  fEqualByID(),
+  fObjects()
+{
+  // Constructor
+}
+
+//____________________________________________________________________
+void AliUEParticleBlock::Clear(Option_t* /*option*/)
+{
+  // resets the block, the allocated capacity is kept
+
+  fNParticles = 0;
+  fHasEventIndex = kTRUE;
+}
+
+//____________________________________________________________________
+void AliUEParticleBlock::Fill(const TObjArray* particles)
+{
+  // copies the kinematics of the AliVParticles in particles into the columns
+  // a 0 pointer results in an empty block
+
+  Clear();
+  if (!particles)
+    return;
+
+  fNParticles = particles->GetEntriesFast();
+
+  fPt.resize(fNParticles);
+  fPhi.resize(fNParticles);
+  fEta.resize(fNParticles);
+  fCharge.resize(fNParticles);
+  fID.resize(fNParticles);
+  fEventIndex.resize(fNParticles);
+  fEqualByID.resize(fNParticles);
+  fObjects.resize(fNParticles);
+
+  for (Int_t i=0; i<fNParticles; i++)
+  {
+    AliVParticle* particle = (AliVParticle*) particles->UncheckedAt(i);
+
+    fPt[i] = particle->Pt();
+    fPhi[i] = particle->Phi();
+    fEta[i] = particle->Eta();
+    fCharge[i] = particle->Charge();
+    fID[i] = particle->GetUniqueID();
+    fObjects[i] = particle;
+
+    AliBasicParticle* basic = dynamic_cast<AliBasicParticle*> (particle);
+    if (basic)
+    {
+      fEventIndex[i] = basic->GetEventIndex();
+      fEqualByID[i] = kTRUE;
+    }
+    else
+    {
+      fEventIndex[i] = -1;
+      fHasEventIndex = kFALSE;
+      // AliCFParticle has the same IsEqual as AliBasicParticle, all other classes go through the virtual call
+      fEqualByID[i] = (dynamic_cast<AliCFParticle*> (particle) != 0);
+    }
+  }
+}
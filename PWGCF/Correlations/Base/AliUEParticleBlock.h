@@ -0,0 +1,55 @@
+#ifndef AliUEParticleBlock_H
+#define AliUEParticleBlock_H
+
+/* Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. *
+ * See cxx source for full Copyright notice                               */
+
+// structure-of-arrays copy of a list of AliVParticles, used by AliUEHistograms::FillCorrelations
+// to avoid virtual calls and casts inside the pair loop
+
+#include "TObject.h"
+#include <vector>
+
+class TObjArray;
+
+class AliUEParticleBlock : public TObject
+{
+ public:
+  AliUEParticleBlock();
+  virtual ~AliUEParticleBlock() {}
+
+  void Fill(const TObjArray* particles);
+  virtual void Clear(Option_t* option = "");
+
+  Int_t GetEntries() const { return fNParticles; }
+  Bool_t HasEventIndex() const { return fHasEventIndex; }
+
+  const Double_t* GetPt() const        { return fPt.data(); }
+  const Double_t* GetPhi() const       { return fPhi.data(); }
+  const Float_t* GetEta() const        { return fEta.data(); }
+  const Short_t* GetCharge() const     { return fCharge.data(); }
+  const UInt_t* GetID() const          { return fID.data(); }
+  const Long64_t* GetEventIndex() const { return fEventIndex.data(); }
+  const Char_t* GetEqualByID() const   { return fEqualByID.data(); }
+  TObject* GetObject(Int_t i) const    { return fObjects[i]; }
+
+ private:
+  AliUEParticleBlock(const AliUEParticleBlock&);
+  AliUEParticleBlock& operator=(const AliUEParticleBlock&);
+
+  Int_t fNParticles;                 // number of particles in the block
+  Bool_t fHasEventIndex;             // all particles are AliBasicParticles, i.e. fEventIndex is valid
+
+  std::vector<Double_t> fPt;         //! pT
+  std::vector<Double_t> fPhi;        //! phi
+  std::vector<Float_t> fEta;         //! eta (float, as cached before in FillCorrelations)
+  std::vector<Short_t> fCharge;      //! charge
+  std::vector<UInt_t> fID;           //! unique ID
+  std::vector<Long64_t> fEventIndex; //! event index (AliBasicParticle only, -1 otherwise)
+  std::vector<Char_t> fEqualByID;    //! IsEqual() of this particle compares unique IDs (otherwise the virtual IsEqual() is called)
+  std::vector<TObject*> fObjects;    //! source objects, not owned
+
+  ClassDef(AliUEParticleBlock, 1)  // SoA particle buffer for correlation filling
+};
+
+#endif
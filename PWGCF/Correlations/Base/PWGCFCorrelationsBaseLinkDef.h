@@ -6,6 +6,7 @@
 
 #pragma link C++ class AliUEHist+;
 #pragma link C++ class AliUEHistograms+;
+#pragma link C++ class AliUEParticleBlock+;
 #pragma link C++ class AliAnalyseLeadingTrackUE+;
 #pragma link C++ class AliCFParticle+;
 #pragma link C++ class AliCFTreeMapping+;
@@ -207,7 +207,10 @@ fCustomParticlesA(""),
 fCustomParticlesB(""),
 fEventPoolOutputList(),
 fUsePtBinnedEventPool(0),
-fCheckEventNumberInMixedEvent(kFALSE)
+fCheckEventNumberInMixedEvent(kFALSE),
+fTracksBlock(),
+fTracksCorrelateBlock(),
+fMixedBlock()
 {
   // Default constructor
   // Define input and output slots here
@@ -1008,14 +1011,23 @@ void  AliAnalysisTaskPhiCorrelations::AnalyseCorrectionMode()
 	delete tmpList;
       }
      
+      // the kinematics are copied once and used for all steps below
+      fTracksBlock.Fill(tracks);
+      AliUEParticleBlock* tracksCorrelateBlock = &fTracksBlock;
+      if (tracksCorrelate != tracks)
+      {
+	fTracksCorrelateBlock.Fill(tracksCorrelate);
+	tracksCorrelateBlock = &fTracksCorrelateBlock;
+      }
+     
       // (RECO all tracks)
       // STEP 6
       if (!fSkipStep6)
-	fHistos->FillCorrelations(centrality, zVtx, AliUEHist::kCFStepReconstructed, tracks, tracksCorrelate, weight);
+	fHistos->FillCorrelations(centrality, zVtx, AliUEHist::kCFStepReconstructed, fTracksBlock, tracksCorrelateBlock, weight);
       
       // two track cut, STEP 8
       if (fTwoTrackEfficiencyCut > 0)
-	fHistos->FillCorrelations(centrality, zVtx, AliUEHist::kCFStepBiasStudy, tracks, tracksCorrelate, weight, kTRUE, kTRUE, bSign, fTwoTrackEfficiencyCut);
+	fHistos->FillCorrelations(centrality, zVtx, AliUEHist::kCFStepBiasStudy, fTracksBlock, tracksCorrelateBlock, weight, kTRUE, kTRUE, bSign, fTwoTrackEfficiencyCut);
 
       // apply correction efficiency, STEP 10
       if (fEfficiencyCorrectionTriggers || fEfficiencyCorrectionAssociated)
@@ -1023,7 +1035,7 @@ void  AliAnalysisTaskPhiCorrelations::AnalyseCorrectionMode()
 	  // with or without two track efficiency depending on if fTwoTrackEfficiencyCut is set
 	Bool_t twoTrackCut = (fTwoTrackEfficiencyCut > 0);
 	
-	fHistos->FillCorrelations(centrality, zVtx, AliUEHist::kCFStepCorrected, tracks, tracksCorrelate, weight, kTRUE, twoTrackCut, bSign, fTwoTrackEfficiencyCut, kTRUE);
+	fHistos->FillCorrelations(centrality, zVtx, AliUEHist::kCFStepCorrected, fTracksBlock, tracksCorrelateBlock, weight, kTRUE, twoTrackCut, bSign, fTwoTrackEfficiencyCut, kTRUE);
       }
       
       // mixed event
@@ -1038,13 +1050,15 @@ void  AliAnalysisTaskPhiCorrelations::AnalyseCorrectionMode()
           {
             for (Int_t jMix=0; jMix<pool2->GetCurrentNEvents(); jMix++)
             {
+              fMixedBlock.Fill(pool2->GetEvent(jMix));
+              
               // STEP 6
               if (!fSkipStep6)
-                fHistosMixed->FillCorrelations(centrality, zVtx, AliUEHist::kCFStepReconstructed, tracks, pool2->GetEvent(jMix), 1.0 / pool2->GetCurrentNEvents(), (jMix == 0));
+                fHistosMixed->FillCorrelations(centrality, zVtx, AliUEHist::kCFStepReconstructed, fTracksBlock, &fMixedBlock, 1.0 / pool2->GetCurrentNEvents(), (jMix == 0));
               
               // two track cut, STEP 8
               if (fTwoTrackEfficiencyCut > 0)
-                fHistosMixed->FillCorrelations(centrality, zVtx, AliUEHist::kCFStepBiasStudy, tracks, pool2->GetEvent(jMix), 1.0 / pool2->GetCurrentNEvents(), (jMix == 0), kTRUE, bSign, fTwoTrackEfficiencyCut);
+                fHistosMixed->FillCorrelations(centrality, zVtx, AliUEHist::kCFStepBiasStudy, fTracksBlock, &fMixedBlock, 1.0 / pool2->GetCurrentNEvents(), (jMix == 0), kTRUE, bSign, fTwoTrackEfficiencyCut);
               
               // apply correction efficiency, STEP 10
               if (fEfficiencyCorrectionTriggers || fEfficiencyCorrectionAssociated)
@@ -1052,7 +1066,7 @@ void  AliAnalysisTaskPhiCorrelations::AnalyseCorrectionMode()
                 // with or without two track efficiency depending on if fTwoTrackEfficiencyCut is set
                 Bool_t twoTrackCut = (fTwoTrackEfficiencyCut > 0);
                 
-                fHistosMixed->FillCorrelations(centrality, zVtx, AliUEHist::kCFStepCorrected, tracks, pool2->GetEvent(jMix), 1.0 / pool2->GetCurrentNEvents(), (jMix == 0), twoTrackCut, bSign, fTwoTrackEfficiencyCut, kTRUE);
+                fHistosMixed->FillCorrelations(centrality, zVtx, AliUEHist::kCFStepCorrected, fTracksBlock, &fMixedBlock, 1.0 / pool2->GetCurrentNEvents(), (jMix == 0), twoTrackCut, bSign, fTwoTrackEfficiencyCut, kTRUE);
               }
             }
           }
@@ -1377,19 +1391,32 @@ void  AliAnalysisTaskPhiCorrelations::AnalyseDataMode()
   // Fill containers at STEP 6 (reconstructed)
   if (centrality >= 0)
   {
+    // the kinematics are copied once and used for both steps
+    fTracksBlock.Fill(tracks);
+    AliUEParticleBlock* tracksCorrelateBlock = 0;
+    if (tracksCorrelate)
+    {
+      fTracksCorrelateBlock.Fill(tracksCorrelate);
+      tracksCorrelateBlock = &fTracksCorrelateBlock;
+    }
+    
     if (!fSkipStep6)
-      fHistos->FillCorrelations(centrality, zVtx, AliUEHist::kCFStepReconstructed, tracks, tracksCorrelate, weight, kTRUE, kFALSE, 0, 0.02, kTRUE);
+      fHistos->FillCorrelations(centrality, zVtx, AliUEHist::kCFStepReconstructed, fTracksBlock, tracksCorrelateBlock, weight, kTRUE, kFALSE, 0, 0.02, kTRUE);
     
     ((TH1F*) fListOfHistos->FindObject("eventStat"))->Fill(1);
     
     if (fTwoTrackEfficiencyCut > 0)
-      fHistos->FillCorrelations(centrality, zVtx, AliUEHist::kCFStepBiasStudy, tracks, tracksCorrelate, weight, kTRUE, kTRUE, bSign, fTwoTrackEfficiencyCut, kTRUE);
+      fHistos->FillCorrelations(centrality, zVtx, AliUEHist::kCFStepBiasStudy, fTracksBlock, tracksCorrelateBlock, weight, kTRUE, kTRUE, bSign, fTwoTrackEfficiencyCut, kTRUE);
   }
 
   // create a list of reduced objects. This speeds up processing and reduces memory consumption for the event pool
   TObjArray* tracksClone = CloneAndReduceTrackList(tracks);
   delete tracks;
   
+  // the triggers for mixing are the reduced particles, they are shared by all pools and pool events
+  if (fFillMixed)
+    fTracksBlock.Fill(tracksClone);
+  
   if (fFillMixed)
   {
     // event mixing
@@ -1433,12 +1460,13 @@ void  AliAnalysisTaskPhiCorrelations::AnalyseDataMode()
         for (Int_t jMix=0; jMix<nMix; jMix++) 
         {
           TObjArray* bgTracks = pool->GetEvent(jMix);
+          fMixedBlock.Fill(bgTracks);
         
           if (!fSkipStep6)
-            fHistosMixed->FillCorrelations(centrality, zVtx, AliUEHist::kCFStepReconstructed, tracksClone, bgTracks, 1.0 / nMix, (jMix == 0), kFALSE, 0, 0.02, kTRUE);
+            fHistosMixed->FillCorrelations(centrality, zVtx, AliUEHist::kCFStepReconstructed, fTracksBlock, &fMixedBlock, 1.0 / nMix, (jMix == 0), kFALSE, 0, 0.02, kTRUE);
 
           if (fTwoTrackEfficiencyCut > 0)
-            fHistosMixed->FillCorrelations(centrality, zVtx, AliUEHist::kCFStepBiasStudy, tracksClone, bgTracks, 1.0 / nMix, (jMix == 0), kTRUE, bSign, fTwoTrackEfficiencyCut, kTRUE);
+            fHistosMixed->FillCorrelations(centrality, zVtx, AliUEHist::kCFStepBiasStudy, fTracksBlock, &fMixedBlock, 1.0 / nMix, (jMix == 0), kTRUE, bSign, fTwoTrackEfficiencyCut, kTRUE);
         }
       }
       
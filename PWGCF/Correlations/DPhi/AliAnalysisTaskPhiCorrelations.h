@@ -30,6 +30,7 @@
 #include "AliUEHist.h"
 #include "TString.h"
 #include "AliBasicParticle.h"
+#include "AliUEParticleBlock.h"
 #include "AliLog.h"
 #include "THn.h" // in cxx file causes .../THn.h:257: error: conflicting declaration ‘typedef class THnT<float> THnF’
 
@@ -342,7 +343,12 @@ private:
   Bool_t                      fUsePtBinnedEventPool; // uses event pool in pt bins
   Bool_t                      fCheckEventNumberInMixedEvent; // check event number before correlation in mixed event
 
-  ClassDef(AliAnalysisTaskPhiCorrelations, 62); // Analysis task for delta phi correlations
+  // SoA copies of the particle lists, filled once per event (pool event) and reused for all steps
+  AliUEParticleBlock fTracksBlock;          //! trigger particles
+  AliUEParticleBlock fTracksCorrelateBlock; //! associated particles (same event)
+  AliUEParticleBlock fMixedBlock;           //! associated particles (pool event)
+
+  ClassDef(AliAnalysisTaskPhiCorrelations, 63); // Analysis task for delta phi correlations
 };
 
 #endif
@@ -34,6 +34,19 @@ void AliFemtoCorrFctn::AddMixedPair(AliFemtoPair*)
   cout << "AliFemtoCorrFctn::AddMixedPair -- Not implemented\n";
 }
 
+void AliFemtoCorrFctn::AddRealPairs(const AliFemtoPairBlock& pairs)
+{
+  for (size_t i = 0; i < pairs.Size(); ++i) {
+    AddRealPair(pairs.Pair(i));
+  }
+}
+void AliFemtoCorrFctn::AddMixedPairs(const AliFemtoPairBlock& pairs)
+{
+  for (size_t i = 0; i < pairs.Size(); ++i) {
+    AddMixedPair(pairs.Pair(i));
+  }
+}
+
 void AliFemtoCorrFctn::AddFirstParticle(AliFemtoParticle*, bool)
 {
   cout << "AliFemtoCorrFctn::AddFirstParticle -- Not implemented\n";
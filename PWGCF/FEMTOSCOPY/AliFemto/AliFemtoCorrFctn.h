@@ -10,6 +10,7 @@
 #include "AliFemtoAnalysis.h"
 #include "AliFemtoEvent.h"
 #include "AliFemtoPair.h"
+#include "AliFemtoPairBlock.h"
 #include "AliFemtoPairCut.h"
 
 #include <TCollection.h>
@@ -44,6 +45,15 @@ public:
   /// Not Implemented - Add background pair
   virtual void AddMixedPair(AliFemtoPair* aPir);
 
+  /// Add a block of signal pairs
+  ///
+  /// The default calls AddRealPair for each pair in the block.
+  /// Correlation functions which only need the precomputed pair
+  /// kinematics may override this to fill their histograms directly.
+  virtual void AddRealPairs(const AliFemtoPairBlock& pairs);
+  /// Add a block of background pairs - see AddRealPairs
+  virtual void AddMixedPairs(const AliFemtoPairBlock& pairs);
+
   /// Not Implemented - Add pair with optional
   virtual void AddFirstParticle(AliFemtoParticle *particle, bool mixing);
   virtual void AddSecondParticle(AliFemtoParticle *particle);
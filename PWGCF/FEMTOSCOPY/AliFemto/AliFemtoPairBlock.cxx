@@ -0,0 +1,102 @@
+///
+/// \file AliFemtoPairBlock.cxx
+///
+
+#include "AliFemtoPairBlock.h"
+
+AliFemtoPairBlock::AliFemtoPairBlock():
+  fPairs(),
+  fSize(0),
+  fKinematicsCalculated(false),
+  fKinematicsCMSCalculated(false),
+  fQInv(),
+  fKT(),
+  fQOutCMS(),
+  fQSideCMS(),
+  fQLongCMS()
+{
+  fPairs.reserve(kDefaultSize);
+}
+
+AliFemtoPairBlock::AliFemtoPairBlock(const AliFemtoPairBlock& orig):
+  fPairs(),
+  fSize(0),
+  fKinematicsCalculated(false),
+  fKinematicsCMSCalculated(false),
+  fQInv(),
+  fKT(),
+  fQOutCMS(),
+  fQSideCMS(),
+  fQLongCMS()
+{
+  fPairs.reserve(kDefaultSize);
+  *this = orig;
+}
+
+AliFemtoPairBlock& AliFemtoPairBlock::operator=(const AliFemtoPairBlock& orig)
+{
+  // the copy gets its own pair objects with the same particles,
+  // cached pair quantities are not copied
+  if (this != &orig) {
+    Clear();
+    for (size_t i = 0; i < orig.Size(); ++i) {
+      AliFemtoPair *pair = Candidate();
+      pair->SetTrack1(orig.Track1(i));
+      pair->SetTrack2(orig.Track2(i));
+      Accept();
+    }
+  }
+  return *this;
+}
+
+AliFemtoPairBlock::~AliFemtoPairBlock()
+{
+  for (size_t i = 0; i < fPairs.size(); ++i) {
+    delete fPairs[i];
+  }
+}
+
+void AliFemtoPairBlock::Clear()
+{
+  fSize = 0;
+  fKinematicsCalculated = false;
+  fKinematicsCMSCalculated = false;
+}
+
+void AliFemtoPairBlock::CalculateKinematics() const
+{
+  if (fKinematicsCalculated) {
+    return;
+  }
+
+  fQInv.resize(fSize);
+  fKT.resize(fSize);
+
+  for (size_t i = 0; i < fSize; ++i) {
+    const AliFemtoPair *pair = fPairs[i];
+    fQInv[i] = pair->QInv();
+    fKT[i] = pair->KT();
+  }
+
+  fKinematicsCalculated = true;
+}
+
+void AliFemtoPairBlock::CalculateKinematicsCMS() const
+{
+  if (fKinematicsCMSCalculated) {
+    return;
+  }
+
+  fQOutCMS.resize(fSize);
+  fQSideCMS.resize(fSize);
+  fQLongCMS.resize(fSize);
+
+  for (size_t i = 0; i < fSize; ++i) {
+    const AliFemtoPair *pair = fPairs[i];
+    fQOutCMS[i] = pair->QOutCMS();
+    fQSideCMS[i] = pair->QSideCMS();
+    fQLongCMS[i] = pair->QLongCMS();
+  }
+
+  fKinematicsCMSCalculated = true;
+}
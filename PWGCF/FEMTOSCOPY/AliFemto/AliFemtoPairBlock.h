@@ -0,0 +1,99 @@
+///
+/// \file  AliFemtoPairBlock.h
+/// \class AliFemtoPairBlock
+/// \brief A block of pairs which passed the pair cut, handed to the
+///        correlation functions in one call
+///
+/// AliFemtoSimpleAnalysis::MakePairs collects the accepted pairs of one
+/// (event, mixed event) combination in blocks of at most
+/// AliFemtoPairBlock::kDefaultSize pairs and passes each block to
+/// AliFemtoCorrFctn::AddRealPairs / AddMixedPairs.
+///
+/// Each entry is a persistent AliFemtoPair owned by the block: the pair
+/// cut is applied to Candidate() and Accept() keeps it. Quantities cached
+/// by the pair (NonId and merging parameters) are therefore computed once
+/// and shared by the pair cut and all correlation functions, as for the
+/// single pair passed to them before.
+///
+/// The relative-momentum variables used by most correlation functions are
+/// computed for the whole block the first time they are requested and
+/// kept in contiguous arrays: qinv and kT together, the LCMS components
+/// only when one of them is requested.
+///
+
+#ifndef ALIFEMTOPAIRBLOCK_H
+#define ALIFEMTOPAIRBLOCK_H
+
+#include <vector>
+
+#include "AliFemtoPair.h"
+
+class AliFemtoPairBlock {
+public:
+  /// maximum number of pairs collected before the block is handed over
+  static const size_t kDefaultSize = 1024;
+
+  AliFemtoPairBlock();
+  AliFemtoPairBlock(const AliFemtoPairBlock&);
+  AliFemtoPairBlock& operator=(const AliFemtoPairBlock&);
+  ~AliFemtoPairBlock();
+
+  /// Remove all pairs, the pair objects are kept for re-use
+  void Clear();
+
+  /// Pair object for the next candidate. It becomes part of the block
+  /// with Accept(), otherwise it is re-used by the next call.
+  AliFemtoPair* Candidate();
+  /// Keep the pair returned by the last call of Candidate()
+  void Accept();
+
+  size_t Size() const { return fSize; }
+  bool Empty() const { return fSize == 0; }
+
+  AliFemtoParticle* Track1(size_t i) const { return fPairs[i]->Track1(); }
+  AliFemtoParticle* Track2(size_t i) const { return fPairs[i]->Track2(); }
+
+  /// Return the pair of entry i. The object is owned by the block and
+  /// re-used after the block is cleared, so it must not be stored.
+  AliFemtoPair* Pair(size_t i) const { return fPairs[i]; }
+
+  /// Precomputed kinematics, one entry per pair (same definitions as
+  /// the AliFemtoPair methods of the same name)
+  const double* QInv() const { CalculateKinematics(); return fQInv.data(); }
+  const double* KT() const { CalculateKinematics(); return fKT.data(); }
+  const double* QOutCMS() const { CalculateKinematicsCMS(); return fQOutCMS.data(); }
+  const double* QSideCMS() const { CalculateKinematicsCMS(); return fQSideCMS.data(); }
+  const double* QLongCMS() const { CalculateKinematicsCMS(); return fQLongCMS.data(); }
+
+private:
+  void CalculateKinematics() const;
+  void CalculateKinematicsCMS() const;
+
+  std::vector<AliFemtoPair*> fPairs;            ///< owned pair objects, the first fSize are in the block
+  size_t fSize;                                 ///< number of accepted pairs
+
+  mutable bool fKinematicsCalculated;           ///< fQInv and fKT are filled
+  mutable bool fKinematicsCMSCalculated;        ///< the LCMS arrays are filled
+  mutable std::vector<double> fQInv;            ///< qinv
+  mutable std::vector<double> fKT;              ///< kT
+  mutable std::vector<double> fQOutCMS;         ///< q_out in LCMS
+  mutable std::vector<double> fQSideCMS;        ///< q_side in LCMS
+  mutable std::vector<double> fQLongCMS;        ///< q_long in LCMS
+};
+
+inline AliFemtoPair* AliFemtoPairBlock::Candidate()
+{
+  if (fSize == fPairs.size()) {
+    fPairs.push_back(new AliFemtoPair);
+  }
+  return fPairs[fSize];
+}
+
+inline void AliFemtoPairBlock::Accept()
+{
+  ++fSize;
+  fKinematicsCalculated = false;
+  fKinematicsCMSCalculated = false;
+}
+
+#endif
@@ -245,6 +245,41 @@ void AliFemtoQinvCorrFctn::AddMixedPair(AliFemtoPair* pair)
   }
 }
 
+//____________________________
+void AliFemtoQinvCorrFctn::AddRealPairs(const AliFemtoPairBlock& pairs)
+{
+  // add a block of true pairs - without own pair cut and (Δη, Δϕ*)
+  // histograms only qinv and kT are needed, which the block provides
+  if (fPairCut || fDetaDphiscal) {
+    AliFemtoCorrFctn::AddRealPairs(pairs);
+    return;
+  }
+
+  const double *qinv = pairs.QInv(),
+               *kt = pairs.KT();
+
+  for (size_t i = 0; i < pairs.Size(); ++i) {
+    fNumerator->Fill(fabs(qinv[i]));
+    fkTMonitor->Fill(kt[i]);
+  }
+}
+
+//____________________________
+void AliFemtoQinvCorrFctn::AddMixedPairs(const AliFemtoPairBlock& pairs)
+{
+  // add a block of mixed (background) pairs - see AddRealPairs
+  if (fPairCut || fDetaDphiscal || fPairKinematics) {
+    AliFemtoCorrFctn::AddMixedPairs(pairs);
+    return;
+  }
+
+  const double *qinv = pairs.QInv();
+
+  for (size_t i = 0; i < pairs.Size(); ++i) {
+    fDenominator->Fill(fabs(qinv[i]));
+  }
+}
+
 void AliFemtoQinvCorrFctn::Write()
 {
   // Write out neccessary objects
@@ -65,6 +65,8 @@ public:
   virtual AliFemtoString Report();
   virtual void AddRealPair(AliFemtoPair* aPair);
   virtual void AddMixedPair(AliFemtoPair* aPair);
+  virtual void AddRealPairs(const AliFemtoPairBlock& pairs);
+  virtual void AddMixedPairs(const AliFemtoPairBlock& pairs);
 
   virtual void Finish();
 
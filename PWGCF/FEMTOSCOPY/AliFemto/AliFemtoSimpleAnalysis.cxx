@@ -183,7 +183,8 @@ AliFemtoSimpleAnalysis::AliFemtoSimpleAnalysis():
   fMinSizePartCollection(0),
   fVerbose(kTRUE),
   fPerformSharedDaughterCut(kFALSE),
-  fEnablePairMonitors(kFALSE)
+  fEnablePairMonitors(kFALSE),
+  fPairBlock()
 {
   // Default constructor
   fCorrFctnCollection = new AliFemtoCorrFctnCollection;
@@ -205,7 +206,8 @@ AliFemtoSimpleAnalysis::AliFemtoSimpleAnalysis(const AliFemtoSimpleAnalysis& a):
   fMinSizePartCollection(a.fMinSizePartCollection),
   fVerbose(a.fVerbose),
   fPerformSharedDaughterCut(a.fPerformSharedDaughterCut),
-  fEnablePairMonitors(a.fEnablePairMonitors)
+  fEnablePairMonitors(a.fEnablePairMonitors),
+  fPairBlock()
 {
   /// Copy constructor
 
@@ -581,8 +583,8 @@ void AliFemtoSimpleAnalysis::MakePairs(const char* typeIn,
                                        AliFemtoParticleCollection *partCollection2,
                                        Bool_t enablePairMonitors)
 {
-/// Build pairs, check pair cuts, and call CFs' AddRealPair() or
-/// AddMixedPair() methods. If no second particle collection is
+/// Build pairs, check pair cuts, and call CFs' AddRealPairs() or
+/// AddMixedPairs() methods. If no second particle collection is
 /// specfied, make pairs within first particle collection.
 
   bool these_are_real_pairs = 0 == strcmp(typeIn, "real");
@@ -620,8 +622,9 @@ void AliFemtoSimpleAnalysis::MakePairs(const char* typeIn,
     tEndInnerLoop = partCollection1->end() ;     //   Inner loop goes to last particle
   }
 
-  // Create the pair outside the loop - only allocate once
-  AliFemtoPair* tPair = new AliFemtoPair;
+  // The candidate pairs are the entries of the block of accepted pairs,
+  // their memory is re-used for every call
+  fPairBlock.Clear();
 
   // Begin the outer loop
   for (AliFemtoParticleConstIterator tPartIter1 = tStartOuterLoop;
@@ -635,17 +638,17 @@ void AliFemtoSimpleAnalysis::MakePairs(const char* typeIn,
       tStartInnerLoop++;
     }
 
-    // If we have two collections - set the first track
-    if (partCollection2 != nullptr) {
-      tPair->SetTrack1(*tPartIter1);
-    }
-
     // Begin the inner loop
     for (AliFemtoParticleConstIterator tPartIter2 = tStartInnerLoop;
                                        tPartIter2 != tEndInnerLoop;
                                      ++tPartIter2) {
-      // If we have two collections - only set the second track
+      // The candidate is the next entry of the block, so the quantities
+      // cached by the pair cut are kept for the correlation functions
+      AliFemtoPair* tPair = fPairBlock.Candidate();
+
+      // If we have two collections - no swapping
       if (partCollection2 != nullptr) {
+        tPair->SetTrack1(*tPartIter1);
         tPair->SetTrack2(*tPartIter2);
 
       // Swap between first and second particles to avoid biased ordering
@@ -663,21 +666,38 @@ void AliFemtoSimpleAnalysis::MakePairs(const char* typeIn,
         fPairCut->FillCutMonitor(tPair, tmpPassPair);
       }
 
-      // If pair passes cut, loop over CF's and add pair to real/mixed
+      // If pair passes cut, keep it for the correlation functions
       if (tmpPassPair) {
-        for (auto &tCorrFctn : *fCorrFctnCollection) {
-          if (these_are_real_pairs)
-            tCorrFctn->AddRealPair(tPair);
-          else
-            tCorrFctn->AddMixedPair(tPair);
-        } // loop over correlation functions
+        fPairBlock.Accept();
+        if (fPairBlock.Size() >= AliFemtoPairBlock::kDefaultSize) {
+          FlushPairBlock(these_are_real_pairs);
+        }
       }
 
     }    // loop over second particle
   }      // loop over first particle
 
-  // we are done with the pair
-  delete tPair;
+  // hand the remaining pairs to the correlation functions
+  FlushPairBlock(these_are_real_pairs);
+}
+
+//_________________________
+void AliFemtoSimpleAnalysis::FlushPairBlock(bool these_are_real_pairs)
+{
+  /// Loop over CF's and add the pairs to real/mixed
+
+  if (fPairBlock.Empty()) {
+    return;
+  }
+
+  for (auto &tCorrFctn : *fCorrFctnCollection) {
+    if (these_are_real_pairs)
+      tCorrFctn->AddRealPairs(fPairBlock);
+    else
+      tCorrFctn->AddMixedPairs(fPairBlock);
+  } // loop over correlation functions
+
+  fPairBlock.Clear();
 }
 //_________________________
 void AliFemtoSimpleAnalysis::EventBegin(const AliFemtoEvent* ev)
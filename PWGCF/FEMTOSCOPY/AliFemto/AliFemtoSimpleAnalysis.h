@@ -148,17 +148,25 @@ protected:
   /// Increment fNeventsProcessed - is this method neccessary?
   void AddEventProcessed();
 
-  /// Build pairs, check pair cuts, and call CFs' AddRealPair() or
-  /// AddMixedPair() methods. If no second particle collection is
+  /// Build pairs, check pair cuts, and call CFs' AddRealPairs() or
+  /// AddMixedPairs() methods. If no second particle collection is
   /// specfied, make pairs within first particle collection.
   ///
+  /// Pairs passing the pair cut are collected in fPairBlock, which is
+  /// handed to the correlation functions whenever it is full and once
+  /// more after the last pair.
+  ///
   /// \param type Either the string "real" or "mixed", specifying which method
-  ///             to call (AddRealPair or AddMixedPair)
+  ///             to call (AddRealPairs or AddMixedPairs)
   void MakePairs(const char* type,
                  AliFemtoParticleCollection* ParticlesPassingCut1,
                  AliFemtoParticleCollection* ParticlesPssingCut2=NULL,
                  Bool_t enablePairMonitors=kFALSE);
 
+  /// Pass the pairs in fPairBlock to all correlation functions and
+  /// empty the block
+  void FlushPairBlock(bool these_are_real_pairs);
+
   AliFemtoPicoEventCollectionVectorHideAway* fPicoEventCollectionVectorHideAway; //!<! Mixing Buffer used for Analyses which wrap this one
 
   AliFemtoPairCut*             fPairCut;             ///< cut applied to pairs
@@ -178,6 +186,8 @@ protected:
   Bool_t fPerformSharedDaughterCut;
   Bool_t fEnablePairMonitors;
 
+  AliFemtoPairBlock fPairBlock;                      //!<! Pairs passing the pair cut, not yet given to the correlation functions, and the candidate pair
+
 #ifdef __ROOT__
   /// \cond CLASSIMP
   ClassDef(AliFemtoSimpleAnalysis, 0);
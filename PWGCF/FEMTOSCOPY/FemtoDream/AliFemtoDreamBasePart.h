@@ -49,17 +49,19 @@ class AliFemtoDreamBasePart {
   size_t GetNdaughters() const {
     return fP.size();
   }
-  TVector3 GetMomentum(unsigned int iEntr = 0) const {
-    if (iEntr > fP.size()) {
+  // the getters of the vector members return const references, they are
+  // called per pair in the close pair rejection and mixing
+  const TVector3 &GetMomentum(unsigned int iEntr = 0) const {
+    if (iEntr >= fP.size()) {
       std::cout << "Trying to get a momentum which is out of bounds. iEntr = "
                 << iEntr << std::endl;
-    } else {
-      return fP.at(iEntr);
+      static const TVector3 invalidMomentum(-999, -999, -999);
+      return invalidMomentum;
     }
-    return TVector3(-999,-999,-999);
+    return fP[iEntr];
   }
   ;
-  std::vector<TVector3> GetMomenta() const {
+  const std::vector<TVector3> &GetMomenta() const {
     return fP;
   }
   float GetP() const {
@@ -69,7 +71,7 @@ class AliFemtoDreamBasePart {
     fMCP.SetXYZ(px, py, pz);
   }
   ;
-  TVector3 GetMCMomentum() const {
+  const TVector3 &GetMCMomentum() const {
     return fMCP;
   }
   ;
@@ -101,7 +103,7 @@ class AliFemtoDreamBasePart {
     fEta.push_back(eta);
   }
   ;
-  std::vector<float> GetEta() const {
+  const std::vector<float> &GetEta() const {
     return fEta;
   }
   ;
@@ -109,7 +111,7 @@ class AliFemtoDreamBasePart {
     fTheta.push_back(theta);
   }
   ;
-  std::vector<float> GetTheta() const {
+  const std::vector<float> &GetTheta() const {
     return fTheta;
   }
   ;
@@ -117,7 +119,7 @@ class AliFemtoDreamBasePart {
     fMCTheta.push_back(theta);
   }
   ;
-  std::vector<float> GetMCTheta() const {
+  const std::vector<float> &GetMCTheta() const {
     return fMCTheta;
   }
   ;
@@ -125,7 +127,7 @@ class AliFemtoDreamBasePart {
     fPhi.push_back(phi);
   }
   ;
-  std::vector<float> GetPhi() const {
+  const std::vector<float> &GetPhi() const {
     return fPhi;
   }
   ;
@@ -133,7 +135,7 @@ class AliFemtoDreamBasePart {
     fPhiAtRadius.push_back(phiAtRad);
   }
   ;
-  std::vector<std::vector<float>> GetPhiAtRaidius() const {
+  const std::vector<std::vector<float>> &GetPhiAtRaidius() const {
     return fPhiAtRadius;
   }
   ;
@@ -156,7 +158,7 @@ class AliFemtoDreamBasePart {
     fXYZAtRadius.push_back(XYZAtRad);
   }
   ;
-  std::vector<TVector3> GetXYZAtRadius() {
+  const std::vector<TVector3> &GetXYZAtRadius() const {
     return fXYZAtRadius;
   }
   ;
@@ -164,7 +166,7 @@ class AliFemtoDreamBasePart {
     fMCPhi.push_back(phi);
   }
   ;
-  std::vector<float> GetMCPhi() const {
+  const std::vector<float> &GetMCPhi() const {
     return fMCPhi;
   }
   ;
@@ -172,7 +174,7 @@ class AliFemtoDreamBasePart {
     fIDTracks.push_back(idTracks);
   }
   ;
-  std::vector<int> GetIDTracks() const {
+  const std::vector<int> &GetIDTracks() const {
     return fIDTracks;
   }
   ;
@@ -180,7 +182,7 @@ class AliFemtoDreamBasePart {
     fCharge.push_back(charge);
   }
   ;
-  std::vector<int> GetCharge() const {
+  const std::vector<int> &GetCharge() const {
     return fCharge;
   }
   ;
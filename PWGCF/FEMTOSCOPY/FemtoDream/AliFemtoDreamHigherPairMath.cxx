@@ -108,11 +108,11 @@ void AliFemtoDreamHigherPairMath::RecalculatePhiStar(
     AliWarning(
         "BField was most probably not set! PhiStar Calculation meaningless. \n");
   }
-  std::vector<TVector3> momenta = part.GetMomenta();
+  const std::vector<TVector3> &momenta = part.GetMomenta();
   unsigned int nPart = momenta.size();
   unsigned int counter = 0;
   part.ResizePhiAtRadii(0);
-  for (auto it : momenta) {
+  for (const auto &it : momenta) {
     if (nPart != 1 && counter == 0) {
       counter++;
       continue;
@@ -528,11 +528,11 @@ bool AliFemtoDreamHigherPairMath::DeltaEtaDeltaPhi(int Hist,
             Hist, nDaug2, (unsigned int)part2.GetPhiAtRaidius().size());
     AliWarning(outMessage.Data());
   }
-  std::vector<float> eta1 = part1.GetEta();
-  std::vector<float> eta2 = part2.GetEta();
+  const std::vector<float> &eta1 = part1.GetEta();
+  const std::vector<float> &eta2 = part2.GetEta();
 
   for (unsigned int iDaug1 = 0; iDaug1 < nDaug1; ++iDaug1) {
-    std::vector<float> PhiAtRad1 = part1.GetPhiAtRaidius().at(iDaug1);
+    const std::vector<float> &PhiAtRad1 = part1.GetPhiAtRaidius().at(iDaug1);
     float etaPar1;
     if (nDaug1 == 1) {
       etaPar1 = eta1.at(0);
@@ -540,7 +540,7 @@ bool AliFemtoDreamHigherPairMath::DeltaEtaDeltaPhi(int Hist,
       etaPar1 = eta1.at(iDaug1 + 1);
     }
     for (unsigned int iDaug2 = 0; iDaug2 < nDaug2; ++iDaug2) {
-      std::vector<float> phiAtRad2 = part2.GetPhiAtRaidius().at(iDaug2);
+      const std::vector<float> &phiAtRad2 = part2.GetPhiAtRaidius().at(iDaug2);
       float etaPar2;
       if (nDaug2 == 1) {
         etaPar2 = eta2.at(0);
@@ -16,6 +16,9 @@
 //Class Containing the Particles from previous Events up to a certain mixing
 //depth for one Particle Species and Mult/ZVtx Bin
 //ZVtx bin.
+//The events are kept in a ring buffer of fMixingDepth slots. A new event is
+//assigned to the slot of the oldest one, so that the particles (and their
+//vector members) re-use the memory allocated for earlier events.
 class AliFemtoDreamPartContainer {
  public:
   AliFemtoDreamPartContainer();
@@ -24,18 +27,26 @@ class AliFemtoDreamPartContainer {
   virtual ~AliFemtoDreamPartContainer();
   void PrintLastEvent();
   void SetEvent(std::vector<AliFemtoDreamBasePart> &Particles);
-  std::deque<std::vector<AliFemtoDreamBasePart>> GetEventBuffer() const {
-    return fPartBuffer;
+  std::deque<std::vector<AliFemtoDreamBasePart>> GetEventBuffer() const;
+  //Depth 0 is the oldest event in the buffer
+  std::vector<AliFemtoDreamBasePart> &GetEvent(int Depth) {
+    return fPartBuffer[(fFirstEvent + Depth) % fPartBuffer.size()];
+  }
+  ;
+  const std::vector<AliFemtoDreamBasePart> &GetEvent(int Depth) const {
+    return fPartBuffer[(fFirstEvent + Depth) % fPartBuffer.size()];
   }
   ;
-  std::vector<AliFemtoDreamBasePart> &GetEvent(int Depth);
   unsigned int GetMixingDepth() const {
-    return fPartBuffer.size();
+    return fNEvents;
   }
   ;
  private:
-  std::deque<std::vector<AliFemtoDreamBasePart>> fPartBuffer;
-  unsigned int fMixingDepth;ClassDef(AliFemtoDreamPartContainer,2)
+  std::vector<std::vector<AliFemtoDreamBasePart>> fPartBuffer;
+  unsigned int fMixingDepth;
+  unsigned int fFirstEvent;
+  unsigned int fNEvents;
+  ClassDef(AliFemtoDreamPartContainer,3)
   ;
 };
 
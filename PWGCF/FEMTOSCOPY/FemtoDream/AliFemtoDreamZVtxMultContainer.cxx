@@ -60,6 +60,7 @@ void AliFemtoDreamZVtxMultContainer::PairParticlesSE(
     std::vector<std::vector<AliFemtoDreamBasePart>> &Particles,
     AliFemtoDreamHigherPairMath *HigherMath, int iMult, float cent) {
   int HistCounter = 0;
+  std::vector<double> Masses = GetMasses();
   //First loop over all the different Species
   auto itPDGPar1 = fPDGParticleSpecies.begin();
   for (auto itSpec1 = Particles.begin(); itSpec1 != Particles.end();
@@ -70,9 +71,11 @@ void AliFemtoDreamZVtxMultContainer::PairParticlesSE(
       HigherMath->FillPairCounterSE(HistCounter, itSpec1->size(),
                                     itSpec2->size());
       //Now loop over the actual Particles and correlate them
+      const double MassPar1 = Masses[itPDGPar1 - fPDGParticleSpecies.begin()];
+      const double MassPar2 = Masses[itPDGPar2 - fPDGParticleSpecies.begin()];
       for (auto itPart1 = itSpec1->begin(); itPart1 != itSpec1->end();
           ++itPart1) {
-        AliFemtoDreamBasePart part1 = *itPart1;
+        const TVector3 &MomPart1 = itPart1->GetMomentum();
         std::vector<AliFemtoDreamBasePart>::iterator itPart2;
         if (itSpec1 == itSpec2) {
           itPart2 = itPart1 + 1;
@@ -80,16 +83,10 @@ void AliFemtoDreamZVtxMultContainer::PairParticlesSE(
           itPart2 = itSpec2->begin();
         }
         while (itPart2 != itSpec2->end()) {
-          AliFemtoDreamBasePart part2 = *itPart2;
+          const TVector3 &MomPart2 = itPart2->GetMomentum();
           TLorentzVector PartOne, PartTwo;
-          PartOne.SetXYZM(
-              itPart1->GetMomentum().X(), itPart1->GetMomentum().Y(),
-              itPart1->GetMomentum().Z(),
-              TDatabasePDG::Instance()->GetParticle(*itPDGPar1)->Mass());
-          PartTwo.SetXYZM(
-              itPart2->GetMomentum().X(), itPart2->GetMomentum().Y(),
-              itPart2->GetMomentum().Z(),
-              TDatabasePDG::Instance()->GetParticle(*itPDGPar2)->Mass());
+          PartOne.SetXYZM(MomPart1.X(), MomPart1.Y(), MomPart1.Z(), MassPar1);
+          PartTwo.SetXYZM(MomPart2.X(), MomPart2.Y(), MomPart2.Z(), MassPar2);
           float RelativeK = HigherMath->RelativePairMomentum(PartOne, PartTwo);
           if (!HigherMath->PassesPairSelection(HistCounter, *itPart1, *itPart2,
                                                RelativeK, true, false)) {
@@ -97,9 +94,9 @@ void AliFemtoDreamZVtxMultContainer::PairParticlesSE(
             continue;
           }
           RelativeK = HigherMath->FillSameEvent(HistCounter, iMult, cent,
-                                                part1,
+                                                *itPart1,
                                                 *itPDGPar1,
-                                                part2,
+                                                *itPart2,
                                                 *itPDGPar2);
           HigherMath->MassQA(HistCounter, RelativeK, *itPart1, *itPart2);
           HigherMath->SEDetaDPhiPlots(HistCounter, *itPart1, *itPDGPar1,
@@ -120,6 +117,7 @@ void AliFemtoDreamZVtxMultContainer::PairParticlesME(
     std::vector<std::vector<AliFemtoDreamBasePart>> &Particles,
     AliFemtoDreamHigherPairMath *HigherMath, int iMult, float cent) {
   int HistCounter = 0;
+  std::vector<double> Masses = GetMasses();
   auto itPDGPar1 = fPDGParticleSpecies.begin();
   //First loop over all the different Species
   for (auto itSpec1 = Particles.begin(); itSpec1 != Particles.end();
@@ -134,25 +132,24 @@ void AliFemtoDreamZVtxMultContainer::PairParticlesME(
         HigherMath->FillEffectiveMixingDepth(HistCounter,
                                              (int) itSpec2->GetMixingDepth());
       }
+      const double MassPar1 = Masses[itPDGPar1 - fPDGParticleSpecies.begin()];
+      const double MassPar2 = Masses[itPDGPar2 - fPDGParticleSpecies.begin()];
       for (int iDepth = 0; iDepth < (int) itSpec2->GetMixingDepth(); ++iDepth) {
-        std::vector<AliFemtoDreamBasePart> ParticlesOfEvent = itSpec2->GetEvent(
+        //reference into the mixing ring buffer, no copy of the event
+        std::vector<AliFemtoDreamBasePart> &ParticlesOfEvent = itSpec2->GetEvent(
             iDepth);
         HigherMath->FillPairCounterME(HistCounter, itSpec1->size(),
                                       ParticlesOfEvent.size());
         for (auto itPart1 = itSpec1->begin(); itPart1 != itSpec1->end();
             ++itPart1) {
+          const TVector3 &MomPart1 = itPart1->GetMomentum();
           for (auto itPart2 = ParticlesOfEvent.begin();
               itPart2 != ParticlesOfEvent.end(); ++itPart2) {
 
+            const TVector3 &MomPart2 = itPart2->GetMomentum();
             TLorentzVector PartOne, PartTwo;
-            PartOne.SetXYZM(
-                itPart1->GetMomentum().X(), itPart1->GetMomentum().Y(),
-                itPart1->GetMomentum().Z(),
-                TDatabasePDG::Instance()->GetParticle(*itPDGPar1)->Mass());
-            PartTwo.SetXYZM(
-                itPart2->GetMomentum().X(), itPart2->GetMomentum().Y(),
-                itPart2->GetMomentum().Z(),
-                TDatabasePDG::Instance()->GetParticle(*itPDGPar2)->Mass());
+            PartOne.SetXYZM(MomPart1.X(), MomPart1.Y(), MomPart1.Z(), MassPar1);
+            PartTwo.SetXYZM(MomPart2.X(), MomPart2.Y(), MomPart2.Z(), MassPar2);
             float RelativeK = HigherMath->RelativePairMomentum(PartOne, PartTwo);
             if (!HigherMath->PassesPairSelection(HistCounter, *itPart1, *itPart2,
                                                  RelativeK, false, false)) {
@@ -178,3 +175,14 @@ void AliFemtoDreamZVtxMultContainer::PairParticlesME(
     ++itPDGPar1;
   }
 }
+
+std::vector<double> AliFemtoDreamZVtxMultContainer::GetMasses() const {
+  //The masses only depend on the species, look them up once per call instead
+  //of once per pair
+  std::vector<double> Masses;
+  Masses.reserve(fPDGParticleSpecies.size());
+  for (auto itPDG : fPDGParticleSpecies) {
+    Masses.push_back(TDatabasePDG::Instance()->GetParticle(itPDG)->Mass());
+  }
+  return Masses;
+}
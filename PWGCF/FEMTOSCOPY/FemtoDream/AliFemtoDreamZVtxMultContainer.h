@@ -36,6 +36,7 @@ class AliFemtoDreamZVtxMultContainer {
   float ComputeDeltaPhi(AliFemtoDreamBasePart &part1,
                         AliFemtoDreamBasePart &part2);
   void SetEvent(std::vector<std::vector<AliFemtoDreamBasePart>> &Particles);
+  std::vector<double> GetMasses() const;
   TString ClassName() {
     return "zVtxMult Container";
   }
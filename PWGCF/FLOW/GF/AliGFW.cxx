@@ -78,13 +78,13 @@ Int_t AliGFW::CreateRegions() {
   //for(auto pitr = fRegions.begin(); pitr!=fRegions.end(); pitr++) pitr->PrintStructure();
   Int_t nRegions=0;
   for(auto pItr=fRegions.begin(); pItr!=fRegions.end(); pItr++) {
-    AliGFWCumulant *lCumulant = new AliGFWCumulant();
+    fCumulants.push_back(AliGFWCumulant());
+    AliGFWCumulant *lCumulant = &fCumulants.back(); //Q-vectors are held by value, so construct in place rather than copying
     if(pItr->NparVec.size()) {
       lCumulant->CreateComplexVectorArrayVarPower(pItr->Nhar, pItr->NparVec, pItr->NpT);
     } else {
       lCumulant->CreateComplexVectorArray(pItr->Nhar, pItr->Npar, pItr->NpT);
     };
-    fCumulants.push_back(*lCumulant);
     ++nRegions;
   };
   if(nRegions) fInitialized=kTRUE;
@@ -98,88 +98,157 @@ void AliGFW::Fill(Double_t eta, Int_t ptin, Double_t phi, Double_t weight, Int_t
       fCumulants.at(i).FillArray(eta,ptin,phi,weight,SecondWeight);
   };
 };
-TComplex AliGFW::TwoRec(Int_t n1, Int_t n2, Int_t p1, Int_t p2, Int_t ptbin, AliGFWCumulant *r1, AliGFWCumulant *r2, AliGFWCumulant *r3) {
-  TComplex part1 = r1->Vec(n1,p1,ptbin);
-  TComplex part2 = r2->Vec(n2,p2,ptbin);
-  TComplex part3 = r3?r3->Vec(n1+n2,p1+p2,ptbin):TComplex(0,0);
-  TComplex formula = part1*part2-part3;
-  return formula;
+void AliGFW::Fill(Int_t nTracks, const Double_t *eta, const Int_t *ptin, const Double_t *phi, const Double_t *weight, const Int_t *mask, const Double_t *SecondWeight) {
+  if(!fInitialized) CreateRegions();
+  if(!fInitialized) return;
+  //Loop over regions first, so that the Q-vectors of one region are filled in one go
+  for(Int_t i=0;i<(Int_t)fRegions.size();++i) {
+    const Region &lRegion = fRegions[i];
+    AliGFWCumulant &lCumulant = fCumulants[i];
+    for(Int_t j=0;j<nTracks;++j) {
+      if(lRegion.EtaMin<eta[j] && lRegion.EtaMax>eta[j] && (lRegion.BitMask&mask[j]))
+        lCumulant.FillArray(eta[j],ptin[j],phi[j],weight[j],SecondWeight?SecondWeight[j]:-1);
+    };
+  };
 };
-TComplex AliGFW::RecursiveCorr(AliGFWCumulant *qpoi, AliGFWCumulant *qref, AliGFWCumulant *qol, Int_t ptbin, vector<Int_t> hars, vector<Int_t> pows) {
-  if(pows.size()==0) //if powers are not initialized, initialize them to 1
-    for(Int_t i=0; i<(Int_t)hars.size(); i++)
-      pows.push_back(1);
-  if((pows.at(0)!=1) && qol) qpoi=qol; //if the power of POI is not unity, then always use overlap (if defined).
+Int_t AliGFW::AddPlanNode(CorrPlan &plan, std::map<vector<Int_t>, Int_t> &nodeIndex, const vector<Int_t> &hars, const vector<Int_t> &pows, Bool_t hasOverlap) {
+  vector<Int_t> key(hars);
+  key.insert(key.end(),pows.begin(),pows.end());
+  auto found = nodeIndex.find(key);
+  if(found!=nodeIndex.end()) return found->second;
+  PlanNode node;
+  node.Type = kPlanVec;
+  node.Har = hars.at(0);
+  node.Pow = pows.at(0);
+  node.Har2 = 0;
+  node.Pow2 = 0;
+  node.UseOverlap = (pows.at(0)!=1) && hasOverlap; //if the power of POI is not unity, then always use overlap (if defined).
   //Only valid for 1 particle of interest though!
-  if(hars.size()<2) return qpoi->Vec(hars.at(0),pows.at(0),ptbin);
-  if(hars.size()<3) return TwoRec(hars.at(0), hars.at(1),pows.at(0),pows.at(1), ptbin, qpoi, qref, qol);
-  Int_t harlast=hars.at(hars.size()-1);
-  Int_t powlast=pows.at(pows.size()-1);
-  hars.erase(hars.end()-1);
-  pows.erase(pows.end()-1);
-  TComplex formula = RecursiveCorr(qpoi, qref, qol, ptbin, hars, pows)*qref->Vec(harlast,powlast);
-  for(Int_t i=0;i<(Int_t)hars.size();i++) {
-    vector<Int_t> lhars = hars;
-    vector<Int_t> lpows = pows;
-    lhars.at(i)+=harlast;
-    lpows.at(i)+=powlast;
-    //The issue is here. In principle, if i=0 (dif), then the overlap is only qpoi (0, if no overlap);
-    //Otherwise, if we are not working with the 1st entry (dif.), then overlap will always be from qref
-    //One should thus (probably) make a check if i=0, then qovl=qpoi, otherwise qovl=qref. But need to think more
-    //-- This is not aplicable anymore, since the overlap is explicitly specified
-    formula-=RecursiveCorr(qpoi, qref, qol, ptbin, lhars, lpows);
+  node.First = -1;
+  node.ChildBegin = 0;
+  node.ChildEnd = 0;
+  if(hars.size()==2) {
+    node.Type = kPlanTwo;
+    node.Har2 = hars.at(1);
+    node.Pow2 = pows.at(1);
+  } else if(hars.size()>2) {
+    node.Type = kPlanRec;
+    vector<Int_t> lhars(hars.begin(),hars.end()-1);
+    vector<Int_t> lpows(pows.begin(),pows.end()-1);
+    node.Har = hars.back();
+    node.Pow = pows.back();
+    node.First = AddPlanNode(plan, nodeIndex, lhars, lpows, hasOverlap);
+    vector<Int_t> lChildren;
+    for(Int_t i=0;i<(Int_t)lhars.size();i++) {
+      vector<Int_t> lhars2 = lhars;
+      vector<Int_t> lpows2 = lpows;
+      lhars2.at(i)+=node.Har;
+      lpows2.at(i)+=node.Pow;
+      //The issue is here. In principle, if i=0 (dif), then the overlap is only qpoi (0, if no overlap);
+      //Otherwise, if we are not working with the 1st entry (dif.), then overlap will always be from qref
+      //One should thus (probably) make a check if i=0, then qovl=qpoi, otherwise qovl=qref. But need to think more
+      //-- This is not aplicable anymore, since the overlap is explicitly specified
+      lChildren.push_back(AddPlanNode(plan, nodeIndex, lhars2, lpows2, hasOverlap));
+    };
+    //Children are added after the recursion, so that the range of this node stays contiguous
+    node.ChildBegin = plan.Children.size();
+    plan.Children.insert(plan.Children.end(),lChildren.begin(),lChildren.end());
+    node.ChildEnd = plan.Children.size();
   };
-  return formula;
+  plan.Nodes.push_back(node);
+  nodeIndex[key] = plan.Nodes.size()-1;
+  return plan.Nodes.size()-1;
+};
+const AliGFW::CorrPlan &AliGFW::GetPlan(const vector<Int_t> &hars, Bool_t hasOverlap) {
+  vector<Int_t> key(hars);
+  key.push_back(hasOverlap);
+  auto found = fPlanIndex.find(key);
+  if(found!=fPlanIndex.end()) return fPlans[found->second];
+  CorrPlan plan;
+  std::map<vector<Int_t>, Int_t> nodeIndex;
+  //if powers are not given, they are all unity
+  AddPlanNode(plan, nodeIndex, hars, vector<Int_t>(hars.size(),1), hasOverlap);
+  fPlans.push_back(plan);
+  fPlanIndex[key] = fPlans.size()-1;
+  return fPlans.back();
+};
+TComplex AliGFW::EvaluatePlan(const CorrPlan &plan, AliGFWCumulant *qpoi, AliGFWCumulant *qref, AliGFWCumulant *qol, Int_t ptbin) {
+  //Nodes are ordered such that the ones a node depends on come before it; the last node is the correlator
+  fPlanValues.resize(plan.Nodes.size());
+  for(Int_t i=0;i<(Int_t)plan.Nodes.size();i++) {
+    const PlanNode &node = plan.Nodes[i];
+    AliGFWCumulant *lpoi = node.UseOverlap?qol:qpoi;
+    if(node.Type==kPlanVec) {
+      fPlanValues[i] = lpoi->Vec(node.Har,node.Pow,ptbin);
+    } else if(node.Type==kPlanTwo) {
+      TComplex part1 = lpoi->Vec(node.Har,node.Pow,ptbin);
+      TComplex part2 = qref->Vec(node.Har2,node.Pow2,ptbin);
+      TComplex part3 = qol?qol->Vec(node.Har+node.Har2,node.Pow+node.Pow2,ptbin):TComplex(0,0);
+      fPlanValues[i] = part1*part2-part3;
+    } else {
+      TComplex formula = fPlanValues[node.First]*qref->Vec(node.Har,node.Pow);
+      for(Int_t j=node.ChildBegin;j<node.ChildEnd;j++) formula-=fPlanValues[plan.Children[j]];
+      fPlanValues[i] = formula;
+    };
+  };
+  return fPlanValues.back();
+};
+TComplex AliGFW::RecursiveCorr(AliGFWCumulant *qpoi, AliGFWCumulant *qref, AliGFWCumulant *qol, Int_t ptbin, const vector<Int_t> &hars) {
+  if(hars.size()==0) return TComplex(0,0);
+  return EvaluatePlan(GetPlan(hars,qol!=0), qpoi, qref, qol, ptbin);
 };
 void AliGFW::Clear() {
   for(auto ptr = fCumulants.begin(); ptr!=fCumulants.end(); ++ptr) ptr->ResetQs();
-  fCalculatedNames.clear();
-  fCalculatedQs.clear();
 };
 TComplex AliGFW::Calculate(TString config, Bool_t SetHarmsToZero) {
   if(config.EqualTo("")) {
     printf("Configuration empty!\n");
     return TComplex(0,0);
   };
-  TString tmp;
-  Ssiz_t sz1=0;
-  TComplex ret(1,0);
-  while(config.Tokenize(tmp,sz1,"}")) {
-    if(SetHarmsToZero) SetHarmonicsToZero(tmp);
-    /*Int_t ind=FindCalculated(tmp);
-    if(ind>=0) {
-      ret*=fCalculatedQs.at(ind);
-      continue;
-    };*/
-    TComplex val=CalculateSingle(tmp);
-    ret*=val;
-    fCalculatedQs.push_back(val);
-    fCalculatedNames.push_back(tmp);
+  //Strings are only parsed the first time they are seen
+  TString key(config);
+  if(SetHarmsToZero) key.Append("#0");
+  auto found = fParsedConfigs.find(key);
+  if(found==fParsedConfigs.end()) {
+    vector<SingleConfig> singles;
+    TString tmp;
+    Ssiz_t sz1=0;
+    while(config.Tokenize(tmp,sz1,"}")) {
+      if(SetHarmsToZero) SetHarmonicsToZero(tmp);
+      singles.push_back(ParseSingle(tmp));
+    };
+    found = fParsedConfigs.insert(std::make_pair(key,singles)).first;
   };
+  TComplex ret(1,0);
+  for(auto single = found->second.begin(); single!=found->second.end(); ++single)
+    ret*=CalculateSingle(*single);
   return ret;
 };
-TComplex AliGFW::CalculateSingle(TString config) {
+AliGFW::SingleConfig AliGFW::ParseSingle(TString config) {
+  SingleConfig ReturnConfig;
+  ReturnConfig.Poi = -1;
+  ReturnConfig.Ref = -1;
+  ReturnConfig.PtBin = 0;
+  ReturnConfig.Valid = kFALSE;
   //First remove all ; and ,:
   config.ReplaceAll(","," ");
   config.ReplaceAll(";"," ");
   //Then make sure we don't have any double-spaces:
   while(config.Index("  ")>-1) config.ReplaceAll("  "," ");
   vector<Int_t> regs;
-  vector<Int_t> hars;
-  Int_t ptbin=0;
   Ssiz_t sz1=0;
   Ssiz_t szend=0;
   TString ts, ts2;
   //find the pT-bin:
   if(config.Tokenize(ts,sz1,"(")) {
     config.Tokenize(ts,sz1,")");
-    ptbin=ts.Atoi();
+    ReturnConfig.PtBin=ts.Atoi();
   };
   //Fetch region descriptor
   if(sz1<0) sz1=0;
   if(!config.Tokenize(ts,szend,"{")) {
     printf("Could not find harmonics!\n");
-    return TComplex(0,0);
+    return ReturnConfig;
   };
   //Fetch regions
   while(ts.Tokenize(ts2,sz1," ")) {
@@ -193,9 +262,20 @@ TComplex AliGFW::CalculateSingle(TString config) {
     regs.push_back(ind);
   };
   //Fetch harmonics
-  while(config.Tokenize(ts,szend," ")) hars.push_back(ts.Atoi());
-  if(regs.size()==1) return Calculate(regs.at(0),hars);
-  return Calculate(regs.at(0),regs.at(1),hars,ptbin);
+  while(config.Tokenize(ts,szend," ")) ReturnConfig.Hars.push_back(ts.Atoi());
+  if(regs.size()==0) {
+    printf("Could not find any region!\n");
+    return ReturnConfig;
+  };
+  ReturnConfig.Poi = regs.at(0);
+  ReturnConfig.Ref = (regs.size()>1)?regs.at(1):-1;
+  ReturnConfig.Valid = kTRUE;
+  return ReturnConfig;
+};
+TComplex AliGFW::CalculateSingle(const SingleConfig &config) {
+  if(!config.Valid) return TComplex(0,0);
+  if(config.Ref<0) return Calculate(config.Poi,config.Hars);
+  return Calculate(config.Poi,config.Ref,config.Hars,config.PtBin);
 };
 AliGFW::CorrConfig AliGFW::GetCorrelatorConfig(TString config, TString head, Bool_t ptdif) {
   //First remove all ; and ,:
@@ -8,6 +8,7 @@ Extention of Generic Flow (https://arxiv.org/abs/1312.3572)
 #include <vector>
 #include <utility>
 #include <algorithm>
+#include <map>
 #include "TString.h"
 #include "TObjArray.h"
 using std::vector;
@@ -56,6 +57,8 @@ class AliGFW {
   void AddRegion(TString refName, Int_t lNhar, Int_t *lNparVec, Double_t lEtaMin, Double_t lEtaMax, Int_t lNpT=1, Int_t BitMask=1);
   Int_t CreateRegions();
   void Fill(Double_t eta, Int_t ptin, Double_t phi, Double_t weight, Int_t mask, Double_t secondWeight=-1);
+  //Fill nTracks tracks at once, region by region. secondWeight can be 0 if not used
+  void Fill(Int_t nTracks, const Double_t *eta, const Int_t *ptin, const Double_t *phi, const Double_t *weight, const Int_t *mask, const Double_t *secondWeight=0);
   void Clear();// { for(auto ptr = fCumulants.begin(); ptr!=fCumulants.end(); ++ptr) ptr->ResetQs(); };
   AliGFWCumulant GetCumulant(Int_t index) { return fCumulants.at(index); };
   TComplex Calculate(TString config, Bool_t SetHarmsToZero=kFALSE);
@@ -65,8 +68,37 @@ class AliGFW {
   Bool_t fInitialized;
   void SplitRegions();
   AliGFWCumulant fEmptyCumulant;
-  TComplex TwoRec(Int_t n1, Int_t n2, Int_t p1, Int_t p2, Int_t ptbin, AliGFWCumulant*, AliGFWCumulant*, AliGFWCumulant*);
-  TComplex RecursiveCorr(AliGFWCumulant *qpoi, AliGFWCumulant *qref, AliGFWCumulant *qol, Int_t ptbin, vector<Int_t> hars, vector<Int_t> pows={}); //POI, Ref. flow, overlapping region
+  //A correlator with given harmonics, compiled once from the recursion of https://arxiv.org/abs/1312.3572
+  //into a list of nodes, each node being a lower-order term. Identical terms appear only once.
+  //The plan does not depend on the regions or pT bin, so it is shared by all correlators with the same harmonics.
+  enum PlanNodeType_t {kPlanVec, kPlanTwo, kPlanRec};
+  struct PlanNode {
+    Int_t Type;
+    Int_t Har, Pow; //kPlanVec, kPlanTwo: first vector (POI); kPlanRec: last harmonic, multiplied by the reference vector
+    Int_t Har2, Pow2; //kPlanTwo: reference vector
+    Bool_t UseOverlap; //POI vector is taken from the overlap region
+    Int_t First; //kPlanRec: node with the last harmonic removed
+    Int_t ChildBegin, ChildEnd; //kPlanRec: range in CorrPlan::Children of the nodes to subtract
+  };
+  struct CorrPlan {
+    vector<PlanNode> Nodes;
+    vector<Int_t> Children;
+  };
+  vector<CorrPlan> fPlans; //! compiled correlators
+  std::map<vector<Int_t>, Int_t> fPlanIndex; //! harmonics (+ overlap flag) -> index in fPlans
+  vector<TComplex> fPlanValues; //! node values, re-used between calls
+  const CorrPlan &GetPlan(const vector<Int_t> &hars, Bool_t hasOverlap);
+  Int_t AddPlanNode(CorrPlan &plan, std::map<vector<Int_t>, Int_t> &nodeIndex, const vector<Int_t> &hars, const vector<Int_t> &pows, Bool_t hasOverlap);
+  TComplex EvaluatePlan(const CorrPlan &plan, AliGFWCumulant *qpoi, AliGFWCumulant *qref, AliGFWCumulant *qol, Int_t ptbin);
+  TComplex RecursiveCorr(AliGFWCumulant *qpoi, AliGFWCumulant *qref, AliGFWCumulant *qol, Int_t ptbin, const vector<Int_t> &hars); //POI, Ref. flow, overlapping region
+  //Parsed strings for Calculate(TString); one entry per {...} block
+  struct SingleConfig {
+    Int_t Poi, Ref;
+    vector<Int_t> Hars;
+    Int_t PtBin;
+    Bool_t Valid;
+  };
+  std::map<TString, vector<SingleConfig> > fParsedConfigs; //! config string (+ SetHarmsToZero flag) -> parsed blocks
   //Deprecated and not used (for now):
   void AddRegion(Region inreg) { fRegions.push_back(inreg); };
   Region GetRegion(Int_t index) { return fRegions.at(index); };
@@ -78,7 +110,8 @@ class AliGFW {
   TComplex Calculate(Int_t poi, Int_t ref, vector<Int_t> hars, Int_t ptbin=0); //For differential, need POI and reference
   TComplex Calculate(Int_t poi, vector<Int_t> hars); //For integrated case
   //Process one string (= one region)
-  TComplex CalculateSingle(TString config);
+  SingleConfig ParseSingle(TString config);
+  TComplex CalculateSingle(const SingleConfig &config);
 
   Bool_t SetHarmonicsToZero(TString &instr);
 
@@ -3,16 +3,22 @@ Author: Vytautas Vislavicius
 Extention of Generic Flow (https://arxiv.org/abs/1312.3572)
 */
 #include "AliGFWCumulant.h"
+#include <algorithm>
 
 AliGFWCumulant::AliGFWCumulant():
-  fQvector(0),
+  fQRe(),
+  fQIm(),
   fUsed(kBlank),
   fNEntries(-1),
   fN(1),
   fPow(1),
   fPt(1),
-  fFilledPts(0),
-  fInitialized(kFALSE)
+  fFilledPts(),
+  fInitialized(kFALSE),
+  fPowOffset(),
+  fPtStride(0),
+  fMaxPow(0),
+  fPrefactors()
 {
 };
 
@@ -21,53 +27,57 @@ AliGFWCumulant::~AliGFWCumulant()
   //printf("Destructor (?) for some reason called?\n");
   //DestroyComplexVectorArray();
 };
+void AliGFWCumulant::AddTrack(Int_t ptin, Double_t phi, Double_t weight, Double_t SecondWeight) {
+  fFilledPts[ptin] = kTRUE;
+  //Powers of the weight, by multiplication instead of TMath::Power for every harmonic.
+  //If second weight is specified, then keep the first weight with power no more than 1, and us the other weight otherwise
+  //this is important when POIs are a subset of REFs and have different weights than REFs
+  Double_t *lPrefactor = fPrefactors.data();
+  if(fMaxPow>0) lPrefactor[0] = 1;
+  if(fMaxPow>1) lPrefactor[1] = weight;
+  Double_t lStep = (SecondWeight>0)?SecondWeight:weight;
+  for(Int_t lPow=2; lPow<fMaxPow; lPow++) lPrefactor[lPow] = lPrefactor[lPow-1]*lStep;
+  //cos(n*phi) and sin(n*phi) from the angle-addition formulas, starting from n=0
+  Double_t lCos1 = TMath::Cos(phi);
+  Double_t lSin1 = TMath::Sin(phi);
+  Double_t lCos = 1;
+  Double_t lSin = 0;
+  Double_t *lQRe = fQRe.data() + ptin*fPtStride;
+  Double_t *lQIm = fQIm.data() + ptin*fPtStride;
+  for(Int_t lN = 0; lN<fN; lN++) {
+    const Int_t lOffset = fPowOffset[lN];
+    const Int_t lNPow = fPowVec[lN];
+    for(Int_t lPow=0; lPow<lNPow; lPow++) {
+      lQRe[lOffset+lPow] += lPrefactor[lPow]*lCos;
+      lQIm[lOffset+lPow] += lPrefactor[lPow]*lSin;
+    };
+    Double_t lCosNext = lCos*lCos1 - lSin*lSin1;
+    lSin = lSin*lCos1 + lCos*lSin1;
+    lCos = lCosNext;
+  };
+};
 void AliGFWCumulant::FillArray(Double_t eta, Int_t ptin, Double_t phi, Double_t weight, Double_t SecondWeight) {
   if(!fInitialized)
     CreateComplexVectorArray(1,1,1);
   if(fPt==1) ptin=0; //If one bin, then just fill it straight; otherwise, if ptin is out-of-range, do not fill
   else if(ptin<0 || ptin>=fPt) return;
-  fFilledPts[ptin] = kTRUE;
-  for(Int_t lN = 0; lN<fN; lN++) {
-    Double_t lSin = TMath::Sin(lN*phi); //No need to recalculate for each power
-    Double_t lCos = TMath::Cos(lN*phi); //No need to recalculate for each power
-    for(Int_t lPow=0; lPow<PW(lN); lPow++) {
-      Double_t lPrefactor = 0;
-      //Dont calculate it twice; multiplication is cheaper that power
-      //Also, if second weight is specified, then keep the first weight with power no more than 1, and us the other weight otherwise
-      //this is important when POIs are a subset of REFs and have different weights than REFs
-      if(SecondWeight>0 && lPow>1) lPrefactor = TMath::Power(SecondWeight, lPow-1)*weight;
-      else lPrefactor = TMath::Power(weight,lPow);
-      Double_t qsin = lPrefactor * lSin;
-      Double_t qcos = lPrefactor * lCos;
-      fQvector[ptin][lN][lPow](fQvector[ptin][lN][lPow].Re()+qcos,fQvector[ptin][lN][lPow].Im()+qsin);//+=TComplex(qcos,qsin);
-    };
-  };
+  AddTrack(ptin,phi,weight,SecondWeight);
   Inc();
 };
 void AliGFWCumulant::ResetQs() {
   if(!fNEntries) return; //If 0 entries, then no need to reset. Otherwise, if -1, then just initialized and need to set to 0.
-  for(Int_t i=0; i<fPt; i++) {
-    fFilledPts[i] = kFALSE;
-    for(Int_t lN=0;lN<fN;lN++) {
-      for(Int_t lPow=0;lPow<PW(lN);lPow++) {
-  	       fQvector[i][lN][lPow](0.,0.);
-      };
-    };
-  };
+  std::fill(fFilledPts.begin(),fFilledPts.end(),kFALSE);
+  std::fill(fQRe.begin(),fQRe.end(),0.);
+  std::fill(fQIm.begin(),fQIm.end(),0.);
   fNEntries=0;
 };
 void AliGFWCumulant::DestroyComplexVectorArray() {
   if(!fInitialized) return;
-  for(Int_t l_n = 0; l_n<fN; l_n++) {
-    for(Int_t i=0;i<fPt;i++) {
-      delete [] fQvector[i][l_n];
-    };
-  };
-  for(Int_t i=0;i<fPt;i++) {
-    delete [] fQvector[i];
-  };
-  delete [] fQvector;
-  delete [] fFilledPts;
+  fQRe.clear();
+  fQIm.clear();
+  fFilledPts.clear();
+  fPowOffset.clear();
+  fPrefactors.clear();
   fInitialized=kFALSE;
   fNEntries=-1;
 };
@@ -83,23 +93,29 @@ void AliGFWCumulant::CreateComplexVectorArrayVarPower(Int_t N, vector<Int_t> Pow
   fN=N;
   fPow=0;
   fPt=Pt;
-  fFilledPts = new Bool_t[Pt];
   fPowVec = PowVec;
-  fQvector = new TComplex**[fPt];
-  for(Int_t i=0;i<fPt;i++) {
-    fQvector[i] = new TComplex*[fN];
-  };
+  fPowOffset.resize(fN);
+  fPtStride=0;
+  fMaxPow=0;
   for(Int_t l_n=0;l_n<fN;l_n++) {
-    for(Int_t i=0;i<fPt;i++) {
-      fQvector[i][l_n] = new TComplex[PW(l_n)];
-    };
+    fPowOffset[l_n] = fPtStride;
+    fPtStride += PW(l_n);
+    if(PW(l_n)>fMaxPow) fMaxPow = PW(l_n);
   };
+  fPrefactors.resize(fMaxPow);
+  fFilledPts.resize(fPt);
+  fQRe.resize(fPt*fPtStride);
+  fQIm.resize(fPt*fPtStride);
   ResetQs();
   fInitialized=kTRUE;
 };
 TComplex AliGFWCumulant::Vec(Int_t n, Int_t p, Int_t ptbin) {
   if(!fInitialized) return 0;
   if(ptbin>=fPt || ptbin<0) ptbin=0;
-  if(n>=0) return fQvector[ptbin][n][p];
-  return TComplex::Conjugate(fQvector[ptbin][-n][p]);
+  if(n>=0) {
+    const Int_t ind = ptbin*fPtStride + fPowOffset[n] + p;
+    return TComplex(fQRe[ind],fQIm[ind]);
+  };
+  const Int_t ind = ptbin*fPtStride + fPowOffset[-n] + p;
+  return TComplex(fQRe[ind],-fQIm[ind]);
 };
@@ -8,6 +8,7 @@ Extention of Generic Flow (https://arxiv.org/abs/1312.3572)
 #include "TNamed.h"
 #include "TMath.h"
 #include "TAxis.h"
+#include <vector>
 using std::vector;
 class AliGFWCumulant {
  public:
@@ -20,7 +21,9 @@ class AliGFWCumulant {
   void Inc() { fNEntries++; };
   Int_t GetN() { return fNEntries; };
   // protected:
-  TComplex ***fQvector;
+  //Q-vectors are stored flat, [ptbin][harmonic][power] -> ptbin*fPtStride + fPowOffset[harmonic] + power
+  vector<Double_t> fQRe; //! Re(Q)
+  vector<Double_t> fQIm; //! Im(Q)
   UInt_t fUsed;
   Int_t fNEntries;
   //Q-vectors. Could be done recursively, but maybe defining each one of them explicitly is easier to read
@@ -29,13 +32,19 @@ class AliGFWCumulant {
   Int_t fPow; //! Power
   vector<Int_t> fPowVec; //! Powers array
   Int_t fPt; //!fPt bins
-  Bool_t *fFilledPts;
+  vector<Bool_t> fFilledPts; //! pT bins with at least one entry
   Bool_t fInitialized; //Arrays are initialized
   void CreateComplexVectorArray(Int_t N=1, Int_t P=1, Int_t Pt=1);
   void CreateComplexVectorArrayVarPower(Int_t N=1, vector<Int_t> Pvec={1}, Int_t Pt=1);
   Int_t PW(Int_t ind) { return fPowVec.at(ind); }; //No checks to speed up, be carefull!!!
   void DestroyComplexVectorArray();
-  Bool_t IsPtBinFilled(Int_t ptb) { if(!fFilledPts) return kFALSE; return fFilledPts[ptb]; };
+  Bool_t IsPtBinFilled(Int_t ptb) { if(!fInitialized) return kFALSE; if(ptb>=fPt || ptb<0) ptb=0; return fFilledPts[ptb]; }; //out-of-range bins treated as in Vec()
+ private:
+  void AddTrack(Int_t ptin, Double_t phi, Double_t weight, Double_t SecondWeight);
+  vector<Int_t> fPowOffset; //! offset of each harmonic within one pT bin
+  Int_t fPtStride; //! number of Q-vectors per pT bin
+  Int_t fMaxPow; //! largest number of powers over all harmonics
+  vector<Double_t> fPrefactors; //! weight^power of the current track, re-used between tracks
 };
 
 #endif
@@ -47,6 +47,8 @@ The names are available via the function PairClassName(Int_t i)
 #include <TMath.h>
 #include <TObject.h>
 #include <TGrid.h>
+#include <TDatabasePDG.h>
+#include <TVector2.h>
 
 #include <AliKFParticle.h>
 
@@ -69,6 +71,7 @@ The names are available via the function PairClassName(Int_t i)
 #include "AliDielectronMixingHandler.h"
 #include "AliDielectronPairLegCuts.h"
 #include "AliDielectronV0Cuts.h"
+#include "AliDielectronVarCuts.h"
 #include "AliDielectronPID.h"
 #include "AliDielectronHistos.h"
 
@@ -120,6 +123,7 @@ AliDielectron::AliDielectron() :
   fPairPreFilterLegs1("PairPreFilterLegs1"),
   fPairPreFilterLegs2("PairPreFilterLegs2"),
   fPairFilter("PairFilter"),
+  fPairKinPreSelection(0x0),
   fEventPlanePreFilter("EventPlanePreFilter"),
   fEventPlanePOIPreFilter("EventPlanePOIPreFilter"),
   fQnTPCACcuts(0x0),
@@ -135,6 +139,7 @@ AliDielectron::AliDielectron() :
   fHistos(0x0),
   fUsedVars(new TBits(AliDielectronVarManager::kNMaxValues)),
   fPairCandidates(new TObjArray(11)),
+  fPairPool(0x0),
   fCfManagerPair(0x0),
   fTrackRotator(0x0),
   fRotatePP(kFALSE),
@@ -211,6 +216,7 @@ AliDielectron::AliDielectron(const char* name, const char* title) :
   fPairPreFilterLegs1("PairPreFilterLegs1"),
   fPairPreFilterLegs2("PairPreFilterLegs2"),
   fPairFilter("PairFilter"),
+  fPairKinPreSelection(0x0),
   fEventPlanePreFilter("EventPlanePreFilter"),
   fEventPlanePOIPreFilter("EventPlanePOIPreFilter"),
   fQnTPCACcuts(0x0),
@@ -226,6 +232,7 @@ AliDielectron::AliDielectron(const char* name, const char* title) :
   fHistos(0x0),
   fUsedVars(new TBits(AliDielectronVarManager::kNMaxValues)),
   fPairCandidates(new TObjArray(11)),
+  fPairPool(0x0),
   fCfManagerPair(0x0),
   fTrackRotator(0x0),
   fRotatePP(kFALSE),
@@ -296,6 +303,8 @@ AliDielectron::~AliDielectron()
   if (fHistos) delete fHistos;
   if (fUsedVars) delete fUsedVars;
   if (fPairCandidates && fEventProcess) delete fPairCandidates;
+  if (fPairPool) delete fPairPool;
+  if (fPairKinPreSelection) delete fPairKinPreSelection;
   if (fDebugTree) delete fDebugTree;
   if (fMixing) delete fMixing;
   if (fEvtVsTrkHist) delete fEvtVsTrkHist;
@@ -321,6 +330,28 @@ void AliDielectron::Init()
 
   if(fEventProcess) InitPairCandidateArrays();
 
+  if (fPairKinPreSelection) {
+    // only variables which can be calculated from the leg momenta are available,
+    // this includes the second variable of the cuts combining two variables
+    // and the axes of the cut objects giving the upper limit
+    const Int_t kinVars[]={AliDielectronVarManager::kPx, AliDielectronVarManager::kPy, AliDielectronVarManager::kPz,
+                           AliDielectronVarManager::kPt, AliDielectronVarManager::kP,  AliDielectronVarManager::kPhi,
+                           AliDielectronVarManager::kEta, AliDielectronVarManager::kY, AliDielectronVarManager::kM,
+                           AliDielectronVarManager::kOpeningAngle};
+    const Int_t nKinVars=sizeof(kinVars)/sizeof(kinVars[0]);
+    TBits kinBits(AliDielectronVarManager::kNMaxValues);
+    for (Int_t ivar=0; ivar<nKinVars; ++ivar) kinBits.SetBitNumber(kinVars[ivar]);
+    TBits *usedVars=fPairKinPreSelection->GetUsedVars();
+    for (UInt_t ivar=usedVars->FirstSetBit(); ivar<usedVars->GetNbits(); ivar=usedVars->FirstSetBit(ivar+1)) {
+      if (kinBits.TestBitNumber(ivar)) continue;
+      AliError(Form("Kinematic pair pre-selection '%s' uses %s, not available before the pair is built, it is not applied",
+                    fPairKinPreSelection->GetName(), AliDielectronVarManager::GetValueName(ivar)));
+      delete fPairKinPreSelection;
+      fPairKinPreSelection=0x0;
+      break;
+    }
+  }
+
   if (fCfManagerPair) {
     fCfManagerPair->SetSignalsMC(fSignalsMC);
     fCfManagerPair->InitialiseContainer(fPairFilter);
@@ -1460,15 +1491,32 @@ void AliDielectron::FillPairArrays(Int_t arr1, Int_t arr2, const AliVEvent *ev)
   Int_t ntrack1=arrTracks1.GetEntriesFast();
   Int_t ntrack2=arrTracks2.GetEntriesFast();
 
-  AliDielectronPair *candidate=new AliDielectronPair;
-  candidate->SetKFUsage(fUseKF);
+  AliDielectronPair *candidate=NextPoolPair();
 
   UInt_t selectedMask=(1<<fPairFilter.GetCuts()->GetEntries())-1;
 
+  //kinematic pre-selection on the leg momenta, skips building the pair for rejected combinations
+  Double_t preValues[AliDielectronVarManager::kNMaxValues];
+  Double_t pLeg1[3]={0.};
+  Double_t pLeg2[3]={0.};
+  Double_t mLeg1=0.;
+  Double_t mLeg2=0.;
+  if (fPairKinPreSelection) {
+    TParticlePDG *pdgLeg1=TDatabasePDG::Instance()->GetParticle(fPdgLeg1);
+    TParticlePDG *pdgLeg2=TDatabasePDG::Instance()->GetParticle(fPdgLeg2);
+    mLeg1=pdgLeg1?pdgLeg1->Mass():0.;
+    mLeg2=pdgLeg2?pdgLeg2->Mass():0.;
+  }
+
   for (Int_t itrack1=0; itrack1<ntrack1; ++itrack1){
     Int_t end=ntrack2;
     if (arr1==arr2) end=itrack1;
+    if (fPairKinPreSelection) static_cast<AliVTrack*>(arrTracks1.UncheckedAt(itrack1))->PxPyPz(pLeg1);
     for (Int_t itrack2=0; itrack2<end; ++itrack2){
+      if (fPairKinPreSelection) {
+        static_cast<AliVTrack*>(arrTracks2.UncheckedAt(itrack2))->PxPyPz(pLeg2);
+        if (!IsPairKinematicsSelected(pLeg1,mLeg1,pLeg2,mLeg2,preValues)) continue;
+      }
       //create the pair (direct pointer to the memory by this daughter reference are kept also for ME)
       candidate->SetTracks(&(*static_cast<AliVTrack*>(arrTracks1.UncheckedAt(itrack1))), fPdgLeg1,
                            &(*static_cast<AliVTrack*>(arrTracks2.UncheckedAt(itrack2))), fPdgLeg2);
@@ -1508,12 +1556,11 @@ void AliDielectron::FillPairArrays(Int_t arr1, Int_t arr2, const AliVEvent *ev)
       //add the candidate to the candidate array
       PairArray(pairIndex)->Add(candidate);
       //get a new candidate
-      candidate=new AliDielectronPair;
-      candidate->SetKFUsage(fUseKF);
+      candidate=NextPoolPair();
     }
   }
-  //delete the surplus candidate
-  delete candidate;
+  //the surplus candidate goes back to the pool
+  ReturnPoolPair(candidate);
 }
 
 //________________________________________________________________
@@ -1524,8 +1571,16 @@ void AliDielectron::FillPairArrayTR()
   //
   UInt_t selectedMask=(1<<fPairFilter.GetCuts()->GetEntries())-1;
 
+  Double_t preValues[AliDielectronVarManager::kNMaxValues];
   while ( fTrackRotator->NextCombination() ){
     if(fTrackRotator->SameTracks() ) continue;
+    if (fPairKinPreSelection) {
+      const AliKFParticle &kfP=fTrackRotator->GetKFTrackP();
+      const AliKFParticle &kfN=fTrackRotator->GetKFTrackN();
+      const Double_t pLeg1[3]={kfP.GetPx(),kfP.GetPy(),kfP.GetPz()};
+      const Double_t pLeg2[3]={kfN.GetPx(),kfN.GetPy(),kfN.GetPz()};
+      if (!IsPairKinematicsSelected(pLeg1,kfP.GetMass(),pLeg2,kfN.GetMass(),preValues)) continue;
+    }
     AliDielectronPair candidate;
     candidate.SetKFUsage(fUseKF);
     candidate.SetTracks(&fTrackRotator->GetKFTrackP(), &fTrackRotator->GetKFTrackN(),
@@ -1545,11 +1600,62 @@ void AliDielectron::FillPairArrayTR()
       if (fHistoArray) fHistoArray->Fill((Int_t)kEv1PMRot,&candidate);
 
       if(fHistos) FillHistogramsPair(&candidate);
-      if(fStoreRotatedPairs) PairArray(kEv1PMRot)->Add(new AliDielectronPair(candidate));
+      if(fStoreRotatedPairs) {
+        AliDielectronPair *pair=NextPoolPair();
+        *pair=candidate;
+        PairArray(kEv1PMRot)->Add(pair);
+      }
     }
   }
 }
 
+//________________________________________________________________
+AliDielectronPair* AliDielectron::NextPoolPair()
+{
+  //
+  // Take an unused pair object from the pool, or create one if the pool is empty.
+  // The pair belongs to the caller until it is added to a candidate array or
+  // given back with ReturnPoolPair.
+  // Pair objects are not reset, all information is set again when filling the pair.
+  //
+  AliDielectronPair *pair=static_cast<AliDielectronPair*>(fPairPool->RemoveLast());
+  if (!pair) pair=new AliDielectronPair;
+  pair->SetKFUsage(fUseKF);
+  return pair;
+}
+
+//________________________________________________________________
+Bool_t AliDielectron::IsPairKinematicsSelected(const Double_t p1[3], Double_t m1, const Double_t p2[3], Double_t m2,
+                                               Double_t * const values) const
+{
+  //
+  // Apply the kinematic pair pre-selection using the sum of the leg four-momenta.
+  // Only the variables of the pre-selection are filled in values
+  //
+  const Double_t px=p1[0]+p2[0];
+  const Double_t py=p1[1]+p2[1];
+  const Double_t pz=p1[2]+p2[2];
+  const Double_t pp1=TMath::Sqrt(p1[0]*p1[0]+p1[1]*p1[1]+p1[2]*p1[2]);
+  const Double_t pp2=TMath::Sqrt(p2[0]*p2[0]+p2[1]*p2[1]+p2[2]*p2[2]);
+  const Double_t e=TMath::Sqrt(pp1*pp1+m1*m1)+TMath::Sqrt(pp2*pp2+m2*m2);
+  const Double_t p=TMath::Sqrt(px*px+py*py+pz*pz);
+  const Double_t m2pair=e*e-p*p;
+
+  values[AliDielectronVarManager::kPx]  = px;
+  values[AliDielectronVarManager::kPy]  = py;
+  values[AliDielectronVarManager::kPz]  = pz;
+  values[AliDielectronVarManager::kPt]  = TMath::Sqrt(px*px+py*py);
+  values[AliDielectronVarManager::kP]   = p;
+  values[AliDielectronVarManager::kPhi] = TVector2::Phi_0_2pi(TMath::ATan2(py,px));
+  values[AliDielectronVarManager::kEta] = (p-pz)>1.0e-6 && (p+pz)>1.0e-6 ? 0.5*TMath::Log((p+pz)/(p-pz)) : -9999.;
+  values[AliDielectronVarManager::kY]   = (e-pz)>1.0e-6 && (e+pz)>1.0e-6 ? 0.5*TMath::Log((e+pz)/(e-pz)) : -9999.;
+  values[AliDielectronVarManager::kM]   = m2pair>0. ? TMath::Sqrt(m2pair) : 0.;
+  values[AliDielectronVarManager::kOpeningAngle] = (pp1>0. && pp2>0.) ?
+    TMath::ACos(TMath::Max(-1.,TMath::Min(1.,(p1[0]*p2[0]+p1[1]*p2[1]+p1[2]*p2[2])/(pp1*pp2)))) : 0.;
+
+  return fPairKinPreSelection->IsSelected(values);
+}
+
 //________________________________________________________________
 void AliDielectron::FillDebugTree()
 {
@@ -39,6 +39,7 @@ class AliDielectronTrackRotator;
 class AliDielectronPair;
 class AliDielectronSignalMC;
 class AliDielectronMixingHandler;
+class AliDielectronVarCuts;
 
 //________________________________________________________________
 class AliDielectron : public TNamed {
@@ -68,6 +69,8 @@ public:
   AliAnalysisFilter& GetEventFilter()       { return fEventFilter;       }
   AliAnalysisFilter& GetTrackFilter()       { return fTrackFilter;       }
   AliAnalysisFilter& GetPairFilter()        { return fPairFilter;        }
+  void SetPairKinematicPreSelection(AliDielectronVarCuts * const cuts) { fPairKinPreSelection=cuts; }
+  AliDielectronVarCuts* GetPairKinematicPreSelection() const { return fPairKinPreSelection; }
   AliAnalysisFilter& GetPairPreFilter()     { return fPairPreFilter1;     }
   AliAnalysisFilter& GetPairPreFilter2()     { return fPairPreFilter2;     }
   AliAnalysisFilter& GetPairPreFilterLegs() { return fPairPreFilterLegs1; }
@@ -231,6 +234,7 @@ private:
   AliAnalysisFilter fPairPreFilterLegs1; // Leg filter after the pair prefilter cuts
   AliAnalysisFilter fPairPreFilterLegs2; // Leg filter after the pair prefilter cuts
   AliAnalysisFilter fPairFilter;     // pair cuts
+  AliDielectronVarCuts *fPairKinPreSelection; // cuts on the pair kinematics from the leg momenta, applied before the pair is built
   AliAnalysisFilter fEventPlanePreFilter;  // event plane prefilter cuts
   AliAnalysisFilter fEventPlanePOIPreFilter;  // PoI cuts in the event plane prefilter
   AliDielectronQnEPcorrection *fQnTPCACcuts; // QnFramework est. 2016 ac removal
@@ -260,6 +264,7 @@ private:
 
   TObjArray *fPairCandidates;     //! Pair candidate arrays
                                   //TODO: better way to store it? TClonesArray?
+  TObjArray *fPairPool;           //! Unused pair objects, the pairs of the candidate arrays are moved here at the end of the event
 
   AliDielectronCF *fCfManagerPair;//Correction Framework Manager for the Pair
   AliDielectronTrackRotator *fTrackRotator; //Track rotator
@@ -295,6 +300,9 @@ private:
   void PairPreFilter(Int_t arr1, Int_t arr2, TObjArray &arrTracks1, TObjArray &arrTracks2, const AliVEvent *ev, Int_t prefilterN);
   void FillPairArrays(Int_t arr1, Int_t arr2, const AliVEvent *ev = 0x0);
   void FillPairArrayTR();
+  AliDielectronPair* NextPoolPair();
+  void ReturnPoolPair(AliDielectronPair *pair) { fPairPool->Add(pair); }
+  Bool_t IsPairKinematicsSelected(const Double_t p1[3], Double_t m1, const Double_t p2[3], Double_t m2, Double_t * const values) const;
 
   Int_t GetPairIndex(Int_t arr1, Int_t arr2) const {return arr1>=arr2?arr1*(arr1+1)/2+arr2:arr2*(arr2+1)/2+arr1;}
 
@@ -332,7 +340,7 @@ private:
   AliDielectron(const AliDielectron &c);
   AliDielectron &operator=(const AliDielectron &c);
 
-  ClassDef(AliDielectron,19);
+  ClassDef(AliDielectron,20);
 };
 
 inline void AliDielectron::InitPairCandidateArrays()
@@ -346,6 +354,10 @@ inline void AliDielectron::InitPairCandidateArrays()
     fPairCandidates->AddAt(arr,i);
     arr->SetOwner();
   }
+  if (!fPairPool) {
+    fPairPool=new TObjArray(1000);
+    fPairPool->SetOwner();
+  }
 }
 
 inline TObjArray* AliDielectron::PairArray(Int_t i)
@@ -365,7 +377,19 @@ inline void AliDielectron::ClearArrays()
     fTracks[i].Clear();
   }
   for (Int_t i=0;i<11;++i){
-    if (PairArray(i)) PairArray(i)->Delete();
+    TObjArray *arr=PairArray(i);
+    if (!arr) continue;
+    if (!fPairPool || !arr->IsOwner()) {
+      arr->Delete();
+      continue;
+    }
+    // the pair objects are kept and re-used by NextPoolPair
+    for (Int_t ipair=0; ipair<arr->GetEntriesFast(); ++ipair){
+      if (arr->UncheckedAt(ipair)) fPairPool->Add(arr->UncheckedAt(ipair));
+    }
+    arr->SetOwner(kFALSE);
+    arr->Clear();
+    arr->SetOwner();
   }
 }
 
@@ -59,6 +59,7 @@ public:
   CutType GetCutType()      const { return fCutType;      }
 
   Int_t GetNCuts() { return fNActiveCuts; }
+  TBits *GetUsedVars() const { return fUsedVars; } // all variables read by the cuts
 
   //
   //Analysis cuts interface
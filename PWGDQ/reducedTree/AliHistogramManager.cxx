@@ -49,7 +49,12 @@ AliHistogramManager::AliHistogramManager() :
   fBinsAllocated(0),
   fVariableNames(),
   fVariableUnits(),
-  fNVars(0)
+  fNVars(0),
+  fFillEntries(),
+  fTHnAxisVars(),
+  fPlanOffsets(),
+  fPlanLists(),
+  fPlansDirty(kTRUE)
 {
   //
   // Constructor
@@ -71,7 +76,12 @@ AliHistogramManager::AliHistogramManager(const Char_t* name, Int_t nvars) :
   fBinsAllocated(0),
   fVariableNames(),
   fVariableUnits(),
-  fNVars(nvars)
+  fNVars(nvars),
+  fFillEntries(),
+  fTHnAxisVars(),
+  fPlanOffsets(),
+  fPlanLists(),
+  fPlansDirty(kTRUE)
 {
   //
   // Constructor
@@ -131,6 +141,7 @@ void AliHistogramManager::AddHistClass(const Char_t* histClass) {
   hList->SetOwner(kTRUE);
   hList->SetName(histClass);
   fMainList.Add(hList);
+  fPlansDirty = kTRUE;
 }
 
 //_________________________________________________________________
@@ -154,6 +165,7 @@ void AliHistogramManager::AddHistogram(const Char_t* histClass,
     cout << "Warning in AliHistogramManager::AddHistogram(): Histogram " << name << " already exists" << endl;
     return;
   }
+  fPlansDirty = kTRUE;
   TString hname = name;
   
   Int_t dimension = 1;
@@ -296,6 +308,7 @@ void AliHistogramManager::AddHistogram(const Char_t* histClass,
     cout << "Warning in AliHistogramManager::AddHistogram(): Histogram " << name << " already exists" << endl;
     return;
   }
+  fPlansDirty = kTRUE;
   TString hname = name;
   
   Int_t dimension = 1;
@@ -441,6 +454,7 @@ void AliHistogramManager::AddHistogram(const Char_t* histClass,
     cout << "Warning in AliHistogramManager::AddHistogram(): Histogram " << name << " already exists" << endl;
     return;
   }
+  fPlansDirty = kTRUE;
   TString hname = name;
   
   TString titleStr(title);
@@ -494,6 +508,7 @@ void AliHistogramManager::AddHistogram(const Char_t* histClass,
     cout << "Warning in AliHistogramManager::AddHistogram(): Histogram " << name << " already exists" << endl;
     return;
   }
+  fPlansDirty = kTRUE;
   TString hname = name;
   
   TString titleStr(title);
@@ -624,146 +639,204 @@ void AliHistogramManager::FillHistClass(const Char_t* className, Float_t* values
   //
   //  fill a class of histograms
   //
+  FillHistClass(className, values, 1);
+}
+
+//__________________________________________________________________
+void AliHistogramManager::FillHistClass(const Char_t* className, const Float_t* values, Int_t nValues, Int_t stride) {
+  //
+  //  fill a class of histograms for a block of nValues variable arrays
+  //
+  Int_t classIndex = GetHistClassIndex(className);
+  if(classIndex<0) return;
+  RunFillPlan(classIndex, values, nValues, stride);
+}
+
+//__________________________________________________________________
+void AliHistogramManager::FillHistClass(Int_t classIndex, const Float_t* values, Int_t nValues /*=1*/, Int_t stride /*=AliReducedVarManager::kNVars*/) {
+  //
+  //  fill a class of histograms using the index from GetHistClassIndex()
+  //
+  if(fPlansDirty) CompileFillPlans();
+  if(classIndex<0 || classIndex>=(Int_t)fPlanLists.size()) return;
+  RunFillPlan(classIndex, values, nValues, stride);
+}
+
+//__________________________________________________________________
+Int_t AliHistogramManager::GetHistClassIndex(const Char_t* className) {
+  //
+  //  get the index of the fill plan of a histogram class, -1 if the class does not exist
+  //  The plan index is kept in the UniqueID of the class list
+  //
   THashList* hList = (THashList*)fMainList.FindObject(className);
-  if(!hList) {
-    /*cout << "Warning in AliHistogramManager::FillHistClass(): Histogram list " << className << " not found!" << endl;
-    cout << "         Histogram list not filled" << endl; */
-    return;
-  }
-  if(!hList) {
-    return;
+  if(!hList) return -1;
+  if(fPlansDirty) CompileFillPlans();
+  Int_t classIndex = Int_t(hList->GetUniqueID())-1;
+  if(classIndex<0 || classIndex>=(Int_t)fPlanLists.size() || fPlanLists[classIndex]!=hList) {
+    // list not known to the current plans (e.g. manager read from a file), recompile
+    CompileFillPlans();
+    classIndex = Int_t(hList->GetUniqueID())-1;
   }
+  return classIndex;
+}
+
+//__________________________________________________________________
+void AliHistogramManager::CompileFillPlans() {
+  //
+  //  decode the histogram variables from the UniqueIDs once and build the fill plans of all classes
+  //  The checks on fUsedVars are done here; fUsedVars only changes when histograms are added,
+  //    which invalidates the plans
+  //
+  fFillEntries.clear();
+  fTHnAxisVars.clear();
+  fPlanOffsets.clear();
+  fPlanLists.clear();
+  
+  for(Int_t iclass=0; iclass<fMainList.GetEntries(); ++iclass) {
+    THashList* hList = (THashList*)fMainList.At(iclass);
+    hList->SetUniqueID(iclass+1);
+    fPlanLists.push_back(hList);
+    fPlanOffsets.push_back(fFillEntries.size());
     
-  TIter next(hList);
-  TObject* h=0x0;
-  Bool_t isProfile;
-  Bool_t isTHn;
-  Int_t thnDim=0;
-  Bool_t isSparse=kFALSE;
-  Double_t fillValues[20]={0.0};
-  Int_t uid = 0;
-  Int_t varX=-1, varY=-1, varZ=-1, varT=-1, varW=-1;
-  Int_t dimension=0;
-  while((h=next())) {
-    Bool_t allVarsGood = kTRUE;
-    uid = h->GetUniqueID();
-    isProfile = (uid%10==1 ? kTRUE : kFALSE);   // units digit encodes the isProfile
-    isTHn = ((uid%100)>10 ? kTRUE : kFALSE);      
-    if(isTHn) thnDim = (uid%100)-10;        // the excess over 10 from the last 2 digits give the dimension of the THn
-    if(isTHn && ((TString)h->ClassName()).Contains("Sparse")) isSparse = kTRUE;
-    dimension = 0;
-    if(!isTHn) dimension = ((TH1*)h)->GetDimension();
-        
-    uid = (uid-(uid%100))/100;
-    varX = -1;
-    varY = -1;
-    varZ = -1;
-    varT = -1;
-    varW = -1;
-    if(uid>0) {
-      varW = uid%(fNVars+1)-1;
-      if(varW==0) varW=AliReducedVarManager::kNothing;
-      uid = (uid-(uid%(fNVars+1)))/(fNVars+1);
-      if(uid>0) varT = uid - 1;
-      //cout << "Filling " << h->GetName() << " with varT " << varT << endl;
-    }
-        
-    if(!isTHn) {
-      varX = ((TH1*)h)->GetXaxis()->GetUniqueID();
-      if(fUsedVars[varX]) {
-        switch(dimension) {
-          case 1:
-            if(isProfile) {
-              varY = ((TH1*)h)->GetYaxis()->GetUniqueID();
-              if(!fUsedVars[varY]) break;
-              if(varW>AliReducedVarManager::kNothing) { 
-                if(!fUsedVars[varW]) break;
-                ((TProfile*)h)->Fill(values[varX],values[varY],values[varW]);
-              }
-              else 
-                ((TProfile*)h)->Fill(values[varX],values[varY]);
-            }
-            else {
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TH1F*)h)->Fill(values[varX],values[varW]);
-              }
-              else
-                ((TH1F*)h)->Fill(values[varX]);
-            }
-          break;
-          case 2:
-            varY = ((TH1*)h)->GetYaxis()->GetUniqueID();
-            if(!fUsedVars[varY]) break;
-            if(isProfile) {
-              varZ = ((TH1*)h)->GetZaxis()->GetUniqueID();
-              if(!fUsedVars[varZ]) break;
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TProfile2D*)h)->Fill(values[varX],values[varY],values[varZ],values[varW]);
-              }
-              else
-                ((TProfile2D*)h)->Fill(values[varX],values[varY],values[varZ]);        
-            }
-            else {
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TH2F*)h)->Fill(values[varX],values[varY], values[varW]);
-              }
-              else
-                ((TH2F*)h)->Fill(values[varX],values[varY]);
-            }
+    TIter next(hList);
+    TObject* h=0x0;
+    while((h=next())) {
+      Int_t uid = h->GetUniqueID();
+      Bool_t isProfile = (uid%10==1 ? kTRUE : kFALSE);   // units digit encodes the isProfile
+      Bool_t isTHn = ((uid%100)>10 ? kTRUE : kFALSE);
+      Int_t thnDim = (isTHn ? (uid%100)-10 : 0);        // the excess over 10 from the last 2 digits give the dimension of the THn
+      
+      FillEntry entry;
+      entry.fHist = h;
+      entry.fVarX = -1; entry.fVarY = -1; entry.fVarZ = -1; entry.fVarT = -1; entry.fVarW = -1;
+      
+      uid = (uid-(uid%100))/100;
+      if(uid>0) {
+        entry.fVarW = uid%(fNVars+1)-1;
+        if(entry.fVarW==0) entry.fVarW=AliReducedVarManager::kNothing;
+        uid = (uid-(uid%(fNVars+1)))/(fNVars+1);
+        if(uid>0) entry.fVarT = uid - 1;
+      }
+      if(entry.fVarW>AliReducedVarManager::kNothing && !fUsedVars[entry.fVarW]) continue;
+      else if(entry.fVarW<=AliReducedVarManager::kNothing) entry.fVarW = -1;
+      
+      if(isTHn) {
+        Bool_t allVarsGood = kTRUE;
+        entry.fKind = kFillTHn;
+        entry.fVarX = fTHnAxisVars.size();
+        entry.fVarY = thnDim;
+        for(Int_t idim=0;idim<thnDim;++idim) {
+          Int_t var = ((THnBase*)h)->GetAxis(idim)->GetUniqueID();
+          allVarsGood &= fUsedVars[var];
+          fTHnAxisVars.push_back(var);
+        }
+        if(!allVarsGood) {
+          fTHnAxisVars.resize(entry.fVarX);
+          continue;
+        }
+        fFillEntries.push_back(entry);
+        continue;
+      }
+      
+      TH1* h1 = (TH1*)h;
+      entry.fVarX = h1->GetXaxis()->GetUniqueID();
+      if(!fUsedVars[entry.fVarX]) continue;
+      switch(h1->GetDimension()) {
+        case 1:
+          entry.fKind = kFillTH1;
+          if(isProfile) {
+            entry.fKind = kFillTProfile;
+            entry.fVarY = h1->GetYaxis()->GetUniqueID();
+            if(!fUsedVars[entry.fVarY]) continue;
+          }
           break;
-          case 3:
-            varY = ((TH1*)h)->GetYaxis()->GetUniqueID();
-            if(!fUsedVars[varY]) break;
-            varZ = ((TH1*)h)->GetZaxis()->GetUniqueID();
-            if(!fUsedVars[varZ]) break;
-            if(isProfile) {
-              if(!fUsedVars[varT]) break;
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TProfile3D*)h)->Fill(values[varX],values[varY],values[varZ],values[varT],values[varW]);
-              }
-              else
-                ((TProfile3D*)h)->Fill(values[varX],values[varY],values[varZ],values[varT]);
-            }
-            else {
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TH3F*)h)->Fill(values[varX],values[varY],values[varZ],values[varW]);
-              }
-              else
-                ((TH3F*)h)->Fill(values[varX],values[varY],values[varZ]);
-            }
+        case 2:
+          entry.fKind = (isProfile ? kFillTProfile2D : kFillTH2);
+          entry.fVarY = h1->GetYaxis()->GetUniqueID();
+          if(!fUsedVars[entry.fVarY]) continue;
+          if(isProfile) {
+            entry.fVarZ = h1->GetZaxis()->GetUniqueID();
+            if(!fUsedVars[entry.fVarZ]) continue;
+          }
           break;
-          default:
+        case 3:
+          entry.fKind = (isProfile ? kFillTProfile3D : kFillTH3);
+          entry.fVarY = h1->GetYaxis()->GetUniqueID();
+          if(!fUsedVars[entry.fVarY]) continue;
+          entry.fVarZ = h1->GetZaxis()->GetUniqueID();
+          if(!fUsedVars[entry.fVarZ]) continue;
+          if(isProfile && (entry.fVarT<0 || !fUsedVars[entry.fVarT])) continue;
           break;
-        }  // end switch
+        default:
+          continue;
       }
-    }  // end if(!isTHn)
-    else {
-      for(Int_t idim=0;idim<thnDim;++idim) {
-        if (isSparse) {
-          allVarsGood &= fUsedVars[((THnSparseF*)h)->GetAxis(idim)->GetUniqueID()];
-          fillValues[idim] = values[((THnSparseF*)h)->GetAxis(idim)->GetUniqueID()];
-        } else {
-          allVarsGood &= fUsedVars[((THnF*)h)->GetAxis(idim)->GetUniqueID()];
-          fillValues[idim] = values[((THnF*)h)->GetAxis(idim)->GetUniqueID()];
+      fFillEntries.push_back(entry);
+    }
+  }
+  fPlanOffsets.push_back(fFillEntries.size());
+  fPlansDirty = kFALSE;
+}
+
+//__________________________________________________________________
+void AliHistogramManager::RunFillPlan(Int_t classIndex, const Float_t* values, Int_t nValues, Int_t stride) {
+  //
+  //  fill the histograms of a class from its plan
+  //  The loop over histograms is the outer one so that each histogram is kept in cache for the whole block
+  //
+  const FillEntry* first = fFillEntries.data()+fPlanOffsets[classIndex];
+  const FillEntry* last = fFillEntries.data()+fPlanOffsets[classIndex+1];
+  Double_t fillValues[20]={0.0};
+  for(const FillEntry* e=first; e!=last; ++e) {
+    const Float_t* v = values;
+    const Bool_t weighted = (e->fVarW>=0);
+    switch(e->fKind) {
+      case kFillTH1:
+        for(Int_t i=0; i<nValues; ++i, v+=stride) {
+          if(weighted) ((TH1*)e->fHist)->Fill(v[e->fVarX], v[e->fVarW]);
+          else         ((TH1*)e->fHist)->Fill(v[e->fVarX]);
         }
-      }
-      if(allVarsGood) {
-        if(varW>AliReducedVarManager::kNothing) {
-          if(fUsedVars[varW]) {
-            if (isSparse) ((THnSparseF*)h)->Fill(fillValues,values[varW]);
-            else          ((THnF*)h)->Fill(fillValues,values[varW]);
-          }
+        break;
+      case kFillTProfile:
+        for(Int_t i=0; i<nValues; ++i, v+=stride) {
+          if(weighted) ((TProfile*)e->fHist)->Fill(v[e->fVarX], v[e->fVarY], v[e->fVarW]);
+          else         ((TProfile*)e->fHist)->Fill(v[e->fVarX], v[e->fVarY]);
         }
-        else {
-          if (isSparse) ((THnSparseF*)h)->Fill(fillValues);
-          else          ((THnF*)h)->Fill(fillValues);
+        break;
+      case kFillTH2:
+        for(Int_t i=0; i<nValues; ++i, v+=stride) {
+          if(weighted) ((TH2*)e->fHist)->Fill(v[e->fVarX], v[e->fVarY], v[e->fVarW]);
+          else         ((TH2*)e->fHist)->Fill(v[e->fVarX], v[e->fVarY]);
+        }
+        break;
+      case kFillTProfile2D:
+        for(Int_t i=0; i<nValues; ++i, v+=stride) {
+          if(weighted) ((TProfile2D*)e->fHist)->Fill(v[e->fVarX], v[e->fVarY], v[e->fVarZ], v[e->fVarW]);
+          else         ((TProfile2D*)e->fHist)->Fill(v[e->fVarX], v[e->fVarY], v[e->fVarZ]);
+        }
+        break;
+      case kFillTH3:
+        for(Int_t i=0; i<nValues; ++i, v+=stride) {
+          if(weighted) ((TH3*)e->fHist)->Fill(v[e->fVarX], v[e->fVarY], v[e->fVarZ], v[e->fVarW]);
+          else         ((TH3*)e->fHist)->Fill(v[e->fVarX], v[e->fVarY], v[e->fVarZ]);
+        }
+        break;
+      case kFillTProfile3D:
+        for(Int_t i=0; i<nValues; ++i, v+=stride) {
+          if(weighted) ((TProfile3D*)e->fHist)->Fill(v[e->fVarX], v[e->fVarY], v[e->fVarZ], v[e->fVarT], v[e->fVarW]);
+          else         ((TProfile3D*)e->fHist)->Fill(v[e->fVarX], v[e->fVarY], v[e->fVarZ], v[e->fVarT]);
+        }
+        break;
+      case kFillTHn: {
+        const Int_t* axisVars = fTHnAxisVars.data()+e->fVarX;
+        for(Int_t i=0; i<nValues; ++i, v+=stride) {
+          for(Int_t idim=0; idim<e->fVarY; ++idim) fillValues[idim] = v[axisVars[idim]];
+          if(weighted) ((THnBase*)e->fHist)->Fill(fillValues, v[e->fVarW]);
+          else         ((THnBase*)e->fHist)->Fill(fillValues);
         }
+        break;
       }
+      default:
+        break;
     }
   }
 }
@@ -8,6 +8,8 @@
 #ifndef ALIHISTOGRAMMANAGER_H
 #define ALIHISTOGRAMMANAGER_H
 
+#include <vector>
+
 #include <TString.h>
 #include <TObject.h>
 #include <THn.h>
@@ -69,6 +71,11 @@ class AliHistogramManager : public TObject {
                         TAxis* axis);
   
   void FillHistClass(const Char_t* className, Float_t* values);
+  // fill a block of nValues variable arrays (each of size stride) in one go
+  void FillHistClass(const Char_t* className, const Float_t* values, Int_t nValues, Int_t stride=AliReducedVarManager::kNVars);
+  // index based filling, avoiding the lookup by name; the index is valid until histograms are added
+  Int_t GetHistClassIndex(const Char_t* className);
+  void FillHistClass(Int_t classIndex, const Float_t* values, Int_t nValues=1, Int_t stride=AliReducedVarManager::kNVars);
   
   void SetUseDefaultVariableNames(Bool_t flag) {fUseDefaultVariableNames = flag;};
   void SetDefaultVarNames(TString* vars, TString* units);
@@ -106,7 +113,30 @@ class AliHistogramManager : public TObject {
   TString fVariableUnits[AliReducedVarManager::kNVars];               //! variable units
   Int_t fNVars;                          // maximum number of variables
   
+  // Fill plan: each histogram class is compiled once into a flat array of entries holding
+  // the target histogram and the decoded variable indices, so that the UniqueID decoding
+  // and the type checks are not repeated at every fill
+  enum EFillKind {
+    kFillTH1=0, kFillTProfile, kFillTH2, kFillTProfile2D, kFillTH3, kFillTProfile3D, kFillTHn
+  };
+  struct FillEntry {
+    TObject* fHist;      // target histogram
+    Int_t fKind;         // one of EFillKind
+    Int_t fVarX;         // variable on x (or first THn axis variable offset in fTHnAxisVars)
+    Int_t fVarY;         // variable on y (or THn dimension)
+    Int_t fVarZ;         // variable on z
+    Int_t fVarT;         // 4th variable for TProfile3D
+    Int_t fVarW;         // weight variable, -1 if not weighted
+  };
+  std::vector<FillEntry> fFillEntries;   //! fill entries of all histogram classes, contiguous per class
+  std::vector<Int_t> fTHnAxisVars;       //! axis variables of the THn entries
+  std::vector<Int_t> fPlanOffsets;       //! index of the first entry of each class plan (size: number of classes + 1)
+  std::vector<THashList*> fPlanLists;    //! histogram class list each plan was compiled from
+  Bool_t fPlansDirty;                    //! plans need to be recompiled (histograms were added)
+  
   void MakeAxisLabels(TAxis* ax, const Char_t* labels);
+  void CompileFillPlans();
+  void RunFillPlan(Int_t classIndex, const Float_t* values, Int_t nValues, Int_t stride);
   
   ClassDef(AliHistogramManager, 4)
 };
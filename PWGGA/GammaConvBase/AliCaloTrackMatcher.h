@@ -89,6 +89,10 @@ class AliCaloTrackMatcher : public AliAnalysisTaskSE {
     // private methods
     void Initialize(Int_t runNumber);
     void ProcessEvent(AliVEvent *event);
+    void ClearMatches();
+    Int_t GetTrackPosition(AliVEvent *event, Int_t trackID);
+    Bool_t GetClusterRow(Int_t clusterID, Int_t &begin, Int_t &end) const;
+    Bool_t GetTrackRow(Int_t trackPos, Int_t &begin, Int_t &end) const;
     void SetLogBinningYTH2(TH2* histoRebin);
 
     // debug methods
@@ -117,12 +121,21 @@ class AliCaloTrackMatcher : public AliAnalysisTaskSE {
 
     TClonesArray*         fArrClusters;            //! array with clusters
 
-    multimap<Int_t,Int_t> fMapTrackToCluster;      //! connects a given track ID with all associated cluster IDs
-    multimap<Int_t,Int_t> fMapClusterToTrack;      //! connects a given cluster ID with all associated track IDs
-
-    Int_t                 fNEntries;               //! number of current TrackID/ClusterID -> Eta/Phi connections
-    vector<pairFloat>     fVectorDeltaEtaDeltaPhi; //! vector of all matching residuals for a specific TrackID/ClusterID
-    mapT                  fMap_TrID_ClID_ToIndex;  //! map tuple of (trackID,clusterID) to index in vector fVectorDeltaEtaDeltaPhi
+    // track <-> cluster matches of the current event, compressed sparse row index by cluster ID and by track,
+    // the entries of a row are in matching order and hold the matching residuals
+    Int_t                 fFirstClusterRow;        //! cluster ID of the first row of fClusterRows
+    vector<Int_t>         fClusterRows;            //! first entry of each cluster ID, last element is the number of entries
+    vector<Int_t>         fClusterTracks;          //! matched track (position in the event) of each entry
+    vector<Int_t>         fClusterTrackIDs;        //! matched track ID of each entry
+    vector<Float_t>       fClusterDeltaEta;        //! dEta of each entry
+    vector<Float_t>       fClusterDeltaPhi;        //! dPhi of each entry
+    Int_t                 fFirstTrackRow;          //! track position of the first row of fTrackRows
+    vector<Int_t>         fTrackRows;              //! first entry of each track position, last element is the number of entries
+    vector<Int_t>         fTrackClusters;          //! matched cluster ID of each entry
+    vector<Float_t>       fTrackDeltaEta;          //! dEta of each entry
+    vector<Float_t>       fTrackDeltaPhi;          //! dPhi of each entry
+    Bool_t                fHasTrackPositions;      //! fTrackIDToPosition filled for the current event
+    vector<pairInt>       fTrackIDToPosition;      //! (track ID, position) of all tracks of the current AOD event, sorted
 
     // for cluster <-> V0-track matching (running with different mass hypthesis)
     multimap<Int_t,Int_t> fSecMapTrackToCluster;      //! connects a given secondary track ID with all associated cluster IDs
@@ -140,7 +153,7 @@ class AliCaloTrackMatcher : public AliAnalysisTaskSE {
 
     Bool_t                fDoLightOutput;          // switch for running light output, kFALSE -> normal mode, kTRUE -> light mode
 
-    ClassDef(AliCaloTrackMatcher,8)
+    ClassDef(AliCaloTrackMatcher,9)
 };
 
 #endif
@@ -192,6 +192,7 @@ AliAnalysisTaskSESigmacTopK0Spi::AliAnalysisTaskSESigmacTopK0Spi():
   fMultiplicityCutMax(99999.),
   fUseXmlFileFromCVMFS(kFALSE),
   fXmlFileFromCVMFS(""),
+  fUseFlatBDTForest(kFALSE),
   ftrackArraySelSoftPi(0x0),
   fnSelSoftPi(),
   fESDtrackCutsSoftPion(0x0),
@@ -317,6 +318,7 @@ AliAnalysisTaskSESigmacTopK0Spi::AliAnalysisTaskSESigmacTopK0Spi(const Char_t* n
   fMultiplicityCutMax(99999.),
   fUseXmlFileFromCVMFS(kFALSE),
   fXmlFileFromCVMFS(""),
+  fUseFlatBDTForest(kFALSE),
   ftrackArraySelSoftPi(0x0),
   fnSelSoftPi(),
   fESDtrackCutsSoftPion(0x0),
@@ -873,9 +875,19 @@ void AliAnalysisTaskSESigmacTopK0Spi::UserCreateOutputObjects() {
     delete tokensSpectators;
     if (fUseWeightsLibrary) {
       void* lib = dlopen(fTMVAlibName.Data(), RTLD_NOW);
-      void* p = dlsym(lib, Form("%s", fTMVAlibPtBin.Data()));
-      IClassifierReader* (*maker1)(std::vector<std::string>&) = (IClassifierReader* (*)(std::vector<std::string>&)) p;
-      fBDTReader = maker1(inputNamesVec);
+      if (fUseFlatBDTForest) {
+	TString xmlFile = fXmlWeightsFile;
+	if (fUseXmlFileFromCVMFS) xmlFile = AliDataFile::GetFileName(fXmlFileFromCVMFS.Data());
+	void* p = dlsym(lib, "AliHFTMVAFlatForest_maker");
+	IClassifierReader* (*maker1)(const char*, std::vector<std::string>&) = (IClassifierReader* (*)(const char*, std::vector<std::string>&)) p;
+	if (!p || xmlFile.IsNull()) AliFatal("Cannot build the flat BDT forest");
+	fBDTReader = maker1(xmlFile.Data(), inputNamesVec);
+      }
+      else {
+	void* p = dlsym(lib, Form("%s", fTMVAlibPtBin.Data()));
+	IClassifierReader* (*maker1)(std::vector<std::string>&) = (IClassifierReader* (*)(std::vector<std::string>&)) p;
+	fBDTReader = maker1(inputNamesVec);
+      }
     }
     
     if (fUseXmlWeightsFile) fReader->BookMVA("BDT method", fXmlWeightsFile);
@@ -182,6 +182,11 @@ class AliAnalysisTaskSESigmacTopK0Spi : public AliAnalysisTaskSE
   void SetXmlFileFromCVMFS(TString fileName) {fXmlFileFromCVMFS = fileName;}
   TString GetXmlFileFromCVMFS() const {return fXmlFileFromCVMFS;}
 
+  /// build fBDTReader at runtime from the xml weights (AliHFTMVAFlatForest in fTMVAlibName)
+  /// instead of using the compiled ReadBDT_* class of fTMVAlibPtBin
+  void SetUseFlatBDTForest(Bool_t flag) {fUseFlatBDTForest = flag;}
+  Bool_t GetUseFlatBDTForest() const {return fUseFlatBDTForest;}
+
   void SetUseMultiplicityCorrection(Bool_t flag){fUseMultCorrection=flag;}
 
   void SetReferenceMultiplcity(Double_t rmu){fRefMult=rmu;}
@@ -527,6 +532,7 @@ class AliAnalysisTaskSESigmacTopK0Spi : public AliAnalysisTaskSE
   TH2D *fBDTHistoTMVA;                  //!<! BDT histo file for the case in which the xml file is used
   Bool_t fUseXmlFileFromCVMFS;          // Boolean to acces Xml from CVMFS path
   TString fXmlFileFromCVMFS;            // Path in CVMFS directory
+  Bool_t fUseFlatBDTForest;             // flag to build the BDT class from the xml file at runtime
   
   // Multiplicity corrections
   TProfile* GetEstimatorHistogram(const AliVEvent *event);
@@ -563,7 +569,7 @@ class AliAnalysisTaskSESigmacTopK0Spi : public AliAnalysisTaskSE
   Bool_t isLcAnalysis;                    /// fill tree with only Lc candidates
   
   /// \cond CLASSIMP    
-  ClassDef(AliAnalysisTaskSESigmacTopK0Spi, 2); /// class for Sc ->pi Lc->p K0
+  ClassDef(AliAnalysisTaskSESigmacTopK0Spi, 3); /// class for Sc ->pi Lc->p K0
   /// \endcond    
 };
 
@@ -31,6 +31,7 @@
 #include <TDatabasePDG.h>
 #include <TString.h>
 #include <TList.h>
+#include <TClonesArray.h>
 #include <TProcessID.h>
 #include "AliLog.h"
 #include "AliVEvent.h"
@@ -161,7 +162,9 @@ fMassLambdaC(0.),
 fMassDstar(0.),
 fMassJpsi(0.),
 fMassPhi(0.),
-fMassK(0.)
+fMassK(0.),
+fVertexPool(0x0),
+fVertexPoolActive(kFALSE)
 {
   /// Default constructor
 
@@ -260,7 +263,9 @@ fMassLambdaC(source.fMassLambdaC),
 fMassDstar(source.fMassDstar),
 fMassJpsi(source.fMassJpsi),
 fMassPhi(source.fMassPhi),
-fMassK(source.fMassK)
+fMassK(source.fMassK),
+fVertexPool(0x0),
+fVertexPoolActive(kFALSE)
 {
   ///
   /// Copy constructor
@@ -384,6 +389,7 @@ AliAnalysisVertexingHF::~AliAnalysisVertexingHF() {
   if(fMassCalc2) { delete fMassCalc2; fMassCalc2=0; }
   if(fMassCalc3) { delete fMassCalc3; fMassCalc3=0; }
   if(fMassCalc4) { delete fMassCalc4; fMassCalc4=0; }
+  if(fVertexPool) { delete fVertexPool; fVertexPool=0; }
 }
 //----------------------------------------------------------------------------
 TList *AliAnalysisVertexingHF::FillListOfCuts() {
@@ -629,6 +635,16 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
   AliDebug(1,Form(" Selected tracks: %d",nSeleTrks));
   fnSeleTrksTotal += nSeleTrks;
 
+  // momenta of the selected tracks at the primary vertex, for the invariant
+  // mass pre-filters applied before the track-to-track DCAs and the vertexing
+  Double_t *seleMom = new Double_t[3*nSeleTrks+3];
+  for(Int_t iTrk=0; iTrk<nSeleTrks; iTrk++)
+    ((AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrk))->GetPxPyPz(&seleMom[3*iTrk]);
+
+  // the secondary vertices of this event are built in the pool
+  if(!fVertexPool) fVertexPool = new TClonesArray("AliAODVertex",16);
+  fVertexPoolActive=kTRUE;
+
 
   TObjArray *twoTrackArray1    = new TObjArray(2);
   TObjArray *twoTrackArray2    = new TObjArray(2);
@@ -782,7 +798,7 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
           fV1->GetXYZ(pos);
           fV1->GetCovMatrix(cov);
           chi2perNDF = fV1->GetChi2toNDF();
-          vertexCasc = new AliAODVertex(pos,cov,chi2perNDF,0x0,-1,AliAODVertex::kUndef,2);
+          vertexCasc = NewVertex(pos,cov,chi2perNDF,2);
           dcaCasc = 0.;
         }
         if(!vertexCasc) {
@@ -818,7 +834,7 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
         delete trackV0; trackV0=NULL;
         twoTrackArrayCasc->Clear();
         if(ioCascade) { delete ioCascade; ioCascade=NULL; }
-        if(vertexCasc) { delete vertexCasc; vertexCasc=NULL; }
+        if(vertexCasc) { DeleteVertex(vertexCasc); vertexCasc=NULL; }
         if(!fInputAOD) {delete v0; v0=NULL;}
 
       } // end loop on V0's
@@ -992,7 +1008,7 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	      fV1->GetXYZ(pos);
 	      fV1->GetCovMatrix(cov);
 	      chi2perNDF = fV1->GetChi2toNDF();
-	      vertexCasc = new AliAODVertex(pos,cov,chi2perNDF,0x0,-1,AliAODVertex::kUndef,2);
+	      vertexCasc = NewVertex(pos,cov,chi2perNDF,2);
 	      dcaCasc = 0.;
 	    }
 	    if(!vertexCasc) {
@@ -1039,7 +1055,7 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	    twoTrackArrayCasc->Clear();
 	    trackPi=0;
 	    if(ioCascade) {delete ioCascade; ioCascade=NULL;}
-	    delete vertexCasc; vertexCasc=NULL;
+	    DeleteVertex(vertexCasc); vertexCasc=NULL;
 	  } // end loop on soft pi tracks
 
 	  if(trackD0) {delete trackD0; trackD0=NULL;}
@@ -1052,7 +1068,7 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
       if( (!f3Prong && !f4Prong) ||
 	  (isLikeSign2Prong && !f3Prong) ) {
 	negtrack1=0;
-	delete vertexp1n1;
+	DeleteVertex(vertexp1n1);
 	continue;
       }
 
@@ -1139,13 +1155,24 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 
 	//printf("********** %d %d %d\n",postrack1->GetID(),postrack2->GetID(),negtrack1->GetID());
 
+	// check invariant mass cuts for D+,Ds,Lc
+	// (before the DCAs if the triplet is not needed for 4 prongs)
+        massCutOK=kTRUE;
+	Bool_t massCutDone=kFALSE;
+	if(f3Prong && fMassCutBeforeVertexing && !f4Prong) {
+	  Double_t pxDau[3]={mompos1[0],momneg1[0],seleMom[3*iTrkP2]};
+	  Double_t pyDau[3]={mompos1[1],momneg1[1],seleMom[3*iTrkP2+1]};
+	  Double_t pzDau[3]={mompos1[2],momneg1[2],seleMom[3*iTrkP2+2]};
+	  massCutOK = SelectInvMassAndPt3prong(pxDau,pyDau,pzDau,pidLcStatus);
+	  massCutDone=kTRUE;
+	  if(!massCutOK) { postrack2=0; continue; }
+	}
+
 	dcap2n1 = postrack2->GetDCA(negtrack1,fBzkG,xdummy,ydummy);
 	if(dcap2n1>dcaMax) { postrack2=0; continue; }
 	dcap1p2 = postrack2->GetDCA(postrack1,fBzkG,xdummy,ydummy);
 	if(dcap1p2>dcaMax) { postrack2=0; continue; }
 
-	// check invariant mass cuts for D+,Ds,Lc
-        massCutOK=kTRUE;
 	if(f3Prong) {
 	  if(postrack2->Charge()>0) {
 	    threeTrackArray->AddAt(postrack1,0);
@@ -1156,7 +1183,7 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	    threeTrackArray->AddAt(postrack1,1);
 	    threeTrackArray->AddAt(postrack2,2);
 	  }
-	  if(fMassCutBeforeVertexing){
+	  if(fMassCutBeforeVertexing && !massCutDone){
 	    postrack2->GetPxPyPz(mompos2);
 	    Double_t pxDau[3]={mompos1[0],momneg1[0],mompos2[0]};
 	    Double_t pyDau[3]={mompos1[1],momneg1[1],mompos2[1]};
@@ -1221,7 +1248,7 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 
 	  }
 	  if(io3Prong) {delete io3Prong; io3Prong=NULL;}
-	  if(secVert3PrAOD) {delete secVert3PrAOD; secVert3PrAOD=NULL;}
+	  if(secVert3PrAOD) {DeleteVertex(secVert3PrAOD); secVert3PrAOD=NULL;}
 	}
 
 	// 4 prong candidates
@@ -1277,6 +1304,21 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	    SetParametersAtVertex(postrack2,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP2));
 	    SetParametersAtVertex(negtrack2,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN2));
 
+	    // check invariant mass cuts for D0 (before the DCAs)
+	    massCutOK=kTRUE;
+	    if(fMassCutBeforeVertexing) {
+	      Double_t pxDau[4],pyDau[4],pzDau[4];
+	      Int_t iDau[4]={iTrkP1,iTrkN1,iTrkP2,iTrkN2};
+	      for(Int_t k=0; k<4; k++) {
+		pxDau[k]=seleMom[3*iDau[k]]; pyDau[k]=seleMom[3*iDau[k]+1]; pzDau[k]=seleMom[3*iDau[k]+2];
+	      }
+	      massCutOK = SelectInvMassAndPt4prong(pxDau,pyDau,pzDau);
+	    }
+	    if(!massCutOK) {
+	      negtrack2=0;
+	      continue;
+	    }
+
 	    dcap1n2 = postrack1->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
 	    if(dcap1n2 > fCutsD0toKpipipi->GetDCACut()) { negtrack2=0; continue; }
             dcap2n2 = postrack2->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
@@ -1288,17 +1330,6 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	    fourTrackArray->AddAt(postrack2,2);
 	    fourTrackArray->AddAt(negtrack2,3);
 
-	    // check invariant mass cuts for D0
-	    massCutOK=kTRUE;
-	    if(fMassCutBeforeVertexing)
-	      massCutOK = SelectInvMassAndPt4prong(fourTrackArray);
-
-	    if(!massCutOK) {
-	      fourTrackArray->Clear();
-	      negtrack2=0;
-	      continue;
-	    }
-
 	    // Vertexing
 	    AliAODVertex* secVert4PrAOD = ReconstructSecondaryVertex(fourTrackArray,dispersion);
 	    io4Prong = Make4Prong(fourTrackArray,event,secVert4PrAOD,vertexp1n1,vertexp1n1p2,dcap1n1,dcap1n2,dcap2n1,dcap2n2,ok4Prong);
@@ -1316,14 +1347,14 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
             }
 
 	    if(io4Prong) {delete io4Prong; io4Prong=NULL;}
-	    if(secVert4PrAOD) {delete secVert4PrAOD; secVert4PrAOD=NULL;}
+	    if(secVert4PrAOD) {DeleteVertex(secVert4PrAOD); secVert4PrAOD=NULL;}
 	    fourTrackArray->Clear();
 	    negtrack2 = 0;
 
 	  } // end loop on negative tracks
 
           threeTrackArray->Clear();
-	  delete vertexp1n1p2;
+	  DeleteVertex(vertexp1n1p2);
 
 	}
 
@@ -1410,16 +1441,7 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	SetParametersAtVertex(negtrack2,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN2));
 	//printf("********** %d %d %d\n",postrack1->GetID(),negtrack1->GetID(),negtrack2->GetID());
 
-	dcap1n2 = postrack1->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
-	if(dcap1n2>dcaMax) { negtrack2=0; continue; }
-	dcan1n2 = negtrack1->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
-	if(dcan1n2>dcaMax) { negtrack2=0; continue; }
-
-	threeTrackArray->AddAt(negtrack1,0);
-	threeTrackArray->AddAt(postrack1,1);
-	threeTrackArray->AddAt(negtrack2,2);
-
-	// check invariant mass cuts for D+,Ds,Lc
+	// check invariant mass cuts for D+,Ds,Lc (before the DCAs)
         massCutOK=kTRUE;
 	if(fMassCutBeforeVertexing && f3Prong){
 	  negtrack2->GetPxPyPz(momneg2);
@@ -1430,11 +1452,19 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	  massCutOK = SelectInvMassAndPt3prong(pxDau,pyDau,pzDau,pidLcStatus);
 	}
 	if(!massCutOK) {
-	  threeTrackArray->Clear();
 	  negtrack2=0;
 	  continue;
 	}
 
+	dcap1n2 = postrack1->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
+	if(dcap1n2>dcaMax) { negtrack2=0; continue; }
+	dcan1n2 = negtrack1->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
+	if(dcan1n2>dcaMax) { negtrack2=0; continue; }
+
+	threeTrackArray->AddAt(negtrack1,0);
+	threeTrackArray->AddAt(postrack1,1);
+	threeTrackArray->AddAt(negtrack2,2);
+
 	// Vertexing
 	twoTrackArray2->AddAt(postrack1,0);
 	twoTrackArray2->AddAt(negtrack2,1);
@@ -1477,7 +1507,7 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	    }
 	  }
 	  if(io3Prong) {delete io3Prong; io3Prong=NULL;}
-	  if(secVert3PrAOD) {delete secVert3PrAOD; secVert3PrAOD=NULL;}
+	  if(secVert3PrAOD) {DeleteVertex(secVert3PrAOD); secVert3PrAOD=NULL;}
 	}
 	threeTrackArray->Clear();
 	negtrack2 = 0;
@@ -1487,7 +1517,7 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
       twoTrackArray2->Clear();
 
       negtrack1 = 0;
-      delete vertexp1n1;
+      DeleteVertex(vertexp1n1);
     } // end 1st loop on negative tracks
 
     postrack1 = 0;
@@ -1538,9 +1568,14 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
   threeTrackArray->Delete(); delete threeTrackArray;
   fourTrackArray->Delete();  delete fourTrackArray;
   delete [] seleFlags; seleFlags=NULL;
+  delete [] seleMom; seleMom=NULL;
   if(evtNumber) {delete [] evtNumber; evtNumber=NULL;}
   tracksAtVertex.Delete();
 
+  // release the vertices of this event, the memory is kept for the next one
+  fVertexPool->Delete();
+  fVertexPoolActive=kFALSE;
+
   if(fInputAOD) {
     seleTrksArray.Delete();
     if(fAODMap) { delete [] fAODMap; fAODMap=NULL; }
@@ -2305,11 +2340,7 @@ AliAODRecoDecayHF2Prong *AliAnalysisVertexingHF::Make2Prong(
 
   if(!refill && !callFromCascade){
     //skip if it is called in refill step or for V0+bachelor because already checked
-    Bool_t okMassCut=kFALSE;
-    if(!okMassCut && fD0toKpi)   if(SelectInvMassAndPtD0Kpi(px,py,pz))     okMassCut=kTRUE;
-    if(!okMassCut && fJPSItoEle) if(SelectInvMassAndPtJpsiee(px,py,pz))    okMassCut=kTRUE;
-    if(!okMassCut && fDstar)     if(SelectInvMassAndPtDstarD0pi(px,py,pz)) okMassCut=kTRUE;
-    if(!okMassCut) {
+    if(!SelectInvMassAndPt2prong(px,py,pz)) {
       //AliDebug(2," candidate didn't pass mass cut");
       return 0x0;
     }
@@ -2551,7 +2582,7 @@ AliAODRecoDecayHF3Prong* AliAnalysisVertexingHF::Make3Prong(
       dist23=TMath::Sqrt((vertexp2n1->GetX()-pos[0])*(vertexp2n1->GetX()-pos[0])+(vertexp2n1->GetY()-pos[1])*(vertexp2n1->GetY()-pos[1])+(vertexp2n1->GetZ()-pos[2])*(vertexp2n1->GetZ()-pos[2]));
       the3Prong->SetDist12toPrim(dist12);
       the3Prong->SetDist23toPrim(dist23);
-      delete vertexp2n1;
+      DeleteVertex(vertexp2n1);
     }
   }
 
@@ -3034,11 +3065,41 @@ AliAODVertex* AliAnalysisVertexingHF::ReconstructSecondaryVertex(TObjArray *trkA
   delete vertexESD; vertexESD=NULL;
 
   Int_t nprongs= (useTRefArray ? 0 : trkArray->GetEntriesFast());
-  vertexAOD = new AliAODVertex(pos,cov,chi2perNDF,0x0,-1,AliAODVertex::kUndef,nprongs);
+  vertexAOD = NewVertex(pos,cov,chi2perNDF,nprongs);
 
   return vertexAOD;
 }
 //-----------------------------------------------------------------------------
+AliAODVertex* AliAnalysisVertexingHF::NewVertex(Double_t *pos,Double_t *cov,
+						Double_t chi2perNDF,Int_t nprongs) const
+{
+  /// Create a secondary vertex, in the pool while FindCandidates is running.
+  /// Release it with DeleteVertex
+
+  if(fVertexPoolActive) {
+    return new((*fVertexPool)[fVertexPool->GetEntriesFast()]) AliAODVertex(pos,cov,chi2perNDF,0x0,-1,AliAODVertex::kUndef,nprongs);
+  }
+  return new AliAODVertex(pos,cov,chi2perNDF,0x0,-1,AliAODVertex::kUndef,nprongs);
+}
+//-----------------------------------------------------------------------------
+void AliAnalysisVertexingHF::DeleteVertex(AliAODVertex *vtx) const
+{
+  /// Delete a vertex created with NewVertex. Pool vertices are destructed
+  /// in place, their memory is reused by the next vertex
+
+  if(!vtx) return;
+  if(fVertexPool) {
+    // vertices are released in reverse order of creation, search from the last one
+    for(Int_t i=fVertexPool->GetEntriesFast()-1; i>=0; i--) {
+      if(fVertexPool->UncheckedAt(i)==vtx) {
+	fVertexPool->RemoveAt(i);
+	return;
+      }
+    }
+  }
+  delete vtx;
+}
+//-----------------------------------------------------------------------------
 Bool_t AliAnalysisVertexingHF::SelectInvMassAndPt3prong(TObjArray *trkArray){
   /// Invariant mass cut on tracks
   //AliCodeTimerAuto("",0);
@@ -3110,6 +3171,17 @@ Bool_t AliAnalysisVertexingHF::SelectInvMassAndPtCascade(TObjArray *trkArray){
   return retval;
 }
 //-----------------------------------------------------------------------------
+Bool_t AliAnalysisVertexingHF::SelectInvMassAndPt2prong(Double_t *px,
+							Double_t *py,
+							Double_t *pz){
+  /// Check invariant mass cut and pt candidate cut for the enabled 2 prong decays
+
+  if(fD0toKpi   && SelectInvMassAndPtD0Kpi(px,py,pz))     return kTRUE;
+  if(fJPSItoEle && SelectInvMassAndPtJpsiee(px,py,pz))    return kTRUE;
+  if(fDstar     && SelectInvMassAndPtDstarD0pi(px,py,pz)) return kTRUE;
+  return kFALSE;
+}
+//-----------------------------------------------------------------------------
 Bool_t AliAnalysisVertexingHF::SelectInvMassAndPtD0Kpi(Double_t *px,
 						       Double_t *py,
 						       Double_t *pz){
@@ -355,6 +355,9 @@ class AliAnalysisVertexingHF : public TNamed {
   Double_t fMassPhi;
   Double_t fMassK;
 
+  TClonesArray *fVertexPool; //! reused memory of the vertices built in FindCandidates
+  Bool_t fVertexPoolActive;  //! vertices are built in fVertexPool (only inside FindCandidates)
+
   //
   void AddRefs(AliAODVertex *v,AliAODRecoDecayHF *rd,const AliVEvent *event,
 	       const TObjArray *trkArray) const;
@@ -401,7 +404,10 @@ class AliAnalysisVertexingHF : public TNamed {
   void MapAODtracks(AliVEvent *aod);
   AliAODVertex* PrimaryVertex(const TObjArray *trkArray=0x0,AliVEvent *event=0x0) const;
   AliAODVertex* ReconstructSecondaryVertex(TObjArray *trkArray,Double_t &dispersion,Bool_t useTRefArray=kTRUE) const;
+  AliAODVertex* NewVertex(Double_t *pos,Double_t *cov,Double_t chi2perNDF,Int_t nprongs) const;
+  void DeleteVertex(AliAODVertex *vtx) const;
 
+  Bool_t SelectInvMassAndPt2prong(Double_t *px,Double_t *py,Double_t *pz);
   Bool_t SelectInvMassAndPt3prong(Double_t *px,Double_t *py,Double_t *pz, Int_t pidLcStatus=3);
   Bool_t SelectInvMassAndPt4prong(Double_t *px,Double_t *py,Double_t *pz);
   Bool_t SelectInvMassAndPtD0Kpi(Double_t *px,Double_t *py,Double_t *pz);
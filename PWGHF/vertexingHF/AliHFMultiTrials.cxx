@@ -26,10 +26,39 @@
 #include "AliHFMassFitterVAR.h"
 #include "AliHFMultiTrials.h"
 
+#include <unistd.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
 /// \cond CLASSIMP
 ClassImp(AliHFMultiTrials);
 /// \endcond
 
+namespace {
+  // results of one trial, followed by (done, counts, error) for each bin counting range
+  enum { kResOut, kResChi2, kResSignif, kResErSignif, kResMean, kResErMean, kResSigma, kResErSigma,
+         kResRawY, kResErRawY, kResBkg, kResErBkg, kResBkgBEdge, kResErBkgBEdge, kNResValues };
+
+  Bool_t IsGoodFit(const Double_t* res, Double_t sigmaMC){
+    return res[kResOut]>0 && res[kResChi2]>0. && res[kResSigma]>0.5*sigmaMC && res[kResSigma]<2.0*sigmaMC;
+  }
+
+  Bool_t WriteAll(Int_t fd, const void* buf, size_t n){
+    const char* p=(const char*)buf;
+    while(n>0){
+      ssize_t w=write(fd,p,n);
+      if(w<0 && errno==EINTR) continue;
+      if(w<=0) return kFALSE;
+      p+=w; n-=w;
+    }
+    return kTRUE;
+  }
+}
+
 
 //_________________________________________________________________________
 AliHFMultiTrials::AliHFMultiTrials() : 
@@ -65,6 +94,8 @@ AliHFMultiTrials::AliHFMultiTrials() :
   fUseFixSigFixMean(kTRUE),
   fSaveBkgVal(kFALSE),
   fDrawIndividualFits(kFALSE),
+  fNumOfWorkers(1),
+  fUseWarmStart(kFALSE),
   fHistoRawYieldDistAll(0x0),
   fHistoRawYieldTrialAll(0x0),
   fHistoSigmaTrialAll(0x0),
@@ -186,6 +217,35 @@ Bool_t AliHFMultiTrials::CreateHistos(){
 
 }
 
+//________________________________________________________________________
+Bool_t AliHFMultiTrials::IsCaseUsed(Int_t typeb, Int_t igs) const{
+  // check if the background function and the sigma/mean configuration are enabled
+  if(typeb==kExpoBkg && !fUseExpoBkg) return kFALSE;
+  if(typeb==kLinBkg && !fUseLinBkg) return kFALSE;
+  if(typeb==kPol2Bkg && !fUsePol2Bkg) return kFALSE;
+  if(typeb==kPol3Bkg && !fUsePol3Bkg) return kFALSE;
+  if(typeb==kPol4Bkg && !fUsePol4Bkg) return kFALSE;
+  if(typeb==kPol5Bkg && !fUsePol5Bkg) return kFALSE;
+  if(typeb==kPowBkg && !fUsePowLawBkg) return kFALSE;
+  if(typeb==kPowTimesExpoBkg && !fUsePowLawTimesExpoBkg) return kFALSE;
+  if (igs==kFixSigUpFreeMean && !fUseFixSigUpFreeMean) return kFALSE;
+  if (igs==kFixSigDownFreeMean && !fUseFixSigDownFreeMean) return kFALSE;
+  if (igs==kFreeSigFixMean  && !fUseFixedMeanFreeS) return kFALSE;
+  if (igs==kFreeSigFreeMean  && !fUseFreeS) return kFALSE;
+  if (igs==kFixSigFreeMean  && !fUseFixSigFreeMean) return kFALSE;
+  if (igs==kFixSigFixMean   && !fUseFixSigFixMean) return kFALSE;
+  return kTRUE;
+}
+
+//________________________________________________________________________
+Int_t AliHFMultiTrials::TrialIndex(Int_t ir, Int_t iFirstBin, Int_t iMinMass, Int_t iMaxMass, Int_t typeb, Int_t igs) const{
+  // index of the trial in the array of results
+  Int_t index=ir*fNumOfFirstBinSteps+iFirstBin-1;
+  index=index*fNumOfLowLimFitSteps+iMinMass;
+  index=index*fNumOfUpLimFitSteps+iMaxMass;
+  return (index*kNBkgFuncCases+typeb)*kNFitConfCases+igs;
+}
+
 //________________________________________________________________________
 Bool_t AliHFMultiTrials::DoMultiTrials(TH1D* hInvMassHisto, TPad* thePad){
   // perform the multiple fits
@@ -193,255 +253,408 @@ Bool_t AliHFMultiTrials::DoMultiTrials(TH1D* hInvMassHisto, TPad* thePad){
   Bool_t hOK=CreateHistos();
   if(!hOK) return kFALSE;
 
-  Int_t itrial=0;
-  Int_t types=0;
-  Int_t itrialBC=0;
-  Int_t totTrials=fNumOfRebinSteps*fNumOfFirstBinSteps*fNumOfLowLimFitSteps*fNumOfUpLimFitSteps;
-
   fMinYieldGlob=999999.;
   fMaxYieldGlob=0.;
-  Float_t xnt[15];
 
+  // rebinned histograms, shared by all the trials with the same rebin and first bin
+  std::vector<TH1F*> hRebinned(fNumOfRebinSteps*fNumOfFirstBinSteps);
+  for(Int_t ir=0; ir<fNumOfRebinSteps; ir++){
+    for(Int_t iFirstBin=1; iFirstBin<=fNumOfFirstBinSteps; iFirstBin++) {
+      Int_t ih=ir*fNumOfFirstBinSteps+iFirstBin-1;
+      if(fNumOfFirstBinSteps==1) hRebinned[ih]=RebinHisto(hInvMassHisto,fRebinSteps[ir],-1);
+      else hRebinned[ih]=RebinHisto(hInvMassHisto,fRebinSteps[ir],iFirstBin);
+    }
+  }
+
+  Int_t nTrials=fNumOfRebinSteps*fNumOfFirstBinSteps*fNumOfLowLimFitSteps*fNumOfUpLimFitSteps*kNBkgFuncCases*kNFitConfCases;
+  const Int_t nRes=kNResValues+3*fNumOfnSigmaBinCSteps;
+  std::vector<Double_t> results((size_t)nTrials*nRes,0.);
+  for(Int_t i=0; i<nTrials; i++) results[(size_t)i*nRes+kResChi2]=-1.;
+
+  Int_t nWorkers=fNumOfWorkers;
+  if(nWorkers>1 && fDrawIndividualFits && thePad){
+    Printf("Drawing of the individual fits needs the fitters in this process, using one worker");
+    nWorkers=1;
+  }
+
+  if(nWorkers==1){
+    FitTrials(hInvMassHisto,hRebinned,0,1,results,-1,thePad);
+  }else{
+    // each worker process sends back (trial index, results) records through a pipe
+    std::vector<Int_t> pids(nWorkers,-1);
+    std::vector<Int_t> fds(nWorkers,-1);
+    fflush(stdout);
+    fflush(stderr);
+    for(Int_t iw=0; iw<nWorkers; iw++){
+      Int_t fd[2];
+      if(pipe(fd)==0){
+        pids[iw]=fork();
+        if(pids[iw]==0){
+          close(fd[0]);
+          for(Int_t jw=0; jw<iw; jw++) if(fds[jw]>=0) close(fds[jw]);
+          FitTrials(hInvMassHisto,hRebinned,iw,nWorkers,results,fd[1],0x0);
+          close(fd[1]);
+          fflush(stdout);
+          _exit(0);
+        }
+        close(fd[1]);
+        if(pids[iw]>0) fds[iw]=fd[0];
+        else close(fd[0]);
+      }
+      if(pids[iw]<0){
+        Printf("Could not start worker %d, its fits are done in this process",iw);
+        FitTrials(hInvMassHisto,hRebinned,iw,nWorkers,results,-1,0x0);
+      }
+    }
+    // the pipes are read as the data arrive, a worker never blocks on a full pipe;
+    // the records can be split between reads and are collected in a buffer per worker
+    const size_t recSize=sizeof(Int_t)+nRes*sizeof(Double_t);
+    std::vector<std::vector<char> > pending(nWorkers);
+    std::vector<char> chunk(65536);
+    std::vector<struct pollfd> pfds;
+    std::vector<Int_t> pworker;
+    for(;;){
+      pfds.clear();
+      pworker.clear();
+      for(Int_t iw=0; iw<nWorkers; iw++){
+        if(fds[iw]<0) continue;
+        struct pollfd p;
+        p.fd=fds[iw];
+        p.events=POLLIN;
+        p.revents=0;
+        pfds.push_back(p);
+        pworker.push_back(iw);
+      }
+      if(pfds.empty()) break;
+      if(poll(pfds.data(),pfds.size(),-1)<0){
+        if(errno==EINTR) continue;
+        Printf("Error while waiting for the workers, their missing fits are counted as failed");
+        for(size_t ip=0; ip<pfds.size(); ip++){ close(fds[pworker[ip]]); fds[pworker[ip]]=-1; }
+        break;
+      }
+      for(size_t ip=0; ip<pfds.size(); ip++){
+        if(!pfds[ip].revents) continue;
+        const Int_t iw=pworker[ip];
+        ssize_t r=read(fds[iw],chunk.data(),chunk.size());
+        if(r<0 && (errno==EINTR || errno==EAGAIN)) continue;
+        if(r<=0){ // end of the worker output
+          close(fds[iw]);
+          fds[iw]=-1;
+          continue;
+        }
+        std::vector<char>& buf=pending[iw];
+        buf.insert(buf.end(),chunk.begin(),chunk.begin()+r);
+        size_t used=0;
+        for(; used+recSize<=buf.size(); used+=recSize){
+          Int_t index;
+          memcpy(&index,&buf[used],sizeof(Int_t));
+          if(index>=0 && index<nTrials) memcpy(&results[(size_t)index*nRes],&buf[used+sizeof(Int_t)],nRes*sizeof(Double_t));
+        }
+        buf.erase(buf.begin(),buf.begin()+used);
+      }
+    }
+    for(Int_t iw=0; iw<nWorkers; iw++){
+      if(pids[iw]<=0) continue;
+      Int_t status=0;
+      waitpid(pids[iw],&status,0);
+      if(!WIFEXITED(status) || WEXITSTATUS(status)!=0) Printf("Worker %d did not terminate correctly, its missing fits are counted as failed",iw);
+    }
+  }
+
+  // fill the outputs in the order of the trials
+  Int_t itrial=0;
   for(Int_t ir=0; ir<fNumOfRebinSteps; ir++){
-    Int_t rebin=fRebinSteps[ir];
     for(Int_t iFirstBin=1; iFirstBin<=fNumOfFirstBinSteps; iFirstBin++) {
-      TH1F* hRebinned=0x0;
-      if(fNumOfFirstBinSteps==1) hRebinned=RebinHisto(hInvMassHisto,rebin,-1);
-      else hRebinned=RebinHisto(hInvMassHisto,rebin,iFirstBin);
       for(Int_t iMinMass=0; iMinMass<fNumOfLowLimFitSteps; iMinMass++){
-        Double_t minMassForFit=fLowLimFitSteps[iMinMass];
-        Double_t hmin=TMath::Max(minMassForFit,hRebinned->GetBinLowEdge(2));
         for(Int_t iMaxMass=0; iMaxMass<fNumOfUpLimFitSteps; iMaxMass++){
-          Double_t maxMassForFit=fUpLimFitSteps[iMaxMass];
-          Double_t hmax=TMath::Min(maxMassForFit,hRebinned->GetBinLowEdge(hRebinned->GetNbinsX()));
           ++itrial;
           for(Int_t typeb=0; typeb<kNBkgFuncCases; typeb++){
-            if(typeb==kExpoBkg && !fUseExpoBkg) continue;
-            if(typeb==kLinBkg && !fUseLinBkg) continue;
-            if(typeb==kPol2Bkg && !fUsePol2Bkg) continue;
-            if(typeb==kPol3Bkg && !fUsePol3Bkg) continue;
-            if(typeb==kPol4Bkg && !fUsePol4Bkg) continue;
-            if(typeb==kPol5Bkg && !fUsePol5Bkg) continue;
-            if(typeb==kPowBkg && !fUsePowLawBkg) continue;
-            if(typeb==kPowTimesExpoBkg && !fUsePowLawTimesExpoBkg) continue;
             for(Int_t igs=0; igs<kNFitConfCases; igs++){
-              if (igs==kFixSigUpFreeMean && !fUseFixSigUpFreeMean) continue;
-              if (igs==kFixSigDownFreeMean && !fUseFixSigDownFreeMean) continue;
-              if (igs==kFreeSigFixMean  && !fUseFixedMeanFreeS) continue;
-              if (igs==kFreeSigFreeMean  && !fUseFreeS) continue;
-              if (igs==kFixSigFreeMean  && !fUseFixSigFreeMean) continue;
-              if (igs==kFixSigFixMean   && !fUseFixSigFixMean) continue;
-              Int_t theCase=igs*kNBkgFuncCases+typeb;
+              if(!IsCaseUsed(typeb,igs)) continue;
+              Int_t index=TrialIndex(ir,iFirstBin,iMinMass,iMaxMass,typeb,igs);
+              FillTrial(fRebinSteps[ir],iFirstBin,fLowLimFitSteps[iMinMass],fUpLimFitSteps[iMaxMass],typeb,igs,itrial,&results[(size_t)index*nRes]);
+            }
+          }
+        }
+      }
+    }
+  }
+  for(auto h : hRebinned) delete h;
+  return kTRUE;
+}
+
+//________________________________________________________________________
+void AliHFMultiTrials::FitTrials(TH1D* hInvMassHisto, const std::vector<TH1F*>& hRebinned, Int_t worker, Int_t nWorkers,
+                                 std::vector<Double_t>& results, Int_t fd, TPad* thePad){
+  // fit the trials of a worker. The trials differing only in the fit range
+  // are fitted by the same worker, in order of fit range, so that each of them
+  // can start from the previous one
+  // The results are written in the pipe fd, if fd>=0
+
+  const Int_t nRes=kNResValues+3*fNumOfnSigmaBinCSteps;
+  Int_t totTrials=fNumOfRebinSteps*fNumOfFirstBinSteps*fNumOfLowLimFitSteps*fNumOfUpLimFitSteps;
+  Int_t iGroup=-1;
+  for(Int_t ir=0; ir<fNumOfRebinSteps; ir++){
+    for(Int_t iFirstBin=1; iFirstBin<=fNumOfFirstBinSteps; iFirstBin++) {
+      TH1F* hReb=hRebinned[ir*fNumOfFirstBinSteps+iFirstBin-1];
+      for(Int_t typeb=0; typeb<kNBkgFuncCases; typeb++){
+        for(Int_t igs=0; igs<kNFitConfCases; igs++){
+          if(!IsCaseUsed(typeb,igs)) continue;
+          if((++iGroup)%nWorkers!=worker) continue;
+          Int_t theCase=igs*kNBkgFuncCases+typeb;
+          for(Int_t iMinMass=0; iMinMass<fNumOfLowLimFitSteps; iMinMass++){
+            for(Int_t iMaxMass=0; iMaxMass<fNumOfUpLimFitSteps; iMaxMass++){
+              Int_t itrial=((ir*fNumOfFirstBinSteps+iFirstBin-1)*fNumOfLowLimFitSteps+iMinMass)*fNumOfUpLimFitSteps+iMaxMass+1;
               Int_t globBin=itrial+theCase*totTrials;
-              for(Int_t j=0; j<15; j++) xnt[j]=0.;
-
-              Bool_t mustDeleteFitter = kTRUE;
-              AliHFMassFitterVAR*  fitter=0x0;
-              //if D0 Reflection
-              if(fhTemplRefl){
-                fitter=new AliHFMassFitterVAR(hRebinned,hmin,hmax,1,typeb,2);
-                fitter->SetTemplateReflections(fhTemplRefl);
-                fitter->SetFixReflOverS(fFixRefloS,kTRUE);
-              }
-              else {
-                if(typeb<=kPol2Bkg){
-                  fitter=new AliHFMassFitterVAR(hRebinned,hmin, hmax,1,typeb,types);
-                }else if(typeb==kPowBkg){
-                  fitter=new AliHFMassFitterVAR(hRebinned,hmin, hmax,1,4,types);
-                }else if(typeb==kPowTimesExpoBkg){
-                  fitter=new AliHFMassFitterVAR(hRebinned,hmin, hmax,1,5,types);
-                }else{
-                  fitter=new AliHFMassFitterVAR(hRebinned,hmin, hmax,1,6,types);
-                  if(typeb==kPol3Bkg) fitter->SetBackHighPolDegree(3);
-                  if(typeb==kPol4Bkg) fitter->SetBackHighPolDegree(4);
-                  if(typeb==kPol5Bkg) fitter->SetBackHighPolDegree(5);
-                }
-                fitter->SetReflectionSigmaFactor(0);
-              }
-              if(fFitOption==0) {
-                fitter->SetUseLikelihoodFit();
-                Printf("Using likelihood fit");
-              }
-              else if(fFitOption==1) {
-                fitter->SetUseChi2Fit();
-                Printf("Using chi2 fit");
-              }
-              else if (fFitOption==2) {
-                fitter->SetUseLikelihoodWithWeightsFit();
-                Printf("Using likelihood fit with weights");
+              Int_t index=TrialIndex(ir,iFirstBin,iMinMass,iMaxMass,typeb,igs);
+              const Double_t* warmStart=0x0;
+              if(fUseWarmStart){
+                Int_t iNeigh=-1;
+                if(iMaxMass>0) iNeigh=TrialIndex(ir,iFirstBin,iMinMass,iMaxMass-1,typeb,igs);
+                else if(iMinMass>0) iNeigh=TrialIndex(ir,iFirstBin,iMinMass-1,iMaxMass,typeb,igs);
+                if(iNeigh>=0 && IsGoodFit(&results[(size_t)iNeigh*nRes],fSigmaGausMC)) warmStart=&results[(size_t)iNeigh*nRes];
               }
-              fitter->SetInitialGaussianMean(fMassD);
-              fitter->SetInitialGaussianSigma(fSigmaGausMC);
-              xnt[0]=rebin;
-              xnt[1]=iFirstBin;
-              xnt[2]=minMassForFit;
-              xnt[3]=maxMassForFit;
-              xnt[4]=typeb;
-              xnt[6]=0;
-              if(igs==kFixSigFreeMean){
-                fitter->SetFixGaussianSigma(fSigmaGausMC,kTRUE);
-                xnt[5]=1;
-              }else if(igs==kFixSigUpFreeMean){
-                fitter->SetFixGaussianSigma(fSigmaGausMC*(1.+fSigmaMCVariation),kTRUE);
-                xnt[5]=2;
-              }else if(igs==kFixSigDownFreeMean){
-                fitter->SetFixGaussianSigma(fSigmaGausMC*(1.-fSigmaMCVariation),kTRUE);
-                xnt[5]=3;
-              }else if(igs==kFreeSigFreeMean){
-                xnt[5]=0;
-              }else if(igs==kFixSigFixMean){
-                fitter->SetFixGaussianSigma(fSigmaGausMC,kTRUE);
-                fitter->SetFixGaussianMean(fMassD,kTRUE);
-                xnt[5]=1;
-                xnt[6]=1;
-              }else if(igs==kFreeSigFixMean){
-                fitter->SetFixGaussianMean(fMassD,kTRUE);
-                xnt[5]=0;
-                xnt[6]=1;
-              }
-              Bool_t out=kFALSE;
-              Double_t chisq=-1.;
-              Double_t sigma=0.;
-              Double_t esigma=0.;
-              Double_t pos=.0;
-              Double_t epos=.0;
-              Double_t ry=.0;
-              Double_t ery=.0;
-              Double_t significance=0.;
-              Double_t erSignif=0.;
-              Double_t bkg=0.;
-              Double_t erbkg=0.;
-              Double_t bkgBEdge=0;
-              Double_t erbkgBEdge=0;
-              TF1* fB1=0x0;
-              if(typeb<kNBkgFuncCases){
-                printf("****** START FIT OF HISTO %s WITH REBIN %d FIRST BIN %d MASS RANGE %f-%f BACKGROUND FIT FUNCTION=%d CONFIG SIGMA/MEAN=%d\n",hInvMassHisto->GetName(),rebin,iFirstBin,minMassForFit,maxMassForFit,typeb,igs);
-                out=fitter->MassFitter(0);
-                chisq=fitter->GetReducedChiSquare();
-                fitter->Significance(fnSigmaForBkgEval,significance,erSignif);
-                sigma=fitter->GetSigma();
-                pos=fitter->GetMean();
-                esigma=fitter->GetSigmaUncertainty();
-                if(esigma<0.00001) esigma=0.0001;
-                epos=fitter->GetMeanUncertainty();
-                if(epos<0.00001) epos=0.0001;
-                ry=fitter->GetRawYield();
-                ery=fitter->GetRawYieldError();
-                fB1=fitter->GetBackgroundFullRangeFunc();
-                fitter->Background(fnSigmaForBkgEval,bkg,erbkg);
-                Double_t minval = hInvMassHisto->GetXaxis()->GetBinLowEdge(hInvMassHisto->FindBin(pos-fnSigmaForBkgEval*sigma));
-                Double_t maxval = hInvMassHisto->GetXaxis()->GetBinUpEdge(hInvMassHisto->FindBin(pos+fnSigmaForBkgEval*sigma));
-                fitter->Background(minval,maxval,bkgBEdge,erbkgBEdge);
-                if(out && fDrawIndividualFits && thePad){
-                  thePad->Clear();
-                  fitter->DrawHere(thePad, fnSigmaForBkgEval);
-                  fMassFitters.push_back(fitter);
-                  mustDeleteFitter = kFALSE;
-                  for (auto format : fInvMassFitSaveAsFormats) {
-                    thePad->SaveAs(Form("FitOutput_%s_Trial%d.%s",hInvMassHisto->GetName(),globBin, format.c_str()));
-                  }
-                }
-              }
-              // else{
-              //   out=DoFitWithPol3Bkg(hRebinned,hmin,hmax,igs);
-              //   if(out && thePad){
-              // 	thePad->Clear();
-              // 	hRebinned->Draw();
-              // 	TF1* fSB=(TF1*)hRebinned->GetListOfFunctions()->FindObject("fSB");
-              // 	fB1=new TF1("fB1","[0]+[1]*x+[2]*x*x+[3]*x*x*x",hmin,hmax);
-              // 	for(Int_t j=0; j<4; j++) fB1->SetParameter(j,fSB->GetParameter(3+j));
-              // 	fB1->SetLineColor(2);
-              // 	fB1->Draw("same");
-              // 	fSB->SetLineColor(4);
-              // 	fSB->Draw("same");
-              // 	thePad->Update();
-              // 	chisq=fSB->GetChisquare()/fSB->GetNDF();;
-              // 	sigma=fSB->GetParameter(2);
-              // 	esigma=fSB->GetParError(2);
-              // 	if(esigma<0.00001) esigma=0.0001;
-              // 	pos=fSB->GetParameter(1);
-              // 	epos=fSB->GetParError(1);
-              // 	if(epos<0.00001) epos=0.0001;
-              // 	ry=fSB->GetParameter(0)/hRebinned->GetBinWidth(1);
-              // 	ery=fSB->GetParError(0)/hRebinned->GetBinWidth(1);
-              //   }
-              // }
-              xnt[7]=chisq;
-              if(out && chisq>0. && sigma>0.5*fSigmaGausMC && sigma<2.0*fSigmaGausMC){
-                xnt[8]=significance;
-                xnt[9]=pos;
-                xnt[10]=epos;
-                xnt[11]=sigma;
-                xnt[12]=esigma;
-                xnt[13]=ry;
-                xnt[14]=ery;
-                fHistoRawYieldDistAll->Fill(ry);
-                fHistoRawYieldTrialAll->SetBinContent(globBin,ry);
-                fHistoRawYieldTrialAll->SetBinError(globBin,ery);
-                fHistoSigmaTrialAll->SetBinContent(globBin,sigma);
-                fHistoSigmaTrialAll->SetBinError(globBin,esigma);
-                fHistoMeanTrialAll->SetBinContent(globBin,pos);
-                fHistoMeanTrialAll->SetBinError(globBin,epos);
-                fHistoChi2TrialAll->SetBinContent(globBin,chisq);
-                fHistoChi2TrialAll->SetBinError(globBin,0.00001);
-                fHistoSignifTrialAll->SetBinContent(globBin,significance);
-                fHistoSignifTrialAll->SetBinError(globBin,erSignif);
-                if(fSaveBkgVal) {
-                  fHistoBkgTrialAll->SetBinContent(globBin,bkg);
-                  fHistoBkgTrialAll->SetBinError(globBin,erbkg);
-                  fHistoBkgInBinEdgesTrialAll->SetBinContent(globBin,bkgBEdge);
-                  fHistoBkgInBinEdgesTrialAll->SetBinError(globBin,erbkgBEdge);
-                }
-
-                if(ry<fMinYieldGlob) fMinYieldGlob=ry;
-                if(ry>fMaxYieldGlob) fMaxYieldGlob=ry;
-                fHistoRawYieldDist[theCase]->Fill(ry);
-                fHistoRawYieldTrial[theCase]->SetBinContent(itrial,ry);
-                fHistoRawYieldTrial[theCase]->SetBinError(itrial,ery);
-                fHistoSigmaTrial[theCase]->SetBinContent(itrial,sigma);
-                fHistoSigmaTrial[theCase]->SetBinError(itrial,esigma);
-                fHistoMeanTrial[theCase]->SetBinContent(itrial,pos);
-                fHistoMeanTrial[theCase]->SetBinError(itrial,epos);
-                fHistoChi2Trial[theCase]->SetBinContent(itrial,chisq);
-                fHistoChi2Trial[theCase]->SetBinError(itrial,0.00001);
-                fHistoSignifTrial[theCase]->SetBinContent(itrial,significance);
-                fHistoSignifTrial[theCase]->SetBinError(itrial,erSignif);
-                if(fSaveBkgVal) {
-                  fHistoBkgTrial[theCase]->SetBinContent(itrial,bkg);
-                  fHistoBkgTrial[theCase]->SetBinError(itrial,erbkg);
-                  fHistoBkgInBinEdgesTrial[theCase]->SetBinContent(itrial,bkgBEdge);
-                  fHistoBkgInBinEdgesTrial[theCase]->SetBinError(itrial,erbkgBEdge);
-                }
-
-                for(Int_t iStepBC=0; iStepBC<fNumOfnSigmaBinCSteps; iStepBC++){
-                  Double_t minMassBC=fMassD-fnSigmaBinCSteps[iStepBC]*sigma;
-                  Double_t maxMassBC=fMassD+fnSigmaBinCSteps[iStepBC]*sigma;
-                  if(minMassBC>minMassForFit &&
-                      maxMassBC<maxMassForFit &&
-                      minMassBC>(hRebinned->GetXaxis()->GetXmin()) &&
-                      maxMassBC<(hRebinned->GetXaxis()->GetXmax())){
-                    Double_t cnts,ecnts;
-                    BinCount(hRebinned,fB1,1,minMassBC,maxMassBC,cnts,ecnts);
-                    ++itrialBC;
-                    fHistoRawYieldDistBinCAll->Fill(cnts);
-                    fHistoRawYieldTrialBinCAll->SetBinContent(globBin,iStepBC+1,cnts);
-                    fHistoRawYieldTrialBinCAll->SetBinError(globBin,iStepBC+1,ecnts);
-                    fHistoRawYieldTrialBinC[theCase]->SetBinContent(itrial,iStepBC+1,cnts);
-                    fHistoRawYieldTrialBinC[theCase]->SetBinError(itrial,iStepBC+1,ecnts);
-                    fHistoRawYieldDistBinC[theCase]->Fill(cnts);
-                  }
-                }
-              }
-              if (mustDeleteFitter) delete fitter;
-              fNtupleMultiTrials->Fill(xnt);
+              Double_t* res=&results[(size_t)index*nRes];
+              FitTrial(hInvMassHisto,hReb,fRebinSteps[ir],iFirstBin,fLowLimFitSteps[iMinMass],fUpLimFitSteps[iMaxMass],typeb,igs,warmStart,res,thePad,globBin);
+              if(fd>=0 && (!WriteAll(fd,&index,sizeof(Int_t)) || !WriteAll(fd,res,nRes*sizeof(Double_t)))) return;
             }
           }
         }
       }
-      delete hRebinned;
     }
   }
-  return kTRUE;
+}
+
+//________________________________________________________________________
+void AliHFMultiTrials::FitTrial(TH1D* hInvMassHisto, TH1F* hRebinned, Int_t rebin, Int_t iFirstBin, Double_t minMassForFit, Double_t maxMassForFit,
+                                Int_t typeb, Int_t igs, const Double_t* warmStart, Double_t* res, TPad* thePad, Int_t globBin){
+  // perform one fit and store its results in res
+
+  Int_t types=0;
+  Double_t hmin=TMath::Max(minMassForFit,hRebinned->GetBinLowEdge(2));
+  Double_t hmax=TMath::Min(maxMassForFit,hRebinned->GetBinLowEdge(hRebinned->GetNbinsX()));
+
+  Bool_t mustDeleteFitter = kTRUE;
+  AliHFMassFitterVAR*  fitter=0x0;
+  //if D0 Reflection
+  if(fhTemplRefl){
+    fitter=new AliHFMassFitterVAR(hRebinned,hmin,hmax,1,typeb,2);
+    fitter->SetTemplateReflections(fhTemplRefl);
+    fitter->SetFixReflOverS(fFixRefloS,kTRUE);
+  }
+  else {
+    if(typeb<=kPol2Bkg){
+      fitter=new AliHFMassFitterVAR(hRebinned,hmin, hmax,1,typeb,types);
+    }else if(typeb==kPowBkg){
+      fitter=new AliHFMassFitterVAR(hRebinned,hmin, hmax,1,4,types);
+    }else if(typeb==kPowTimesExpoBkg){
+      fitter=new AliHFMassFitterVAR(hRebinned,hmin, hmax,1,5,types);
+    }else{
+      fitter=new AliHFMassFitterVAR(hRebinned,hmin, hmax,1,6,types);
+      if(typeb==kPol3Bkg) fitter->SetBackHighPolDegree(3);
+      if(typeb==kPol4Bkg) fitter->SetBackHighPolDegree(4);
+      if(typeb==kPol5Bkg) fitter->SetBackHighPolDegree(5);
+    }
+    fitter->SetReflectionSigmaFactor(0);
+  }
+  if(fFitOption==0) {
+    fitter->SetUseLikelihoodFit();
+    Printf("Using likelihood fit");
+  }
+  else if(fFitOption==1) {
+    fitter->SetUseChi2Fit();
+    Printf("Using chi2 fit");
+  }
+  else if (fFitOption==2) {
+    fitter->SetUseLikelihoodWithWeightsFit();
+    Printf("Using likelihood fit with weights");
+  }
+  // the parameters fixed below are not affected by the warm start
+  fitter->SetInitialGaussianMean(warmStart ? warmStart[kResMean] : fMassD);
+  fitter->SetInitialGaussianSigma(warmStart ? warmStart[kResSigma] : fSigmaGausMC);
+  if(igs==kFixSigFreeMean){
+    fitter->SetFixGaussianSigma(fSigmaGausMC,kTRUE);
+  }else if(igs==kFixSigUpFreeMean){
+    fitter->SetFixGaussianSigma(fSigmaGausMC*(1.+fSigmaMCVariation),kTRUE);
+  }else if(igs==kFixSigDownFreeMean){
+    fitter->SetFixGaussianSigma(fSigmaGausMC*(1.-fSigmaMCVariation),kTRUE);
+  }else if(igs==kFixSigFixMean){
+    fitter->SetFixGaussianSigma(fSigmaGausMC,kTRUE);
+    fitter->SetFixGaussianMean(fMassD,kTRUE);
+  }else if(igs==kFreeSigFixMean){
+    fitter->SetFixGaussianMean(fMassD,kTRUE);
+  }
+  Bool_t out=kFALSE;
+  Double_t chisq=-1.;
+  Double_t sigma=0.;
+  Double_t esigma=0.;
+  Double_t pos=.0;
+  Double_t epos=.0;
+  Double_t ry=.0;
+  Double_t ery=.0;
+  Double_t significance=0.;
+  Double_t erSignif=0.;
+  Double_t bkg=0.;
+  Double_t erbkg=0.;
+  Double_t bkgBEdge=0;
+  Double_t erbkgBEdge=0;
+  TF1* fB1=0x0;
+  if(typeb<kNBkgFuncCases){
+    printf("****** START FIT OF HISTO %s WITH REBIN %d FIRST BIN %d MASS RANGE %f-%f BACKGROUND FIT FUNCTION=%d CONFIG SIGMA/MEAN=%d\n",hInvMassHisto->GetName(),rebin,iFirstBin,minMassForFit,maxMassForFit,typeb,igs);
+    out=fitter->MassFitter(0);
+    chisq=fitter->GetReducedChiSquare();
+    fitter->Significance(fnSigmaForBkgEval,significance,erSignif);
+    sigma=fitter->GetSigma();
+    pos=fitter->GetMean();
+    esigma=fitter->GetSigmaUncertainty();
+    if(esigma<0.00001) esigma=0.0001;
+    epos=fitter->GetMeanUncertainty();
+    if(epos<0.00001) epos=0.0001;
+    ry=fitter->GetRawYield();
+    ery=fitter->GetRawYieldError();
+    fB1=fitter->GetBackgroundFullRangeFunc();
+    fitter->Background(fnSigmaForBkgEval,bkg,erbkg);
+    Double_t minval = hInvMassHisto->GetXaxis()->GetBinLowEdge(hInvMassHisto->FindBin(pos-fnSigmaForBkgEval*sigma));
+    Double_t maxval = hInvMassHisto->GetXaxis()->GetBinUpEdge(hInvMassHisto->FindBin(pos+fnSigmaForBkgEval*sigma));
+    fitter->Background(minval,maxval,bkgBEdge,erbkgBEdge);
+    if(out && fDrawIndividualFits && thePad){
+      thePad->Clear();
+      fitter->DrawHere(thePad, fnSigmaForBkgEval);
+      fMassFitters.push_back(fitter);
+      mustDeleteFitter = kFALSE;
+      for (auto format : fInvMassFitSaveAsFormats) {
+        thePad->SaveAs(Form("FitOutput_%s_Trial%d.%s",hInvMassHisto->GetName(),globBin, format.c_str()));
+      }
+    }
+  }
+  res[kResOut]=out;
+  res[kResChi2]=chisq;
+  res[kResSignif]=significance;
+  res[kResErSignif]=erSignif;
+  res[kResMean]=pos;
+  res[kResErMean]=epos;
+  res[kResSigma]=sigma;
+  res[kResErSigma]=esigma;
+  res[kResRawY]=ry;
+  res[kResErRawY]=ery;
+  res[kResBkg]=bkg;
+  res[kResErBkg]=erbkg;
+  res[kResBkgBEdge]=bkgBEdge;
+  res[kResErBkgBEdge]=erbkgBEdge;
+  if(IsGoodFit(res,fSigmaGausMC)){
+    for(Int_t iStepBC=0; iStepBC<fNumOfnSigmaBinCSteps; iStepBC++){
+      Double_t minMassBC=fMassD-fnSigmaBinCSteps[iStepBC]*sigma;
+      Double_t maxMassBC=fMassD+fnSigmaBinCSteps[iStepBC]*sigma;
+      Double_t* resBC=&res[kNResValues+3*iStepBC];
+      if(minMassBC>minMassForFit &&
+          maxMassBC<maxMassForFit &&
+          minMassBC>(hRebinned->GetXaxis()->GetXmin()) &&
+          maxMassBC<(hRebinned->GetXaxis()->GetXmax())){
+        BinCount(hRebinned,fB1,1,minMassBC,maxMassBC,resBC[1],resBC[2]);
+        resBC[0]=1;
+      }
+    }
+  }
+  if (mustDeleteFitter) delete fitter;
+}
+
+//________________________________________________________________________
+void AliHFMultiTrials::FillTrial(Int_t rebin, Int_t iFirstBin, Double_t minMassForFit, Double_t maxMassForFit,
+                                 Int_t typeb, Int_t igs, Int_t itrial, const Double_t* res){
+  // fill histograms and ntuple with the results of one fit
+
+  Int_t totTrials=fNumOfRebinSteps*fNumOfFirstBinSteps*fNumOfLowLimFitSteps*fNumOfUpLimFitSteps;
+  Int_t theCase=igs*kNBkgFuncCases+typeb;
+  Int_t globBin=itrial+theCase*totTrials;
+  Float_t xnt[15];
+  for(Int_t j=0; j<15; j++) xnt[j]=0.;
+  xnt[0]=rebin;
+  xnt[1]=iFirstBin;
+  xnt[2]=minMassForFit;
+  xnt[3]=maxMassForFit;
+  xnt[4]=typeb;
+  xnt[6]=0;
+  if(igs==kFixSigFreeMean || igs==kFixSigFixMean) xnt[5]=1;
+  else if(igs==kFixSigUpFreeMean) xnt[5]=2;
+  else if(igs==kFixSigDownFreeMean) xnt[5]=3;
+  else xnt[5]=0;
+  if(igs==kFixSigFixMean || igs==kFreeSigFixMean) xnt[6]=1;
+
+  Double_t chisq=res[kResChi2];
+  Double_t sigma=res[kResSigma];
+  Double_t esigma=res[kResErSigma];
+  Double_t pos=res[kResMean];
+  Double_t epos=res[kResErMean];
+  Double_t ry=res[kResRawY];
+  Double_t ery=res[kResErRawY];
+  Double_t significance=res[kResSignif];
+  Double_t erSignif=res[kResErSignif];
+  Double_t bkg=res[kResBkg];
+  Double_t erbkg=res[kResErBkg];
+  Double_t bkgBEdge=res[kResBkgBEdge];
+  Double_t erbkgBEdge=res[kResErBkgBEdge];
+  xnt[7]=chisq;
+  if(IsGoodFit(res,fSigmaGausMC)){
+    xnt[8]=significance;
+    xnt[9]=pos;
+    xnt[10]=epos;
+    xnt[11]=sigma;
+    xnt[12]=esigma;
+    xnt[13]=ry;
+    xnt[14]=ery;
+    fHistoRawYieldDistAll->Fill(ry);
+    fHistoRawYieldTrialAll->SetBinContent(globBin,ry);
+    fHistoRawYieldTrialAll->SetBinError(globBin,ery);
+    fHistoSigmaTrialAll->SetBinContent(globBin,sigma);
+    fHistoSigmaTrialAll->SetBinError(globBin,esigma);
+    fHistoMeanTrialAll->SetBinContent(globBin,pos);
+    fHistoMeanTrialAll->SetBinError(globBin,epos);
+    fHistoChi2TrialAll->SetBinContent(globBin,chisq);
+    fHistoChi2TrialAll->SetBinError(globBin,0.00001);
+    fHistoSignifTrialAll->SetBinContent(globBin,significance);
+    fHistoSignifTrialAll->SetBinError(globBin,erSignif);
+    if(fSaveBkgVal) {
+      fHistoBkgTrialAll->SetBinContent(globBin,bkg);
+      fHistoBkgTrialAll->SetBinError(globBin,erbkg);
+      fHistoBkgInBinEdgesTrialAll->SetBinContent(globBin,bkgBEdge);
+      fHistoBkgInBinEdgesTrialAll->SetBinError(globBin,erbkgBEdge);
+    }
+
+    if(ry<fMinYieldGlob) fMinYieldGlob=ry;
+    if(ry>fMaxYieldGlob) fMaxYieldGlob=ry;
+    fHistoRawYieldDist[theCase]->Fill(ry);
+    fHistoRawYieldTrial[theCase]->SetBinContent(itrial,ry);
+    fHistoRawYieldTrial[theCase]->SetBinError(itrial,ery);
+    fHistoSigmaTrial[theCase]->SetBinContent(itrial,sigma);
+    fHistoSigmaTrial[theCase]->SetBinError(itrial,esigma);
+    fHistoMeanTrial[theCase]->SetBinContent(itrial,pos);
+    fHistoMeanTrial[theCase]->SetBinError(itrial,epos);
+    fHistoChi2Trial[theCase]->SetBinContent(itrial,chisq);
+    fHistoChi2Trial[theCase]->SetBinError(itrial,0.00001);
+    fHistoSignifTrial[theCase]->SetBinContent(itrial,significance);
+    fHistoSignifTrial[theCase]->SetBinError(itrial,erSignif);
+    if(fSaveBkgVal) {
+      fHistoBkgTrial[theCase]->SetBinContent(itrial,bkg);
+      fHistoBkgTrial[theCase]->SetBinError(itrial,erbkg);
+      fHistoBkgInBinEdgesTrial[theCase]->SetBinContent(itrial,bkgBEdge);
+      fHistoBkgInBinEdgesTrial[theCase]->SetBinError(itrial,erbkgBEdge);
+    }
+
+    for(Int_t iStepBC=0; iStepBC<fNumOfnSigmaBinCSteps; iStepBC++){
+      const Double_t* resBC=&res[kNResValues+3*iStepBC];
+      if(resBC[0]>0){
+        Double_t cnts=resBC[1];
+        Double_t ecnts=resBC[2];
+        fHistoRawYieldDistBinCAll->Fill(cnts);
+        fHistoRawYieldTrialBinCAll->SetBinContent(globBin,iStepBC+1,cnts);
+        fHistoRawYieldTrialBinCAll->SetBinError(globBin,iStepBC+1,ecnts);
+        fHistoRawYieldTrialBinC[theCase]->SetBinContent(itrial,iStepBC+1,cnts);
+        fHistoRawYieldTrialBinC[theCase]->SetBinError(itrial,iStepBC+1,ecnts);
+        fHistoRawYieldDistBinC[theCase]->Fill(cnts);
+      }
+    }
+  }
+  fNtupleMultiTrials->Fill(xnt);
 }
 
 //________________________________________________________________________
@@ -87,6 +87,13 @@ class AliHFMultiTrials : public TNamed {
 
   void SetDrawIndividualFits(Bool_t opt=kTRUE){fDrawIndividualFits=opt;}
 
+  /// distribute the fits over nw forked processes (each with its own minimizer),
+  /// the output does not depend on the number of workers
+  void SetNumOfWorkers(Int_t nw){fNumOfWorkers=nw>0 ? nw : 1;}
+  /// start mean and sigma of each fit from the fit with the nearest fit range
+  /// (same rebin, background and sigma/mean configuration), if it converged
+  void SetUseWarmStart(Bool_t opt=kTRUE){fUseWarmStart=opt;}
+
   Bool_t DoMultiTrials(TH1D* hInvMassHisto, TPad* thePad=0x0);
   void SaveToRoot(TString fileName, TString option="recreate") const;
   void DrawHistos(TCanvas* cry) const;
@@ -104,6 +111,14 @@ class AliHFMultiTrials : public TNamed {
  private:
 
   Bool_t CreateHistos();
+  Bool_t IsCaseUsed(Int_t typeb, Int_t igs) const;
+  Int_t TrialIndex(Int_t ir, Int_t iFirstBin, Int_t iMinMass, Int_t iMaxMass, Int_t typeb, Int_t igs) const;
+  void FitTrials(TH1D* hInvMassHisto, const std::vector<TH1F*>& hRebinned, Int_t worker, Int_t nWorkers,
+                 std::vector<Double_t>& results, Int_t fd, TPad* thePad);
+  void FitTrial(TH1D* hInvMassHisto, TH1F* hRebinned, Int_t rebin, Int_t iFirstBin, Double_t minMassForFit, Double_t maxMassForFit,
+                Int_t typeb, Int_t igs, const Double_t* warmStart, Double_t* res, TPad* thePad, Int_t globBin);
+  void FillTrial(Int_t rebin, Int_t iFirstBin, Double_t minMassForFit, Double_t maxMassForFit,
+                 Int_t typeb, Int_t igs, Int_t itrial, const Double_t* res);
   TH1F* RebinHisto(TH1D* hOrig, Int_t reb, Int_t firstUse) const;
   void BinCount(TH1F* h, TF1* fB, Int_t rebin, Double_t minMass, Double_t maxMass, Double_t& count, Double_t& ecount) const;
   Bool_t DoFitWithPol3Bkg(TH1F* histoToFit, Double_t  hmin, Double_t  hmax,
@@ -147,6 +162,8 @@ class AliHFMultiTrials : public TNamed {
   Bool_t fSaveBkgVal;		/// switch for saving bkg values in nsigma
 
   Bool_t fDrawIndividualFits; /// flag for drawing fits
+  Int_t fNumOfWorkers;        /// number of processes for the fits
+  Bool_t fUseWarmStart;       /// flag for starting the fits from the neighbour fit range
 
   TH1F* fHistoRawYieldDistAll;  /// histo with yield from all trials
   TH1F* fHistoRawYieldTrialAll; /// histo with yield from all trials
@@ -181,7 +198,7 @@ class AliHFMultiTrials : public TNamed {
   std::vector<AliHFMassFitterVAR*> fMassFitters; //!<! Mass fitters
 
   /// \cond CLASSIMP
-  ClassDef(AliHFMultiTrials,5); /// class for multiple trials of invariant mass fit
+  ClassDef(AliHFMultiTrials,6); /// class for multiple trials of invariant mass fit
   /// \endcond
 };
 
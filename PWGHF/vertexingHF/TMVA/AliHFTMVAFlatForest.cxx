@@ -0,0 +1,298 @@
+/**************************************************************************
+ * Copyright(c) 1998-2019, ALICE Experiment at CERN, All rights reserved. *
+ *                                                                        *
+ * Author: The ALICE Off-line Project.                                    *
+ * Contributors are mentioned in the code where appropriate.              *
+ *                                                                        *
+ * Permission to use, copy, modify and distribute this software and its   *
+ * documentation strictly for non-commercial purposes is hereby granted   *
+ * without fee, provided that the above copyright notice appears in all   *
+ * copies and that both the copyright notice and this permission notice   *
+ * appear in the supporting documentation. The authors make no claims     *
+ * about the suitability of this software for any purpose. It is          *
+ * provided "as is" without express or implied warranty.                  *
+ **************************************************************************/
+
+///////////////////////////////////////////////////////////////////////////
+// Class AliHFTMVAFlatForest
+//
+// Runtime reader of TMVA BDT weight files into a flat node array.
+// It reproduces the response of the ReadBDT_* classes generated with
+// MethodBase::MakeClass, without compiling the forest into the library.
+///////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include <TXMLEngine.h>
+#include <TSystem.h>
+
+#include "AliHFTMVAFlatForest.h"
+
+//_______________________________________________________________________
+AliHFTMVAFlatForest::AliHFTMVAFlatForest():
+  IClassifierReader(),
+  fNVars(0),
+  fIsGrad(kFALSE),
+  fUseYesNoLeaf(kTRUE),
+  fNorm(0.),
+  fNodes(),
+  fTreeOffsets(),
+  fBoostWeights(),
+  fVarExpressions(),
+  fFileName("")
+{
+  //
+  // Default constructor: empty forest, status is dirty until weights are loaded
+  //
+  fStatusIsClean = false;
+}
+
+//_______________________________________________________________________
+AliHFTMVAFlatForest::AliHFTMVAFlatForest(const char* xmlFile):
+  IClassifierReader(),
+  fNVars(0),
+  fIsGrad(kFALSE),
+  fUseYesNoLeaf(kTRUE),
+  fNorm(0.),
+  fNodes(),
+  fTreeOffsets(),
+  fBoostWeights(),
+  fVarExpressions(),
+  fFileName(xmlFile)
+{
+  //
+  // Standard constructor: load the forest from a TMVA .weights.xml file
+  //
+  fStatusIsClean = LoadWeights(xmlFile);
+}
+
+//_______________________________________________________________________
+AliHFTMVAFlatForest::AliHFTMVAFlatForest(const char* xmlFile, const std::vector<std::string>& theInputVars):
+  IClassifierReader(),
+  fNVars(0),
+  fIsGrad(kFALSE),
+  fUseYesNoLeaf(kTRUE),
+  fNorm(0.),
+  fNodes(),
+  fTreeOffsets(),
+  fBoostWeights(),
+  fVarExpressions(),
+  fFileName(xmlFile)
+{
+  //
+  // Constructor with the same input-variable validation as the generated classes
+  //
+  fStatusIsClean = LoadWeights(xmlFile);
+  if(fStatusIsClean) fStatusIsClean = CheckInputVariables(theInputVars);
+}
+
+//_______________________________________________________________________
+Bool_t AliHFTMVAFlatForest::LoadWeights(const char* xmlFile)
+{
+  //
+  // Parse the weights file and build the flat forest
+  //
+  fNodes.clear();
+  fTreeOffsets.clear();
+  fBoostWeights.clear();
+  fVarExpressions.clear();
+  fNVars = 0;
+  fNorm = 0.;
+  fFileName = xmlFile;
+
+  TString path(xmlFile);
+  gSystem->ExpandPathName(path);
+
+  TXMLEngine xml;
+  XMLDocPointer_t doc = xml.ParseFile(path.Data());
+  if(!doc){
+    std::cout << "AliHFTMVAFlatForest: cannot parse weights file " << path.Data() << std::endl;
+    return kFALSE;
+  }
+  XMLNodePointer_t methodSetup = xml.DocGetRootElement(doc);
+
+  Bool_t ok = kTRUE;
+  for(XMLNodePointer_t sec = xml.GetChild(methodSetup); sec && ok; sec = xml.GetNext(sec)){
+    TString secName = xml.GetNodeName(sec);
+    if(secName == "Options"){
+      for(XMLNodePointer_t opt = xml.GetChild(sec); opt; opt = xml.GetNext(opt)){
+        TString optName = xml.GetAttr(opt,"name");
+        TString optVal = xml.GetNodeContent(opt);
+        if(optName == "BoostType") fIsGrad = (optVal == "Grad");
+        else if(optName == "UseYesNoLeaf") fUseYesNoLeaf = (optVal == "True");
+      }
+    }
+    else if(secName == "Variables"){
+      for(XMLNodePointer_t var = xml.GetChild(sec); var; var = xml.GetNext(var)){
+        const char* expr = xml.GetAttr(var,"Expression");
+        fVarExpressions.push_back(expr ? expr : "");
+      }
+      fNVars = (Int_t)fVarExpressions.size();
+    }
+    else if(secName == "Transformations"){
+      if(xml.GetIntAttr(sec,"NTransformations") > 0){
+        std::cout << "AliHFTMVAFlatForest: variable transformations are not supported" << std::endl;
+        ok = kFALSE;
+      }
+    }
+    else if(secName == "Weights"){
+      Int_t nTrees = xml.GetIntAttr(sec,"NTrees");
+      if(nTrees > 0){
+        fTreeOffsets.reserve(nTrees);
+        fBoostWeights.reserve(nTrees);
+      }
+      for(XMLNodePointer_t tree = xml.GetChild(sec); tree && ok; tree = xml.GetNext(tree)){
+        if(TString(xml.GetNodeName(tree)) != "BinaryTree") continue;
+        XMLNodePointer_t rootNode = xml.GetChild(tree);
+        if(!rootNode){
+          ok = kFALSE;
+          break;
+        }
+        const char* bw = xml.GetAttr(tree,"boostWeight");
+        double boostWeight = bw ? std::atof(bw) : 1.;
+        fTreeOffsets.push_back((int)fNodes.size());
+        fBoostWeights.push_back(fIsGrad ? 1.f : (float)boostWeight);
+        fNorm += fIsGrad ? 1. : boostWeight;
+        ok = ReadNode(xml, rootNode);
+      }
+    }
+  }
+  xml.FreeDoc(doc);
+
+  if(ok && (fTreeOffsets.empty() || fNVars <= 0)){
+    std::cout << "AliHFTMVAFlatForest: no trees or variables found in " << path.Data() << std::endl;
+    ok = kFALSE;
+  }
+  return ok;
+}
+
+//_______________________________________________________________________
+Bool_t AliHFTMVAFlatForest::ReadNode(TXMLEngine& xml, void* node)
+{
+  //
+  // Append the node and its subtree in pre-order. The daughter reached
+  // for x <= cut is always stored right after its mother, the other one
+  // at fRight, so the cut type is resolved here and not at evaluation.
+  //
+  XMLNodePointer_t xnode = (XMLNodePointer_t)node;
+  XMLNodePointer_t left = 0;
+  XMLNodePointer_t right = 0;
+  for(XMLNodePointer_t ch = xml.GetChild(xnode); ch; ch = xml.GetNext(ch)){
+    if(TString(xml.GetNodeName(ch)) != "Node") continue;
+    TString pos = xml.GetAttr(ch,"pos");
+    if(pos == "l") left = ch;
+    else if(pos == "r") right = ch;
+  }
+
+  Int_t index = (Int_t)fNodes.size();
+  FlatNode flat;
+  flat.fCut = 0.f;
+  flat.fVar = -1;
+  flat.fRight = -1;
+  flat.fValue = 0.f;
+
+  if(!left || !right){
+    if(fIsGrad) flat.fValue = (float)std::atof(xml.GetAttr(xnode,"res"));
+    else if(fUseYesNoLeaf) flat.fValue = (float)xml.GetIntAttr(xnode,"nType");
+    else flat.fValue = (float)std::atof(xml.GetAttr(xnode,"purity"));
+    fNodes.push_back(flat);
+    return kTRUE;
+  }
+
+  flat.fVar = xml.GetIntAttr(xnode,"IVar");
+  // round the cut down to the closest float, so that x > cut gives the
+  // same answer for float inputs as the double comparison in TMVA
+  double cut = std::atof(xml.GetAttr(xnode,"Cut"));
+  flat.fCut = (float)cut;
+  if((double)flat.fCut > cut) flat.fCut = std::nextafter(flat.fCut, -HUGE_VALF);
+  if(flat.fVar < 0 || (fNVars > 0 && flat.fVar >= fNVars)) return kFALSE;
+  fNodes.push_back(flat);
+
+  // cType=1: x > cut goes to the "r" daughter; cType=0: the opposite
+  Bool_t cutType = xml.GetIntAttr(xnode,"cType") != 0;
+  XMLNodePointer_t below = cutType ? left : right;
+  XMLNodePointer_t above = cutType ? right : left;
+  if(!ReadNode(xml, below)) return kFALSE;
+  fNodes[index].fRight = (Int_t)fNodes.size();
+  return ReadNode(xml, above);
+}
+
+//_______________________________________________________________________
+Bool_t AliHFTMVAFlatForest::CheckInputVariables(const std::vector<std::string>& theInputVars)
+{
+  //
+  // Validate the input variable names against the weight file
+  //
+  if(theInputVars.size() != (size_t)fNVars){
+    std::cout << "AliHFTMVAFlatForest: mismatch in number of input values: "
+              << theInputVars.size() << " != " << fNVars << std::endl;
+    return kFALSE;
+  }
+  for(size_t ivar = 0; ivar < theInputVars.size(); ivar++){
+    if(theInputVars[ivar] != fVarExpressions[ivar]){
+      std::cout << "AliHFTMVAFlatForest: mismatch in input variable names for variable ["
+                << ivar << "]: " << theInputVars[ivar] << " != " << fVarExpressions[ivar] << std::endl;
+      return kFALSE;
+    }
+  }
+  return kTRUE;
+}
+
+//_______________________________________________________________________
+double AliHFTMVAFlatForest::GetMvaValue(const std::vector<double>& inputValues) const
+{
+  //
+  // Single-candidate response (IClassifierReader interface)
+  //
+  if(!IsStatusClean() || inputValues.size() < (size_t)fNVars){
+    std::cout << "AliHFTMVAFlatForest: cannot return classifier response because status is dirty" << std::endl;
+    return 0.;
+  }
+  std::vector<float> features(inputValues.begin(), inputValues.begin()+fNVars);
+  return Predict(features.data());
+}
+
+//_______________________________________________________________________
+void AliHFTMVAFlatForest::Predict(const float* features, size_t nCandidates, float* out) const
+{
+  //
+  // Batched response. Trees are the outer loop so that each tree stays
+  // in cache while all candidates of the batch are walked through it.
+  //
+  for(size_t ic = 0; ic < nCandidates; ic++) out[ic] = 0.f;
+  if(!IsStatusClean() || nCandidates == 0) return;
+
+  const FlatNode* nodes = fNodes.data();
+  const size_t nTrees = fTreeOffsets.size();
+  for(size_t itree = 0; itree < nTrees; itree++){
+    const FlatNode* root = nodes + fTreeOffsets[itree];
+    const float weight = fBoostWeights[itree];
+    const float* row = features;
+    for(size_t ic = 0; ic < nCandidates; ic++, row += fNVars){
+      const FlatNode* cur = root;
+      while(cur->fVar >= 0){
+        cur = (row[cur->fVar] > cur->fCut) ? nodes + cur->fRight : cur + 1;
+      }
+      out[ic] += weight * cur->fValue;
+    }
+  }
+
+  if(fIsGrad){
+    for(size_t ic = 0; ic < nCandidates; ic++) out[ic] = 2.f/(1.f+std::exp(-2.f*out[ic])) - 1.f;
+  }
+  else if(fNorm > 0.){
+    const float invNorm = (float)(1./fNorm);
+    for(size_t ic = 0; ic < nCandidates; ic++) out[ic] *= invNorm;
+  }
+}
+
+// Loadable with dlopen/dlsym in the same way as the ReadBDT_maker_* functions
+extern "C"
+{
+  IClassifierReader *AliHFTMVAFlatForest_maker(const char* xmlFile, std::vector<std::string>& theInpVar)
+  {
+    return new AliHFTMVAFlatForest(xmlFile, theInpVar);
+  }
+}
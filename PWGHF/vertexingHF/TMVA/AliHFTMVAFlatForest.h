@@ -0,0 +1,85 @@
+#ifndef ALIHFTMVAFLATFOREST_H
+#define ALIHFTMVAFLATFOREST_H
+/* Copyright(c) 1998-2019, ALICE Experiment at CERN, All rights reserved. *
+ * See cxx source for full Copyright notice                               */
+
+///*************************************************************************
+/// Class AliHFTMVAFlatForest
+///
+/// Reader for TMVA BDT .weights.xml files. The forest is stored as one
+/// contiguous array of nodes (pre-order, left daughter = next node), so
+/// the response is computed without virtual calls or per-call copies.
+/// Drop-in replacement of the generated ReadBDT_* classes via the
+/// IClassifierReader interface, plus a batched Predict() for candidates.
+///
+/// Author: vertexingHF team
+///*************************************************************************
+
+#include <vector>
+#include <string>
+#include <TString.h>
+
+#include "IClassifierReader.h"
+
+class TXMLEngine;
+
+class AliHFTMVAFlatForest : public IClassifierReader
+{
+ public:
+
+  /// flat node; for leaves fVar is -1 and fValue holds the leaf response
+  struct FlatNode {
+    float fCut;     ///< cut value (already oriented: x > cut goes right)
+    int   fVar;     ///< input variable index, -1 for leaves
+    int   fRight;   ///< index of the right daughter in the node array
+    float fValue;   ///< leaf response (nodeType, purity or regression res)
+  };
+
+  AliHFTMVAFlatForest();
+  AliHFTMVAFlatForest(const char* xmlFile);
+  AliHFTMVAFlatForest(const char* xmlFile, const std::vector<std::string>& theInputVars);
+  virtual ~AliHFTMVAFlatForest() {}
+
+  Bool_t LoadWeights(const char* xmlFile);
+  Bool_t CheckInputVariables(const std::vector<std::string>& theInputVars);
+
+  /// single-candidate response, same convention as the generated classes
+  virtual double GetMvaValue(const std::vector<double>& inputValues) const;
+
+  /// batched response: features is a row-major nCandidates x GetNVars() matrix
+  void Predict(const float* features, size_t nCandidates, float* out) const;
+  float Predict(const float* features) const;
+
+  Int_t GetNVars() const {return fNVars;}
+  Int_t GetNTrees() const {return (Int_t)fTreeOffsets.size();}
+  Int_t GetNNodes() const {return (Int_t)fNodes.size();}
+  const std::vector<std::string>& GetVarExpressions() const {return fVarExpressions;}
+  Bool_t IsGradBoost() const {return fIsGrad;}
+
+ private:
+
+  AliHFTMVAFlatForest(const AliHFTMVAFlatForest& source);
+  AliHFTMVAFlatForest& operator=(const AliHFTMVAFlatForest& source);
+
+  Bool_t ReadNode(TXMLEngine& xml, void* node);
+
+  Int_t                    fNVars;          ///< number of input variables
+  Bool_t                   fIsGrad;         ///< BoostType=Grad (regression-like leaves + sigmoid)
+  Bool_t                   fUseYesNoLeaf;   ///< AdaBoost: leaf value is nodeType instead of purity
+  double                   fNorm;           ///< sum of boost weights (AdaBoost normalisation)
+  std::vector<FlatNode>    fNodes;          ///< all nodes of all trees, contiguous
+  std::vector<int>         fTreeOffsets;    ///< index of the root node of each tree
+  std::vector<float>       fBoostWeights;   ///< boost weight of each tree (1 for Grad)
+  std::vector<std::string> fVarExpressions; ///< input variable expressions from the xml
+  TString                  fFileName;       ///< weights file the forest was built from
+};
+
+//_______________________________________________________________________
+inline float AliHFTMVAFlatForest::Predict(const float* features) const
+{
+  float out = 0.;
+  Predict(features, 1, &out);
+  return out;
+}
+
+#endif
@@ -12,6 +12,8 @@
 // Author: A. Pulvirenti
 // Developers: F. Bellini (fbellini@cern.ch)
 
+#include <algorithm>
+
 #include <Riostream.h>
 
 #include <TH1.h>
@@ -114,7 +116,10 @@ AliRsnMiniAnalysisTask::AliRsnMiniAnalysisTask() :
    fComputeSpherocity(kFALSE),
    fTrackFilter(0x0),
    fSpherocity(-10),
-   fResonanceFinders(0)
+   fResonanceFinders(0),
+   fMixInUserExec(kFALSE),
+   fMixPoolSize(0),
+   fMixPool()
 {
 //
 // Dummy constructor ALWAYS needed for I/O.
@@ -186,7 +191,10 @@ AliRsnMiniAnalysisTask::AliRsnMiniAnalysisTask(const char *name, Bool_t useMC,Bo
    fComputeSpherocity(kFALSE),
    fTrackFilter(0x0),
    fSpherocity(-10),
-   fResonanceFinders(0)
+   fResonanceFinders(0),
+   fMixInUserExec(kFALSE),
+   fMixPoolSize(0),
+   fMixPool()
 {
 //
 // Default constructor.
@@ -257,7 +265,10 @@ AliRsnMiniAnalysisTask::AliRsnMiniAnalysisTask(const AliRsnMiniAnalysisTask &cop
    fComputeSpherocity(copy.fComputeSpherocity),
    fTrackFilter(copy.fTrackFilter),
    fSpherocity(copy.fSpherocity),
-   fResonanceFinders(copy.fResonanceFinders)
+   fResonanceFinders(copy.fResonanceFinders),
+   fMixInUserExec(copy.fMixInUserExec),
+   fMixPoolSize(copy.fMixPoolSize),
+   fMixPool()
 {
 //
 // Copy constructor.
@@ -330,6 +341,8 @@ AliRsnMiniAnalysisTask &AliRsnMiniAnalysisTask::operator=(const AliRsnMiniAnalys
    fTrackFilter = copy.fTrackFilter;
    fSpherocity = copy.fSpherocity;
    fResonanceFinders = copy.fResonanceFinders;
+   fMixInUserExec = copy.fMixInUserExec;
+   fMixPoolSize = copy.fMixPoolSize;
 
    return (*this);
 }
@@ -347,6 +360,7 @@ AliRsnMiniAnalysisTask::~AliRsnMiniAnalysisTask()
       delete fOutput;
       delete fEvBuffer;
    }
+   ClearMixPool();
 }
 
 //__________________________________________________________________________________________________
@@ -560,6 +574,7 @@ void AliRsnMiniAnalysisTask::UserExec(Option_t *)
       AliDebugClass(2, Form("Adding event #%d with ID = %d", fEvNum, id));
       fMiniEvent->ID() = id;
       fEvBuffer->Fill();
+      if (fMixInUserExec) MixInUserExec();
    }
 
    // post data for computed stuff
@@ -601,10 +616,16 @@ void AliRsnMiniAnalysisTask::FinishTaskOutput()
    // using the appropriate procedure depending on its type
    // only mother-related histograms are filled in UserExec,
    // since they require direct access to MC event
+   // the mixing variables of all events are kept, so that the search
+   // for mixing partners does not need to read the buffer
+   std::vector<Double_t> evVz(nEvents), evMult(nEvents), evAngle(nEvents);
    timer.Start();
    for (ievt = 0; ievt < nEvents; ievt++) {
       // get next entry
       fEvBuffer->GetEntry(ievt);
+      evVz[ievt]    = fMiniEvent->Vz();
+      evMult[ievt]  = fMiniEvent->Mult();
+      evAngle[ievt] = fMiniEvent->Angle();
       if (printNum&&(ievt%printNum==0)) {
          AliInfo(Form("[%s] Std.Event %d/%d",GetName(), ievt,nEvents));
          timer.Stop(); timer.Print(); fflush(stdout); timer.Start(kFALSE);
@@ -647,20 +668,31 @@ void AliRsnMiniAnalysisTask::FinishTaskOutput()
       }
    }
 
-   // if no mixing is required, stop here and post the output
-   if (fNMix < 1) {
+   // if no mixing is required, or it was done already in UserExec, stop here and post the output
+   if (fNMix < 1 || fMixInUserExec) {
       AliDebugClass(2, "Stopping here, since no mixing is required");
+      ClearMixPool();
       PostData(1, fOutput);
       return;
    }
 
-   // initialize mixing counter
-   Int_t    nmatched[nEvents];
-   TString *smatched = new TString[nEvents];
-   for (ievt = 0; ievt < nEvents; ievt++) {
-      smatched[ievt] = "|";
-      nmatched[ievt] = 0;
+   // initialize mixing counter and list of matched events
+   std::vector<Int_t> nmatched(nEvents, 0);
+   std::vector< std::vector<Int_t> > matched(nEvents);
+
+   // index of the candidate partners:
+   // - binned mixing: events of each mixing bin, in increasing order
+   // - continuous mixing: events sorted in vz
+   std::map<MixBin_t, std::vector<Int_t> > binEvents;
+   std::vector< std::pair<Double_t, Int_t> > vzEvents;
+   if (fContinuousMix) {
+      vzEvents.reserve(nEvents);
+      for (ievt = 0; ievt < nEvents; ievt++) vzEvents.push_back(std::make_pair(evVz[ievt], ievt));
+      std::sort(vzEvents.begin(), vzEvents.end());
+   } else {
+      for (ievt = 0; ievt < nEvents; ievt++) binEvents[MixingBin(evVz[ievt], evMult[ievt], evAngle[ievt])].push_back(ievt);
    }
+   std::vector<Int_t> candidates;
 
 
    AliInfo(Form("[%s] Std.Event %d/%d",GetName(), nEvents,nEvents));
@@ -673,47 +705,57 @@ void AliRsnMiniAnalysisTask::FinishTaskOutput()
          timer.Stop(); timer.Print(); timer.Start(kFALSE); fflush(stdout);
       }
       if (nmatched[ievt] >= fNMix) continue;
-      fEvBuffer->GetEntry(ievt);
-      AliRsnMiniEvent evMain(*fMiniEvent);
-      for (iloop = 1; iloop < nEvents; iloop++) {
-         imix = ievt + iloop;
+      // collect the matching events, in the order ievt+1, ..., nEvents-1, 0, ..., ievt-1
+      candidates.clear();
+      if (fContinuousMix) {
+         // only events in the vz window can match, the window is slightly enlarged against rounding
+         Double_t vzMin = evVz[ievt] - fMaxDiffVz - 1E-9 * (1.0 + TMath::Abs(fMaxDiffVz));
+         std::vector< std::pair<Double_t, Int_t> >::const_iterator it = std::lower_bound(vzEvents.begin(), vzEvents.end(), std::make_pair(vzMin, -1));
+         for (; it != vzEvents.end(); ++it) {
+            imix = it->second;
+            if (it->first - evVz[ievt] > fMaxDiffVz + 1E-9 * (1.0 + TMath::Abs(fMaxDiffVz))) break;
+            if (imix == ievt) continue;
+            if (!EventsMatch(evVz[ievt], evMult[ievt], evAngle[ievt], evVz[imix], evMult[imix], evAngle[imix])) continue;
+            candidates.push_back(imix < ievt ? imix + nEvents : imix);
+         }
+         std::sort(candidates.begin(), candidates.end());
+      } else {
+         const std::vector<Int_t> &bin = binEvents[MixingBin(evVz[ievt], evMult[ievt], evAngle[ievt])];
+         std::vector<Int_t>::const_iterator first = std::upper_bound(bin.begin(), bin.end(), ievt);
+         candidates.insert(candidates.end(), first, bin.end());
+         for (std::vector<Int_t>::const_iterator it = bin.begin(); it != bin.end() && *it < ievt; ++it) candidates.push_back(*it);
+      }
+      for (iloop = 0; iloop < (Int_t)candidates.size(); iloop++) {
+         imix = candidates[iloop];
          if (imix >= nEvents) imix -= nEvents;
-         if (imix == ievt) continue;
-         // text next entry
-         fEvBuffer->GetEntry(imix);
-         // skip if events are not matched
-         if (!EventsMatch(&evMain, fMiniEvent)) continue;
          // check that the array of good matches for mixed does not already contain main event
-         if (smatched[imix].Contains(Form("|%d|", ievt))) continue;
+         if (std::find(matched[imix].begin(), matched[imix].end(), ievt) != matched[imix].end()) continue;
          // check that the found good events has not enough matches already
          if (nmatched[imix] >= fNMix) continue;
          // add new mixing candidate
-         smatched[ievt].Append(Form("%d|", imix));
+         matched[ievt].push_back(imix);
          nmatched[ievt]++;
          nmatched[imix]++;
          if (nmatched[ievt] >= fNMix) break;
       }
-      AliDebugClass(1, Form("Matches for event %5d = %d [%s] (missing are declared above)", evMain.ID(), nmatched[ievt], smatched[ievt].Data()));
+      AliDebugClass(1, Form("Matches for event %5d = %d (missing are declared above)", ievt, nmatched[ievt]));
    }
 
    AliInfo(Form("[%s] EventMixing searching %d/%d",GetName(),nEvents,nEvents));
    timer.Stop(); timer.Print(); fflush(stdout); timer.Start();
 
    // perform mixing
-   TObjArray *list = 0x0;
-   TObjString *os = 0x0;
    for (ievt = 0; ievt < nEvents; ievt++) {
       if (printNum&&(ievt%printNum==0)) {
          AliInfo(Form("[%s] EventMixing %d/%d",GetName(),ievt,nEvents));
          timer.Stop(); timer.Print(); timer.Start(kFALSE); fflush(stdout);
       }
       ifill = 0;
+      if (matched[ievt].empty()) continue;
       fEvBuffer->GetEntry(ievt);
       AliRsnMiniEvent evMain(*fMiniEvent);
-      list = smatched[ievt].Tokenize("|");
-      TObjArrayIter next(list);
-      while ( (os = (TObjString *)next()) ) {
-         imix = os->GetString().Atoi();
+      for (iloop = 0; iloop < (Int_t)matched[ievt].size(); iloop++) {
+         imix = matched[ievt][iloop];
          fEvBuffer->GetEntry(imix);
          for (idef = 0; idef < nDefs; idef++) {
             def = (AliRsnMiniOutput *)fHistograms[idef];
@@ -726,11 +768,8 @@ void AliRsnMiniAnalysisTask::FinishTaskOutput()
             }
          }
       }
-      delete list;
    }
 
-   delete [] smatched;
-
    AliInfo(Form("[%s] EventMixing %d/%d",GetName(),nEvents,nEvents));
    timer.Stop(); timer.Print(); fflush(stdout);
 
@@ -1677,38 +1716,98 @@ void AliRsnMiniAnalysisTask::SetDselection(UShort_t originDselection)
 Bool_t AliRsnMiniAnalysisTask::EventsMatch(AliRsnMiniEvent *event1, AliRsnMiniEvent *event2)
 {
    if (!event1 || !event2) return kFALSE;
-   Int_t ivz1, ivz2, imult1, imult2, iangle1, iangle2;
+   return EventsMatch(event1->Vz(), event1->Mult(), event1->Angle(), event2->Vz(), event2->Mult(), event2->Angle());
+}
+
+//__________________________________________________________________________________________________
+/// Same as above, from the mixing variables of the two events
+///
+Bool_t AliRsnMiniAnalysisTask::EventsMatch(Double_t vz1, Double_t mult1, Double_t angle1, Double_t vz2, Double_t mult2, Double_t angle2) const
+{
    Double_t dv, dm, da;
 
    if (fContinuousMix) {
-      dv = TMath::Abs(event1->Vz()    - event2->Vz()   );
-      dm = TMath::Abs(event1->Mult()  - event2->Mult() );
-      da = TMath::Abs(event1->Angle() - event2->Angle());
+      dv = TMath::Abs(vz1    - vz2   );
+      dm = TMath::Abs(mult1  - mult2 );
+      da = TMath::Abs(angle1 - angle2);
       if (dv > fMaxDiffVz) {
-         //AliDebugClass(2, Form("Events #%4d and #%4d don't match due to a too large diff in Vz = %f", event1->ID(), event2->ID(), dv));
+         //AliDebugClass(2, Form("Events don't match due to a too large diff in Vz = %f", dv));
          return kFALSE;
       }
       if (dm > fMaxDiffMult ) {
-         //AliDebugClass(2, Form("Events #%4d and #%4d don't match due to a too large diff in Mult = %f", event1->ID(), event2->ID(), dm));
+         //AliDebugClass(2, Form("Events don't match due to a too large diff in Mult = %f", dm));
          return kFALSE;
       }
       if (da > fMaxDiffAngle) {
-         //AliDebugClass(2, Form("Events #%4d and #%4d don't match due to a too large diff in Angle = %f", event1->ID(), event2->ID(), da));
+         //AliDebugClass(2, Form("Events don't match due to a too large diff in Angle = %f", da));
          return kFALSE;
       }
       return kTRUE;
    } else {
-      ivz1 = (Int_t)(event1->Vz() / fMaxDiffVz);
-      ivz2 = (Int_t)(event2->Vz() / fMaxDiffVz);
-      imult1 = (Int_t)(event1->Mult() / fMaxDiffMult);
-      imult2 = (Int_t)(event2->Mult() / fMaxDiffMult);
-      iangle1 = (Int_t)(event1->Angle() / fMaxDiffAngle);
-      iangle2 = (Int_t)(event2->Angle() / fMaxDiffAngle);
-      if (ivz1 != ivz2) return kFALSE;
-      if (imult1 != imult2) return kFALSE;
-      if (iangle1 != iangle2) return kFALSE;
-      return kTRUE;
+      return (MixingBin(vz1, mult1, angle1) == MixingBin(vz2, mult2, angle2));
+   }
+}
+
+//__________________________________________________________________________________________________
+/// Bin of an event in binned mixing.
+/// Two events are mixed if they fall in the same bin.
+///
+AliRsnMiniAnalysisTask::MixBin_t AliRsnMiniAnalysisTask::MixingBin(Double_t vz, Double_t mult, Double_t angle) const
+{
+   return MixBin_t((Int_t)(vz / fMaxDiffVz), (Int_t)(mult / fMaxDiffMult), (Int_t)(angle / fMaxDiffAngle));
+}
+
+//__________________________________________________________________________________________________
+/// Mix the current mini-event with the previous matching events kept in the pool,
+/// then add it to the pool. In binned mixing the pool is kept per mixing bin and
+/// holds at most fMixPoolSize events (fNMix if not set), the oldest being dropped;
+/// in continuous mixing one pool is used and searched from the most recent event.
+///
+void AliRsnMiniAnalysisTask::MixInUserExec()
+{
+   if (fNMix < 1) return;
+
+   MixBin_t bin = fContinuousMix ? MixBin_t(0, 0, 0) : MixingBin(fMiniEvent->Vz(), fMiniEvent->Mult(), fMiniEvent->Angle());
+   std::deque<AliRsnMiniEvent*> &pool = fMixPool[bin];
+
+   Int_t idef, nDefs = fHistograms.GetEntries(), nmix = 0, ifill = 0;
+   AliRsnMiniOutput *def = 0x0;
+   for (std::deque<AliRsnMiniEvent*>::reverse_iterator it = pool.rbegin(); it != pool.rend() && nmix < fNMix; ++it) {
+      AliRsnMiniEvent *evMix = *it;
+      if (fContinuousMix && !EventsMatch(fMiniEvent, evMix)) continue;
+      nmix++;
+      for (idef = 0; idef < nDefs; idef++) {
+         def = (AliRsnMiniOutput *)fHistograms[idef];
+         if (!def) continue;
+         if (!def->IsTrackPairMix()) continue;
+         ifill += def->FillPair(fMiniEvent, evMix, &fValues, kTRUE);
+         if (!def->IsSymmetric()) {
+            AliDebugClass(2, "Reflecting non symmetric pair");
+            ifill += def->FillPair(evMix, fMiniEvent, &fValues, kFALSE);
+         }
+      }
+   }
+   AliDebugClass(1, Form("Event %6d mixed with %d events -- fills = %5d", fMiniEvent->ID(), nmix, ifill));
+
+   // keep a copy of the current event for the next ones
+   Int_t poolSize = (fMixPoolSize > 0) ? fMixPoolSize : fNMix;
+   pool.push_back(new AliRsnMiniEvent(*fMiniEvent));
+   while ((Int_t)pool.size() > poolSize) {
+      delete pool.front();
+      pool.pop_front();
+   }
+}
+
+//__________________________________________________________________________________________________
+/// Delete the events kept for mixing in UserExec
+///
+void AliRsnMiniAnalysisTask::ClearMixPool()
+{
+   std::map<MixBin_t, std::deque<AliRsnMiniEvent*> >::iterator it;
+   for (it = fMixPool.begin(); it != fMixPool.end(); ++it) {
+      for (UInt_t i = 0; i < it->second.size(); i++) delete it->second[i];
    }
+   fMixPool.clear();
 }
 
 //---------------------------------------------------------------------
@@ -15,6 +15,11 @@
 #ifndef ALIRSNMINIANALYSISTASK_H
 #define ALIRSNMINIANALYSISTASK_H
 
+#include <deque>
+#include <map>
+#include <tuple>
+#include <vector>
+
 #include <TString.h>
 #include <TClonesArray.h>
 
@@ -66,6 +71,7 @@ public:
    void                SetMaxDiffMult (Double_t val)      {fMaxDiffMult  = val;}
    void                SetMaxDiffVz   (Double_t val)      {fMaxDiffVz    = val;}
    void                SetMaxDiffAngle(Double_t val)      {fMaxDiffAngle = val;}
+   void                SetMixInUserExec(Bool_t yn = kTRUE, Int_t poolSize = 0) {fMixInUserExec = yn; fMixPoolSize = poolSize;}
    void                SetUseBuiltinEventCuts(Bool_t use = kTRUE)   {fUseBuiltinEventCuts    = use;}
    void                SetUseTimeRangeCut(Bool_t use = kTRUE)   {fUseTimeRangeCut    = use;}
    void                SetEventCuts(AliRsnCutSet *cuts)   {fEventCuts    = cuts;}
@@ -120,6 +126,13 @@ private:
    void     FillTrueMotherAOD(AliRsnMiniEvent *event);
    void     StoreTrueMother(AliRsnMiniPair *pair, AliRsnMiniEvent *event);
    Bool_t   EventsMatch(AliRsnMiniEvent *event1, AliRsnMiniEvent *event2);
+   Bool_t   EventsMatch(Double_t vz1, Double_t mult1, Double_t angle1, Double_t vz2, Double_t mult2, Double_t angle2) const;
+   void     MixInUserExec();
+   void     ClearMixPool();
+
+   /// mixing bin of an event in binned mixing: (vz, multiplicity, angle) bin numbers
+   typedef std::tuple<Int_t, Int_t, Int_t> MixBin_t;
+   MixBin_t MixingBin(Double_t vz, Double_t mult, Double_t angle) const;
    AliQnCorrectionsQnVector * GetQnVectorFromList(const TList *list, const char *subdetector, const char *expectedstep) const;
 
    Bool_t               fUseMC;           ///<  use or not MC info
@@ -181,9 +194,12 @@ private:
    AliAnalysisFilter   *fTrackFilter;       //!<! track filter for spherocity estimator 
    Double_t             fSpherocity;        ///< stores value of spherocity
    TObjArray            fResonanceFinders;  ///< list of AliRsnMiniResonanceFinder objects
+   Bool_t               fMixInUserExec;     ///<  mixing --> mix each event in UserExec with the previous matching events, instead of at the end
+   Int_t                fMixPoolSize;       ///<  mixing --> number of events kept per mixing bin when mixing in UserExec (if <= 0, fNMix)
+   std::map<MixBin_t, std::deque<AliRsnMiniEvent*> > fMixPool; //!<! previous events per mixing bin when mixing in UserExec
 
 /// \cond CLASSIMP
-   ClassDef(AliRsnMiniAnalysisTask, 22);     
+   ClassDef(AliRsnMiniAnalysisTask, 23);     
 /// \endcond
 };
 
@@ -27,10 +27,30 @@
 #include "TRandom3.h"
 #include "AliESDEvent.h"
 #include "AliESDcascade.h"
+#include <vector>
 #include "AliCascadeVertexerUncheckedCharges.h"
 
 ClassImp(AliCascadeVertexerUncheckedCharges)
 
+namespace {
+    //Position, momentum and frame of a bachelor candidate, computed once per event
+    struct BachelorCache {
+        Int_t fIndex;     //track index in the event
+        Double_t fR[3];   //position
+        Double_t fP[3];   //momentum
+        Double_t fCos;    //cos and sin of the track frame
+        Double_t fSin;
+    };
+    
+    void FillBachelorCache(BachelorCache &c, Int_t idx, const AliESDtrack *t) {
+        c.fIndex = idx;
+        t->GetXYZ(c.fR);
+        t->GetPxPyPz(c.fP);
+        c.fCos = TMath::Cos(t->GetAlpha());
+        c.fSin = TMath::Sin(t->GetAlpha());
+    }
+}
+
 //A set of loose cuts
 Double_t
 AliCascadeVertexerUncheckedCharges::fgChi2max=33.;   //maximal allowed chi2
@@ -95,9 +115,10 @@ Int_t AliCascadeVertexerUncheckedCharges::V0sTracks2CascadeVertices(AliESDEvent
     Info("V0sTracks2CascadeVertices","Number of like-sign V0s used: %d",lNumberOfLikeSignV0s);
     nV0=vtcs.GetEntriesFast();
     
-    // stores relevant tracks in another array
+    // stores relevant tracks in a scratch buffer
     Int_t nentr=(Int_t)event->GetNumberOfTracks();
-    TArrayI trk(nentr); Int_t ntr=0;
+    std::vector<BachelorCache> trk;
+    trk.reserve(nentr);
     for (i=0; i<nentr; i++) {
         AliESDtrack *esdtr=event->GetTrack(i);
         
@@ -111,8 +132,14 @@ Int_t AliCascadeVertexerUncheckedCharges::V0sTracks2CascadeVertices(AliESDEvent
         
         if (TMath::Abs(esdtr->GetD(xPrimaryVertex,yPrimaryVertex,b))<fDBachMin) continue;
         
-        trk[ntr++]=i;
+        //eta cut (the propagation to the V0 does not change eta)
+        if (TMath::Abs(esdtr->Eta())>fMaxEta) continue;
+        
+        BachelorCache c;
+        FillBachelorCache(c,i,esdtr);
+        trk.push_back(c);
     }
+    Int_t ntr=trk.size();
     
     Double_t massLambda=1.11568;
     Int_t ncasc=0;
@@ -137,24 +164,31 @@ Int_t AliCascadeVertexerUncheckedCharges::V0sTracks2CascadeVertices(AliESDEvent
         if (TMath::Abs(lMassAsLambda-massLambda)>fMassWin &&
             TMath::Abs(lMassAsAntiLambda-massLambda)>fMassWin) continue;
         
+        Double_t rV0[3], pV0[3];
+        v0.GetXYZ(rV0[0],rV0[1],rV0[2]);
+        v0.GetPxPyPz(pV0[0],pV0[1],pV0[2]);
+        
         for (Int_t j=0; j<ntr; j++) {//loop on tracks
-            Int_t bidx=trk[j];
+            Int_t bidx=trk[j].fIndex;
             //Check if different tracks are used all times
             if (bidx==v0.GetIndex(0)) continue; //Bo:  consistency 0 for neg
             if (bidx==v0.GetIndex(1)) continue; //Bo:  consistency 0 for neg
             if (v0.GetIndex(0)==v0.GetIndex(1)) continue; //Bo:  consistency 0 for neg
             
-            AliESDtrack *btrk=event->GetTrack(bidx);
-            
             //Do not check charges!
-            AliESDv0 *pv0=&v0;
-            AliExternalTrackParam bt(*btrk), *pbt=&bt;
-            
-            Double_t dca=PropagateToDCA(pv0,pbt,b);
+            //DCA from the cached track, the track is copied and propagated
+            //only if it passes the cut (same as PropagateToDCA)
+            Double_t t1, dca=GetStraightLineDCA(trk[j].fR,trk[j].fP,rV0,pV0,t1);
             if (dca > fDCAmax) continue;
             
-            //eta cut - test
-            if (TMath::Abs(pbt->Eta())>fMaxEta) continue;
+            AliESDtrack *btrk=event->GetTrack(bidx);
+            AliESDv0 *pv0=&v0;
+            AliExternalTrackParam bt(*btrk), *pbt=&bt;
+            Double_t xb=trk[j].fR[0] + trk[j].fP[0]*t1, yb=trk[j].fR[1] + trk[j].fP[1]*t1;
+            if (!pbt->PropagateTo(xb*trk[j].fCos + yb*trk[j].fSin,b)) {
+                Error("PropagateToDCA","Propagation failed !");
+                continue;
+            }
             
             AliESDcascade cascade(*pv0,*pbt,bidx);//constucts a cascade candidate
             
@@ -200,23 +234,16 @@ Double_t AliCascadeVertexerUncheckedCharges::Det(Double_t a00,Double_t a01,Doubl
     return  a00*Det(a11,a12,a21,a22)-a01*Det(a10,a12,a20,a22)+a02*Det(a10,a11,a20,a21);
 }
 
-Double_t AliCascadeVertexerUncheckedCharges::PropagateToDCA(AliESDv0 *v, AliExternalTrackParam *t, Double_t b) {
+Double_t AliCascadeVertexerUncheckedCharges::GetStraightLineDCA(const Double_t r1[3], const Double_t p1[3],
+                                                                const Double_t r2[3], const Double_t p2[3], Double_t &t1) const {
     //--------------------------------------------------------------------
-    // This function returns the DCA between the V0 and the track
+    // This function returns the DCA between the straight lines (r1,p1) and
+    // (r2,p2), t1 is the parameter of the point of the first line
     //--------------------------------------------------------------------
-    Double_t alpha=t->GetAlpha(), cs1=TMath::Cos(alpha), sn1=TMath::Sin(alpha);
-    Double_t r[3]; t->GetXYZ(r);
-    Double_t x1=r[0], y1=r[1], z1=r[2];
-    Double_t p[3]; t->GetPxPyPz(p);
-    Double_t px1=p[0], py1=p[1], pz1=p[2];
-    
-    Double_t x2,y2,z2;     // position and momentum of V0
-    Double_t px2,py2,pz2;
-    
-    v->GetXYZ(x2,y2,z2);
-    v->GetPxPyPz(px2,py2,pz2);
-    
-    // calculation dca
+    Double_t x1=r1[0], y1=r1[1], z1=r1[2];
+    Double_t px1=p1[0], py1=p1[1], pz1=p1[2];
+    Double_t x2=r2[0], y2=r2[1], z2=r2[2];
+    Double_t px2=p2[0], py2=p2[1], pz2=p2[2];
     
     Double_t dd= Det(x2-x1,y2-y1,z2-z1,px1,py1,pz1,px2,py2,pz2);
     Double_t ax= Det(py1,pz1,py2,pz2);
@@ -225,15 +252,28 @@ Double_t AliCascadeVertexerUncheckedCharges::PropagateToDCA(AliESDv0 *v, AliExte
     
     Double_t dca=TMath::Abs(dd)/TMath::Sqrt(ax*ax + ay*ay + az*az);
     
-    //points of the DCA
-    Double_t t1 = Det(x2-x1,y2-y1,z2-z1,px2,py2,pz2,ax,ay,az)/
-    Det(px1,py1,pz1,px2,py2,pz2,ax,ay,az);
+    t1 = Det(x2-x1,y2-y1,z2-z1,px2,py2,pz2,ax,ay,az)/
+         Det(px1,py1,pz1,px2,py2,pz2,ax,ay,az);
     
-    x1 += px1*t1; y1 += py1*t1; //z1 += pz1*t1;
+    return dca;
+}
+
+Double_t AliCascadeVertexerUncheckedCharges::PropagateToDCA(AliESDv0 *v, AliExternalTrackParam *t, Double_t b) {
+    //--------------------------------------------------------------------
+    // This function returns the DCA between the V0 and the track
+    //--------------------------------------------------------------------
+    Double_t alpha=t->GetAlpha(), cs1=TMath::Cos(alpha), sn1=TMath::Sin(alpha);
+    Double_t r1[3]; t->GetXYZ(r1);
+    Double_t p1[3]; t->GetPxPyPz(p1);
     
+    Double_t r2[3], p2[3]; // position and momentum of V0
+    v->GetXYZ(r2[0],r2[1],r2[2]);
+    v->GetPxPyPz(p2[0],p2[1],p2[2]);
     
-    //propagate track to the points of DCA
+    Double_t t1, dca=GetStraightLineDCA(r1,p1,r2,p2,t1);
     
+    //propagate track to the points of DCA
+    Double_t x1=r1[0] + p1[0]*t1, y1=r1[1] + p1[1]*t1;
     x1=x1*cs1 + y1*sn1;
     if (!t->PropagateTo(x1,b)) {
         Error("PropagateToDCA","Propagation failed !");
@@ -0,0 +1,59 @@
+#ifndef AliLightV0DaughterCache_H
+#define AliLightV0DaughterCache_H
+/* Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. *
+ * See cxx source for full Copyright notice                               */
+
+//------------------------------------------------------------------
+//        Per-track quantities of the V0 daughter candidates,
+//   computed once per event by the light V0 vertexers. They are
+//     used to reject pairs before the helix-helix DCA (GetDCA)
+//------------------------------------------------------------------
+
+#include "TMath.h"
+#include "AliESDtrack.h"
+
+//_____________________________________________________________________________
+struct AliLightV0DaughterCache {
+    Int_t fIndex;     //track index in the event
+    Double_t fD;      //|impact parameter| in the transverse plane
+    Double_t fXc;     //center and radius of the track circle in the
+    Double_t fYc;     //transverse plane, fR<0 for straight tracks
+    Double_t fR;
+    Double_t fSigmaY2; //covariances used by GetDCA to weight the distance
+    Double_t fSigmaZ2;
+
+    void Fill(Int_t idx, const AliESDtrack *t, Double_t d, Double_t b) {
+        fIndex = idx;
+        fD = TMath::Abs(d);
+        fSigmaY2 = t->GetSigmaY2();
+        fSigmaZ2 = t->GetSigmaZ2();
+        fR = -1.;
+        Double_t h[6];
+        t->GetHelixParameters(h,b);
+        if (TMath::Abs(h[4]) < 1e-4) return; //no check for R>100 m
+        fXc = h[5] - TMath::Sin(h[2])/h[4];
+        fYc = h[0] + TMath::Cos(h[2])/h[4];
+        fR = 1./TMath::Abs(h[4]);
+    }
+
+    //Lower bound of the DCA returned by AliExternalTrackParam::GetDCA.
+    //GetDCA returns sqrt(dm*sqrt(dy2*dz2)), where dm is the squared distance
+    //of the two helices weighted by 1/dy2 in the transverse plane and by 1/dz2
+    //along z (dy2, dz2: sums of the SigmaY2, SigmaZ2 of the two tracks). The
+    //transverse distance of two points on the helices is at least the distance
+    //between the track circles, so the DCA is at least the circle distance
+    //scaled by (dz2/dy2)^(1/4)
+    static Double_t GetDCALowerBound(const AliLightV0DaughterCache &c1, const AliLightV0DaughterCache &c2) {
+        if (c1.fR < 0 || c2.fR < 0) return 0.;
+        Double_t dy2 = c1.fSigmaY2 + c2.fSigmaY2, dz2 = c1.fSigmaZ2 + c2.fSigmaZ2;
+        if (!(dy2 > 0.) || !(dz2 > 0.)) return 0.;
+        Double_t dx = c1.fXc - c2.fXc, dy = c1.fYc - c2.fYc;
+        Double_t dc = TMath::Sqrt(dx*dx + dy*dy), dist = 0.;
+        Double_t dr = TMath::Abs(c1.fR - c2.fR);
+        if (dc > c1.fR + c2.fR) dist = dc - c1.fR - c2.fR;
+        else if (dc < dr) dist = dr - dc;
+        return dist*TMath::Sqrt(TMath::Sqrt(dz2/dy2));
+    }
+};
+
+#endif
@@ -27,6 +27,8 @@
 
 #include "AliESDEvent.h"
 #include "AliESDv0.h"
+#include <vector>
+#include "AliLightV0DaughterCache.h"
 #include "AliLightV0vertexer.h"
 
 ClassImp(AliLightV0vertexer)
@@ -60,8 +62,9 @@ Int_t AliLightV0vertexer::Tracks2V0vertices(AliESDEvent *event) {
     
     if (nentr<2) return 0;
     
-    TArrayI neg(nentr);
-    TArrayI pos(nentr);
+    //Scratch buffers of the selected tracks
+    std::vector<AliLightV0DaughterCache> neg, pos;
+    neg.reserve(nentr); pos.reserve(nentr);
     
     Int_t nneg=0, npos=0, nvtx=0;
     
@@ -80,24 +83,31 @@ Int_t AliLightV0vertexer::Tracks2V0vertices(AliESDEvent *event) {
         if (TMath::Abs(d)<fDPmin) continue;
         if (TMath::Abs(d)>fRmax) continue;
         
-        if (esdTrack->GetSign() < 0.) neg[nneg++]=i;
-        else pos[npos++]=i;
+        //select maximum eta range (the propagation to the V0 does not change eta)
+        if (TMath::Abs(esdTrack->Eta())>fMaxEta) continue;
+        
+        AliLightV0DaughterCache c;
+        c.Fill(i,esdTrack,d,b);
+        if (esdTrack->GetSign() < 0.) neg.push_back(c);
+        else pos.push_back(c);
     }
+    nneg=neg.size(); npos=pos.size();
     
     
     for (i=0; i<nneg; i++) {
-        Int_t nidx=neg[i];
+        Int_t nidx=neg[i].fIndex;
         AliESDtrack *ntrk=event->GetTrack(nidx);
         
         for (Int_t k=0; k<npos; k++) {
-            Int_t pidx=pos[k];
-            AliESDtrack *ptrk=event->GetTrack(pidx);
+            Int_t pidx=pos[k].fIndex;
             
-            //Track pre-selection: clusters
-            if (ptrk->GetTPCNcls() < fMinClusters ) continue;
+            if (neg[i].fD<fDNmin)
+                if (pos[k].fD<fDNmin) continue;
             
-            if (TMath::Abs(ntrk->GetD(xPrimaryVertex,yPrimaryVertex,b))<fDNmin)
-                if (TMath::Abs(ptrk->GetD(xPrimaryVertex,yPrimaryVertex,b))<fDNmin) continue;
+            //geometric pre-check before the helix-helix DCA
+            if (AliLightV0DaughterCache::GetDCALowerBound(neg[i],pos[k]) > fDCAmax + 1e-4) continue;
+            
+            AliESDtrack *ptrk=event->GetTrack(pidx);
             
             Double_t xn, xp, dca=ntrk->GetDCA(ptrk,b,xn,xp);
             if (dca > fDCAmax) continue;
@@ -123,10 +133,6 @@ Int_t AliLightV0vertexer::Tracks2V0vertices(AliESDEvent *event) {
             
             nt.PropagateTo(xn,b); pt.PropagateTo(xp,b);
             
-            //select maximum eta range (after propagation)
-            if (TMath::Abs(nt.Eta())>fMaxEta) continue;
-            if (TMath::Abs(pt.Eta())>fMaxEta) continue;
-            
             AliESDv0 vertex(nt,nidx,pt,pidx);
             
             //Experimental: refit V0 if asked to do so 
@@ -30,6 +30,8 @@
 
 #include "AliESDEvent.h"
 #include "AliESDv0.h"
+#include <vector>
+#include "AliLightV0DaughterCache.h"
 #include "AliV0vertexerUncheckedCharges.h"
 
 ClassImp(AliV0vertexerUncheckedCharges)
@@ -63,7 +65,9 @@ Int_t AliV0vertexerUncheckedCharges::Tracks2V0vertices(AliESDEvent *event) {
     
     if (nentr<2) return 0;
     
-    TArrayI trackarray(nentr);
+    //Scratch buffer of the selected tracks
+    std::vector<AliLightV0DaughterCache> trackarray;
+    trackarray.reserve(nentr);
     
     Int_t ntracks=0, nvtx=0;
     
@@ -82,26 +86,35 @@ Int_t AliV0vertexerUncheckedCharges::Tracks2V0vertices(AliESDEvent *event) {
         if (TMath::Abs(d)<fDPmin) continue;
         if (TMath::Abs(d)>fRmax) continue;
         
+        //select maximum eta range (the propagation to the V0 does not change eta)
+        if (TMath::Abs(esdTrack->Eta())>fMaxEta) continue;
+        
         //Disregard charges
-        trackarray[ntracks++]=i;
+        AliLightV0DaughterCache c;
+        c.Fill(i,esdTrack,d,b);
+        trackarray.push_back(c);
     }
+    ntracks=trackarray.size();
     
     
     for (i=0; i<ntracks; i++) {
         //originally: negative (now track 1)
-        Int_t  idx1=trackarray[i];
+        Int_t  idx1=trackarray[i].fIndex;
         AliESDtrack *trk1=event->GetTrack(idx1);
         
         for (Int_t k=0; k<ntracks; k++) {
             if( i==k ) continue; //don't combine a track with itself, please
             
             //originally: positive (now track 2) 
-            Int_t idx2=trackarray[k];
-            AliESDtrack *trk2=event->GetTrack(idx2);
+            Int_t idx2=trackarray[k].fIndex;
             
+            if (trackarray[i].fD<fDNmin)
+                if (trackarray[k].fD<fDNmin) continue;
             
-            if (TMath::Abs(trk1->GetD(xPrimaryVertex,yPrimaryVertex,b))<fDNmin)
-                if (TMath::Abs(trk2->GetD(xPrimaryVertex,yPrimaryVertex,b))<fDNmin) continue;
+            //geometric pre-check before the helix-helix DCA
+            if (AliLightV0DaughterCache::GetDCALowerBound(trackarray[i],trackarray[k]) > fDCAmax + 1e-4) continue;
+            
+            AliESDtrack *trk2=event->GetTrack(idx2);
             
             Double_t xn, xp, dca=trk1->GetDCA(trk2,b,xn,xp);
             if (dca > fDCAmax) continue;
@@ -127,10 +140,6 @@ Int_t AliV0vertexerUncheckedCharges::Tracks2V0vertices(AliESDEvent *event) {
             
             t1.PropagateTo(xn,b); t2.PropagateTo(xp,b);
             
-            //select maximum eta range (after propagation)
-            if (TMath::Abs(t1.Eta())>fMaxEta) continue;
-            if (TMath::Abs(t2.Eta())>fMaxEta) continue;
-            
             AliESDv0 vertex(t1,idx1,t2,idx2);
             
             //Experimental: refit V0 if asked to do so 
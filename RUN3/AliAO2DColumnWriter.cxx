@@ -0,0 +1,885 @@
+/**************************************************************************
+ * Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. *
+ *                                                                        *
+ * Author: The ALICE Off-line Project.                                    *
+ * Contributors are mentioned in the code where appropriate.              *
+ *                                                                        *
+ * Permission to use, copy, modify and distribute this software and its   *
+ * documentation strictly for non-commercial purposes is hereby granted   *
+ * without fee, provided that the above copyright notice appears in all   *
+ * copies and that both the copyright notice and this permission notice   *
+ * appear in the supporting documentation. The authors make no claims     *
+ * about the suitability of this software for any purpose. It is          *
+ * provided "as is" without express or implied warranty.                  *
+ **************************************************************************/
+
+/* AliAO2DColumnWriter
+ *
+ * Column buffers for the column output backend of AliAnalysisTaskAO2Dconverter.
+ *
+ * The Arrow output follows the Arrow IPC file format (Arrow columnar format
+ * version 1.0, metadata V5): the schema and one record batch per flush are
+ * written as encapsulated flatbuffer messages, without compression. The
+ * flatbuffers are built by the small builder below, so no Arrow library is
+ * needed. The files can be read e.g. with pyarrow.ipc.open_file().
+ *
+ * At each flush the buffered rows are filled into the trees on the calling
+ * thread, so the baskets are compressed by ROOT as with TTree::Fill. Only the
+ * Arrow files are written by worker threads.
+ */
+
+#include "AliAO2DColumnWriter.h"
+
+#include <TBranch.h>
+#include <TChain.h>
+#include <TDirectory.h>
+#include <TLeaf.h>
+#include <TList.h>
+#include <TNamed.h>
+#include <TObjArray.h>
+#include <TTree.h>
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+
+// Minimal flatbuffer builder. As in the reference implementation the buffer
+// is filled from the back; offsets are counted from the end of the buffer.
+class FlatBuilder
+{
+public:
+  FlatBuilder() : fBuf(1024), fHead(1024) {}
+
+  UInt_t GetSize() const { return fBuf.size() - fHead; }
+
+  template <typename T>
+  void Push(T value)
+  {
+    Prep(sizeof(T), 0);
+    PushBytes(&value, sizeof(T));
+  }
+
+  void PushOffset(UInt_t off)
+  {
+    Prep(4, 0);
+    Push<UInt_t>(GetSize() - off + 4);
+  }
+
+  UInt_t CreateString(const char *s)
+  {
+    const size_t len = strlen(s);
+    Prep(4, len + 1);
+    Pad(1);
+    PushBytes(s, len);
+    Push<UInt_t>(len);
+    return GetSize();
+  }
+
+  UInt_t CreateOffsetVector(const std::vector<UInt_t> &offsets)
+  {
+    Prep(4, 4 * offsets.size());
+    for (size_t i = offsets.size(); i > 0; i--)
+      PushOffset(offsets[i - 1]);
+    Push<UInt_t>(offsets.size());
+    return GetSize();
+  }
+
+  UInt_t CreateStructVector(const void *data, size_t n, size_t size)
+  {
+    Prep(4, n * size);
+    Prep(8, n * size);
+    PushBytes(data, n * size);
+    Push<UInt_t>(n);
+    return GetSize();
+  }
+
+  void StartTable()
+  {
+    fFields.clear();
+    fTableStart = GetSize();
+  }
+
+  template <typename T>
+  void AddScalar(Int_t slot, T value)
+  {
+    Push(value);
+    fFields.push_back(std::make_pair(slot, GetSize()));
+  }
+
+  void AddOffset(Int_t slot, UInt_t off)
+  {
+    PushOffset(off);
+    fFields.push_back(std::make_pair(slot, GetSize()));
+  }
+
+  UInt_t EndTable()
+  {
+    Push<Int_t>(0); // Placeholder of the offset to the vtable
+    const UInt_t table = GetSize();
+    Int_t nslots = 0;
+    for (const auto &f : fFields)
+      nslots = std::max(nslots, f.first + 1);
+    std::vector<UShort_t> vtable(nslots, 0);
+    for (const auto &f : fFields)
+      vtable[f.first] = table - f.second;
+    for (Int_t i = nslots - 1; i >= 0; i--)
+      Push<UShort_t>(vtable[i]);
+    Push<UShort_t>(table - fTableStart);
+    Push<UShort_t>(4 + 2 * nslots);
+    const Int_t soffset = GetSize() - table;
+    memcpy(&fBuf[fBuf.size() - table], &soffset, 4);
+    return table;
+  }
+
+  std::vector<unsigned char> Finish(UInt_t root)
+  {
+    Prep(8, 4);
+    PushOffset(root);
+    return std::vector<unsigned char>(fBuf.begin() + fHead, fBuf.end());
+  }
+
+private:
+  void Grow(size_t n)
+  {
+    if (fHead >= n)
+      return;
+    const size_t size = GetSize();
+    std::vector<unsigned char> buf(2 * fBuf.size() + n);
+    memcpy(&buf[buf.size() - size], &fBuf[fHead], size);
+    fHead = buf.size() - size;
+    fBuf.swap(buf);
+  }
+
+  void Pad(size_t n)
+  {
+    Grow(n);
+    for (size_t i = 0; i < n; i++)
+      fBuf[--fHead] = 0;
+  }
+
+  void Prep(size_t align, size_t additional)
+  {
+    Pad((align - ((GetSize() + additional) % align)) % align);
+  }
+
+  void PushBytes(const void *data, size_t n)
+  {
+    Grow(n);
+    fHead -= n;
+    memcpy(&fBuf[fHead], data, n);
+  }
+
+  std::vector<unsigned char> fBuf;
+  size_t fHead;
+  UInt_t fTableStart = 0;
+  std::vector<std::pair<Int_t, UInt_t>> fFields;
+};
+
+// Arrow flatbuffer enumerations (Schema.fbs, Message.fbs)
+const Short_t kArrowMetadataV5 = 4;
+const UChar_t kArrowTypeInt = 2;
+const UChar_t kArrowTypeFloatingPoint = 3;
+const UChar_t kArrowTypeFixedSizeList = 16;
+const UChar_t kArrowTypeRunEndEncoded = 22;
+const Short_t kArrowPrecisionSingle = 1;
+const Short_t kArrowPrecisionDouble = 2;
+const UChar_t kArrowHeaderSchema = 1;
+const UChar_t kArrowHeaderRecordBatch = 3;
+const UInt_t kArrowContinuation = 0xFFFFFFFF;
+
+Long64_t ArrowPadding(Long64_t n) { return (8 - n % 8) % 8; }
+
+// Field table with an optional list of children
+UInt_t BuildArrowField(FlatBuilder &b, const char *name, UChar_t typeType, UInt_t type, const std::vector<UInt_t> &children)
+{
+  const UInt_t nameString = b.CreateString(name);
+  const UInt_t childrenVector = b.CreateOffsetVector(children);
+  b.StartTable();
+  b.AddOffset(0, nameString);
+  b.AddOffset(3, type);
+  b.AddOffset(5, childrenVector);
+  b.AddScalar<UChar_t>(1, 0); // Not nullable
+  b.AddScalar<UChar_t>(2, typeType);
+  return b.EndTable();
+}
+
+UInt_t BuildArrowInt(FlatBuilder &b, Int_t bytes, Bool_t isSigned)
+{
+  b.StartTable();
+  b.AddScalar<Int_t>(0, 8 * bytes);
+  b.AddScalar<UChar_t>(1, isSigned);
+  return b.EndTable();
+}
+
+// Schema table of the columns written to Arrow. Arrays of fixed size are
+// written as FixedSizeList, run-length encoded columns as RunEndEncoded
+template <typename Columns>
+UInt_t BuildArrowSchema(FlatBuilder &b, const Columns &columns)
+{
+  std::vector<UInt_t> fields;
+  for (const auto &c : columns) {
+    if (!c.fArrowType)
+      continue;
+    UInt_t type;
+    if (c.fArrowType == kArrowTypeFloatingPoint) {
+      b.StartTable();
+      b.AddScalar<Short_t>(0, c.fValueSize == 4 ? kArrowPrecisionSingle : kArrowPrecisionDouble);
+      type = b.EndTable();
+    } else {
+      type = BuildArrowInt(b, c.fValueSize, c.fSigned);
+    }
+    if (c.fEncoding == AliAO2DColumnWriter::kRunLength) {
+      std::vector<UInt_t> children;
+      children.push_back(BuildArrowField(b, "run_ends", kArrowTypeInt, BuildArrowInt(b, 4, kTRUE), std::vector<UInt_t>()));
+      children.push_back(BuildArrowField(b, "values", c.fArrowType, type, std::vector<UInt_t>()));
+      b.StartTable();
+      fields.push_back(BuildArrowField(b, c.fName.Data(), kArrowTypeRunEndEncoded, b.EndTable(), children));
+    } else if (c.fCount > 1) {
+      std::vector<UInt_t> children(1, BuildArrowField(b, "item", c.fArrowType, type, std::vector<UInt_t>()));
+      b.StartTable();
+      b.AddScalar<Int_t>(0, c.fCount);
+      fields.push_back(BuildArrowField(b, c.fName.Data(), kArrowTypeFixedSizeList, b.EndTable(), children));
+    } else {
+      fields.push_back(BuildArrowField(b, c.fName.Data(), c.fArrowType, type, std::vector<UInt_t>()));
+    }
+  }
+  const UInt_t fieldsVector = b.CreateOffsetVector(fields);
+  b.StartTable();
+  b.AddOffset(1, fieldsVector);
+  b.AddScalar<Short_t>(0, 0); // Little endian
+  return b.EndTable();
+}
+
+// Delta encoding of n integer values of type T, with unsigned wrap-around
+template <typename T>
+void DeltaEncode(char *values, char *previous, Int_t n)
+{
+  for (Int_t i = 0; i < n; i++) {
+    T value, last;
+    memcpy(&value, values + i * sizeof(T), sizeof(T));
+    memcpy(&last, previous + i * sizeof(T), sizeof(T));
+    const T delta = value - last;
+    memcpy(values + i * sizeof(T), &delta, sizeof(T));
+    memcpy(previous + i * sizeof(T), &value, sizeof(T));
+  }
+}
+
+template <typename T>
+void DeltaDecode(char *values, const char *deltas, Int_t n)
+{
+  for (Int_t i = 0; i < n; i++) {
+    T value, delta;
+    memcpy(&value, values + i * sizeof(T), sizeof(T));
+    memcpy(&delta, deltas + i * sizeof(T), sizeof(T));
+    value += delta;
+    memcpy(values + i * sizeof(T), &value, sizeof(T));
+  }
+}
+
+void DeltaCode(Bool_t encode, char *values, char *other, Int_t valueSize, Int_t n)
+{
+  switch (valueSize) {
+  case 1:
+    encode ? DeltaEncode<UChar_t>(values, other, n) : DeltaDecode<UChar_t>(values, other, n);
+    break;
+  case 2:
+    encode ? DeltaEncode<UShort_t>(values, other, n) : DeltaDecode<UShort_t>(values, other, n);
+    break;
+  case 4:
+    encode ? DeltaEncode<UInt_t>(values, other, n) : DeltaDecode<UInt_t>(values, other, n);
+    break;
+  default:
+    encode ? DeltaEncode<ULong64_t>(values, other, n) : DeltaDecode<ULong64_t>(values, other, n);
+    break;
+  }
+}
+
+// Value of n bytes, zero extended
+UInt_t ReadUnsigned(const char *data, Int_t n)
+{
+  UInt_t value = 0;
+  memcpy(&value, data, n);
+  return value;
+}
+
+UInt_t UnpackBits(const UInt_t *words, Long64_t index, UInt_t nbits)
+{
+  const ULong64_t bit = index * nbits;
+  const ULong64_t word = bit / 32;
+  const UInt_t shift = bit % 32;
+  ULong64_t value = words[word] >> shift;
+  if (shift + nbits > 32)
+    value |= (ULong64_t)words[word + 1] << (32 - shift);
+  return nbits == 32 ? (UInt_t)value : (UInt_t)(value & ((1u << nbits) - 1));
+}
+
+const char *kEncodingNames[] = {"plain", "delta", "rle", "bitpack"};
+
+} // namespace
+
+AliAO2DColumnWriter::AliAO2DColumnWriter(Int_t ntables)
+  : fTables(ntables)
+{
+}
+
+AliAO2DColumnWriter::~AliAO2DColumnWriter()
+{
+  for (Table &table : fTables)
+    CloseArrow(table);
+}
+
+void AliAO2DColumnWriter::AddTable(Int_t t, TTree *tree)
+{
+  Table &table = fTables[t];
+  table.fTree = tree;
+  table.fColumns.clear();
+  TObjArray *branches = tree->GetListOfBranches();
+  for (Int_t i = 0; i < branches->GetEntriesFast(); i++) {
+    TBranch *branch = (TBranch *)branches->At(i);
+    if (!tree->GetBranchStatus(branch->GetName()))
+      continue; // Pruned
+    TObjArray *leaves = branch->GetListOfLeaves();
+    TLeaf *leaf = leaves->GetEntriesFast() == 1 ? (TLeaf *)leaves->At(0) : nullptr;
+    if (!leaf || leaf->GetLeafCount() || !branch->GetAddress())
+      ::Fatal("AliAO2DColumnWriter::AddTable", "Branch %s of %s is not a fixed size leaf", branch->GetName(), tree->GetName());
+
+    Column column;
+    column.fName = branch->GetName();
+    column.fSource = branch->GetAddress();
+    column.fValueSize = leaf->GetLenType();
+    column.fCount = leaf->GetLenStatic();
+    column.fBytes = column.fValueSize * column.fCount;
+    const TString type = leaf->GetTypeName();
+    if (type == "Float_t") {
+      column.fArrowType = kArrowTypeFloatingPoint;
+      column.fIsFloat = kTRUE;
+    } else if (type == "Double_t") {
+      column.fArrowType = kArrowTypeFloatingPoint;
+    } else if (type == "Char_t" || type == "Short_t" || type == "Int_t" || type == "Long_t" || type == "Long64_t") {
+      column.fArrowType = kArrowTypeInt;
+    } else if (type == "UChar_t" || type == "UShort_t" || type == "UInt_t" || type == "ULong_t" || type == "ULong64_t" || type == "Bool_t") {
+      column.fArrowType = kArrowTypeInt;
+      column.fSigned = kFALSE;
+    } else {
+      ::Warning("AliAO2DColumnWriter::AddTable", "Branch %s of %s has type %s, not written to Arrow", branch->GetName(), tree->GetName(), type.Data());
+    }
+    table.fColumns.push_back(column);
+  }
+}
+
+Bool_t AliAO2DColumnWriter::SetColumnMask(Int_t t, const char *column, UInt_t mask)
+{
+  for (Column &c : fTables[t].fColumns) {
+    if (!c.fName.EqualTo(column))
+      continue;
+    if (!c.fIsFloat)
+      return kFALSE;
+    c.fMask = mask;
+    return kTRUE;
+  }
+  return kFALSE; // Not present or pruned
+}
+
+Bool_t AliAO2DColumnWriter::SetColumnEncoding(Int_t t, const char *column, Encoding encoding)
+{
+  Table &table = fTables[t];
+  for (Column &c : table.fColumns) {
+    if (!c.fName.EqualTo(column))
+      continue;
+    const Bool_t scalar = c.fCount == 1 && c.fValueSize <= 4;
+    if (c.fArrowType != kArrowTypeInt || c.fEncoding != kPlain ||
+        (encoding == kRunLength && (!scalar || c.fValueSize != 4)) || (encoding == kBitPacked && !scalar)) {
+      ::Warning("AliAO2DColumnWriter::SetColumnEncoding", "Cannot use %s for %s of %s", EncodingName(encoding), column, table.fTree->GetName());
+      return kFALSE;
+    }
+    c.fEncoding = encoding;
+    const TString size = c.fName + "_n";
+    if (encoding == kDelta) {
+      c.fPrevious.assign(c.fBytes, 0);
+      table.fTree->Branch(size, &c.fNEncoded, size + "/I");
+    } else if (encoding != kPlain) {
+      // The column is replaced by the encoded time frames
+      const TString encoded = c.fName + "_enc";
+      table.fTree->SetBranchStatus(c.fName, 0);
+      c.fEncoded.assign(1, 0);
+      table.fTree->Branch(size, &c.fNEncoded, size + "/I");
+      c.fEncodedBranch = table.fTree->Branch(encoded, c.fEncoded.data(), encoded + "[" + size + "]/i");
+    }
+    table.fTree->GetUserInfo()->Add(new TNamed(column, EncodingName(encoding)));
+    return kTRUE;
+  }
+  return kFALSE; // Not present or pruned
+}
+
+const char *AliAO2DColumnWriter::EncodingName(Encoding encoding)
+{
+  return kEncodingNames[encoding];
+}
+
+void AliAO2DColumnWriter::Fill(Int_t t)
+{
+  Table &table = fTables[t];
+  for (Column &c : table.fColumns)
+    c.fData.insert(c.fData.end(), c.fSource, c.fSource + c.fBytes);
+  table.fNRows++;
+}
+
+void AliAO2DColumnWriter::Flush()
+{
+  for (Table &table : fTables) {
+    Truncate(table);
+    Encode(table);
+  }
+
+  // The Arrow record batches are written by worker threads while the rows
+  // are replayed into the trees
+  std::vector<std::thread> workers;
+  if (!fArrowPrefix.IsNull()) {
+    for (Table &table : fTables)
+      if (table.fTree && !table.fArrowFile)
+        OpenArrow(table);
+    const Int_t nworkers = std::max(1, std::min(fNArrowWriterThreads, (Int_t)fTables.size()));
+    for (Int_t w = 0; w < nworkers; w++)
+      workers.emplace_back([this, w, nworkers]() {
+        for (size_t t = w; t < fTables.size(); t += nworkers)
+          WriteArrowBatch(fTables[t]);
+      });
+  }
+  for (Table &table : fTables)
+    WriteTree(table);
+  for (std::thread &w : workers)
+    w.join();
+
+  for (Table &table : fTables) {
+    for (Column &c : table.fColumns)
+      c.fData.clear();
+    table.fNRows = 0;
+  }
+}
+
+void AliAO2DColumnWriter::Close()
+{
+  Flush();
+  for (Table &table : fTables)
+    CloseArrow(table);
+}
+
+void AliAO2DColumnWriter::Truncate(Table &table)
+{
+  // Same as AliMathBase::TruncateFloatFraction, one column at a time
+  for (Column &c : table.fColumns) {
+    if (!c.fIsFloat || c.fMask == 0xFFFFFFFF)
+      continue;
+    UInt_t *values = reinterpret_cast<UInt_t *>(c.fData.data());
+    const size_t n = c.fData.size() / sizeof(UInt_t);
+    const UInt_t mask = c.fMask;
+    for (size_t i = 0; i < n; i++)
+      values[i] &= mask;
+  }
+}
+
+void AliAO2DColumnWriter::Encode(Table &table)
+{
+  for (Column &c : table.fColumns) {
+    const Long64_t n = table.fNRows;
+    if (c.fEncoding == kRunLength) {
+      c.fEncoded.clear();
+      const UInt_t *values = reinterpret_cast<const UInt_t *>(c.fData.data());
+      for (Long64_t i = 0; i < n; i++) {
+        if (i && values[i] == values[i - 1]) {
+          c.fEncoded.back()++;
+        } else {
+          c.fEncoded.push_back(values[i]);
+          c.fEncoded.push_back(1);
+        }
+      }
+    } else if (c.fEncoding == kBitPacked) {
+      UInt_t max = 0;
+      for (Long64_t i = 0; i < n; i++)
+        max |= ReadUnsigned(&c.fData[i * c.fValueSize], c.fValueSize);
+      UInt_t nbits = 1;
+      while (nbits < 32 && (max >> nbits))
+        nbits++;
+      c.fEncoded.assign(1 + (n * nbits + 31) / 32, 0);
+      c.fEncoded[0] = nbits;
+      UInt_t *words = c.fEncoded.data() + 1;
+      for (Long64_t i = 0; i < n; i++) {
+        const ULong64_t value = ReadUnsigned(&c.fData[i * c.fValueSize], c.fValueSize);
+        const ULong64_t bit = i * nbits;
+        const UInt_t shift = bit % 32;
+        words[bit / 32] |= value << shift;
+        if (shift + nbits > 32)
+          words[bit / 32 + 1] |= value >> (32 - shift);
+      }
+    }
+  }
+}
+
+void AliAO2DColumnWriter::WriteTree(Table &table)
+{
+  if (!table.fTree || !table.fNRows)
+    return;
+
+  // The rows go through the branch addresses, keep their current content
+  size_t nbytes = 0;
+  for (const Column &c : table.fColumns)
+    nbytes += c.fBytes;
+  table.fRowBackup.resize(nbytes);
+  char *backup = table.fRowBackup.data();
+  for (const Column &c : table.fColumns) {
+    memcpy(backup, c.fSource, c.fBytes);
+    backup += c.fBytes;
+  }
+
+  // The encoded time frames go with the first row, the differences start
+  // again from zero
+  for (Column &c : table.fColumns) {
+    if (c.fEncoding == kDelta) {
+      c.fNEncoded = table.fNRows;
+      std::fill(c.fPrevious.begin(), c.fPrevious.end(), 0);
+    }
+    if (!c.fEncodedBranch)
+      continue;
+    c.fNEncoded = c.fEncoded.size();
+    c.fEncodedBranch->SetAddress(c.fEncoded.data());
+  }
+
+  for (Long64_t row = 0; row < table.fNRows; row++) {
+    for (Column &c : table.fColumns) {
+      memcpy(c.fSource, &c.fData[row * c.fBytes], c.fBytes);
+      if (c.fEncoding == kDelta)
+        DeltaCode(kTRUE, c.fSource, c.fPrevious.data(), c.fValueSize, c.fCount);
+    }
+    table.fTree->Fill();
+    if (!row)
+      for (Column &c : table.fColumns)
+        c.fNEncoded = 0;
+  }
+  table.fTree->FlushBaskets();
+
+  backup = table.fRowBackup.data();
+  for (const Column &c : table.fColumns) {
+    memcpy(c.fSource, backup, c.fBytes);
+    backup += c.fBytes;
+  }
+}
+
+void AliAO2DColumnWriter::OpenArrow(Table &table)
+{
+  const TString name = fArrowPrefix + table.fTree->GetName() + ".arrow";
+  table.fArrowFile = fopen(name.Data(), "wb");
+  if (!table.fArrowFile) {
+    ::Error("AliAO2DColumnWriter::OpenArrow", "Cannot open %s", name.Data());
+    return;
+  }
+  table.fArrowPos = 0;
+  table.fArrowBlocks.clear();
+  const char magic[8] = {'A', 'R', 'R', 'O', 'W', '1', 0, 0};
+  fwrite(magic, 1, 8, table.fArrowFile);
+  table.fArrowPos += 8;
+
+  FlatBuilder b;
+  const UInt_t schema = BuildArrowSchema(b, table.fColumns);
+  b.StartTable();
+  b.AddScalar<Long64_t>(3, 0);
+  b.AddOffset(2, schema);
+  b.AddScalar<Short_t>(0, kArrowMetadataV5);
+  b.AddScalar<UChar_t>(1, kArrowHeaderSchema);
+  WriteArrowMessage(table, b.Finish(b.EndTable()), 0);
+  table.fArrowBlocks.clear(); // The schema is not a record batch
+}
+
+void AliAO2DColumnWriter::WriteArrowMessage(Table &table, const std::vector<unsigned char> &meta, Long64_t bodyLength)
+{
+  const Int_t metaLength = meta.size() + ArrowPadding(meta.size());
+  const char zero[8] = {0};
+  ArrowBlock block;
+  block.fOffset = table.fArrowPos;
+  block.fMetaDataLength = 8 + metaLength;
+  block.fBodyLength = bodyLength;
+  table.fArrowBlocks.push_back(block);
+  fwrite(&kArrowContinuation, 4, 1, table.fArrowFile);
+  fwrite(&metaLength, 4, 1, table.fArrowFile);
+  fwrite(meta.data(), 1, meta.size(), table.fArrowFile);
+  fwrite(zero, 1, metaLength - meta.size(), table.fArrowFile);
+  table.fArrowPos += 8 + metaLength + bodyLength;
+}
+
+void AliAO2DColumnWriter::WriteArrowBatch(Table &table)
+{
+  if (!table.fArrowFile || !table.fNRows)
+    return;
+
+  // Nodes and buffers in depth-first order of the fields. No column has
+  // nulls, the validity buffers are empty
+  std::vector<Long64_t> nodes;
+  std::vector<Long64_t> buffers;
+  std::vector<std::pair<const char *, Long64_t>> body;
+  std::vector<std::vector<Int_t>> runs; // Run ends and values of the run-length encoded columns
+  runs.reserve(2 * table.fColumns.size());
+  Long64_t bodyLength = 0;
+  auto addBuffer = [&](const void *data, Long64_t size) {
+    buffers.insert(buffers.end(), {bodyLength, size});
+    if (!size)
+      return;
+    body.push_back(std::make_pair((const char *)data, size));
+    bodyLength += size + ArrowPadding(size);
+  };
+  for (const Column &c : table.fColumns) {
+    if (!c.fArrowType)
+      continue;
+    if (c.fEncoding == kRunLength) {
+      const Long64_t nruns = c.fEncoded.size() / 2;
+      runs.push_back(std::vector<Int_t>(nruns));
+      std::vector<Int_t> &ends = runs.back();
+      runs.push_back(std::vector<Int_t>(nruns));
+      std::vector<Int_t> &values = runs.back();
+      Int_t end = 0;
+      for (Long64_t i = 0; i < nruns; i++) {
+        values[i] = c.fEncoded[2 * i];
+        end += c.fEncoded[2 * i + 1];
+        ends[i] = end;
+      }
+      nodes.insert(nodes.end(), {table.fNRows, 0, nruns, 0, nruns, 0});
+      addBuffer(nullptr, 0);
+      addBuffer(ends.data(), 4 * nruns);
+      addBuffer(nullptr, 0);
+      addBuffer(values.data(), 4 * nruns);
+      continue;
+    }
+    if (c.fCount > 1) {
+      nodes.insert(nodes.end(), {table.fNRows, 0});
+      addBuffer(nullptr, 0);
+    }
+    nodes.insert(nodes.end(), {table.fNRows * c.fCount, 0});
+    addBuffer(nullptr, 0);
+    addBuffer(c.fData.data(), c.fData.size());
+  }
+
+  FlatBuilder b;
+  const UInt_t nodesVector = b.CreateStructVector(nodes.data(), nodes.size() / 2, 16);
+  const UInt_t buffersVector = b.CreateStructVector(buffers.data(), buffers.size() / 2, 16);
+  b.StartTable();
+  b.AddScalar<Long64_t>(0, table.fNRows);
+  b.AddOffset(1, nodesVector);
+  b.AddOffset(2, buffersVector);
+  const UInt_t batch = b.EndTable();
+  b.StartTable();
+  b.AddScalar<Long64_t>(3, bodyLength);
+  b.AddOffset(2, batch);
+  b.AddScalar<Short_t>(0, kArrowMetadataV5);
+  b.AddScalar<UChar_t>(1, kArrowHeaderRecordBatch);
+  WriteArrowMessage(table, b.Finish(b.EndTable()), bodyLength);
+
+  const char zero[8] = {0};
+  for (const auto &buffer : body) {
+    fwrite(buffer.first, 1, buffer.second, table.fArrowFile);
+    fwrite(zero, 1, ArrowPadding(buffer.second), table.fArrowFile);
+  }
+}
+
+void AliAO2DColumnWriter::CloseArrow(Table &table)
+{
+  if (!table.fArrowFile)
+    return;
+  // End-of-stream marker
+  const Int_t eos[2] = {(Int_t)kArrowContinuation, 0};
+  fwrite(eos, 4, 2, table.fArrowFile);
+
+  // Footer: schema and blocks of the record batches
+  std::vector<Long64_t> blocks;
+  for (const ArrowBlock &block : table.fArrowBlocks)
+    blocks.insert(blocks.end(), {block.fOffset, block.fMetaDataLength, block.fBodyLength});
+  FlatBuilder b;
+  const UInt_t schema = BuildArrowSchema(b, table.fColumns);
+  const UInt_t blocksVector = b.CreateStructVector(blocks.data(), blocks.size() / 3, 24);
+  b.StartTable();
+  b.AddOffset(1, schema);
+  b.AddOffset(3, blocksVector);
+  b.AddScalar<Short_t>(0, kArrowMetadataV5);
+  const std::vector<unsigned char> footer = b.Finish(b.EndTable());
+  FILE *file = table.fArrowFile;
+  table.fArrowFile = nullptr;
+  table.fArrowBlocks.clear();
+  fwrite(footer.data(), 1, footer.size(), file);
+  const Int_t footerLength = footer.size();
+  fwrite(&footerLength, 4, 1, file);
+  fwrite("ARROW1", 1, 6, file);
+  fclose(file);
+}
+
+TTree *AliAO2DColumnWriter::Decode(TTree *tree, TDirectory *dir)
+{
+  Reader reader(tree);
+  if (!reader.IsValid())
+    return nullptr;
+  if (!reader.IsEncoded())
+    return tree;
+
+  // In dir the filled baskets go to the file, only the tree header stays in memory
+  TTree *decoded = new TTree(tree->GetName(), tree->GetTitle());
+  decoded->SetDirectory(dir);
+  for (Int_t i = 0; i < reader.GetNColumns(); i++)
+    decoded->Branch(reader.GetColumnName(i), reader.GetAddress(i), reader.GetLeafList(i));
+  const Long64_t nentries = tree->GetEntries();
+  for (Long64_t entry = 0; entry < nentries; entry++) {
+    if (!reader.GetEntry(entry)) {
+      delete decoded;
+      return nullptr;
+    }
+    decoded->Fill();
+  }
+  decoded->ResetBranchAddresses();
+  if (dir)
+    decoded->Write("", TObject::kOverwrite);
+  return decoded;
+}
+
+AliAO2DColumnWriter::Reader::Reader(TTree *tree)
+  : fTree(tree)
+{
+  // The encodings and the branch layout are taken from the first tree, the
+  // UserInfo of a chain is empty
+  TTree *first = tree;
+  if (tree->InheritsFrom(TChain::Class())) {
+    if (tree->LoadTree(0) < 0) {
+      ::Error("AliAO2DColumnWriter::Reader", "Cannot load the first tree of %s", tree->GetName());
+      return;
+    }
+    first = tree->GetTree();
+  }
+  TList *info = first->GetUserInfo();
+  auto encodingOf = [info](const TString &name) {
+    TObject *tag = info->FindObject(name);
+    for (Int_t e = kDelta; tag && e <= kBitPacked; e++)
+      if (TString(tag->GetTitle()) == kEncodingNames[e])
+        return (Encoding)e;
+    return kPlain;
+  };
+
+  TObjArray *branches = first->GetListOfBranches();
+  for (Int_t i = 0; i < branches->GetEntriesFast(); i++) {
+    TBranch *branch = (TBranch *)branches->At(i);
+    const TString name = branch->GetName();
+    if (name.EndsWith("_n") || name.EndsWith("_enc")) {
+      const TString base = name(0, name.Last('_'));
+      if (encodingOf(base) != kPlain)
+        continue; // Read with the encoded column
+      if (name.EndsWith("_enc") || first->GetBranch(base)) {
+        ::Error("AliAO2DColumnWriter::Reader", "No encoding of %s in the UserInfo of %s", base.Data(), first->GetName());
+        return;
+      }
+    }
+    Decoded d;
+    d.fName = name;
+    d.fLeafList = branch->GetTitle();
+    d.fEncoding = encodingOf(name);
+    if (d.fEncoding == kPlain && branch->GetEntries() != first->GetEntries())
+      continue; // Pruned
+    if (d.fEncoding != kPlain && !first->GetBranch(name + "_n")) {
+      ::Error("AliAO2DColumnWriter::Reader", "No time frames of %s in %s", name.Data(), first->GetName());
+      return;
+    }
+    fEncoded |= d.fEncoding != kPlain;
+    TLeaf *leaf = (TLeaf *)branch->GetListOfLeaves()->At(0);
+    d.fValueSize = leaf->GetLenType();
+    d.fCount = leaf->GetLenStatic();
+    d.fValue.assign(d.fValueSize * d.fCount, 0);
+    fColumns.push_back(d);
+  }
+  fValid = kTRUE;
+  if (!fEncoded)
+    return;
+
+  // The buffers do not move once the addresses are set
+  tree->SetBranchStatus("*", 0);
+  for (Int_t i = 0; i < (Int_t)fColumns.size(); i++) {
+    Decoded &d = fColumns[i];
+    const TString &name = d.fName;
+    if (d.fEncoding != kPlain) {
+      if (fBoundary < 0)
+        fBoundary = i;
+      tree->SetBranchStatus(name + "_n", 1);
+      tree->SetBranchAddress(name + "_n", &d.fNEncoded);
+    }
+    if (d.fEncoding == kRunLength || d.fEncoding == kBitPacked) {
+      // Largest time frame of all the trees of a chain
+      d.fRead32.assign(std::max(1, (Int_t)tree->GetMaximum(name + "_n")), 0);
+      tree->SetBranchStatus(name + "_enc", 1);
+      tree->SetBranchAddress(name + "_enc", d.fRead32.data());
+    } else {
+      if (d.fEncoding == kDelta)
+        d.fRead.assign(d.fValue.size(), 0);
+      tree->SetBranchStatus(name, 1);
+      tree->SetBranchAddress(name, d.fEncoding == kDelta ? d.fRead.data() : d.fValue.data());
+    }
+  }
+}
+
+AliAO2DColumnWriter::Reader::~Reader()
+{
+  if (!fEncoded)
+    return;
+  fTree->ResetBranchAddresses();
+  fTree->SetBranchStatus("*", 1);
+}
+
+Bool_t AliAO2DColumnWriter::Reader::GetEntry(Long64_t entry)
+{
+  if (!fValid)
+    return kFALSE;
+  if (!fEncoded)
+    return fTree->GetEntry(entry) > 0;
+
+  if (entry != fNext) {
+    // Back to the first row of the time frame of entry
+    Long64_t start = entry;
+    for (; start > 0; start--) {
+      if (fTree->GetEntry(start) <= 0)
+        return kFALSE;
+      if (fColumns[fBoundary].fNEncoded)
+        break;
+    }
+    for (Long64_t e = start; e < entry; e++) {
+      if (fTree->GetEntry(e) <= 0)
+        return kFALSE;
+      DecodeRow();
+    }
+  }
+  if (fTree->GetEntry(entry) <= 0)
+    return kFALSE;
+  DecodeRow();
+  fNext = entry + 1;
+  return kTRUE;
+}
+
+void AliAO2DColumnWriter::Reader::DecodeRow()
+{
+  for (Decoded &d : fColumns) {
+    if (d.fEncoding == kPlain)
+      continue;
+    if (d.fEncoding == kDelta) {
+      if (d.fNEncoded) // First row of a time frame
+        std::fill(d.fValue.begin(), d.fValue.end(), 0);
+      DeltaCode(kFALSE, d.fValue.data(), d.fRead.data(), d.fValueSize, d.fCount);
+      continue;
+    }
+    if (d.fNEncoded) {
+      d.fFrame.assign(d.fRead32.begin(), d.fRead32.begin() + d.fNEncoded);
+      d.fPos = 0;
+    }
+    UInt_t value = 0;
+    if (d.fEncoding == kRunLength) {
+      // Runs are consumed from the front: (value, remaining length)
+      value = d.fFrame[2 * d.fPos];
+      if (!--d.fFrame[2 * d.fPos + 1])
+        d.fPos++;
+    } else {
+      value = UnpackBits(d.fFrame.data() + 1, d.fPos++, d.fFrame[0]);
+    }
+    memcpy(d.fValue.data(), &value, d.fValueSize);
+  }
+}
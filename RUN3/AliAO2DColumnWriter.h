@@ -0,0 +1,154 @@
+/* Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. */
+/* See cxx source for full Copyright notice */
+/* $Id$ */
+
+#ifndef AliAO2DColumnWriter_H
+#define AliAO2DColumnWriter_H
+
+#include <Rtypes.h>
+#include <TString.h>
+
+#include <cstdio>
+#include <vector>
+
+class TBranch;
+class TDirectory;
+class TTree;
+
+// Column buffers of the AO2D tables, used by the column output backend of
+// AliAnalysisTaskAO2Dconverter. The layout of each table is taken from the
+// active branches of its tree: Fill() appends the values at the branch
+// addresses, Flush() truncates the float columns with their precision mask,
+// replays the rows into the trees and optionally writes them as a record
+// batch of an Arrow IPC file per table.
+//
+// Integer columns can be encoded in the trees. Each flush is a time frame:
+// the encoders start from scratch at its first row, where <column>_n is set,
+// so trees merged with hadd keep decoding. The encodings are listed in the
+// UserInfo of the tree (TNamed: column name, encoding name). Reader decodes
+// the rows one at a time, Decode() returns the tree with the plain columns.
+class AliAO2DColumnWriter
+{
+public:
+  enum Encoding { // Encoding of a column in the tree
+    kPlain = 0,
+    kDelta,     // Difference to the value of the previous row of the time frame, its number of rows in <column>_n
+    kRunLength, // (value, length) pairs of the time frame in <column>_enc, stored at its first row
+    kBitPacked  // Bit width and values of the time frame packed with it in <column>_enc, stored at its first row
+  };
+
+  AliAO2DColumnWriter(Int_t ntables);
+  ~AliAO2DColumnWriter();
+
+  AliAO2DColumnWriter(const AliAO2DColumnWriter &) = delete;
+  AliAO2DColumnWriter &operator=(const AliAO2DColumnWriter &) = delete;
+
+  void AddTable(Int_t t, TTree *tree);                             // Buffer the active branches of tree as table t
+  Bool_t SetColumnMask(Int_t t, const char *column, UInt_t mask); // Truncation mask of a Float_t column
+  Bool_t SetColumnEncoding(Int_t t, const char *column, Encoding encoding); // Encoding of an integer column
+  void SetArrowOutput(const char *prefix) { fArrowPrefix = prefix; } // Also write <prefix><tree name>.arrow
+  void SetNArrowWriterThreads(Int_t n) { fNArrowWriterThreads = n; } // Threads writing the (uncompressed) Arrow files
+
+  void Fill(Int_t t);  // Append the current values of the branches of table t
+  void Flush();        // Write the buffered rows of all tables and clear the buffers
+  void Close();        // Flush and finalise the Arrow files
+
+  Long64_t GetNRows(Int_t t) const { return fTables[t].fNRows; }
+
+  static const char *EncodingName(Encoding encoding);
+  static TTree *Decode(TTree *tree, TDirectory *dir = nullptr); // Copy of tree (or chain) with the columns decoded, in dir or memory resident, tree itself if nothing is encoded, nullptr on error
+
+  // Entry by entry decoding of a tree or chain written with encoded columns.
+  // The entries are best read in order, otherwise the time frame of the entry
+  // is decoded again from its first row
+  class Reader
+  {
+  public:
+    Reader(TTree *tree);
+    ~Reader();
+
+    Reader(const Reader &) = delete;
+    Reader &operator=(const Reader &) = delete;
+
+    Bool_t IsValid() const { return fValid; }     // kFALSE if the encodings cannot be read
+    Bool_t IsEncoded() const { return fEncoded; } // At least one column is encoded
+    Int_t GetNColumns() const { return fColumns.size(); }
+    const char *GetColumnName(Int_t i) const { return fColumns[i].fName; }
+    const char *GetLeafList(Int_t i) const { return fColumns[i].fLeafList; }
+    void *GetAddress(Int_t i) { return fColumns[i].fValue.data(); } // Decoded values of column i
+    Bool_t GetEntry(Long64_t entry);                                 // Read and decode entry
+
+  private:
+    struct Decoded {
+      TString fName;
+      TString fLeafList;
+      Encoding fEncoding = kPlain;
+      Int_t fValueSize = 0;
+      Int_t fCount = 1;
+      std::vector<char> fValue;    // Decoded row
+      std::vector<char> fRead;     // Row as stored (kDelta)
+      Int_t fNEncoded = 0;         // <column>_n, non zero at the first row of a time frame
+      std::vector<UInt_t> fRead32; // <column>_enc as stored
+      std::vector<UInt_t> fFrame;  // Current time frame
+      Long64_t fPos = 0;           // Row in the time frame
+    };
+
+    void DecodeRow();
+
+    TTree *fTree;
+    std::vector<Decoded> fColumns;
+    Bool_t fValid = kFALSE;
+    Bool_t fEncoded = kFALSE;
+    Int_t fBoundary = -1; // Column whose <column>_n marks the time frames
+    Long64_t fNext = 0;   // Entry following the last decoded one
+  };
+
+private:
+  struct Column {
+    TString fName;             // Branch name
+    char *fSource = nullptr;   // Branch address
+    Int_t fBytes = 0;          // Bytes per row
+    Int_t fCount = 1;          // Values per row (fixed size arrays)
+    Int_t fValueSize = 0;      // Bytes per value
+    UChar_t fArrowType = 0;    // Arrow type id of the values, 0: not written to Arrow
+    Bool_t fSigned = kTRUE;    // Signedness of integer columns
+    Bool_t fIsFloat = kFALSE;  // Float_t column, can be truncated
+    UInt_t fMask = 0xFFFFFFFF; // Truncation mask
+    std::vector<char> fData;   // Buffered rows
+    Encoding fEncoding = kPlain;
+    std::vector<char> fPrevious;   // kDelta: last row of the time frame written to the tree
+    std::vector<UInt_t> fEncoded;  // kRunLength, kBitPacked: encoded time frame
+    Int_t fNEncoded = 0;           // <column>_n of the row being written
+    TBranch *fEncodedBranch = nullptr;
+  };
+
+  struct ArrowBlock {
+    Long64_t fOffset;
+    Int_t fMetaDataLength;
+    Long64_t fBodyLength;
+  };
+
+  struct Table {
+    TTree *fTree = nullptr;
+    std::vector<Column> fColumns;
+    Long64_t fNRows = 0;
+    std::vector<char> fRowBackup; // Branch values at the time of the flush
+    FILE *fArrowFile = nullptr;
+    Long64_t fArrowPos = 0;
+    std::vector<ArrowBlock> fArrowBlocks;
+  };
+
+  void Truncate(Table &table);
+  void Encode(Table &table);
+  void WriteTree(Table &table);
+  void WriteArrowBatch(Table &table);
+  void OpenArrow(Table &table);
+  void CloseArrow(Table &table);
+  void WriteArrowMessage(Table &table, const std::vector<unsigned char> &meta, Long64_t bodyLength);
+
+  std::vector<Table> fTables;
+  TString fArrowPrefix = "";
+  Int_t fNArrowWriterThreads = 1;
+};
+
+#endif
@@ -27,6 +27,7 @@
 #include "AliESDInputHandler.h"
 #include "AliEMCALGeometry.h"
 #include "AliAnalysisTaskAO2Dconverter.h"
+#include "AliAO2DColumnWriter.h"
 #include "AliVHeader.h"
 #include "COMMON/MULTIPLICITY/AliMultSelection.h"
 
@@ -72,6 +73,165 @@ ULong64_t GetEventIdAsLong(AliVHeader *header)
           (ULong64_t)header->GetPeriodNumber() * 16777216 * 3564);
 }
 
+// Precision masks used to truncate the float data members
+const UInt_t kMaskCollisionPosition = 0xFFFFFFF0;    // 19 bits mantissa
+const UInt_t kMaskCollisionPositionCov = 0xFFFFE000; // 10 bits mantissa
+
+const UInt_t kMaskTrackX = 0xFFFFFFF0;           // 19 bits
+const UInt_t kMaskTrackAlpha = 0xFFFFFFF0;       // 19 bits
+const UInt_t kMaskTrackSnp = 0xFFFFFF00;         // 15 bits
+const UInt_t kMaskTrackTgl = 0xFFFFFF00;         // 15 bits
+const UInt_t kMaskTrack1Pt = 0xFFFFFC00;         // 13 bits
+const UInt_t kMaskTrackCovDiag = 0xFFFFFF00;     // 15 bits
+const UInt_t kMaskTrackCovOffDiag = 0xFFFF0000;  // 7 bits
+const UInt_t kMaskTrackSignal = 0xFFFFFF00;      // 15 bits
+
+const UInt_t kMaskTracklets = 0xFFFFFF00;        // 15 bits
+
+const UInt_t kMaskMcParticleW = 0xFFFFFFF0;      // 19 bits
+const UInt_t kMaskMcParticlePos = 0xFFFFFFF0;    // 19 bits
+const UInt_t kMaskMcParticleMom = 0xFFFFFFF0;    // 19 bits
+
+const UInt_t kMaskCaloAmp = 0xFFFFFF00;          // 15 bits
+const UInt_t kMaskCaloTime = 0xFFFFFF00;         // 15 bits
+
+const UInt_t kMaskMuonTr1P = 0xFFFFFC00;         // 13 bits
+const UInt_t kMaskMuonTrThetaX = 0xFFFFFF00;     // 15 bits
+const UInt_t kMaskMuonTrThetaY = 0xFFFFFF00;     // 15 bits
+const UInt_t kMaskMuonTrZmu = 0xFFFFFFF0;        // 19 bits
+const UInt_t kMaskMuonTrBend = 0xFFFFFFF0;       // 19 bits
+const UInt_t kMaskMuonTrNonBend = 0xFFFFFFF0;    // 19 bits
+const UInt_t kMaskMuonTrCov = 0xFFFF0000;        // 7 bits
+
+const UInt_t kMaskMuonCl = 0xFFFFFF00;           // 15 bits
+const UInt_t kMaskMuonClErr = 0xFFFF0000;        // 7 bits
+
+const UInt_t kMaskADTime = 0xFFFFF000;           // 11 bits
+
+// The same truncation applied per column by the column backend
+struct ColumnMask {
+  AliAnalysisTaskAO2Dconverter::TreeIndex fTree;
+  const char *fColumn;
+  UInt_t fMask;
+};
+
+const ColumnMask kColumnMasks[] = {
+  {AliAnalysisTaskAO2Dconverter::kEvents, "fPosX", kMaskCollisionPosition},
+  {AliAnalysisTaskAO2Dconverter::kEvents, "fPosY", kMaskCollisionPosition},
+  {AliAnalysisTaskAO2Dconverter::kEvents, "fPosZ", kMaskCollisionPosition},
+  {AliAnalysisTaskAO2Dconverter::kEvents, "fCovXX", kMaskCollisionPositionCov},
+  {AliAnalysisTaskAO2Dconverter::kEvents, "fCovXY", kMaskCollisionPositionCov},
+  {AliAnalysisTaskAO2Dconverter::kEvents, "fCovXZ", kMaskCollisionPositionCov},
+  {AliAnalysisTaskAO2Dconverter::kEvents, "fCovYY", kMaskCollisionPositionCov},
+  {AliAnalysisTaskAO2Dconverter::kEvents, "fCovYZ", kMaskCollisionPositionCov},
+  {AliAnalysisTaskAO2Dconverter::kEvents, "fCovZZ", kMaskCollisionPositionCov},
+  {AliAnalysisTaskAO2Dconverter::kEvents, "fChi2", kMaskCollisionPositionCov},
+  {AliAnalysisTaskAO2Dconverter::kEvents, "fCollisionTime", kMaskCollisionPosition},
+  {AliAnalysisTaskAO2Dconverter::kEvents, "fCollisionTimeRes", kMaskCollisionPositionCov},
+
+  // The tracklets use kMaskTracklets for fAlpha and fTgl, which is at least as strict
+  {AliAnalysisTaskAO2Dconverter::kTracks, "fX", kMaskTrackX},
+  {AliAnalysisTaskAO2Dconverter::kTracks, "fAlpha", kMaskTrackAlpha},
+  {AliAnalysisTaskAO2Dconverter::kTracks, "fSnp", kMaskTrackSnp},
+  {AliAnalysisTaskAO2Dconverter::kTracks, "fTgl", kMaskTrackTgl},
+  {AliAnalysisTaskAO2Dconverter::kTracks, "fSigned1Pt", kMaskTrack1Pt},
+  {AliAnalysisTaskAO2Dconverter::kTracks, "fSigmaY", kMaskTrackCovDiag},
+  {AliAnalysisTaskAO2Dconverter::kTracks, "fSigmaZ", kMaskTrackCovDiag},
+  {AliAnalysisTaskAO2Dconverter::kTracks, "fSigmaSnp", kMaskTrackCovDiag},
+  {AliAnalysisTaskAO2Dconverter::kTracks, "fSigmaTgl", kMaskTrackCovDiag},
+  {AliAnalysisTaskAO2Dconverter::kTracks, "fSigma1Pt", kMaskTrackCovDiag},
+  {AliAnalysisTaskAO2Dconverter::kTracks, "fTPCInnerParam", kMaskTrack1Pt},
+  {AliAnalysisTaskAO2Dconverter::kTracks, "fITSChi2NCl", kMaskTrackCovOffDiag},
+  {AliAnalysisTaskAO2Dconverter::kTracks, "fTPCChi2NCl", kMaskTrackCovOffDiag},
+  {AliAnalysisTaskAO2Dconverter::kTracks, "fTRDChi2", kMaskTrackCovOffDiag},
+  {AliAnalysisTaskAO2Dconverter::kTracks, "fTOFChi2", kMaskTrackCovOffDiag},
+  {AliAnalysisTaskAO2Dconverter::kTracks, "fTPCSignal", kMaskTrackSignal},
+  {AliAnalysisTaskAO2Dconverter::kTracks, "fTRDSignal", kMaskTrackSignal},
+  {AliAnalysisTaskAO2Dconverter::kTracks, "fTOFSignal", kMaskTrackSignal},
+  {AliAnalysisTaskAO2Dconverter::kTracks, "fLength", kMaskTrackSignal},
+  {AliAnalysisTaskAO2Dconverter::kTracks, "fTOFExpMom", kMaskTrack1Pt},
+
+  {AliAnalysisTaskAO2Dconverter::kCalo, "fAmplitude", kMaskCaloAmp},
+  {AliAnalysisTaskAO2Dconverter::kCalo, "fTime", kMaskCaloTime},
+  {AliAnalysisTaskAO2Dconverter::kCaloTrigger, "fL0Amplitude", kMaskCaloAmp},
+
+  {AliAnalysisTaskAO2Dconverter::kMuon, "fInverseBendingMomentum", kMaskMuonTr1P},
+  {AliAnalysisTaskAO2Dconverter::kMuon, "fThetaX", kMaskMuonTrThetaX},
+  {AliAnalysisTaskAO2Dconverter::kMuon, "fThetaY", kMaskMuonTrThetaY},
+  {AliAnalysisTaskAO2Dconverter::kMuon, "fZMu", kMaskMuonTrZmu},
+  {AliAnalysisTaskAO2Dconverter::kMuon, "fBendingCoor", kMaskMuonTrBend},
+  {AliAnalysisTaskAO2Dconverter::kMuon, "fNonBendingCoor", kMaskMuonTrNonBend},
+  {AliAnalysisTaskAO2Dconverter::kMuon, "fCovariances", kMaskMuonTrCov},
+  {AliAnalysisTaskAO2Dconverter::kMuon, "fChi2", kMaskMuonTrCov},
+  {AliAnalysisTaskAO2Dconverter::kMuon, "fChi2MatchTrigger", kMaskMuonTrCov},
+
+  {AliAnalysisTaskAO2Dconverter::kMuonCls, "fX", kMaskMuonCl},
+  {AliAnalysisTaskAO2Dconverter::kMuonCls, "fY", kMaskMuonCl},
+  {AliAnalysisTaskAO2Dconverter::kMuonCls, "fZ", kMaskMuonCl},
+  {AliAnalysisTaskAO2Dconverter::kMuonCls, "fErrX", kMaskMuonClErr},
+  {AliAnalysisTaskAO2Dconverter::kMuonCls, "fErrY", kMaskMuonClErr},
+  {AliAnalysisTaskAO2Dconverter::kMuonCls, "fCharge", kMaskMuonCl},
+  {AliAnalysisTaskAO2Dconverter::kMuonCls, "fChi2", kMaskMuonClErr},
+
+  {AliAnalysisTaskAO2Dconverter::kFDD, "fTimeA", kMaskADTime},
+  {AliAnalysisTaskAO2Dconverter::kFDD, "fTimeC", kMaskADTime},
+
+  {AliAnalysisTaskAO2Dconverter::kMcParticle, "fWeight", kMaskMcParticleW},
+  {AliAnalysisTaskAO2Dconverter::kMcParticle, "fPx", kMaskMcParticleMom},
+  {AliAnalysisTaskAO2Dconverter::kMcParticle, "fPy", kMaskMcParticleMom},
+  {AliAnalysisTaskAO2Dconverter::kMcParticle, "fPz", kMaskMcParticleMom},
+  {AliAnalysisTaskAO2Dconverter::kMcParticle, "fE", kMaskMcParticleMom},
+  {AliAnalysisTaskAO2Dconverter::kMcParticle, "fVx", kMaskMcParticlePos},
+  {AliAnalysisTaskAO2Dconverter::kMcParticle, "fVy", kMaskMcParticlePos},
+  {AliAnalysisTaskAO2Dconverter::kMcParticle, "fVz", kMaskMcParticlePos},
+  {AliAnalysisTaskAO2Dconverter::kMcParticle, "fVt", kMaskMcParticlePos},
+
+  {AliAnalysisTaskAO2Dconverter::kMcCollision, "fPosX", kMaskCollisionPosition},
+  {AliAnalysisTaskAO2Dconverter::kMcCollision, "fPosY", kMaskCollisionPosition},
+  {AliAnalysisTaskAO2Dconverter::kMcCollision, "fPosZ", kMaskCollisionPosition},
+  {AliAnalysisTaskAO2Dconverter::kMcCollision, "fT", kMaskCollisionPosition},
+  {AliAnalysisTaskAO2Dconverter::kMcCollision, "fWeight", kMaskCollisionPosition},
+  {AliAnalysisTaskAO2Dconverter::kMcCollision, "fImpactParameter", kMaskCollisionPosition}
+};
+
+// Encodings of the index and flag columns used by the column backend:
+// delta for increasing indices, run length for the columns constant within
+// a collision and bit packing for the flags and enums
+struct ColumnEncoding {
+  AliAnalysisTaskAO2Dconverter::TreeIndex fTree;
+  const char *fColumn;
+  AliAO2DColumnWriter::Encoding fEncoding;
+};
+
+const ColumnEncoding kColumnEncodings[] = {
+  {AliAnalysisTaskAO2Dconverter::kEvents, "fBCsID", AliAO2DColumnWriter::kDelta},
+  {AliAnalysisTaskAO2Dconverter::kEventsExtra, "fStart", AliAO2DColumnWriter::kDelta},
+  {AliAnalysisTaskAO2Dconverter::kBC, "fRunNumber", AliAO2DColumnWriter::kRunLength},
+
+  {AliAnalysisTaskAO2Dconverter::kTracks, "fCollisionsID", AliAO2DColumnWriter::kRunLength},
+  {AliAnalysisTaskAO2Dconverter::kTracks, "fTrackType", AliAO2DColumnWriter::kBitPacked},
+  {AliAnalysisTaskAO2Dconverter::kCalo, "fBCsID", AliAO2DColumnWriter::kRunLength},
+  {AliAnalysisTaskAO2Dconverter::kCalo, "fCaloType", AliAO2DColumnWriter::kBitPacked},
+  {AliAnalysisTaskAO2Dconverter::kCaloTrigger, "fBCsID", AliAO2DColumnWriter::kRunLength},
+  {AliAnalysisTaskAO2Dconverter::kCaloTrigger, "fCaloType", AliAO2DColumnWriter::kBitPacked},
+  {AliAnalysisTaskAO2Dconverter::kMuon, "fBCsID", AliAO2DColumnWriter::kRunLength},
+  {AliAnalysisTaskAO2Dconverter::kMuonCls, "fMuonsID", AliAO2DColumnWriter::kRunLength},
+  {AliAnalysisTaskAO2Dconverter::kZdc, "fBCsID", AliAO2DColumnWriter::kDelta},
+  {AliAnalysisTaskAO2Dconverter::kRun2V0, "fBCsID", AliAO2DColumnWriter::kDelta},
+  {AliAnalysisTaskAO2Dconverter::kFDD, "fBCsID", AliAO2DColumnWriter::kDelta},
+  {AliAnalysisTaskAO2Dconverter::kV0s, "fPosTrackID", AliAO2DColumnWriter::kDelta},
+  {AliAnalysisTaskAO2Dconverter::kV0s, "fNegTrackID", AliAO2DColumnWriter::kDelta},
+  {AliAnalysisTaskAO2Dconverter::kCascades, "fV0sID", AliAO2DColumnWriter::kDelta},
+  {AliAnalysisTaskAO2Dconverter::kCascades, "fTracksID", AliAO2DColumnWriter::kDelta},
+
+  {AliAnalysisTaskAO2Dconverter::kMcCollision, "fBCsID", AliAO2DColumnWriter::kDelta},
+  {AliAnalysisTaskAO2Dconverter::kMcParticle, "fMcCollisionsID", AliAO2DColumnWriter::kRunLength},
+  {AliAnalysisTaskAO2Dconverter::kMcParticle, "fFlags", AliAO2DColumnWriter::kBitPacked},
+  {AliAnalysisTaskAO2Dconverter::kMcTrackLabel, "fLabel", AliAO2DColumnWriter::kDelta},
+  {AliAnalysisTaskAO2Dconverter::kMcCaloLabel, "fLabel", AliAO2DColumnWriter::kDelta},
+  {AliAnalysisTaskAO2Dconverter::kMcCollisionLabel, "fLabel", AliAO2DColumnWriter::kDelta}
+};
+
 } // namespace
 
 AliAnalysisTaskAO2Dconverter::AliAnalysisTaskAO2Dconverter(const char* name)
@@ -110,6 +270,7 @@ AliAnalysisTaskAO2Dconverter::AliAnalysisTaskAO2Dconverter(const char* name)
 
 AliAnalysisTaskAO2Dconverter::~AliAnalysisTaskAO2Dconverter()
 {
+  delete fColumnWriter;
   fOutputList->Delete();
   delete fOutputList;
   for (Int_t i = 0; i < kTrees; i++)
@@ -140,7 +301,10 @@ void AliAnalysisTaskAO2Dconverter::FillTree(TreeIndex t)
 {
   if (!fTreeStatus[t])
     return;
-  fTree[t]->Fill();
+  if (fColumnWriter)
+    fColumnWriter->Fill(t);
+  else
+    fTree[t]->Fill();
 }
 
 void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
@@ -501,6 +665,25 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 
 
   Prune(); //Removing all unwanted branches (if any)
+
+  if (fOutputBackend == kColumnBackend) {
+    // The column buffers take the layout of the remaining branches
+    fColumnWriter = new AliAO2DColumnWriter(kTrees);
+    for (Int_t i = 0; i < kTrees; i++)
+      if (fTreeStatus[i])
+        fColumnWriter->AddTable(i, fTree[i]);
+    if (fTruncate)
+      for (const ColumnMask &m : kColumnMasks)
+        fColumnWriter->SetColumnMask(m.fTree, m.fColumn, m.fMask);
+    if (fEncodeColumns)
+      for (const ColumnEncoding &e : kColumnEncodings)
+        if (fTreeStatus[e.fTree])
+          fColumnWriter->SetColumnEncoding(e.fTree, e.fColumn, e.fEncoding);
+    fColumnWriter->SetNArrowWriterThreads(fNArrowWriterThreads);
+    if (!fArrowPrefix.IsNull())
+      fColumnWriter->SetArrowOutput(fArrowPrefix);
+    fNBufferedEvents = 0;
+  }
 }
 
 void AliAnalysisTaskAO2Dconverter::Prune()
@@ -568,40 +751,47 @@ void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
   
   // No compression for ZDC and Run2 VZERO for the moment
 
-  if (fTruncate) {
-    mCollisionPosition = 0xFFFFFFF0; // 19 bits mantissa
-    mCollisionPositionCov = 0xFFFFE000; // 10 bits mantissa
-
-    mTrackX =  0xFFFFFFF0; // 19 bits
-    mTrackAlpha = 0xFFFFFFF0; // 19 bits
-    mtrackSnp = 0xFFFFFF00; // 15 bits
-    mTrackTgl = 0xFFFFFF00; // 15 bits
-    mTrack1Pt = 0xFFFFFC00; // 13 bits
-    mTrackCovDiag = 0xFFFFFF00; // 15 bits
-    mTrackCovOffDiag = 0xFFFF0000; // 7 bits
-    mTrackSignal = 0xFFFFFF00; // 15 bits
-
-    mTracklets = 0xFFFFFF00; // 15 bits
-
-    mMcParticleW   = 0xFFFFFFF0; // 19 bits
-    mMcParticlePos = 0xFFFFFFF0; // 19 bits
-    mMcParticleMom = 0xFFFFFFF0; // 19 bits
-
-    mCaloAmp = 0xFFFFFF00; // 15 bits
-    mCaloTime = 0xFFFFFF00; // 15 bits
-
-    mMuonTr1P = 0xFFFFFC00; // 13 bits 
-    mMuonTrThetaX = 0xFFFFFF00; // 15 bits
-    mMuonTrThetaY = 0xFFFFFF00; // 15 bits
-    mMuonTrZmu = 0xFFFFFFF0; // 19 bits
-    mMuonTrBend = 0xFFFFFFF0; // 19 bits
-    mMuonTrNonBend = 0xFFFFFFF0; // 19 bits
-    mMuonTrCov = 0xFFFF0000; // 7 bits
-
-    mMuonCl = 0xFFFFFF00; // 15 bits
-    mMuonClErr = 0xFFFF0000; // 7 bits
+  // With the column backend the truncation is applied to the whole columns
+  // when the buffers are written (see kColumnMasks)
+  if (fTruncate && !fColumnWriter) {
+    mCollisionPosition = kMaskCollisionPosition;
+    mCollisionPositionCov = kMaskCollisionPositionCov;
+
+    mTrackX = kMaskTrackX;
+    mTrackAlpha = kMaskTrackAlpha;
+    mtrackSnp = kMaskTrackSnp;
+    mTrackTgl = kMaskTrackTgl;
+    mTrack1Pt = kMaskTrack1Pt;
+    mTrackCovOffDiag = kMaskTrackCovOffDiag;
+    mTrackSignal = kMaskTrackSignal;
+
+    mMcParticleW   = kMaskMcParticleW;
+    mMcParticlePos = kMaskMcParticlePos;
+    mMcParticleMom = kMaskMcParticleMom;
+
+    mCaloAmp = kMaskCaloAmp;
+    mCaloTime = kMaskCaloTime;
+
+    mMuonTr1P = kMaskMuonTr1P;
+    mMuonTrThetaX = kMaskMuonTrThetaX;
+    mMuonTrThetaY = kMaskMuonTrThetaY;
+    mMuonTrZmu = kMaskMuonTrZmu;
+    mMuonTrBend = kMaskMuonTrBend;
+    mMuonTrNonBend = kMaskMuonTrNonBend;
+    mMuonTrCov = kMaskMuonTrCov;
+
+    mMuonCl = kMaskMuonCl;
+    mMuonClErr = kMaskMuonClErr;
     
-    mADTime = 0xFFFFF000; // 11 bits
+    mADTime = kMaskADTime;
+  }
+  // The tracklets share the columns of the tracks, keep their own mask.
+  // The correlations fRho* are calculated from the truncated sigmas, which
+  // therefore are truncated here for both backends (the column truncation
+  // is a bit mask and leaves them unchanged)
+  if (fTruncate) {
+    mTracklets = kMaskTracklets;
+    mTrackCovDiag = kMaskTrackCovDiag;
   }
   
   // Initialisation
@@ -1414,6 +1604,12 @@ void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
   // We can fill now the vertex + indexing data
   FillTree(kEvents);
 
+  // The column buffers are written once per time frame of fNumberOfEventsPerCluster collisions
+  if (fColumnWriter && ++fNBufferedEvents >= fNumberOfEventsPerCluster) {
+    fColumnWriter->Flush();
+    fNBufferedEvents = 0;
+  }
+
   //---------------------------------------------------------------------------
   //Posting data
   PostData(1, fOutputList);
@@ -1427,6 +1623,14 @@ void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
   fOffsetV0ID += nv0_filled;
 }
 
+void AliAnalysisTaskAO2Dconverter::FinishTaskOutput()
+{
+  // Write the last, partial time frame of the column backend before the outputs are saved
+  if (fColumnWriter)
+    fColumnWriter->Close();
+  fNBufferedEvents = 0;
+}
+
 void AliAnalysisTaskAO2Dconverter::Terminate(Option_t *)
 {
   // terminate
@@ -16,6 +16,7 @@
 #include <Rtypes.h>
 
 class AliESDEvent;
+class AliAO2DColumnWriter;
 
 class AliAnalysisTaskAO2Dconverter : public AliAnalysisTaskSE
 {
@@ -33,12 +34,22 @@ public:
   virtual void Init() {}
   virtual void UserCreateOutputObjects();
   virtual void UserExec(Option_t *option);
+  virtual void FinishTaskOutput();
   virtual void Terminate(Option_t *option);
 
   void SetNumberOfEventsPerCluster(int n) { fNumberOfEventsPerCluster = n; }
 
   virtual void SetTruncation(Bool_t trunc=kTRUE) {fTruncate = trunc;}
 
+  enum OutputBackend { // How the entries reach the output trees
+    kEntryBackend = 0, // TTree::Fill for each entry
+    kColumnBackend     // Columns buffered for fNumberOfEventsPerCluster collisions, then written at once
+  };
+  void SetOutputBackend(OutputBackend backend) { fOutputBackend = backend; }
+  void SetArrowOutput(const char *prefix = "AO2D_") { fArrowPrefix = prefix; } // Column backend only: also write <prefix><tree name>.arrow
+  void SetNArrowWriterThreads(Int_t n) { fNArrowWriterThreads = n; }           // Column backend only: threads writing the Arrow files, the trees are written on the calling thread
+  void SetColumnEncoding(Bool_t encode = kTRUE) { fEncodeColumns = encode; }   // Column backend only: encode the index and flag columns, see AliAO2DColumnWriter::Decode
+
   static AliAnalysisTaskAO2Dconverter* AddTask(TString suffix = "");
   enum TreeIndex { // Index of the output trees
     kEvents = 0,
@@ -125,6 +136,13 @@ private:
   Bool_t fTreeStatus[kTrees] = { kTRUE }; // Status of the trees i.e. kTRUE (enabled) or kFALSE (disabled)
   int fNumberOfEventsPerCluster = 1000;   // Maximum basket size of the trees
 
+  OutputBackend fOutputBackend = kEntryBackend; // Output backend
+  TString fArrowPrefix = "";                    // Prefix of the Arrow files, none if empty
+  Int_t fNArrowWriterThreads = 1;               // Number of threads writing the Arrow files (uncompressed)
+  Bool_t fEncodeColumns = kFALSE;               // Delta, run-length and bit-packed index and flag columns
+  AliAO2DColumnWriter *fColumnWriter = nullptr; //! Column buffers of the column backend
+  Int_t fNBufferedEvents = 0;                   //! Collisions in the column buffers
+
   TaskModes fTaskMode = kStandard; // Running mode of the task. Useful to set for e.g. MC mode
 
   // Data structures
@@ -460,7 +478,7 @@ private:
   TH1F *fCentralityINT7 = nullptr; ///! Centrality histogram for the INT7 triggers
   TH1I *fHistPileupEvents = nullptr; ///! Counter histogram for pileup events
   
-  ClassDef(AliAnalysisTaskAO2Dconverter, 10);
+  ClassDef(AliAnalysisTaskAO2Dconverter, 12);
 };
 
 #endif